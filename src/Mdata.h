@@ -184,7 +184,8 @@ All but the "else" stuff below is specific to factor.c built in standalone mode:
 #define ERR_SKIP_RADIX_SET			14	// In context of self-testing, not fatal for run overall but skip the current set of FFT radices
 #define ERR_INTERRUPT				15	// On one of several interrupt SIGs, exit iteration loop prematurely, write savefiles and exit
 #define ERR_GERBICZ_CHECK			16
-#define ERR_MAX		ERR_GERBICZ_CHECK
+#define ERR_RESIDUE_REF				17	// Interim residue differs from that in a reference file from an earlier run of the same test
+#define ERR_MAX		ERR_RESIDUE_REF
 
 /***********************************************************************************************/
 /* Globals. Unless specified otherwise, these are declared in Mdata.h and defined in Mlucas.c: */
@@ -472,6 +473,44 @@ const long double inv_m61 = (long double)1.0/2305843009213693951ull;
 #define MAX_RADIX	4096	// Largest leading-radix currently supported
 extern uint32 NRADICES, RADIX_VEC[10];	/* NRADICES, RADIX_VEC[] store number & set of complex FFT radices used.	*/
 
+/* Cache-blocked ("two-pass") ordering of the intermediate FFT radix passes: If nonzero, the passes following the leading-radix
+one are done breadth-first only until the per-pass sub-block fits in FFT_CACHE_BLOCK doubles, and depth-first thereafter.
+Selected via the radix-set index for FFT lengths >= FFT_CACHE_BLOCK_MIN_KBLOCKS; see get_fft_radices.c for the encoding: */
+extern uint32 FFT_CACHE_BLOCK;
+#define FFT_CACHE_BLOCK_DEF	(1u << 15)	// 32K doubles = 256KB, which leaves room for the twiddles in a 512KB+ L2
+#define FFT_CACHE_BLOCK_MIN_KBLOCKS	32768	// Only offer cache-blocked radix sets for FFT lengths >= 32M
+// Since intermediate radices are <= 32, this guarantees the depth-first sub-blocks are a multiple of the padding blocklength:
+#if FFT_CACHE_BLOCK_DEF < (32u << DAT_BITS_DEF)
+	#error FFT_CACHE_BLOCK_DEF must be >= 32 x 2^DAT_BITS_DEF!
+#endif
+
+/* ROE-probe FFT-length selection at breakover points: At the start of a Mersenne LL|PRP test whose exponent lies just above
+the maximum recommended for the next-smaller FFT length, run FFT_PROBE_ITERS iterations on random data at that length, fit
+the max-ROE distribution and use the smaller length if the predicted number of fatal ROEs over the full test
+is at most FFT_PROBE_MAX_NERR. The outcome and its statistics are kept in the savefile - see fft_length_roe_probe(): */
+extern uint32 FFT_PROBE_RESULT;		// One of the FFT_PROBE_* codes below
+extern uint32 FFT_PROBE_KBLOCKS;	// FFT length (in Kdoubles) which was probed
+extern uint32 FFT_PROBE_NITER;		// #iterations actually run by the probe
+extern double FFT_PROBE_AME, FFT_PROBE_MME, FFT_PROBE_NERR;	// Avg and max per-iteration maxErr, and predicted #fatal ROEs
+#define FFT_PROBE_NONE		0
+#define FFT_PROBE_PENDING	1	// Switched to the smaller length, probe not yet run
+#define FFT_PROBE_ACCEPT	2
+#define FFT_PROBE_REJECT	3
+#define FFT_PROBE_ITERS		2000
+#define FFT_PROBE_CHUNK		10	// #iterations per max-ROE sample
+#define FFT_PROBE_MAX_RATIO	1.02	// Only probe if p <= FFT_PROBE_MAX_RATIO*given_N_get_maxP(next-smaller FFT length)
+#define FFT_PROBE_MAX_NERR	0.05
+
+/* Per-radix kernel microbenchmark (-bench-radix): bench_radix() runs each radix set at a cache-resident and a DRAM-resident
+FFT length (or just at a user-set -fft one) via ernstMain, which with BENCH_RADIX set calls bench_radix_set() in place of
+the usual timing test. The number of timed iterations defaults to BENCH_RADIX_ITERS at the cache-resident length, scaled
+inversely with FFT length from there: */
+extern uint32 BENCH_RADIX;
+#define BENCH_RADIX_KCACHE	64		// Default FFT lengths in Kdoubles
+#define BENCH_RADIX_KDRAM	4096
+#define BENCH_RADIX_ITERS	100
+#define BENCH_RADIX_MAX_SETS	64	// Max. #radix sets per FFT length
+
 extern int ROE_ITER;	// Iteration of any dangerously high ROE encountered during the current iteration interval.
 						// This must be > 0, but make signed to allow sign-flip encoding of retry-fail.
 extern double ROE_VAL;	// Value (must be in (0, 0.5)) of dangerously high ROE encountered during the current iteration interval
@@ -24,6 +24,9 @@
 *   COMPILING AND RUNNING THE PROGRAM: see https://www.mersenneforum.org/mayer/README.html *
 ******************************************************************************************/
 #include "Mlucas.h"
+#ifdef MULTITHREAD
+	#include "threadpool.h"
+#endif
 #ifndef imul_macro_h_included
 	#error imul_macro.h file not included in build!
 #endif
@@ -70,6 +73,11 @@ double*ADDR0 = 0x0;	// Allows for easy debug on address-read-or-write than setti
 uint32 N2,NRT,NRT_BITS,NRTM1;
 int PFETCH_BLOCK_IDX[MAX_RADIX];// Need this for prefetch-block-index arrays
 uint32 NRADICES, RADIX_VEC[10];	// NRADICES, RADIX_VEC[] store number & set of complex FFT radices used.
+uint32 FFT_CACHE_BLOCK = 0;	// #doubles per sub-block in cache-blocked pass ordering; 0 = breadth-first (default)
+// ROE-probe FFT-length selection outcome and statistics for the current run; see fft_length_roe_probe():
+uint32 FFT_PROBE_RESULT = FFT_PROBE_NONE, FFT_PROBE_KBLOCKS = 0, FFT_PROBE_NITER = 0;
+double FFT_PROBE_AME = 0.0, FFT_PROBE_MME = 0.0, FFT_PROBE_NERR = 0.0;
+uint32 BENCH_RADIX = FALSE;	// -bench-radix: ernstMain benchmarks the kernels of the current radix set instead of running a test
 #ifdef MULTITHREAD
 	uint64 CORE_SET[MAX_CORES>>6];	// Bitmap for user-controlled affinity setting, as specified via the -cpu flag
 #endif
@@ -140,7 +148,8 @@ const char *err_code[ERR_MAX] = {
 	"ERR_UNKNOWN_FATAL",
 	"ERR_SKIP_RADIX_SET",
 	"ERR_INTERRUPT",
-	"ERR_GERBICZ_CHECK"
+	"ERR_GERBICZ_CHECK",
+	"ERR_RESIDUE_REF"
 };
 
 // Shift count and auxiliary arrays used to support rotated-residue computations:
@@ -375,7 +384,7 @@ uint32	ernstMain
 	/* TODO: some of these need to become 64-bit: */
 	uint32 dum = 0,findex = 0,ierr = 0,ilo = 0,ihi = 0,iseed,isprime,kblocks = 0,maxiter = 0,n = 0,npad = 0;
 	uint64 itmp64,cy, s1 = 0ull,s2 = 0ull,s3 = 0ull;	// s1,2,3: Triply-redundant whole-array checksum on b,c-arrays used in the G-check
-	uint32 mode_flag = 0, first_sub, last_sub;
+	uint32 mode_flag = 0, first_sub = 0, last_sub = 0;
 	/* Exponent of number to be tested - note that for trial-factoring, we represent p
 	strictly in string[STR_MAX_LEN] form in this module, only converting it to numeric
 	form in the factoring module. For all other types of assignments uint64 should suffice: */
@@ -393,12 +402,12 @@ uint32	ernstMain
 /*...What a bunch of characters...	*/
 	char *cptr = 0x0, *endp, gcd_str[STR_MAX_LEN], aid[33] = "\0";	// 32-hexit Primenet assignment id needs 33rd char for \0
 /*...initialize logicals and factoring parameters...	*/
-	int restart = FALSE, use_lowmem = 0, check_interval = 0;
+	int restart = FALSE, use_lowmem = 0, check_interval = 0, ires_interval = 0, use_status_page = TRUE;
+	uint32 resref_fail_iter = 0;	// Iteration at which an interim residue last mismatched its reference-file value
+	char ires_test[16];
 
 #if INCLUDE_TF
-	uint32 bit_depth_todo = 0;
-	uint64 factor_k_start = 0;
-	uint32 factor_pass_start = 0, factor_pass_hi = 0;
+	uint32 bit_depth_todo = 0, tf_lo = 0, tf_hi = 0, tf_nfac = 0;
 	double log2_min_factor = 0, log2_max_factor = 0;
 #endif
 	double tests_saved = 0.0;	// v21: make this a dfloat to allow fractional-parts
@@ -409,6 +418,12 @@ uint32	ernstMain
 	static double *a_ptmp = 0x0, *a = 0x0, *b = 0x0, *c = 0x0, *d = 0x0, *e = 0x0;
 	// uint64 scratch array and 4 pointers used to store cast-to-(uint64*) version of above b,c,d,e-pointers
 	static uint64 *arrtmp = 0x0, *b_uint64_ptr = 0x0, *c_uint64_ptr = 0x0, *d_uint64_ptr = 0x0, *e_uint64_ptr = 0x0;
+	// Reduced-memory PRP: if gcheck_lowmem, the G-checkproduct and its copy are stored bytewise in e,d_uint64_ptr, which then
+	// point into the separate gres_ptmp block, and c,d,e[] are not allocated. gshift,dshift are the residue shifts applied
+	// to the respective bytewise data, which both represent the raw checkproduct times 2^-shift (mod 2^p-1):
+	static uint64 *gres_ptmp = 0x0, gres_alloc = 0;
+	static int gcheck_lowmem = FALSE;
+	uint64 gshift = 0ull, dshift = 0ull, glimbs = 0ull, *gc_ptr,*gd_ptr;
 	double final_res_offset;
 
 /*...time-related stuff. clock_t is typically an int (signed 32-bit)
@@ -431,7 +446,7 @@ uint32	ernstMain
 
 RANGE_BEG:
 
-	p = 0ull; ierr = 0;
+	p = 0ull; ierr = 0; resref_fail_iter = 0;
 	USE_SHORT_CY_CHAIN = 0;		// v19: Reset carry-chain length fiddler to default (faster/lower-accuracy) at start of each run:
 	ROE_ITER = 0; ROE_VAL = 0.0;
 	NERR_GCHECK = NERR_ROE = 0;	// v20: Add counters for Gerbicz-check errors and dangerously high ROEs encountered
@@ -439,7 +454,8 @@ RANGE_BEG:
 	// Clear out any FFT-radix or known-factor data that might remain from a just-completed run:
 	for(i = 0; i < 10; i++) { RADIX_VEC[i] = 0; }
 	nfac = 0; mi64_clear(KNOWN_FACTORS,40);
-	NRADICES = 0;
+	NRADICES = 0;	FFT_CACHE_BLOCK = 0;
+	FFT_PROBE_RESULT = FFT_PROBE_NONE;	FFT_PROBE_KBLOCKS = FFT_PROBE_NITER = 0;	FFT_PROBE_AME = FFT_PROBE_MME = FFT_PROBE_NERR = 0.0;
 	RESTARTFILE[0] = STATFILE[0] = '\0';
 	restart = FALSE;
 	B1 = 0; B2 = B2_start = 0ull; gcd_str[0] = '\0'; split_curr_assignment = s2_continuation = s2_partial = FALSE;
@@ -451,7 +467,7 @@ RANGE_BEG:
 		if(dtmp != dtmp) {	// isNaN is C99, want something that also works on pre-C99 platforms
 			sprintf(cbuf,"User did not set LowMem in %s ... allowing all test types.\n",MLUCAS_INI_FILE);
 		} else if(dtmp == 1) {
-			sprintf(cbuf,"User set LowMem = 1 in %s ... this allows PRP-testing but excludes p-1 stage 2.\n",MLUCAS_INI_FILE);	use_lowmem = 1;
+			sprintf(cbuf,"User set LowMem = 1 in %s ... this allows reduced-memory PRP-testing but excludes p-1 stage 2.\n",MLUCAS_INI_FILE);	use_lowmem = 1;
 		} else if(dtmp == 2) {
 			sprintf(cbuf,"User set LowMem = 2 in %s ... this excludes both PRP-testing and p-1 stage 2.\n",MLUCAS_INI_FILE);	use_lowmem = 2;
 		} else {
@@ -472,6 +488,30 @@ RANGE_BEG:
 		}
 		mlucas_fprint(cbuf,1);
 	}
+	dtmp = mlucas_getOptVal(MLUCAS_INI_FILE,"InterimResidues");
+	if(dtmp != 0) {
+		if(dtmp != dtmp) {
+			sprintf(cbuf,"User did not set InterimResidues in %s ... no interim-residue file will be written.\n",MLUCAS_INI_FILE);
+		} else if(dtmp < 1000 || dtmp > 1000000000) {
+			sprintf(cbuf,"User set InterimResidues = %f in %s ... values < 10^3 or > 10^9 are not supported, ignoring.\n",dtmp,MLUCAS_INI_FILE);
+		} else if(DNINT(dtmp) != dtmp) {
+			sprintf(cbuf,"User set non-whole-number InterimResidues = %f in %s ... ignoring.\n",dtmp,MLUCAS_INI_FILE);
+		} else {
+			sprintf(cbuf,"User set InterimResidues = %d in %s.\n",(int)dtmp,MLUCAS_INI_FILE);	ires_interval = (int)dtmp;
+		}
+		mlucas_fprint(cbuf,1);
+	}
+	// Live shared-memory status page is on by default; only an explicit StatusPage = 0 turns it off:
+	dtmp = mlucas_getOptVal(MLUCAS_INI_FILE,"StatusPage");
+	if(dtmp == 0) {
+		sprintf(cbuf,"User set StatusPage = 0 in %s ... no live status page will be published.\n",MLUCAS_INI_FILE);
+		mlucas_fprint(cbuf,1);	use_status_page = FALSE;
+	}
+	// Per-FFT-phase performance counters are off by default, since they cost a few syscalls per FFT pass:
+	dtmp = mlucas_getOptVal(MLUCAS_INI_FILE,"PerfCounters");
+	if(dtmp == 1) {
+		perf_init();
+	}
 
 /*  ...If multithreading enabled, set max. # of threads based on # of available (logical) processors,
 with the default #threads = 1 and affinity set to logical core 0, unless user overrides those via -nthread or -cpu:
@@ -529,6 +569,11 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 		ITERS_BETWEEN_CHECKPOINTS = check_interval;
 
 	fprintf(stderr,"Setting ITERS_BETWEEN_CHECKPOINTS = %u.\n",ITERS_BETWEEN_CHECKPOINTS);
+	// Interim residues are only available at checkpoints, so round any user-set interval up to a multiple of the checkpoint one:
+	if(ires_interval % ITERS_BETWEEN_CHECKPOINTS) {
+		ires_interval += ITERS_BETWEEN_CHECKPOINTS - (ires_interval % ITERS_BETWEEN_CHECKPOINTS);
+		fprintf(stderr,"INFO: InterimResidues must be a multiple of ITERS_BETWEEN_CHECKPOINTS ... rounding up to %d.\n",ires_interval);
+	}
 
 	i = ITERS_BETWEEN_GCHECKS;
 	j = ITERS_BETWEEN_GCHECK_UPDATES;
@@ -892,6 +937,7 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 			ASSERT(log2_max_factor <= MAX_FACT_BITS, "log2_max_factor > MAX_FACT_BITS!");
 
 			/* Field following the exponent is the already-factored-to depth: if none found, use defaults. */
+			TF_BITS = 0;
 			char_addr = strstr(char_addr, ",");
 			if(char_addr++) {
 				/* Convert the ensuing numeric digits to ulong: */
@@ -912,18 +958,17 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 			if(char_addr++) {
 				bit_depth_todo = strtoul(char_addr, &endp, 10);
 				if(bit_depth_todo > MAX_FACT_BITS) {
-					sprintf(cbuf, "ERROR: factor-to bit_depth of %u > max. allowed of %u. The ini file entry was %s\n",TF_BITS,MAX_FACT_BITS,in_line);
+					sprintf(cbuf, "ERROR: factor-to bit_depth of %u > max. allowed of %u. The ini file entry was %s\n",bit_depth_todo,MAX_FACT_BITS,in_line);
 					fprintf(stderr,"%s",cbuf);
 					goto GET_NEXT_ASSIGNMENT;
 				}
 				else if(bit_depth_todo <= TF_BITS) {
-					sprintf(cbuf, "ERROR: factor-to bit_depth of %u < already-done depth of %u. The ini file entry was %s\n",TF_BITS,TF_BITS,in_line);
+					sprintf(cbuf, "ERROR: factor-to bit_depth of %u <= already-done depth of %u. The ini file entry was %s\n",bit_depth_todo,TF_BITS,in_line);
 					fprintf(stderr,"%s",cbuf);
 					goto GET_NEXT_ASSIGNMENT;
 				}
 				else if(bit_depth_todo > log2_max_factor) {
-					sprintf(cbuf, "WARN: the specified factor-to depth of %u bits exceeds the default %10.4f bits - I hope you know what you're doing.\n",TF_BITS,log2_max_factor);
-					log2_max_factor = bit_depth_todo;
+					sprintf(cbuf, "WARN: the specified factor-to depth of %u bits exceeds the default %10.4f bits - I hope you know what you're doing.\n",bit_depth_todo,log2_max_factor);
 					fprintf(stderr,"%s",cbuf);
 				}
 				log2_max_factor = bit_depth_todo;
@@ -978,7 +1023,8 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 						sprintf(cbuf, "ERROR: the specified pm1_done field [%u] should be 0 or 1!\n",pm1_done);
 						ASSERT(0,cbuf);
 					}
-					if(!pm1_done) {	// pm1_done == TRUE is a no-op, translating to "proceed with primality test"
+					// Any TF still due gets done first; the p-1 split happens when the assignment is re-read after that:
+					if(!pm1_done && TEST_TYPE == TEST_TYPE_PRIMALITY) {	// pm1_done == TRUE is a no-op, translating to "proceed with primality test"
 						// Don't actually use this in pm1_set_bounds(), due to the rise of the single-shot PRP-with-proof paradigm, but for form's sake:
 						tests_saved = 1;
 						// Create p-1 assignment, then edit original assignment line appropriately
@@ -1113,7 +1159,7 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 	strcat(STATFILE, ".stat");
 	/*fprintf(stderr, "STATFILE = %s\n",STATFILE);	*/
 	ASSERT(TEST_TYPE,"TEST_TYPE not set!");
-	ASSERT(TEST_TYPE <= TEST_TYPE_MAX,"TEST_TYPE out of range!");
+	ASSERT(TEST_TYPE <= TEST_TYPE_MAX || (INCLUDE_TF && TEST_TYPE == TEST_TYPE_TF),"TEST_TYPE out of range!");
 
 	/* Fom this point onward the first character of restart filenames is context-dependent: */
 #if INCLUDE_TF
@@ -1127,7 +1173,26 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 			ASSERT(0, cbuf);
 		}
 
-		factor(ESTRING, log2_min_factor, log2_max_factor);
+		/* Factor one bit level at a time, using the same NTHREADS and core set as the FFT code. As each level completes
+		the TF_BITS field of the worktodo entry gets updated, so after an interrupt we lose at most the partial level,
+		which factor() itself resumes from its t-savefile. Levels below the smallest candidate q = 2p+1 are done in one go:
+		*/
+		tf_nfac = 0;
+		tf_lo = MAX(TF_BITS, (uint32)log2_min_factor);
+		while(tf_lo < log2_max_factor) {
+			tf_hi = MIN(MAX(tf_lo + 1, nbits_in_p + 1), (uint32)ceil(log2_max_factor));
+			snprintf(cbuf,STR_MAX_LEN*2,"INFO: Trial-factoring M(%s) from 2^%u to 2^%u.\n",ESTRING,tf_lo,tf_hi);
+			mlucas_fprint(cbuf,1);
+			tf_nfac = factor(ESTRING, (double)tf_lo, (double)tf_hi);
+			if(tf_nfac) {
+				snprintf(cbuf,STR_MAX_LEN*2,"Trial-factoring found a factor of M(%s) - see %s for details. Skipping any further work on this exponent.\n",ESTRING,OFILE);
+				mlucas_fprint(cbuf,1);
+				break;
+			}
+			TF_BITS = tf_lo = tf_hi;
+			if(!INTERACT)
+				ASSERT(update_tf_bits(ESTRING, TF_BITS), "Unable to update TF_BITS field of current assignment!");
+		}
 		goto GET_NEXT_ASSIGNMENT;
 	} else
 #endif
@@ -1294,6 +1359,8 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 			fprintf(stderr, " Specified radix set %u for self-test unavailable.\n", radix_set);
 			return ERR_RADIXSET_UNAVAILABLE;
 		}
+		// Radix-set indices past the end of the table for large FFT lengths select the cache-blocked pass ordering:
+		FFT_CACHE_BLOCK = fft_radix_set_is_blocked(kblocks, radix_set) ? FFT_CACHE_BLOCK_DEF : 0;
 
 		if(timing_test_iters > maxiter) {
 			fprintf(stderr, " This exceeds the primality-test limit; will perform %u iterations for timing test.\n",maxiter);
@@ -1324,7 +1391,7 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 			}
 			else	/* If length acceptable, extract the FFT-radix data encoded and populate the NRADICES and RADIX_VEC[] globals */
 			{
-				extractFFTradicesFrom32Bit(dum);
+				extractFFTradicesFrom32Bit(dum);	// Also sets FFT_CACHE_BLOCK from the encoded cache-blocking flag
 				kblocks = i;
 				/* Make sure the FFT length is supported: */
 				if(get_fft_radices(kblocks, 0, 0x0, 0x0, 0) != 0)
@@ -1387,10 +1454,12 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 
 	/*...Find padded array length...	*/
 	npad = n + ( (n >> DAT_BITS) << PAD_BITS );	/* length of padded data array.	*/
-	/* If the residue and other modulus-size-dependent data arrays too small for the new assignment, deallocate them: */
-	if(nalloc > 0 && npad > nalloc)
+	/* If the residue and other modulus-size-dependent data arrays too small for the new assignment, or the reduced-memory
+	PRP layout (LowMem = 1, Mersenne modulus) needs toggling, deallocate them: */
+	i = (use_lowmem == 1 && MODULUS_TYPE == MODULUS_TYPE_MERSENNE);
+	if(nalloc > 0 && (npad > nalloc || (use_lowmem < 2 && i != gcheck_lowmem)))
 	{
-		ASSERT(a_ptmp != 0x0 && a != 0x0 && b != 0x0 && c != 0x0 && d != 0x0,"Require (a_ptmp,a,b,c,d) != 0x0");
+		ASSERT(a_ptmp != 0x0 && a != 0x0,"Require (a_ptmp,a) != 0x0");
 		free((void *)a_ptmp); a_ptmp = a = b = c = d = e = 0x0; b_uint64_ptr = c_uint64_ptr = d_uint64_ptr = e_uint64_ptr = 0x0;
 		free((void *)arrtmp); arrtmp=0x0;
 		free((void *)BIGWORD_BITMAP);	BIGWORD_BITMAP = 0x0;
@@ -1409,10 +1478,16 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 		nalloc = npad + j;	ASSERT((nalloc & 7) == 0,"nalloc must be a multiple of 8!");	// This is so b,c,d enjoy same 64-byte alignment as a[]
 		nbytes = nalloc<<3;
 		ASSERT(a_ptmp == 0x0 && a == 0x0 && b == 0x0 && c == 0x0 && d == 0x0 && e == 0x0 && arrtmp == 0x0,"Require (a_ptmp,b,c,d,e,arrtmp) == 0x0");
+		gcheck_lowmem = FALSE;
 		if(use_lowmem == 2) {	// Handy for huge-FFT self-tests on low-mem systems
 			sprintf(cbuf,"WARN: Low-memory[%u] run mode disallows PRP-testing|Gerbicz-check and p-1 stage 2.\n",use_lowmem);
 			mlucas_fprint(cbuf,1);
 			j = 1;
+		} else if(use_lowmem == 1 && MODULUS_TYPE == MODULUS_TYPE_MERSENNE) {
+			// Reduced-memory PRP: b[] is the only other full-length array, used to hold the G-checkproduct in floating-point
+			// form just for the duration of each checkproduct update and G-check; it is stored bytewise the rest of the time:
+			gcheck_lowmem = TRUE;
+			j = 2;
 		} else {
 			j = 5;
 		}
@@ -1422,7 +1497,10 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 		if(((intptr_t)a & 127) != 0x0)
 			fprintf(stderr, "WARN: a[] = %#08" PRIXPTR " not aligned on 128-byte boundary!\n", (intptr_t)a);
 		// v19: Add three more full-residue arrays to support 2-input FFT-modmul needed for Gerbicz check (and later, p-1 support):
-		if(use_lowmem < 2) {
+		if(gcheck_lowmem) {
+			b = a + nalloc;
+			b_uint64_ptr = (uint64*)b;
+		} else if(use_lowmem < 2) {
 			b = a + nalloc;	c = b + nalloc;	d = c + nalloc, e = d + nalloc;
 			b_uint64_ptr = (uint64*)b; c_uint64_ptr = (uint64*)c; d_uint64_ptr = (uint64*)d; e_uint64_ptr = (uint64*)e;
 		}
@@ -1440,6 +1518,18 @@ with the default #threads = 1 and affinity set to logical core 0, unless user ov
 		BIGWORD_BITMAP =           ALLOC_UINT64(BIGWORD_BITMAP, nalloc>>6);	if(!BIGWORD_BITMAP){ sprintf(cbuf, "ERROR: unable to allocate array BIGWORD_BITMAP in main.\n"); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf); }
 		BIGWORD_NBITS  = (uint32 *)ALLOC_UINT64(BIGWORD_NBITS , nalloc>>7);	if(!BIGWORD_NBITS ){ sprintf(cbuf, "ERROR: unable to allocate array BIGWORD_NBITS in main.\n"); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf); }
 	}
+	/* Reduced-memory PRP: the G-checkproduct [e] and its redundant copy [d] - which at a G-check is the un-updated copy -
+	are each stored bytewise in (p+63)/64 limbs, plus 2 for the carryout of the final multiply-by-base and the extra bit of
+	the Fermat-mod case. c_uint64_ptr points to b[], for use as uint64 scratch at times b[] is not in use as a residue: */
+	if(gcheck_lowmem) {
+		glimbs = (p+63)>>6;
+		if(glimbs+2 > gres_alloc) {
+			gres_alloc = glimbs+2;
+			gres_ptmp = ALLOC_UINT64(gres_ptmp, 2*gres_alloc);	if(!gres_ptmp){ sprintf(cbuf, "ERROR: unable to allocate bytewise G-checkproduct arrays in main.\n"); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf); }
+		}
+		e_uint64_ptr = ALIGN_UINT64(gres_ptmp);	d_uint64_ptr = e_uint64_ptr + gres_alloc;
+		c_uint64_ptr = b_uint64_ptr;
+	}
 // Multithreaded-code debug: Set address to watch:
 #ifdef MULTITHREAD
 	ADDR0 = a;
@@ -1474,6 +1564,8 @@ READ_RESTART_FILE:
 	{	// 27 Nov 2021: If hit successive G-check errors, on try 2 cstr already has the .G extension, end up with doubled .G.G and
 		if(ierr == ERR_GERBICZ_CHECK) {	// "file not found" assertion-exit. So add a re-init of cstr == RESTARTFILE before strcat()
 			strcpy(cstr, RESTARTFILE); strcat(cstr, ".G");
+		} else if(ierr == ERR_RESIDUE_REF) {	// Last savefile whose residue matched the reference-file one:
+			strcpy(cstr, RESTARTFILE); strcat(cstr, ".R");
 		} else if(s2_continuation) {
 			strcpy(cstr, RESTARTFILE); strcat(cstr, ".s1");
 		}
@@ -1501,6 +1593,9 @@ READ_RESTART_FILE:
 				if(ierr == ERR_GERBICZ_CHECK) {
 					sprintf(cbuf,"Failed to correctly read last-good-Gerbicz-check data savefile!");
 					mlucas_fprint(cbuf,0); ASSERT(0,cbuf);
+				} else if(ierr == ERR_RESIDUE_REF) {
+					sprintf(cbuf,"Failed to correctly read last reference-matched data savefile!");
+					mlucas_fprint(cbuf,0); ASSERT(0,cbuf);
 				} else if(cstr[0] != 'q') {
 					cstr[0] = 'q';	goto READ_RESTART_FILE;
 				} else {
@@ -1532,6 +1627,16 @@ READ_RESTART_FILE:
 				NRADICES = 0;
 				goto SETUP_FFT;
 			}
+			// If the run was started at a smaller-than-default FFT length on the strength of a startup ROE probe (and has not
+			// since been switched to a larger one due to ROE), resume at that length:
+			if(FFT_PROBE_RESULT == FFT_PROBE_ACCEPT && j == FFT_PROBE_KBLOCKS && j < kblocks && !fft_length) {
+				snprintf(cbuf,STR_MAX_LEN*2, "INFO: Resuming at ROE-probe-selected FFT length %uK.\n",j);
+				mlucas_fprint(cbuf,1);
+				kblocks = j;
+				for(i = 0; i < NRADICES; i++) { RADIX_VEC[i] = 0; }
+				NRADICES = 0;
+				goto SETUP_FFT;
+			}
 			/* On gcheck-error restart, if p near max for the given FFT length, there is a small chance the GEC-failure was caused
 			by ROE aliasing, e.g. a floating-point convolution output X.4375 or Y.5625 which gets rounded to X or Y but where the
 			exact integer output is really X+1 or Y-1, respectively. In such an case, restart from the last GEC checkpoint data with
@@ -1544,9 +1649,9 @@ READ_RESTART_FILE:
 			deadly" aliased-ROE type are negligibly small. Even should such an improbability occur, if it does the program will once
 			more pseudorandomize the FFT inputs by again mod-doubling the shift count, i.e. we'll never get stuck:
 			*/
-			if(ierr == ERR_GERBICZ_CHECK) {
+			if(ierr == ERR_GERBICZ_CHECK || ierr == ERR_RESIDUE_REF) {
 				MOD_ADD64(RES_SHIFT,RES_SHIFT,p,RES_SHIFT);
-				snprintf(cbuf,STR_MAX_LEN*2, "Gerbicz-check-error restart: Mod-doubling residue shift to avoid repeating any possible fractional-error aliasing in retry, new shift = %" PRIu64 "\n",RES_SHIFT);
+				snprintf(cbuf,STR_MAX_LEN*2, "%s restart: Mod-doubling residue shift to avoid repeating any possible fractional-error aliasing in retry, new shift = %" PRIu64 "\n",(ierr == ERR_GERBICZ_CHECK ? "Gerbicz-check-error" : "Reference-residue-mismatch"),RES_SHIFT);
 				mlucas_fprint(cbuf,1);
 			}
 			/* Allocate floating-point residue array and convert savefile bytewise residue to floating-point form, after
@@ -1555,7 +1660,7 @@ READ_RESTART_FILE:
 			if(!convert_res_bytewise_FP((uint8*)arrtmp, a, n, p)) {
 				snprintf(cbuf,STR_MAX_LEN*2, "ERROR: convert_res_bytewise_FP Failed on primality-test residue read from savefile %s!\n",cstr);
 				mlucas_fprint(cbuf,0);
-				if(cstr[0] != 'q' && !(ierr == ERR_GERBICZ_CHECK)) {	// Secondary savefile only exists for regular checkpoint files
+				if(cstr[0] != 'q' && !(ierr == ERR_GERBICZ_CHECK || ierr == ERR_RESIDUE_REF)) {	// Secondary savefile only exists for regular checkpoint files
 					cstr[0] = 'q';
 					goto READ_RESTART_FILE;
 				} else {
@@ -1567,11 +1672,18 @@ READ_RESTART_FILE:
 			if(!convert_res_bytewise_FP((uint8*)e_uint64_ptr, b, n, p)) {
 				snprintf(cbuf,STR_MAX_LEN*2, "ERROR: convert_res_bytewise_FP Failed on Gerbicz-check residue read from savefile %s!\n",cstr);
 				mlucas_fprint(cbuf,0); ASSERT(0,cbuf);
+			} else if(gcheck_lowmem) {
+				ierr = 0;
+				// The above applied the shift to e[] in place, so convert back; bytewise copy [d] gets inited below:
+				e_uint64_ptr[glimbs-1] = 0ull;
+				convert_res_FP_bytewise(b, (uint8*)e_uint64_ptr, n, p, 0x0,0x0,0x0);	gshift = RES_SHIFT;
+				s1 = sum64(e_uint64_ptr, glimbs); s2 = s3 = s1;
 			} else {
 				ierr = 0;
 				s1 = sum64(b_uint64_ptr, n); s2 = s3 = s1;	// Init triply-redundant checksum of G-checkproduct
 			}
 		  }
+			if(ierr == ERR_RESIDUE_REF) ierr = 0;
 			ASSERT(ilo > 0,"Require ilo > 0!");
 			ihi = ilo+ITERS_BETWEEN_CHECKPOINTS;
 			/* If for some reason last checkpoint was at a non-multiple of ITERS_BETWEEN_CHECKPOINTS, round down: */
@@ -1582,8 +1694,16 @@ READ_RESTART_FILE:
 		}
 		else /* if(!fp) */
 		{
+			/* No reference-matched savefile yet means the mismatch was at the first reference iteration - retry
+			from scratch, mod-doubling the residue shift for the same reason as in the restart-from-savefile case: */
+			if(ierr == ERR_RESIDUE_REF) {
+				MOD_ADD64(RES_SHIFT,RES_SHIFT,p,RES_SHIFT);
+				snprintf(cbuf,STR_MAX_LEN*2, "INFO: No reference-matched restart file %s found...restarting run from scratch with shift = %" PRIu64 ".\n",cstr,RES_SHIFT);
+				mlucas_fprint(cbuf,1);
+				ierr = 0; restart = FALSE;
+			}
 			/* If we're on the primary restart file, set up for secondary: */
-			if(ierr == ERR_GERBICZ_CHECK || s2_continuation) {	// Secondary savefile only exists for regular checkpoint files
+			else if(ierr == ERR_GERBICZ_CHECK || s2_continuation) {	// Secondary savefile only exists for regular checkpoint files
 				snprintf(cbuf,STR_MAX_LEN*2, "INFO: Needed restart file %s not found...moving on to next assignment in %s.\n",cstr,WORKFILE);
 				mlucas_fprint(cbuf,1);
 				goto GET_NEXT_ASSIGNMENT;
@@ -1618,6 +1738,42 @@ READ_RESTART_FILE:
 	ASSERT(TEST_TYPE <= TEST_TYPE_MAX,"Given TEST_TYPE not supported!");
 	if(ilo == 0)
 	{
+		// -bench-radix: Time the kernels of the current radix set on a random residue in place of the usual timing test:
+		if(BENCH_RADIX)
+			return bench_radix_set(p, n, a, arrtmp, maxiter, scrnFlag);
+
+		/* Fresh start of a Mersenne LL|PRP test at the default FFT length: If p lies just above the maximum recommended exponent
+		for the next-smaller length and the .cfg file has that length as the faster one, switch to it and run an ROE probe there.
+		On return here with the probe pending, run it, and if the smaller length fails the probe, revert to the default one:
+		*/
+		if(!INTERACT && !fft_length && FFT_PROBE_RESULT == FFT_PROBE_NONE && MODULUS_TYPE == MODULUS_TYPE_MERSENNE
+		&& (TEST_TYPE == TEST_TYPE_PRIMALITY || TEST_TYPE == TEST_TYPE_PRP) && kblocks == get_default_fft_length(p)) {
+			i = get_nextsmaller_fft_length(n);
+			if(i && (double)p <= FFT_PROBE_MAX_RATIO*given_N_get_maxP(i)) {
+				// get_preferred_fft_radix() overwrites the radix-set globals, so save those and restore if we don't switch:
+				uint32 nrad_save = NRADICES, cblock_save = FFT_CACHE_BLOCK, rvec_save[10];
+				memcpy(rvec_save, RADIX_VEC, sizeof(rvec_save));
+				for(j = 0; j < NRADICES; j++) { RADIX_VEC[j] = 0; }
+				NRADICES = 0;
+				if(get_preferred_fft_radix(i >> 10) == (i >> 10)) {
+					FFT_PROBE_RESULT = FFT_PROBE_PENDING;	FFT_PROBE_KBLOCKS = kblocks = (i >> 10);
+					snprintf(cbuf,STR_MAX_LEN*2, "INFO: p = %" PRIu64 " is within %4.1f%% of the maximum recommended exponent for FFT length %uK; running a %u-iteration ROE probe at that length.\n",p,100*(FFT_PROBE_MAX_RATIO-1),kblocks,FFT_PROBE_ITERS);
+					mlucas_fprint(cbuf,1);
+					for(j = 0; j < NRADICES; j++) { RADIX_VEC[j] = 0; }
+					NRADICES = 0;	USE_SHORT_CY_CHAIN = 0;
+					goto SETUP_FFT;
+				}
+				memcpy(RADIX_VEC, rvec_save, sizeof(rvec_save));	NRADICES = nrad_save;	FFT_CACHE_BLOCK = cblock_save;
+			}
+		} else if(FFT_PROBE_RESULT == FFT_PROBE_PENDING) {
+			ASSERT(kblocks == FFT_PROBE_KBLOCKS, "FFT length changed while ROE probe pending!");
+			if(!fft_length_roe_probe(p, n, a, arrtmp, scrnFlag)) {
+				kblocks = get_default_fft_length(p);
+				for(j = 0; j < NRADICES; j++) { RADIX_VEC[j] = 0; }
+				NRADICES = 0;	USE_SHORT_CY_CHAIN = 0;
+				goto SETUP_FFT;
+			}
+		}
 		memset(a, 0, npad*sizeof(double));
 		if(b) memset(b, 0, npad*sizeof(double));
 		if(c) memset(c, 0, npad*sizeof(double));
@@ -1626,6 +1782,11 @@ READ_RESTART_FILE:
 		/* Always use 3 as the p-1 and Pepin-test seed, and 4 for the LL-test seed. For PRP-test, use seed set in worktodo assignment line: */
 		if(TEST_TYPE == TEST_TYPE_PM1) {
 			iseed = PRP_BASE;
+		} else if(TEST_TYPE == TEST_TYPE_PRP && gcheck_lowmem) {	// Bytewise checkproduct = PRP_BASE, with zero shift:
+			iseed = PRP_BASE;
+			mi64_clear(e_uint64_ptr, glimbs);	mi64_clear(d_uint64_ptr, glimbs);
+			e_uint64_ptr[0] = d_uint64_ptr[0] = PRP_BASE;	gshift = dshift = 0ull;
+			s1 = s2 = s3 = PRP_BASE;
 		} else if(TEST_TYPE == TEST_TYPE_PRP) {	// v21: Enable G-check also for Fermat Pepin test, but use separate clause below due to the PRP_BASE-used-for-something-else issue
 			iseed = b[0] = d[0] = PRP_BASE;	// Init the Gerbicz residue-product accumulator b[] and its redundant copy d[].
 											// On restart b[] inited via full-bytewise-array read from savefile.
@@ -1665,7 +1826,10 @@ READ_RESTART_FILE:
 		if(MODULUS_TYPE == MODULUS_TYPE_FERMAT && TEST_TYPE == TEST_TYPE_PRIMALITY && !INTERACT) {	// Allow shift in timing-test mode
 			ASSERT(RES_SHIFT == 0ull, "Shifted residues unsupported for Pépin test with Gerbicz check!\n");
 		}
-		memcpy(d, b, nbytes);	// If doing a PRP test, init redundant copy d[] Gerbicz residue-product accumulator b[].
+		if(gcheck_lowmem) {
+			memcpy(d_uint64_ptr, e_uint64_ptr, glimbs<<3);	dshift = gshift;
+		} else
+			memcpy(d, b, nbytes);	// If doing a PRP test, init redundant copy d[] Gerbicz residue-product accumulator b[].
 	}
 
 	if(restart) {
@@ -1683,6 +1847,10 @@ READ_RESTART_FILE:
 	// If self-test (INTERACT = True), echo only to stderr (uint32 flag > 1);
 	// otherwise echo only to logfile (flag = 0); use -INTERACT to set flag appropriately
 	mlucas_fprint(cbuf,-INTERACT);
+	// Live status page for production runs - created on first use, then updated from the [mers|fermat]_mod_square main loop:
+	// The status page holds the Fermat-number index, not p = 2^findex, for Fermat-mod runs:
+	if(!INTERACT && use_status_page && mstatus_open())
+		mstatus_set_run((MODULUS_TYPE == MODULUS_TYPE_FERMAT) ? (uint64)findex : p, MODULUS_TYPE, TEST_TYPE, n, NTHREADS, maxiter);
 
 /*...main loop...	*/
 /******************* AVX debug stuff: *******************/
@@ -1816,6 +1984,7 @@ READ_RESTART_FILE:
 		but keep restart files for current assignment around (can finish using hiacc code.)
 		*/
 		AME = MME = 0.0;	/* Init Avg. & Max. RO Error */
+		if(PERF_COUNTERS) perf_reset();
 		AME_ITER_START = 30;/* Start collecting AME after allowing residue to "fill up" in initial few tens of iters */
 	#ifdef USE_FGT61
 		ierr = func_mod_square  (a,c, (int*)arrtmp, n, ilo, ihi, 0ull, p, scrnFlag, &tdiff, update_shift);
@@ -1843,17 +2012,69 @@ READ_RESTART_FILE:
 			// First subinterval: [a] needs fwd-weighting and initial-fwd-FFT-pass done on entry, !undone on exit: mode_flag = 10_2
 			// Last  subinterval: [a] !need fwd-weighting and initial-fwd-FFT-pass done on entry but done on exit: mode_flag = 01_2
 			// Intermediate subs: [a] !need fwd-weighting and initial-fwd-FFT-pass done on entry, !undone on exit: mode_flag = 11_2
-				mode_flag = 3 - first_sub - (last_sub<<1);
+			// Reduced-memory PRP: [a] pure-integer on entry and exit of every subinterval: mode_flag = 00_2
+				mode_flag = (gcheck_lowmem ? 0 : 3 - first_sub - (last_sub<<1));
 				ierr = func_mod_square  (a, (int*)arrtmp, n, i,i+itodo, (uint64)mode_flag, p, scrnFlag, &tdif2, update_shift, 0x0);	tdiff += tdif2;
 				if(ierr) {
 					fprintf(stderr,"At iteration %d: mod_square returned with error code[%u] = %s\n",ROE_ITER,ierr,returnMlucasErrCode(ierr));
 					/* If interrupt *and* we're past the first subinterval, need to undo initial-fwd-FFT-pass and DWT-weighting on b[],
 					whose value will reflect the last multiple-of-ITERS_BETWEEN_GCHECK_UPDATES iteration - prior to writing it,
 					along with the current PRP residue, to savefile: */
-					if(ierr == ERR_INTERRUPT && !first_sub)
+					if(ierr == ERR_INTERRUPT && !first_sub && !gcheck_lowmem)
 						ierr = func_mod_square  (b, (int*)arrtmp, n, i,i+1, 8ull, p, scrnFlag, &tdif2, FALSE, 0x0);
 					break;
 				}
+				/* Reduced-memory PRP: Save a bytewise copy of a[] in arrtmp[] - which is only needed as mod_square scratch on table
+				init, already done by the above call - then fwd-FFT a[] in place, multiply it into the checkproduct, materialized in
+				b[] from its bytewise form for this, and restore a[]. The 4 residue conversions cost about as much as 1 iteration: */
+				if(gcheck_lowmem) {
+					i += itodo;
+					// Prior to each checkproduct update, check integrity of the bytewise data:
+					if(!mi64_cmp_eq(e_uint64_ptr,d_uint64_ptr,glimbs)) {
+						s1 = consensus_checksum(s1,s2,s3);
+						if(s1 == sum64(e_uint64_ptr, glimbs)) {	/* e-data good; no-op */
+						} else if(s1 == sum64(d_uint64_ptr, glimbs)) {	// d-data good, copy back into e
+							memcpy(e_uint64_ptr, d_uint64_ptr, glimbs<<3);	gshift = dshift;
+						} else	// Catastrophic data corruption
+							ASSERT(0, "Catastrophic data corruption detected in G-checkproduct integrity validation ... rolling back to last good G-check. ");
+					}
+					arrtmp[glimbs-1] = 0ull;
+					convert_res_FP_bytewise(a, (uint8*)arrtmp, n, p, 0x0,0x0,0x0);
+					ierr = func_mod_square  (a, 0x0, n, i,i+1, 4ull, p, scrnFlag, &tdif2, FALSE, 0x0);
+					// Note the bytes->FP conversion circular-shifts its input in place, so [e] is only valid again once the
+					// updated checkproduct is written back to it; [d] holds the un-updated copy until then:
+					if(!ierr) {
+						itmp64 = RES_SHIFT;	RES_SHIFT = gshift;
+						j = convert_res_bytewise_FP((uint8*)e_uint64_ptr, b, n, p);
+						RES_SHIFT = itmp64;
+						ASSERT(j, "convert_res_bytewise_FP failed on bytewise G-checkproduct!");
+						ierr = func_mod_square  (b, 0x0, n, i,i+1, (uint64)a, p, scrnFlag, &tdif2, FALSE, 0x0);
+					}
+					if(!ierr) {
+						e_uint64_ptr[glimbs-1] = 0ull;
+						convert_res_FP_bytewise(b, (uint8*)e_uint64_ptr, n, p, 0x0,0x0,0x0);	gshift = RES_SHIFT;
+						// If going to proceed to actual Gerbicz-check, leave [d] as the un-updated copy of the checkproduct:
+						if(i % ITERS_BETWEEN_GCHECKS != 0) {
+							memcpy(d_uint64_ptr, e_uint64_ptr, glimbs<<3);	dshift = gshift;
+							s1 = sum64(e_uint64_ptr, glimbs); s2 = s3 = s1;	// Init triply-redundant checksum of G-checkproduct
+						}
+					} else {
+						memcpy(e_uint64_ptr, d_uint64_ptr, glimbs<<3);	gshift = dshift;
+					}
+					if(!convert_res_bytewise_FP((uint8*)arrtmp, a, n, p)) {
+						ASSERT(0, "convert_res_bytewise_FP failed on restoring PRP residue from bytewise copy!");
+					}
+					if(ierr) {
+						if(ierr == ERR_INTERRUPT) {
+							fprintf(stderr,"Caught interrupt in G-checkproduct update step.\n");
+							break;
+						} else {
+							snprintf(cbuf,STR_MAX_LEN*2,"Unhandled Error of type[%u] = %s in G-checkproduct update step - please send e-mail to ewmayer@aol.com with copy of the p*.stat file attached. Proceeding to next assignment...\n",ierr,returnMlucasErrCode(ierr));
+							mlucas_fprint(cbuf,0); ASSERT(0,cbuf);
+						}
+					}
+					continue;
+				}
 				/* At end of each subinterval, do a single modmul of current residue a[] with Gerbicz-checkproduct to update the latter:
 				Make a copy of a[], e.g. c[] = a[], undo the fwd-FFT-radix pass via a call to radix*_dit_pass1(), then fwd-transform that, then
 				compute b *= c (mod n). But again wasteful, would rather just complete the fwd-FFT of c[] instead of undoing and then immediately
@@ -1996,6 +2217,8 @@ READ_RESTART_FILE:
 				sprintf(cbuf," Switching to next-larger available FFT length %uK and restarting from last checkpoint file.\n",kblocks);
 				mlucas_fprint(cbuf,1);
 				NERR_ROE++;
+				// A smaller-than-default length chosen by the startup ROE probe is not to be resumed at on ensuing restarts:
+				if(FFT_PROBE_RESULT == FFT_PROBE_ACCEPT) FFT_PROBE_RESULT = FFT_PROBE_REJECT;
 				USE_SHORT_CY_CHAIN = 0;
 				ROE_ITER = 0;
 				ierr = 0;	// v19: Need to explicitly clear ierr flag here, otherwise get oo retry loop in PRP-test mode
@@ -2021,7 +2244,25 @@ READ_RESTART_FILE:
 		j = (p+63+(MODULUS_TYPE == MODULUS_TYPE_FERMAT))>>6;	arrtmp[j-1] = 0ull;
 		convert_res_FP_bytewise(	a, (uint8*)      arrtmp, n, p, &Res64, &Res35m1, &Res36m1);	// LL/PRP-test/[p-1 stage 1] residue
 		// G-check residue...must not touch i1,i2,i3 again until ensuing write_ppm1_savefiles call!
-		if(DO_GCHECK) {
+		if(gcheck_lowmem) {
+			/* Reduced-memory PRP: checkproduct already bytewise, but the savefile-read assumes it is stored with the current
+			RES_SHIFT removed. That is the case unless the final partial-length interval skipped the G-check updates, in which
+			case re-express it via b[], along with the redundant copy if that is currently in sync with it: */
+			if(gshift != RES_SHIFT) {
+				i = mi64_cmp_eq(e_uint64_ptr,d_uint64_ptr,glimbs);
+				itmp64 = RES_SHIFT;	RES_SHIFT = gshift;
+				k = convert_res_bytewise_FP((uint8*)e_uint64_ptr, b, n, p);
+				RES_SHIFT = itmp64;
+				ASSERT(k, "convert_res_bytewise_FP failed on bytewise G-checkproduct!");
+				e_uint64_ptr[glimbs-1] = 0ull;
+				convert_res_FP_bytewise(b, (uint8*)e_uint64_ptr, n, p, 0x0,0x0,0x0);	gshift = RES_SHIFT;
+				if(i) {
+					memcpy(d_uint64_ptr, e_uint64_ptr, glimbs<<3);	dshift = gshift;
+					s1 = sum64(e_uint64_ptr, glimbs); s2 = s3 = s1;
+				}
+			}
+			res_SH(e_uint64_ptr,glimbs,&i1,&i2,&i3);
+		} else if(DO_GCHECK) {
 			e_uint64_ptr[j-1] = 0ull;
 			convert_res_FP_bytewise(b, (uint8*)e_uint64_ptr, n, p, &i1,&i2,&i3);
 		}
@@ -2053,6 +2294,7 @@ READ_RESTART_FILE:
 				, timebuffer, PSTRING, iter_or_stage[TEST_TYPE == TEST_TYPE_PM1], ihi, (float)ihi / (float)maxiter * 100,get_time_str(tdiff)
 				, 1000*get_time(tdiff)/(ihi - ilo), Res64, AME, MME, RES_SHIFT);
 			mlucas_fprint(cbuf,scrnFlag);
+			perf_report(ihi - ilo);
 		}
 
 		// Do not save a final residue unless p-1 (if not, still leave penultimate residue file intact).
@@ -2082,8 +2324,20 @@ READ_RESTART_FILE:
 			// If First subinterval also TRUE, [d] needs fwd-weighting and initial-fwd-FFT-pass done on entry: mode_flag = 00_2.
 			/* Note: Interrupt during this step should not be a problem, the handling code in func_mod_square will complete the FFT-mul
 			step and force the undo-initial-FFT-pass-and-DWT-weighting step, leaving a pure-int G-check residue ready for savefile-writing: */
-			mode_flag = 1 - first_sub;
-			ierr = func_mod_square  (d,0x0, n, ihi,ihi+ITERS_BETWEEN_GCHECK_UPDATES, (uint64)mode_flag, p, scrnFlag, &tdiff, FALSE, 0x0);
+			/* Reduced-memory PRP: materialize the bytewise copy of the checkproduct in pure-integer form in b[] and square that;
+			the squaring result then goes into the bytewise d-array, and b[] is used as uint64 scratch for the modulus: */
+			gc_ptr = c_uint64_ptr;	gd_ptr = d_uint64_ptr;
+			if(gcheck_lowmem) {
+				itmp64 = RES_SHIFT;	RES_SHIFT = dshift;
+				i = convert_res_bytewise_FP((uint8*)d_uint64_ptr, b, n, p);
+				RES_SHIFT = itmp64;
+				ASSERT(i, "convert_res_bytewise_FP failed on bytewise G-checkproduct copy!");
+				gc_ptr = d_uint64_ptr;	gd_ptr = c_uint64_ptr;
+				ierr = func_mod_square  (b,0x0, n, ihi,ihi+ITERS_BETWEEN_GCHECK_UPDATES, 0ull, p, scrnFlag, &tdiff, FALSE, 0x0);
+			} else {
+				mode_flag = 1 - first_sub;
+				ierr = func_mod_square  (d,0x0, n, ihi,ihi+ITERS_BETWEEN_GCHECK_UPDATES, (uint64)mode_flag, p, scrnFlag, &tdiff, FALSE, 0x0);
+			}
 			if(ierr) {
 				if(ierr == ERR_INTERRUPT) {
 					fprintf(stderr,"Caught interrupt in Gerbicz-checkproduct mod-squaring update ... skipping G-check and savefile-update and performing immediate-exit.\n");
@@ -2098,9 +2352,9 @@ READ_RESTART_FILE:
 			// First zero the high uint64s of the target array, since the double-to-int residue conversion is bytewise, i.e. may leave
 			// 1 or more MSBs in high word untouched:
 			j = (p+63)>>6;	/*** Jun 2021: cf. convert_res_FP_bytewise() for why we don't include the extra Fermat-modulus bit here ***/
-			c_uint64_ptr[j-1] = 0ull;
+			gc_ptr[j-1] = 0ull;
 			// [1] Convert b[],d[] to bytewise form, former assumed already in e[] doubles-array, latter into currently-unused c[] doubles-array:
-			convert_res_FP_bytewise(d, (uint8*)c_uint64_ptr, n, p, 0x0,0x0,0x0);
+			convert_res_FP_bytewise((gcheck_lowmem ? b : d), (uint8*)gc_ptr, n, p, 0x0,0x0,0x0);
 			// Only need to compute this for initial interval - after that the needed adjustment-shift remains constant
 			if(ihi == ITERS_BETWEEN_GCHECKS && RES_SHIFT) {
 				if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE) {
@@ -2149,43 +2403,53 @@ READ_RESTART_FILE:
 				ASSERT((itmp64>>32) == 0ull,"Shift must be < 2^32!");
 				GCHECK_SHIFT = itmp64;
 			}
-			mi64_shlc(c_uint64_ptr, c_uint64_ptr, (uint32)p, (uint32)GCHECK_SHIFT, j, (MODULUS_TYPE == MODULUS_TYPE_FERMAT));
+			mi64_shlc(gc_ptr, gc_ptr, (uint32)p, (uint32)GCHECK_SHIFT, j, (MODULUS_TYPE == MODULUS_TYPE_FERMAT));
 			/*** Now that have undone shift, include extra modulus bit for Fermat-mod case ***/
-			if(MODULUS_TYPE == MODULUS_TYPE_FERMAT) { c_uint64_ptr[j++] = 0ull; }
+			if(MODULUS_TYPE == MODULUS_TYPE_FERMAT) { gc_ptr[j++] = 0ull; }
 			// Use mi64 routines to compute d[]*PRP_BASE and do ensuing equality check:
 			itmp64 = ((MODULUS_TYPE == MODULUS_TYPE_FERMAT) ? 3ull : (uint64)PRP_BASE);	// Fermat-mod uses PRP_BASE to store 2 for random-shift-offset scheme
-			c_uint64_ptr[j] = mi64_mul_scalar(c_uint64_ptr, itmp64, c_uint64_ptr, j);
-			ASSERT(c_uint64_ptr[j] == 0ull, "d[]*PRP_BASE result has unexpected carryout!");
+			gc_ptr[j] = mi64_mul_scalar(gc_ptr, itmp64, gc_ptr, j);
+			ASSERT(gc_ptr[j] == 0ull, "d[]*PRP_BASE result has unexpected carryout!");
 			// Need to (mod N) ... store modulus N in d[] doubles-array, which is freed up by above convert_res_FP_bytewise(d,...) call:
 			if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE) {
 				// Loop rather than call to mi64_set_eq_scalar here, since need to set all elts = -1:
-				for(i = 0; i < j; i++) { d_uint64_ptr[i] = -1ull; }
-				d_uint64_ptr[j-1] >>= 64-(p&63);	// Leading word needs >> to leave just low p%64 bits set
+				for(i = 0; i < j; i++) { gd_ptr[i] = -1ull; }
+				gd_ptr[j-1] >>= 64-(p&63);	// Leading word needs >> to leave just low p%64 bits set
 			} else {
 				// j = uint64 vector length; init sans the leading '1' word, then increment prior to mi64_div
-				mi64_clear(d_uint64_ptr,j);
-				d_uint64_ptr[j-1] = d_uint64_ptr[0] = 1ull;
+				mi64_clear(gd_ptr,j);
+				gd_ptr[j-1] = gd_ptr[0] = 1ull;
 			}
 			for(i = 1; i < itmp64; i++) {
-				if(!c_uint64_ptr[j] && mi64_cmpult(c_uint64_ptr,d_uint64_ptr,j)) break;
-				cy = mi64_sub(c_uint64_ptr,d_uint64_ptr,c_uint64_ptr,j);	// c -= d, with d = 2^p-1
-				c_uint64_ptr[j] -= cy;	//ASSERT(cy == 0ull, "mi64_sub result has unexpected borrow!");
+				if(!gc_ptr[j] && mi64_cmpult(gc_ptr,gd_ptr,j)) break;
+				cy = mi64_sub(gc_ptr,gd_ptr,gc_ptr,j);	// c -= d, with d = 2^p-1
+				gc_ptr[j] -= cy;	//ASSERT(cy == 0ull, "mi64_sub result has unexpected borrow!");
 			}
-			ASSERT(mi64_cmpult(c_uint64_ptr,d_uint64_ptr,j), "Gerbicz checkproduct reduction (mod 2^p-1) failed!");
-			if(mi64_cmp_eq(e_uint64_ptr,c_uint64_ptr,j)) {
+			ASSERT(mi64_cmpult(gc_ptr,gd_ptr,j), "Gerbicz checkproduct reduction (mod 2^p-1) failed!");
+			if(mi64_cmp_eq(e_uint64_ptr,gc_ptr,j)) {
 				sprintf(cbuf,"At iteration %u, shift = %" PRIu64 ": Gerbicz check passed.\n",ihi,RES_SHIFT);
 				mlucas_fprint(cbuf,0);
 				// In G-check case we need b[] for that, thus skipped the d = b redundancy-copy ... do that now:
-				memcpy(d, b, nbytes);
-				s1 = sum64(b_uint64_ptr, n); s2 = s3 = s1;	// Init triply-redundant checksum of G-checkproduct
+				if(gcheck_lowmem) {
+					memcpy(d_uint64_ptr, e_uint64_ptr, glimbs<<3);	dshift = gshift;
+					s1 = sum64(e_uint64_ptr, glimbs); s2 = s3 = s1;
+				} else {
+					memcpy(d, b, nbytes);
+					s1 = sum64(b_uint64_ptr, n); s2 = s3 = s1;	// Init triply-redundant checksum of G-checkproduct
+				}
 			} else {
-				i = mi64_shlc_bits_align(e_uint64_ptr,c_uint64_ptr,p);
+				i = mi64_shlc_bits_align(e_uint64_ptr,gc_ptr,p);
 				if(i != -1) {
 					sprintf(cbuf,"Gerbicz check passes if D *= 2^%u (mod 2^p-1)\n",i);
 					mlucas_fprint(cbuf,0);
 					// In G-check case we need b[] for that, thus skipped the d = b redundancy-copy ... do that now:
-					memcpy(d, b, nbytes);
-					s1 = sum64(b_uint64_ptr, n); s2 = s3 = s1;	// Init triply-redundant checksum of G-checkproduct
+					if(gcheck_lowmem) {
+						memcpy(d_uint64_ptr, e_uint64_ptr, glimbs<<3);	dshift = gshift;
+						s1 = sum64(e_uint64_ptr, glimbs); s2 = s3 = s1;
+					} else {
+						memcpy(d, b, nbytes);
+						s1 = sum64(b_uint64_ptr, n); s2 = s3 = s1;	// Init triply-redundant checksum of G-checkproduct
+					}
 				} else {
 					if(ihi == ITERS_BETWEEN_GCHECKS)
 						sprintf(cbuf,"Gerbicz check iteration %u failed! Restarting from scratch.\n",ihi);
@@ -2202,6 +2466,49 @@ READ_RESTART_FILE:
 		/* Make sure we start with primary restart file: */
 		RESTARTFILE[0] = ((MODULUS_TYPE == MODULUS_TYPE_MERSENNE) ? 'p' : 'f');
 
+		/* Interim residues: If a reference file [RESTARTFILE].ref - typically a copy of the .ires file written by the first-time
+		test of the same exponent - is present, compare the shift-removed Res64 against any reference value for the current
+		iteration. On a match, save a copy of the checkpoint data to [RESTARTFILE].R; on a mismatch, restart from that (or from
+		scratch if there is none yet), and if the retry again mismatches at the same iteration, abort the run - one of the two
+		runs is bad, and there is no point in running a double-check which is already known to disagree to completion.
+		If user set InterimResidues in mlucas.ini, also append the Res64 to [RESTARTFILE].ires every that-many iterations:
+		*/
+		if(TEST_TYPE == TEST_TYPE_PRIMALITY || TEST_TYPE == TEST_TYPE_PRP) {
+			if(TEST_TYPE == TEST_TYPE_PRP)
+				sprintf(ires_test,"PRP-%u",PRP_BASE);
+			else
+				strcpy(ires_test,(MODULUS_TYPE == MODULUS_TYPE_MERSENNE) ? "LL" : "Pepin");
+			strcpy(cstr, RESTARTFILE); strcat(cstr, ".ref");
+			if(interim_res64_lookup(cstr, ires_test, ihi, &itmp64)) {
+				if(itmp64 == Res64) {
+					snprintf(cbuf,STR_MAX_LEN*2, "At iteration %u, Res64 = %016" PRIX64 " matches reference file %s.\n",ihi,Res64,cstr);
+					mlucas_fprint(cbuf,0);
+					strcpy(cstr, RESTARTFILE); strcat(cstr, ".R");
+					if(!write_ppm1_savefiles(cstr,p,n, (uint64)ihi, (uint8*)arrtmp,Res64,Res35m1,Res36m1, (uint8*)e_uint64_ptr,i1,i2,i3)) {
+						snprintf(cbuf,STR_MAX_LEN*2, "ERROR: unable to write reference-matched savefile %s with checkpoint data.\n",cstr);
+						mlucas_fprint(cbuf,1);
+					}
+				} else if(ihi == resref_fail_iter) {
+					snprintf(cbuf,STR_MAX_LEN*2, "ERROR: At iteration %u, Res64 = %016" PRIX64 " again differs from reference value %016" PRIX64 " in %s on retry ... aborting run.\n",ihi,Res64,itmp64,cstr);
+					mlucas_fprint(cbuf,1);
+					return(ERR_RESIDUE_REF);
+				} else {
+					snprintf(cbuf,STR_MAX_LEN*2, "At iteration %u, Res64 = %016" PRIX64 " differs from reference value %016" PRIX64 " in %s! Restarting from last reference-matched data.\n",ihi,Res64,itmp64,cstr);
+					mlucas_fprint(cbuf,1);
+					resref_fail_iter = ihi;
+					ierr = ERR_RESIDUE_REF;
+					goto READ_RESTART_FILE;
+				}
+			}
+			if(ires_interval && (ihi % ires_interval) == 0) {
+				strcpy(cstr, RESTARTFILE); strcat(cstr, ".ires");
+				if(!interim_res64_write(cstr, ires_test, ihi, Res64)) {
+					snprintf(cbuf,STR_MAX_LEN*2, "ERROR: unable to append interim residue to %s.\n",cstr);
+					mlucas_fprint(cbuf,1);
+				}
+			}
+		}
+
 		/* Oct 2014: Add every-10-million-iter file-checkpointing: deposit a unique-named restart file
 		             p[exponent].xM every 10 million iterations, on top of the usual checkpointing.
 		To avoid having to write an extra copy of the p-savefile, wait for the *next* checkpoint -
@@ -2224,10 +2531,8 @@ READ_RESTART_FILE:
 		itmp64 = ihi;
 		// If Pepin test is at final iteration, change PRP base to 3 for final write to file (cf. earlier assignment at line 1214). More info: https://github.com/primesearch/Mlucas/pull/11
 		if (ihi == maxiter && TEST_TYPE == TEST_TYPE_PRIMALITY && MODULUS_TYPE == MODULUS_TYPE_FERMAT) PRP_BASE = 3;
-		fp = mlucas_fopen(RESTARTFILE, "wb");
-		if(fp) {		// In the non-PRP-test case, write_ppm1_savefiles() treats the latter 4 args as null:
-			write_ppm1_savefiles(RESTARTFILE,p,n,fp, itmp64, (uint8*)arrtmp,Res64,Res35m1,Res36m1, (uint8*)e_uint64_ptr,i1,i2,i3);
-			fclose(fp); fp = 0x0;
+		// In the non-PRP-test case, write_ppm1_savefiles() treats the latter 4 args as null:
+		if(write_ppm1_savefiles(RESTARTFILE,p,n, itmp64, (uint8*)arrtmp,Res64,Res35m1,Res36m1, (uint8*)e_uint64_ptr,i1,i2,i3)) {
 			/* If we're on the primary restart file, set up for secondary: */
 			if(RESTARTFILE[0] != 'q') {
 				RESTARTFILE[0] = 'q';	goto WRITE_RESTART_FILE;
@@ -2235,7 +2540,7 @@ READ_RESTART_FILE:
 				RESTARTFILE[0] = ((MODULUS_TYPE == MODULUS_TYPE_MERSENNE) ? 'p' : 'f');
 			}
 		} else {
-			snprintf(cbuf,STR_MAX_LEN*2, "ERROR: unable to open restart file %s for write of checkpoint data.\n",RESTARTFILE);
+			snprintf(cbuf,STR_MAX_LEN*2, "ERROR: unable to write restart file %s with checkpoint data.\n",RESTARTFILE);
 			mlucas_fprint(cbuf,1);
 			/*
 			Don't want to assert here - asllow processing to continue, in case this is a transient failure-to-open.
@@ -2250,12 +2555,8 @@ READ_RESTART_FILE:
 			if(ihi%ITERS_BETWEEN_GCHECKS == 0) {
 				strcpy(cstr, RESTARTFILE);
 				strcat(cstr, ".G");
-				fp = mlucas_fopen(cstr, "wb");
-				if(fp) {
-					write_ppm1_savefiles(cstr,p,n,fp, itmp64, (uint8*)arrtmp,Res64,Res35m1,Res36m1, (uint8*)e_uint64_ptr,i1,i2,i3);
-					fclose(fp); fp = 0x0;
-				} else {
-					snprintf(cbuf,STR_MAX_LEN*2, "ERROR: unable to open Gerbicz-check savefile %s for write of checkpoint data.\n",cstr);
+				if(!write_ppm1_savefiles(cstr,p,n, itmp64, (uint8*)arrtmp,Res64,Res35m1,Res36m1, (uint8*)e_uint64_ptr,i1,i2,i3)) {
+					snprintf(cbuf,STR_MAX_LEN*2, "ERROR: unable to write Gerbicz-check savefile %s with checkpoint data.\n",cstr);
 					mlucas_fprint(cbuf,1);
 				}
 			}	// ihi a multiple of ITERS_BETWEEN_GCHECKS?
@@ -2605,18 +2906,11 @@ PM1_STAGE2:	// Stage 2 invocation is several hundred lines below, but this needs
 				if(!s2_continuation) {
 					fp = mlucas_fopen(cstr,"rb");
 					if(fp) {
-						// This snip reads the relocation-prime from the high byte of the nsquares field, byte 10 of the S2 savefile:
-						i = fgetc(fp);
-						if(!test_types_compatible(i, TEST_TYPE)) {
-							snprintf(cbuf,STR_MAX_LEN*2, "%s: TEST_TYPE != fgetc(fp)\n",cstr); ASSERT(0,cbuf);
-						}
-						if((i = fgetc(fp)) != MODULUS_TYPE) {
-							snprintf(cbuf,STR_MAX_LEN*2, "ERROR: %s: MODULUS_TYPE != fgetc(fp)\n",cstr); ASSERT(0,cbuf);
-						}
-						itmp64 = 0ull; 	for(j = 0; j < 8; j++) { i = fgetc(fp);	itmp64 += (uint64)i << (8*j); }
+						// This snip reads the relocation-prime from the high byte of the nsquares field of the S2 savefile:
+						i = read_ppm1_nsquares(cstr, fp, &itmp64);
 						fclose(fp); fp = 0x0;
-						if(i != EOF)	// Needed to handle case where .s2 file was touched but ended up empty or < 10 bytes long
-							psmall = i;
+						if(i)	// Needed to handle case where .s2 file was touched but ended up empty or too short
+							psmall = itmp64 >> 56;
 						itmp64 &= 0x00FFFFFFFFFFFFFFull;	// Mask off psmall to get stage 2 q of checkpoint data
 						fprintf(stderr,"Read iter = %" PRIu64 " and relocation-prime psmall = %u from savefile %s.\n",itmp64,psmall,cstr);
 						// Now parse logfile to get proper B2 and validate corresponding B2_start vs B2/[psmall from .s2 file].
@@ -2735,6 +3029,8 @@ PM1_STAGE2:	// Stage 2 invocation is several hundred lines below, but this needs
 			strcpy(cstr, RESTARTFILE); strcat(cstr, ".s1");	// cstr = [p|f][expo].s1
 		}
 	} else if(TEST_TYPE == TEST_TYPE_PRIMALITY || TEST_TYPE == TEST_TYPE_PRP) {
+		strcpy(cstr, RESTARTFILE); strcat(cstr, ".R");	// Any reference-matched savefile is no longer needed
+		remove(cstr);
 		strcpy(cstr, RESTARTFILE); cstr[0] = 'q';		// cstr = q[expo]
 	}
 	for(ierr = 0; ; RESTARTFILE[0] = 'q') {	// Start with the p-savefile, inrement to q-savefile on looping
@@ -2825,12 +3121,10 @@ GET_NEXT_ASSIGNMENT:
 			update the current-assignment line to reflect that and write it out: */
 			if(strstr(in_line, "PRP") || strstr(in_line, "Test") || strstr(in_line, "DoubleCheck")) {
 			#if INCLUDE_TF
-				if(TEST_TYPE == TEST_TYPE_TF) {
-					/* Factor depth assumed to follow the first comma in in_line: */
-					char_addr = strstr(char_addr, ",");
-					ASSERT(char_addr != 0x0,"Null char_addr");
-					sprintf(++char_addr, "%u", TF_BITS);
-					fputs(in_line, fq);
+				// TF_BITS field was updated as each bit level completed. Keep the assignment for the primality test,
+				// unless TF found a factor, in which case lose it (by way of no-op):
+				if(TEST_TYPE == TEST_TYPE_TF && !tf_nfac) {
+					fputs(in_line, fq);	i = 1;
 				}
 			#endif
 				// This imples TEST_TYPE == TEST_TYPE_PM1; note that this flag gets cleared on cycling back to RANGE_BEG:
@@ -3914,7 +4208,7 @@ int 	main(int argc, char *argv[])
 	int		nthread = 0, cpu = 0, core = 0;
 #endif
 	char *cptr = 0x0;
-	int		quick_self_test = 0, fftlen = 0, radset = -1;
+	int		quick_self_test = 0, fftlen = 0, radset = -1, bench_radix_flag = FALSE;
 	uint32 numrad = 0, rad_prod = 0, rvec[10], rvec2[10];	/* Temporary storage for FFT radices */
 	double	runtime,wruntime, runtime_best,wruntime_best, tdiff;	// v20: w-prefixed are weighted by associated ROEs
 	double	roerr_avg = 0, roerr_max = 0;
@@ -4074,6 +4368,13 @@ just below the upper limit for each FFT lengh in some subrange of the self-tests
 			iters = (uint32)i64arg;
 		}
 
+		// Time and check the FFT-radix kernels of every radix set at a cache-resident and a DRAM-resident FFT length - or
+		// just at the one given via -fft - using any -iters and threading settings, then exit; cf. bench_radix():
+		else if(STREQ(stFlag, "-bench-radix"))
+		{
+			bench_radix_flag = TRUE;
+		}
+
 		else if(STREQ(stFlag, "-fft") || STREQ(stFlag, "-fftlen"))
 		{
 			strncpy(stFlag, argv[nargs++], STR_MAX_LEN-1);
@@ -4118,8 +4419,8 @@ just below the upper limit for each FFT lengh in some subrange of the self-tests
 			cptr = strchr(char_addr,',');
 			if(!cptr) {	// It's a radix-set index
 				i64arg = atol(stFlag);
-				// Must be < 2^32:
-				ASSERT(i64arg < 20, "radset-index argument must be < 2^32 ... halting.");
+				// Allow up to 2x the largest table size, since cache-blocked twins double the index range for N >= 32M:
+				ASSERT(i64arg < 40, "radset-index argument must be < 40 ... halting.");
 				radset = (uint32)i64arg;
 			} else {	// It's a set of complex-FFT radices
 				numrad = 0;
@@ -4326,6 +4627,11 @@ just below the upper limit for each FFT lengh in some subrange of the self-tests
 		}
 	}	/* end of command-line-argument processing while() loop */
 
+	if(bench_radix_flag) {
+		ASSERT(modType != MODULUS_TYPE_FERMAT && testType != TEST_TYPE_PM1, "-bench-radix only supports the Mersenne-mod FFT!");
+		exit(bench_radix(fftlen, iters) ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+
 	// Nov 2020: Sanity-check any p-1 bounds:
 	if(testType == TEST_TYPE_PM1) {
 		ASSERT((modType == MODULUS_TYPE_MERSENNE || modType == MODULUS_TYPE_FERMAT) && userSetExponent, "P-1 in command-line mode requires a Mersenne or Fermat-number modulus to be specified via '-m [int]' or '-f [int]'.");
@@ -4805,6 +5111,9 @@ TIMING_TEST_LOOP:
 			so each line has same length (needed to allow update mode):
 			*/
 			for(i = 0; i < 10; i++){ fprintf(fp,"%3u",RADIX_VEC[i]); };
+			// For lengths which support it, record whether the best radix set uses cache-blocked pass ordering:
+			if(iarg >= FFT_CACHE_BLOCK_MIN_KBLOCKS)
+				fprintf(fp, "  blocked = %u", fft_radix_set_is_blocked(iarg, radix_best));
 
 			/* If it's a new self-test residue being computed, add the SH residues to the .cfg file line */
 			if(new_data)
@@ -4899,7 +5208,7 @@ int	cfgNeedsUpdating(char*in_line)
 
 const char*returnMlucasErrCode(uint32 ierr)
 {
-	ASSERT(ierr < ERR_MAX, "Error code out of range!");
+	ASSERT(ierr <= ERR_MAX, "Error code out of range!");
 	return err_code[ierr-1];
 }
 
@@ -4910,7 +5219,7 @@ void	printMlucasErrCode(uint32 ierr)
 
 	if(i == 0)
 		fprintf(stderr, "\n Return with error code 0 - no errors.\n");
-	else if(i < ERR_MAX)
+	else if(i <= ERR_MAX)
 		fprintf(stderr, "\n Return with code %s\n", err_code[i-1]);
 	else
 		fprintf(stderr, "\n Return with unknown error error code %u - suggest running under a debugger.\n\n",(uint32)ierr);
@@ -5020,6 +5329,54 @@ EWM - added in v20:
 	roundoff errors (ROE) >= 0.4375 (>= for LL, > for PRP)for the test in question.
 
 	{e2} A 4-byte field storing the number of occurrences of Gerbicz-check errors for the test in question.
+
+Added in v21:
+	ROE-probe FFT-length selection record, 28 bytes; see fft_length_roe_probe(). Absent in older savefiles:
+	{r}  1 byte: FFT_PROBE_[NONE|ACCEPT|REJECT] = [0|2|3] = [no probe run | smaller length used | default length used];
+	{k}  3 bytes: the probed FFT length in Kdoubles;
+	{n}  4 bytes: #iterations run by the probe;
+	{a}  4 bytes: average per-iteration max ROE during the probe, as a 0.32 fixed-point fraction;
+	{x}  4 bytes: maximum ROE during the probe, ditto;
+	{f}  8 bytes: IEEE64 bit pattern of the predicted #fatal ROEs (>= 0.4375) over the full test at the probed length.
+
+Checksummed-block format, SAVEFILE_VERSION = 1:
+	Savefiles are now written in a checksummed-block format, with all multibyte fields little-endian:
+
+	Offset	Bytes	Field
+	------	-----	-----------------------------------------------------------------------------
+	  0		  8		SAVEFILE_MAGIC; a legacy savefile instead starts with the TEST_TYPE and MODULUS_TYPE bytes
+	  8		  4		SAVEFILE_VERSION
+	 12		  4		Header length, currently SAVEFILE_HDR_LEN
+	 16		  1		TEST_TYPE
+	 17		  1		MODULUS_TYPE
+	 18		  1		Number of residues in the file: 2 if the G-check residue is included, else 1
+	 19		  1		ROE-probe FFT-length selection result; a probe still pending at write time is recorded as not-run
+	 20		  4		FFT length in K
+	 24		  8		nsquares (for p-1 stage 2, the high byte holds the relocation-prime psmall)
+	 32		  8		Exponent p
+	 40		  8		Bytes per residue, nbytes
+	 48		  8		RES_SHIFT
+	 56		  8		GCHECK_SHIFT
+	 64		  4		PRP_BASE
+	 68		  4		NERR_ROE
+	 72		  4		NERR_GCHECK
+	 76		  4		Residue bytes covered by each CRC, blksize
+	 80		  4		FFT_PROBE_KBLOCKS
+	 84		  4		FFT_PROBE_NITER
+	 88		  4		FFT_PROBE_AME*2^32
+	 92		  4		FFT_PROBE_MME*2^32
+	 96		  8		FFT_PROBE_NERR, as the bit pattern of the double
+	104		 24		Res64,Res35m1,Res36m1 of the primality-test residue, 8 bytes each
+	128		 24		Res64,Res35m1,Res36m1 of the G-check residue, if any
+	152		 36		Reserved, zero
+	188		  4		CRC32C of header bytes 0-187
+
+	This is followed, for each residue, by a table of the CRC32Cs of its successive blksize-byte blocks (4 bytes each) and
+	then the nbytes-long bytewise residue, each zero-padded to a multiple of 64 bytes. Since the header length is also a
+	multiple of 64, the residue data are aligned on 64-byte file offsets and can be moved in large blocks straight into
+	the 64-bit limb arrays used for the FFT conversion, and any corruption is caught by the CRC checks before that
+	conversion is done. Savefiles are written to [fname].tmp, synced to disk and renamed to [fname], so an interrupted write
+	leaves the previous savefile intact. Older savefiles, in the format described above, remain readable.
 */
 
 /* Dec 2017: For Fermat case the Pepin primality test is indistinguishable from an Euler-PRP test and
@@ -5034,48 +5391,21 @@ int test_types_compatible(uint32 t1, uint32 t2)
 		return t1 == t2;
 }
 
-/*** READ: Assumes a valid file pointer has been gotten via a call of the form
-fp = mlucas_fopen(RESTARTFILE,"rb");
-***/
-// Reads an [nbytes]-long LL|Pepin|PRP|p-1 residue and validates the associated mod(2^64,2^35-1,2^36-1) checksums:
-int read_ppm1_residue(const uint32 nbytes, FILE*fp, uint8 arr_tmp[], uint64*Res64, uint64*Res35m1, uint64*Res36m1)
+// Checks the Res64,Res35m1,Res36m1 checksums read from a savefile vs the ones computed from the residue byte-array read from it:
+static int check_ppm1_residue(const uint32 nbytes, uint8 arr_tmp[], const uint64 Res64, const uint64 Res35m1, const uint64 Res36m1)
 {
-	const char func[] = "read_ppm1_residue";
+	const char func[] = "check_ppm1_residue";
 	uint32 i,j;
 	uint64 itmp64;
 	const uint64 two35m1 = (uint64)0x7FFFFFFFFull, two36m1 = (uint64)0xFFFFFFFFFull;	/* 2^35,36-1 */
-
-	*Res64 = *Res35m1 = *Res36m1 = 0ull;	// 0 value on return indicates failure of some kind
-
-	i = fread(arr_tmp, sizeof(char), nbytes, fp);		/* Read bytewise residue...	*/
-	if(i != nbytes)	{ sprintf(cbuf, "%s: Error reading bytewise residue array.\n",func)										; return 0; }
-	if(ferror(fp))	{ sprintf(cbuf, "%s: Unknown Error reading bytewise residue array.\n",func)								; return 0; }
-	if(feof(fp))	{ sprintf(cbuf, "%s: End-of-file encountered while attempting to read bytewise residue array.\n",func)	; return 0; }
-
-	/* 8 bytes for Res64: */
-	for(j = 0; j < 8; j++) {
-		i = fgetc(fp);	*Res64 += (uint64)i << (8*j);
-	}
-	/* 5 bytes for Res35m1: */
-	for(j = 0; j < 5; j++) {
-		i = fgetc(fp);	*Res35m1 += (uint64)i << (8*j);
-	}
-	if(*Res35m1 > two35m1) { sprintf(cbuf, "%s: *Res35m1 should be <= 2^35",func); return 0; }
-	/* 5 bytes for Res36m1: */
-	for(j = 0; j < 5; j++) {
-		i = fgetc(fp);	*Res36m1 += (uint64)i << (8*j);
-	}
-	if(*Res36m1 > two36m1) { sprintf(cbuf, "%s: *Res36m1 should be <= 2^36",func); return 0; }
-
-	// Checksums: Check Res64,Res35m1,Res36m1 checksum vs the ones extracted from the residue byte-array read from the file:
 	/* Since arr_tmp may hold previous-exponent data in its high bits (if previous p > current one), need to zero
 	those out before calling any mi64 functions which treat arr_tmp as a 64-bit-limb array rather than a byte-array:
 	*/
 	j = 8 - (nbytes&7);	// nbytes%8 = #significant bytes in high limb; j = #bytes needing zeroing at the high end of the limb
 	for(i = nbytes; i < nbytes+j; i++) arr_tmp[i] = 0;
 	itmp64 = ((uint64*)arr_tmp)[0];
-	if(*Res64 != itmp64) {
-		sprintf(cbuf, "%s: On restart: Res64 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n"  ,func,itmp64,*Res64); return 0;
+	if(Res64 != itmp64) {
+		sprintf(cbuf, "%s: On restart: Res64 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n"  ,func,itmp64,Res64); return 0;
 	}
 	// For big-endian CPUs, casting byte-array to uint64* gives byte-reversed limbs, so use a direct bitwise mod:
   #ifdef USE_BIG_ENDIAN
@@ -5115,22 +5445,109 @@ int read_ppm1_residue(const uint32 nbytes, FILE*fp, uint8 arr_tmp[], uint64*Res6
 		MOD_ADD64(bmod35,29,35,bmod35); MOD_ADD64(bmod36,28,36,bmod36);	// bmod35|36 += 29|28 (mod 35|36)
 	}
 	rmod35 = (rmod35 & two35m1) + (rmod35 >> 35); rmod36 = (rmod36 & two36m1) + (rmod36 >> 36);	// And do a final pair of folds to get mods
-	if(*Res35m1 != rmod35)	{ sprintf(cbuf, "%s: On restart: Res35m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,rmod35,*Res35m1); return 0; }
-	if(*Res36m1 != rmod36)	{ sprintf(cbuf, "%s: On restart: Res36m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,rmod36,*Res36m1); return 0; }
+	if(Res35m1 != rmod35)	{ sprintf(cbuf, "%s: On restart: Res35m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,rmod35,Res35m1); return 0; }
+	if(Res36m1 != rmod36)	{ sprintf(cbuf, "%s: On restart: Res36m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,rmod36,Res36m1); return 0; }
   #else
 	i = (nbytes+7)>>3;	// # of 64-bit limbs
 	itmp64 = mi64_div_by_scalar64((uint64*)arr_tmp,two35m1,i,0x0);
-	if(*Res35m1 != itmp64) {
-		sprintf(cbuf, "%s: On restart: Res35m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,itmp64,*Res35m1); return 0;
+	if(Res35m1 != itmp64) {
+		sprintf(cbuf, "%s: On restart: Res35m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,itmp64,Res35m1); return 0;
 	}
 	itmp64 = mi64_div_by_scalar64((uint64*)arr_tmp,two36m1,i,0x0);
-	if(*Res36m1 != itmp64) {
-		sprintf(cbuf, "%s: On restart: Res36m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,itmp64,*Res36m1); return 0;
+	if(Res36m1 != itmp64) {
+		sprintf(cbuf, "%s: On restart: Res36m1 checksum error! Got %" PRIX64 ", expected %" PRIX64 "\n",func,itmp64,Res36m1); return 0;
 	}
   #endif
 	return 1;
 }
 
+/*** READ: Assumes a valid file pointer has been gotten via a call of the form
+fp = mlucas_fopen(RESTARTFILE,"rb");
+***/
+// Reads an [nbytes]-long LL|Pepin|PRP|p-1 residue and validates the associated mod(2^64,2^35-1,2^36-1) checksums:
+int read_ppm1_residue(const uint32 nbytes, FILE*fp, uint8 arr_tmp[], uint64*Res64, uint64*Res35m1, uint64*Res36m1)
+{
+	const char func[] = "read_ppm1_residue";
+	uint32 i,j;
+	const uint64 two35m1 = (uint64)0x7FFFFFFFFull, two36m1 = (uint64)0xFFFFFFFFFull;	/* 2^35,36-1 */
+
+	*Res64 = *Res35m1 = *Res36m1 = 0ull;	// 0 value on return indicates failure of some kind
+
+	i = fread(arr_tmp, sizeof(char), nbytes, fp);		/* Read bytewise residue...	*/
+	if(i != nbytes)	{ sprintf(cbuf, "%s: Error reading bytewise residue array.\n",func)										; return 0; }
+	if(ferror(fp))	{ sprintf(cbuf, "%s: Unknown Error reading bytewise residue array.\n",func)								; return 0; }
+	if(feof(fp))	{ sprintf(cbuf, "%s: End-of-file encountered while attempting to read bytewise residue array.\n",func)	; return 0; }
+
+	/* 8 bytes for Res64: */
+	for(j = 0; j < 8; j++) {
+		i = fgetc(fp);	*Res64 += (uint64)i << (8*j);
+	}
+	/* 5 bytes for Res35m1: */
+	for(j = 0; j < 5; j++) {
+		i = fgetc(fp);	*Res35m1 += (uint64)i << (8*j);
+	}
+	if(*Res35m1 > two35m1) { sprintf(cbuf, "%s: *Res35m1 should be <= 2^35",func); return 0; }
+	/* 5 bytes for Res36m1: */
+	for(j = 0; j < 5; j++) {
+		i = fgetc(fp);	*Res36m1 += (uint64)i << (8*j);
+	}
+	if(*Res36m1 > two36m1) { sprintf(cbuf, "%s: *Res36m1 should be <= 2^36",func); return 0; }
+	return check_ppm1_residue(nbytes, arr_tmp, *Res64,*Res35m1,*Res36m1);
+}
+
+// Checksummed-block savefile format; see the format notes preceding test_types_compatible():
+#define SAVEFILE_MAGIC		"MlucasSv"
+#define SAVEFILE_VERSION	1
+#define SAVEFILE_HDR_LEN	192
+#ifndef SAVEFILE_BLOCK
+	#define SAVEFILE_BLOCK	(1u << 20)
+#endif
+#ifndef OS_TYPE_WINDOWS
+	#include <unistd.h>	// fsync()
+#else
+	#define fsync(_fd)	0	// fflush() has to do
+#endif
+
+// Store|load the low [nbytes] bytes of a savefile-header field in little-endian order:
+static void savefile_put(uint8*buf, uint64 x, uint32 nbytes)
+{
+	uint32 i;
+	for(i = 0; i < nbytes; i++) { buf[i] = (uint8)(x >> (8*i)); }
+}
+
+static uint64 savefile_get(const uint8*buf, uint32 nbytes)
+{
+	uint32 i;
+	uint64 x = 0ull;
+	for(i = 0; i < nbytes; i++) { x += (uint64)buf[i] << (8*i); }
+	return x;
+}
+
+// Reads the per-block CRC table and the [nbytes]-long residue which follows it in a checksummed-block savefile and checks the CRCs.
+// The Res64,Res35m1,Res36m1 checksums are stored in the file header, and are left to the caller to check:
+static int read_ppm1_residue_blocks(const char*func, const uint32 nbytes, const uint32 blksize, FILE*fp, uint8 arr_tmp[])
+{
+	uint32 i, nblk, len;
+	uint8 *crc;
+	if(!blksize) {
+		sprintf(cbuf, "%s: Illegal CRC block size 0.\n",func); return 0;
+	}
+	nblk = (nbytes + blksize - 1)/blksize;	len = (4*nblk + 63) & ~63;
+	crc = (uint8 *)malloc(len);	ASSERT(crc != 0x0, "FATAL: unable to allocate savefile CRC table.");
+	if(fread(crc, 1, len, fp) != len || fread(arr_tmp, 1, nbytes, fp) != nbytes || fseek(fp, (-nbytes) & 63, SEEK_CUR)) {
+		sprintf(cbuf, "%s: Savefile truncated in residue data.\n",func);
+		free((void *)crc); return 0;
+	}
+	for(i = 0; i < nblk; i++) {
+		if(savefile_get(crc + 4*i, 4) != crc32c(0, arr_tmp + (size_t)i*blksize, MIN(blksize, nbytes - i*blksize))) {
+			sprintf(cbuf, "%s: CRC32C mismatch in residue block %u of %u ... savefile is corrupt.\n",func,i,nblk);
+			free((void *)crc); return 0;
+		}
+	}
+	free((void *)crc);
+	return 1;
+}
+
 // Returns 1 on successful read, 0 otherwise:
 // v19: For PRP-tests, also write a second Gerbicz-check residue array [arr2] and associated S-H checksum triplet [i1,i2,i3]
 // v20: Distributed deep p-1 S2 may use B2 >= 2^32, so make ilo a uint64-ptr; add filename arg since S2 appends '.s2' to RESTARTFILE:
@@ -5139,8 +5556,9 @@ int read_ppm1_savefiles(const char*fname, uint64 p, uint32*kblocks, FILE*fp, uin
 	uint8 arr2[], uint64*i1   , uint64*i2     , uint64*i3     )
 {
 	const char func[] = "read_ppm1_savefiles";
-	uint32 i,j,k,len,nbytes = 0,nerr;
-	uint64 itmp64, nsquares = 0ull, *avec = (uint64*)arr1, *bvec = (uint64*)arr2, exp[4],pow[4],rem[4];
+	uint32 i,j,k,len,nbytes = 0,nerr, version, blksize = 0;
+	uint64 itmp64, nsquares = 0ull, *avec = (uint64*)arr1, exp[4],pow[4],rem[4];
+	uint8 hdr[SAVEFILE_HDR_LEN];
 	uint128 ui128,vi128; uint192 ui192,vi192; uint256 ui256,vi256;	// Fixed-length 2/3/4-word ints for stashing results of multiword modexp.
 	*Res64 = 0ull;	// 0 value on return indicates failure of some kind
 	mi64_clear(pow,4); mi64_clear(rem,4);
@@ -5149,23 +5567,41 @@ int read_ppm1_savefiles(const char*fname, uint64 p, uint32*kblocks, FILE*fp, uin
 		sprintf(cbuf, "%s: File pointer invalid for read!\n",func);	ASSERT(0, cbuf);
 	}
 	fprintf(stderr, " INFO: restart file %s found...reading...\n",fname);
+	// Checksummed-block savefiles are told apart from legacy ones by the leading magic string; see above for the format.
+	// The header is CRC-checked before any of its fields are used:
+	if(fread(hdr, 1, 8, fp) == 8 && !memcmp(hdr, SAVEFILE_MAGIC, 8)) {
+		if(fread(hdr+8, 1, SAVEFILE_HDR_LEN-8, fp) != SAVEFILE_HDR_LEN-8) {
+			sprintf(cbuf, "%s: Savefile truncated in header.\n",func); return 0;
+		}
+		if(savefile_get(hdr+SAVEFILE_HDR_LEN-4, 4) != crc32c(0, hdr, SAVEFILE_HDR_LEN-4)) {
+			sprintf(cbuf, "%s: CRC32C mismatch in header ... savefile is corrupt.\n",func); return 0;
+		}
+		version = savefile_get(hdr+8, 4);
+		if(version > SAVEFILE_VERSION || savefile_get(hdr+12, 4) != SAVEFILE_HDR_LEN) {
+			sprintf(cbuf, "%s: Savefile format version %u not supported by this build, which supports versions <= %u.\n",func,version,SAVEFILE_VERSION); return 0;
+		}
+		i = hdr[16]; k = hdr[17];
+		nsquares = savefile_get(hdr+24, 8);
+	} else {
+		version = 0;	rewind(fp);
+		i = fgetc(fp); k = fgetc(fp);
+		for(j = 0; j < 8; j++) {
+			len = fgetc(fp);	nsquares += (uint64)len << (8*j);
+		}
+	}
 	/* t: */
-	i = fgetc(fp);
 	if(!test_types_compatible(i, TEST_TYPE)) {
 		sprintf(cbuf, "%s: TEST_TYPE != fgetc(fp)\n",func);
 		return 0;
 	}
 	/* m: */
-	if((i = fgetc(fp)) != MODULUS_TYPE) {
+	if(k != MODULUS_TYPE) {
 		// For some reason, this fubared in my rerun-final-F25-iterations-from-33.55m (fgetc = 176, MODULUS_TYPE = 3)
 		// but residue OK, so emit error msg but allow execution past it:
 		sprintf(cbuf, "ERROR: %s: MODULUS_TYPE != fgetc(fp)\n",func);
 		return 0;
 	}
 	/* s: */
- 	for(j = 0; j < 8; j++) {
-		i = fgetc(fp);	nsquares += (uint64)i << (8*j);
-	}
 	// v20: E.g. distributed deep p-1 S2 may use B2 >= 2^32: Only allow nsquares >= 2^32 if it's an S2 restart:
 	if(TEST_TYPE == TEST_TYPE_PM1) {
 		if(strstr(fname, ".s2")) {
@@ -5200,7 +5636,16 @@ int read_ppm1_savefiles(const char*fname, uint64 p, uint32*kblocks, FILE*fp, uin
 		TRANSFORM_TYPE = RIGHT_ANGLE;
 	}
 
-	i = read_ppm1_residue(nbytes, fp, arr1, Res64,Res35m1,Res36m1);
+	if(version) {
+		if(savefile_get(hdr+32, 8) != p || savefile_get(hdr+40, 8) != nbytes) {
+			sprintf(cbuf, "%s: Savefile is for exponent %" PRIu64 ", expected %" PRIu64 ".\n",func,savefile_get(hdr+32, 8),p); return 0;
+		}
+		blksize = savefile_get(hdr+76, 4);
+		*Res64 = savefile_get(hdr+104, 8); *Res35m1 = savefile_get(hdr+112, 8); *Res36m1 = savefile_get(hdr+120, 8);
+		i = read_ppm1_residue_blocks(func, nbytes, blksize, fp, arr1) && check_ppm1_residue(nbytes, arr1, *Res64,*Res35m1,*Res36m1);
+		if(!i) *Res64 = 0ull;
+	} else
+		i = read_ppm1_residue(nbytes, fp, arr1, Res64,Res35m1,Res36m1);
 	if(!i) return 0;
 
 	/* For PRP-tests of N with known-factors (e.g. prelude to a cofactor-PRP postprocessing step),
@@ -5290,7 +5735,39 @@ Thus if we use a negative-power algo, to recover 2^p (mod q = 2^k.qodd):
 3. Then 2^k.r' = 2^p (mod q = 2^k.qodd). */
 #endif
 
-	// FFT length in K (3 bytes) - first added this in v18:
+	if(version) {
+		*kblocks = savefile_get(hdr+20, 4);
+		RES_SHIFT = savefile_get(hdr+48, 8);
+		if(DO_GCHECK) {
+			ASSERT(arr2 != 0x0, "Null arr2 pointer!");
+			if(hdr[18] < 2) {
+				sprintf(cbuf, "%s: Savefile lacks the Gerbicz-check residue.\n",func); return 0;
+			}
+			PRP_BASE = savefile_get(hdr+64, 4);
+			*i1 = savefile_get(hdr+128, 8); *i2 = savefile_get(hdr+136, 8); *i3 = savefile_get(hdr+144, 8);
+			if(!read_ppm1_residue_blocks(func, nbytes, blksize, fp, arr2) || !check_ppm1_residue(nbytes, arr2, *i1,*i2,*i3)) return 0;
+			GCHECK_SHIFT = savefile_get(hdr+56, 8);
+		}
+		NERR_ROE = MAX(savefile_get(hdr+68, 4),NERR_ROE);
+		NERR_GCHECK = MAX(savefile_get(hdr+72, 4),NERR_GCHECK);
+		k = hdr[19];
+		if(k > FFT_PROBE_REJECT || k == FFT_PROBE_PENDING) {
+			sprintf(cbuf, "%s: Malformed ROE-probe record ... ignoring.\n",func);
+			fprintf(stderr,"%s", cbuf);
+			FFT_PROBE_RESULT = FFT_PROBE_NONE;
+			return 1;
+		}
+		FFT_PROBE_KBLOCKS = savefile_get(hdr+80, 4);
+		FFT_PROBE_NITER = savefile_get(hdr+84, 4);
+		FFT_PROBE_AME = (double)savefile_get(hdr+88, 4)/TWO32FLOAT;
+		FFT_PROBE_MME = (double)savefile_get(hdr+92, 4)/TWO32FLOAT;
+		itmp64 = savefile_get(hdr+96, 8);	memcpy(&FFT_PROBE_NERR, &itmp64, sizeof(double));
+		if(!(FFT_PROBE_RESULT == FFT_PROBE_REJECT && k == FFT_PROBE_ACCEPT))
+			FFT_PROBE_RESULT = k;
+		return 1;
+	}
+
+	// Legacy savefile: FFT length in K (3 bytes) - first added this in v18:
 	i = *kblocks = 0;
 	for(j = 0; j < 3 && i != EOF; j++) {
 		i = fgetc(fp);	*kblocks += (uint64)i << (8*j);
@@ -5350,57 +5827,102 @@ Thus if we use a negative-power algo, to recover 2^p (mod q = 2^k.qodd):
 		i = fgetc(fp);	nerr += i << (8*j);
 	}
 	NERR_GCHECK = MAX(nerr,NERR_GCHECK);
+	// v21: ROE-probe FFT-length selection record - absent in older savefiles, in which case leave the main()-init values:
+	k = fgetc(fp);
+	if(k == EOF) return 1;
+	FFT_PROBE_KBLOCKS = FFT_PROBE_NITER = 0;
+	for(j = 0; j < 3; j++) {
+		i = fgetc(fp);	FFT_PROBE_KBLOCKS += i << (8*j);
+	}
+	for(j = 0; j < 4; j++) {
+		i = fgetc(fp);	FFT_PROBE_NITER += i << (8*j);
+	}
+	itmp64 = 0ull;
+	for(j = 0; j < 4; j++) {
+		i = fgetc(fp);	itmp64 += (uint64)i << (8*j);
+	}
+	FFT_PROBE_AME = (double)itmp64/TWO32FLOAT;
+	itmp64 = 0ull;
+	for(j = 0; j < 4; j++) {
+		i = fgetc(fp);	itmp64 += (uint64)i << (8*j);
+	}
+	FFT_PROBE_MME = (double)itmp64/TWO32FLOAT;
+	itmp64 = 0ull;
+	for(j = 0; j < 8; j++) {
+		i = fgetc(fp);	itmp64 += (uint64)i << (8*j);
+	}
+	if(i == EOF || k > FFT_PROBE_REJECT || k == FFT_PROBE_PENDING) {
+		sprintf(cbuf, "%s: Malformed ROE-probe record ... ignoring.\n",func);
+		fprintf(stderr,"%s", cbuf);
+		FFT_PROBE_RESULT = FFT_PROBE_NONE;
+		return 1;
+	}
+	memcpy(&FFT_PROBE_NERR, &itmp64, sizeof(double));
+	// If restart-from-savefile as result of an ROE-triggered switch away from the probe-selected length, preserve that:
+	if(!(FFT_PROBE_RESULT == FFT_PROBE_REJECT && k == FFT_PROBE_ACCEPT))
+		FFT_PROBE_RESULT = k;
 	/* Don't deallocate arr1 here, since we'll need it later for savefile writes. */
 	return 1;
 }
 
-/* WRITE: Assumes the following:
-[1] a valid file pointer has been gotten via a call of the form fp = mlucas_fopen(RESTARTFILE,"wb");
-[2] any circular shift stored in the global RES_SHIFT has been removed in the preceding call to convert_res_FP_bytewise.
-v19: For PRP-tests, also write a second Gerbicz-check residue array [arr2] and associated S-H checksum triplet [i1,i2,i3]
+// Reads just the nsquares field of a savefile of either format, after checking the test and modulus types preceding
+// it, e.g. to get the p-1 stage 2 relocation-prime stored in its high byte. Returns 0 if the file is too short:
+int read_ppm1_nsquares(const char*fname, FILE*fp, uint64*nsquares)
+{
+	uint8 hdr[32];
+	uint32 i = fread(hdr, 1, 32, fp), j = 0;
+	*nsquares = 0ull;
+	if(i >= 8 && !memcmp(hdr, SAVEFILE_MAGIC, 8)) {
+		if(i < 32) return 0;
+		j = 16;
+	}
+	if(i < j+10) return 0;
+	if(!test_types_compatible(hdr[j], TEST_TYPE)) {
+		snprintf(cbuf,STR_MAX_LEN*2, "%s: TEST_TYPE != fgetc(fp)\n",fname); ASSERT(0,cbuf);
+	}
+	if(hdr[j+1] != MODULUS_TYPE) {
+		snprintf(cbuf,STR_MAX_LEN*2, "ERROR: %s: MODULUS_TYPE != fgetc(fp)\n",fname); ASSERT(0,cbuf);
+	}
+	*nsquares = savefile_get(hdr + (j ? 24 : 2), 8);
+	return 1;
+}
+
+/* WRITE: Assumes any circular shift stored in the global RES_SHIFT has been removed in the preceding call to convert_res_FP_bytewise.
+Writes an [nbytes]-long residue in the checksummed-block savefile format described above test_types_compatible(): The
+table of per-block CRC32Cs followed by the residue bytes, each zero-padded to a multiple of 64 bytes. The Res64,Res35m1,
+Res36m1 checksums go into the file header. Returns 1 on success, 0 on any write error:
 */
-void write_ppm1_residue(const uint32 nbytes, FILE*fp, const uint8 arr_tmp[], const uint64 Res64, const uint64 Res35m1, const uint64 Res36m1)
+int write_ppm1_residue(const uint32 nbytes, const uint32 blksize, FILE*fp, const uint8 arr_tmp[])
 {
-	const char func[] = "write_ppm1_residue";
-	uint32 i;
-	/* Write bytewise residue r... */
-	i = fwrite(arr_tmp, sizeof(char), nbytes, fp);
-	if(i != nbytes) {
-		fclose(fp); fp = 0x0;
-		snprintf(cbuf,STR_MAX_LEN*2,"%s: Error writing residue to restart file.\n",func);
-		mlucas_fprint(cbuf,0);	ASSERT(0,cbuf);
-	}
-	/* ...and checksums:	*/
-	/* Res64: */
-	for(i = 0; i < 64; i+=8)
-		fputc((int)(Res64 >> i) & 0xff, fp);
-	/* Res35m1: */
-	for(i = 0; i < 40; i+=8)
-		fputc((int)(Res35m1 >> i) & 0xff, fp);
-	/* Res36m1: */
-	for(i = 0; i < 40; i+=8)
-		fputc((int)(Res36m1 >> i) & 0xff, fp);
+	static const uint8 zeros[64] = {0};
+	uint32 i, nblk = (nbytes + blksize - 1)/blksize, len = 4*nblk, retval;
+	uint8 *crc = (uint8 *)malloc(len);	ASSERT(crc != 0x0, "FATAL: unable to allocate savefile CRC table.");
+	for(i = 0; i < nblk; i++) {
+		savefile_put(crc + 4*i, crc32c(0, arr_tmp + (size_t)i*blksize, MIN(blksize, nbytes - i*blksize)), 4);
+	}
+	retval = (fwrite(crc    , 1, len   , fp) == len    && fwrite(zeros, 1, (-len   ) & 63, fp) == ((-len   ) & 63)
+		   && fwrite(arr_tmp, 1, nbytes, fp) == nbytes && fwrite(zeros, 1, (-nbytes) & 63, fp) == ((-nbytes) & 63));
+	free((void *)crc);
+	return retval;
 }
 
-// v20: E.g. distributed deep p-1 S2 may use B2 >= 2^32, so make ihi a uint64; add filename arg since S2 appends '.s2' to RESTARTFILE:
-void write_ppm1_savefiles(const char*fname, uint64 p, int n, FILE*fp, uint64 ihi,
+// v20: E.g. distributed deep p-1 S2 may use B2 >= 2^32, so make ihi a uint64; add filename arg since S2 appends '.s2' to RESTARTFILE.
+// v19: For PRP-tests, also write a second Gerbicz-check residue array [arr2] and associated S-H checksum triplet [i1,i2,i3].
+// Writes checksummed-block format to [fname].tmp, then sync and rename to [fname]. Returns 1 on success, 0 otherwise:
+int write_ppm1_savefiles(const char*fname, uint64 p, int n, uint64 ihi,
 	uint8 arr1[], uint64 Res64, uint64 Res35m1, uint64 Res36m1,
 	uint8 arr2[], uint64 i1   , uint64 i2     , uint64 i3     )
 {
-	uint32 i,kblocks,nbytes = 0;
-	ASSERT(file_valid(fp),"write_ppm1_savefiles: File pointer invalid for write!");
+	const char func[] = "write_ppm1_savefiles";
+	char tmpname[STR_MAX_LEN+5], path[2*STR_MAX_LEN+1], tmppath[2*STR_MAX_LEN+5];
+	uint8 hdr[SAVEFILE_HDR_LEN];
+	uint32 kblocks,nbytes = 0, nres = 1 + (DO_GCHECK != 0), ierr;
+	uint64 itmp64;
+	FILE*fp;
 	// Make sure n is a proper (unpadded) FFT-length, i.e. is a multiple of 1K:
 	kblocks = (n >> 10);
 	ASSERT(n == (kblocks << 10),"Not a proper unpadded FFT length");
-
-	/* See the function read_ppm1_savefiles() for the file format here: */
-	/* t: */
-	fputc(TEST_TYPE, fp);
-	/* m: */
-	fputc(MODULUS_TYPE, fp);
-	/* s: */
-	for(i = 0; i < 64; i+=8)
-		fputc((ihi >> i) & 0xff, fp);
+	ASSERT(nres == 1 || arr2 != 0x0, "Null arr2 pointer!");
 
 	/* Set the expected number of residue bytes, depending on the modulus: */
 	if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE) {
@@ -5412,259 +5934,713 @@ void write_ppm1_savefiles(const char*fname, uint64 p, int n, FILE*fp, uint64 ihi
 		TRANSFORM_TYPE = RIGHT_ANGLE;
 	}
 
-	write_ppm1_residue(nbytes, fp, arr1, Res64,Res35m1,Res36m1);
-
-	// v18: FFT length in K (3 bytes):
-	for(i = 0; i < 24; i+=8)
-		fputc((kblocks >> i) & 0xff, fp);
-	// v18: circular-shift to apply to the (unshifted) residue read from the file (8 bytes):
-	for(i = 0; i < 64; i+=8)
-		fputc((RES_SHIFT >> i) & 0xff, fp);
+	memset(hdr, 0, SAVEFILE_HDR_LEN);
+	memcpy(hdr, SAVEFILE_MAGIC, 8);
+	savefile_put(hdr+  8, SAVEFILE_VERSION, 4);
+	savefile_put(hdr+ 12, SAVEFILE_HDR_LEN, 4);
+	hdr[16] = TEST_TYPE;	hdr[17] = MODULUS_TYPE;	hdr[18] = nres;
+	hdr[19] = (FFT_PROBE_RESULT == FFT_PROBE_PENDING ? FFT_PROBE_NONE : FFT_PROBE_RESULT);
+	savefile_put(hdr+ 20, kblocks, 4);
+	savefile_put(hdr+ 24, ihi, 8);
+	savefile_put(hdr+ 32, p, 8);
+	savefile_put(hdr+ 40, nbytes, 8);
+	savefile_put(hdr+ 48, RES_SHIFT, 8);
+	savefile_put(hdr+ 56, GCHECK_SHIFT, 8);
+	savefile_put(hdr+ 64, PRP_BASE, 4);
+	savefile_put(hdr+ 68, NERR_ROE, 4);
+	savefile_put(hdr+ 72, NERR_GCHECK, 4);
+	savefile_put(hdr+ 76, SAVEFILE_BLOCK, 4);
+	savefile_put(hdr+ 80, FFT_PROBE_KBLOCKS, 4);
+	savefile_put(hdr+ 84, FFT_PROBE_NITER, 4);
+	savefile_put(hdr+ 88, (uint64)(FFT_PROBE_AME*TWO32FLOAT), 4);
+	savefile_put(hdr+ 92, (uint64)(FFT_PROBE_MME*TWO32FLOAT), 4);
+	memcpy(&itmp64, &FFT_PROBE_NERR, sizeof(double));
+	savefile_put(hdr+ 96, itmp64, 8);
+	savefile_put(hdr+104, Res64, 8);	savefile_put(hdr+112, Res35m1, 8);	savefile_put(hdr+120, Res36m1, 8);
+	if(nres > 1) {
+		savefile_put(hdr+128, i1, 8);	savefile_put(hdr+136, i2, 8);	savefile_put(hdr+144, i3, 8);
+	}
+	savefile_put(hdr+SAVEFILE_HDR_LEN-4, crc32c(0, hdr, SAVEFILE_HDR_LEN-4), 4);
 
-  // v19: For PRP-tests, also write a second Gerbicz-check residue array [arr2] and associated S-H checksum triplet [i1,i2,i3]:
-  if(DO_GCHECK) {	// v21: Change to key off DO_GCHECK, to allow Fermat-mod Pepin-tests to use the Gerbicz check, too
-	for(i = 0; i < 32; i+=8)
-		fputc((PRP_BASE >> i) & 0xff, fp);
-	write_ppm1_residue(nbytes, fp, arr2, i1,i2,i3);
-	// G-check residues all need to be clshifted by residue-shift count at the ITERS_BETWEEN_GCHECK_UPDATESth PRP-test iteration:
-	for(i = 0; i < 64; i+=8)
-		fputc((GCHECK_SHIFT >> i) & 0xff, fp);
-  }
-	// v20: Write cumulative #errs for ROE >= 0.4375 (>= for LL, > for PRP) and Gerbicz-check for the test in question:
-	for(i = 0; i < 32; i+=8)
-		fputc((NERR_ROE >> i) & 0xff, fp);
-	for(i = 0; i < 32; i+=8)
-		fputc((NERR_GCHECK >> i) & 0xff, fp);
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp", fname);
+	fp = mlucas_fopen(tmpname, "wb");
+	if(!fp) {
+		snprintf(cbuf,STR_MAX_LEN*2, "%s: Unable to open %s for write.\n",func,tmpname);
+		mlucas_fprint(cbuf,1);	return 0;
+	}
+	ierr = (fwrite(hdr, 1, SAVEFILE_HDR_LEN, fp) != SAVEFILE_HDR_LEN) || !write_ppm1_residue(nbytes, SAVEFILE_BLOCK, fp, arr1);
+	if(nres > 1)
+		ierr = ierr || !write_ppm1_residue(nbytes, SAVEFILE_BLOCK, fp, arr2);
+	ierr = ierr || fflush(fp) || fsync(fileno(fp));
+	fclose(fp); fp = 0x0;
+	// Unlike mlucas_fopen(), rename() and remove() don't prepend MLUCAS_PATH, so do that here:
+	sprintf(path, "%s%s", MLUCAS_PATH, fname);	sprintf(tmppath, "%s%s", MLUCAS_PATH, tmpname);
+  #ifdef OS_TYPE_WINDOWS
+	if(!ierr) remove(path);	// Windows rename() won't replace an existing file
+  #endif
+	if(ierr || rename(tmppath, path)) {
+		remove(tmppath);
+		snprintf(cbuf,STR_MAX_LEN*2, "%s: Error writing savefile %s.\n",func,fname);
+		mlucas_fprint(cbuf,1);	return 0;
+	}
+	return 1;
 }
 
 /*********************/
 
 /*
-Function to take an n-digit Mersenne or Fermat-mod residue in bytewise savefile form,
-apply the required circular shift read into the global RES_SHIFT during the preceding
-bytewise-savefile read and convert it to balanced-digit floating-point form.
+ROE probe for FFT-length selection at breakover points: Runs FFT_PROBE_ITERS mod-squarings of a random residue
+modulo M(p) at the current (smaller-than-default) FFT length n, using the current carry-chain settings, in chunks
+of FFT_PROBE_CHUNK iterations, and fits the resulting sample of per-chunk maximum fractional errors. Such maxima
+of many roughly-iid errors are approximately Gumbel-distributed; a method-of-moments fit to the sample mean m and
+standard deviation sd gives scale b = sqrt(6)*sd/pi and location u = m - gamma*b, gamma = Euler's constant, whence
+the expected number of chunks with an error >= 0.4375 over a full p-iteration test is
 
-In the Mersenne-mod case the residue digits are stored consecutively in the a[] array.
+	nerr = (p/FFT_PROBE_CHUNK)*(1 - exp(-exp(-(x - u)/b))) ,
 
-In the Fermat-mod case the digits are arranged in (j,j+n/2) (i.e. right-angle transform) order.
+with x = 0.4375 - 1/128, i.e. continuity-corrected for the 1/64 granularity of the ROE values. This is much more
+reliable than anything derived from the sample mean alone, since the spread of the maxima captures the tail shape.
+
+Returns 1 (and sets FFT_PROBE_RESULT = FFT_PROBE_ACCEPT) if the probe completed without a fatal ROE, MaxErr < 0.4375
+and nerr <= FFT_PROBE_MAX_NERR; otherwise returns 0 and sets FFT_PROBE_RESULT = FFT_PROBE_REJECT. Either way the
+FFT_PROBE_* statistics globals are set, and the contents of a[] and arr_scratch[] are overwritten.
 */
-int 	convert_res_bytewise_FP(const uint8 ui64_arr_in[], double a[], int n, const uint64 p)
+int fft_length_roe_probe(uint64 p, int n, double a[], uint64 arr_scratch[], int scrnFlag)
 {
-	uint32 nbytes;
-	uint64 nbits;
-	int bimodn,curr_char,findex,ii,j = 0,j1 = 0,k,pass,rbits;
-	int bw,sw,bits[2];
-	uint64 base[2];	/* Assume base may be > 2^32 (e.g. for mixed FFT/FGT)
-						but < 2^53, i.e. fits in a double */
-	int64 itmp,cy;
-	uint64 curr_word, curr_wd64;
-	int pow2_fft;
+	const char func[] = "fft_length_roe_probe";
+	const double euler_gamma = 0.57721566490153286061, xfatal = 0.4375 - 1.0/128;
+	const int chain_save = USE_SHORT_CY_CHAIN;
+	const uint64 shift_save = RES_SHIFT;
+	uint32 i, nlimb = (p+63)>>6, nsamp = 0;
+	int ierr = 0;
+	double tdiff, mme = 0.0, ame = 0.0, sum = 0.0, sumsq = 0.0, mean,sd,b,u;
+	ASSERT(MODULUS_TYPE == MODULUS_TYPE_MERSENNE, "ROE probe only supported for Mersenne moduli!");
+	ASSERT(FFT_PROBE_ITERS % FFT_PROBE_CHUNK == 0 && FFT_PROBE_ITERS > 2*AME_ITER_START, "Bad FFT_PROBE_ITERS value!");
+	// Random residue in [0, 2^p), converted to balanced-digit form with zero shift:
+	for(i = 0; i < nlimb; i++) { arr_scratch[i] = rng_isaac_rand(); }
+	if(p & 63) arr_scratch[nlimb-1] &= (-1ull >> (64 - (p & 63)));
+	RES_SHIFT = 0ull;
+	if(!convert_res_bytewise_FP((uint8*)arr_scratch, a, n, p)) {
+		sprintf(cbuf, "%s: convert_res_bytewise_FP failed on random probe data!\n",func);	ASSERT(0,cbuf);
+	}
+	for(i = 0; !ierr && i < FFT_PROBE_ITERS; i += FFT_PROBE_CHUNK) {
+		AME = MME = 0.0;
+		ierr = mers_mod_square(a, (int*)arr_scratch, n, i, i+FFT_PROBE_CHUNK, 0ull, p, scrnFlag, &tdiff, FALSE, 0x0);
+		mme = MAX(mme, MME);	ame += AME;
+		// Skip the chunks in which the residue is still 'filling up':
+		if(i >= AME_ITER_START) {
+			sum += MME;	sumsq += MME*MME;	++nsamp;
+		}
+	}
+	// Undo any side effects on the run-state globals:
+	RES_SHIFT = shift_save;	USE_SHORT_CY_CHAIN = chain_save;	ROE_ITER = 0;	ROE_VAL = 0.0;
+	FFT_PROBE_NITER = i;	FFT_PROBE_MME = MME = mme;
+	FFT_PROBE_AME = AME = ame/(i - AME_ITER_START);
+	if(ierr || mme >= 0.4375 || nsamp < 2) {
+		FFT_PROBE_NERR = (double)p/FFT_PROBE_CHUNK;	// Worst case: Any ROE this large may recur in every chunk
+	} else {
+		mean = sum/nsamp;	sd = sqrt(MAX(0.0, (sumsq - nsamp*mean*mean)/(nsamp - 1)));
+		b = 0.7796968012336188*sd;	// sqrt(6)/pi
+		u = mean - euler_gamma*b;
+		FFT_PROBE_NERR = (b > 0.0) ? (double)p/FFT_PROBE_CHUNK*(-expm1(-exp(-(xfatal - u)/b))) : 0.0;
+	}
+	FFT_PROBE_RESULT = (FFT_PROBE_NERR <= FFT_PROBE_MAX_NERR) ? FFT_PROBE_ACCEPT : FFT_PROBE_REJECT;
+	snprintf(cbuf,STR_MAX_LEN*2, "ROE probe at FFT length %uK: %u iterations, AvgMaxErr = %10.9f, MaxErr = %10.9f, predicted #ROE >= 0.4375 over full test = %.3e ... %s.\n",
+		FFT_PROBE_KBLOCKS, FFT_PROBE_NITER, FFT_PROBE_AME, FFT_PROBE_MME, FFT_PROBE_NERR,
+		(FFT_PROBE_RESULT == FFT_PROBE_ACCEPT ? "using this FFT length" : "reverting to default FFT length"));
+	mlucas_fprint(cbuf,1);
+	return (FFT_PROBE_RESULT == FFT_PROBE_ACCEPT);
+}
 
-	ASSERT(MODULUS_TYPE,"MODULUS_TYPE not set!");
-	ASSERT(MODULUS_TYPE <= MODULUS_TYPE_MAX,"MODULUS_TYPE out of range!");
+/*********************/
 
-	ASSERT(TRANSFORM_TYPE,"TRANSFORM_TYPE not set!");
-	ASSERT(TRANSFORM_TYPE <= TRANSFORM_TYPE_MAX,"TRANSFORM_TYPE out of range!");
+/*
+Per-radix kernel microbenchmark: bench_radix() runs each radix set available at the given FFT length through ernstMain,
+which after the usual FFT setup calls bench_radix_set() in place of a timing test. The latter does one untimed squaring
+on a random residue, which takes care of the one-time inits for the radix set, followed by [niter] timed ones, with the
+perfctr.c phase counters splitting the CPU time into that spent in each kernel type:
+
+	DIF pass:	the intermediate radix*_dif_pass calls, of which there are NRADICES-2 per squaring;
+	wrapper:	the fused final-DIF-pass/pointwise-squaring/initial-DIT-pass radix*_wrapper_square call;
+	DIT pass:	the intermediate radix*_dit_pass calls, NRADICES-2 per squaring;
+	carry:		the fused radix0 DIT-pass/carry-step/radix0 DIF-pass radix*_ditN_cy_dif1 call.
+
+These are converted to CPU-nsec per complex datum per pass, i.e. summed over threads and comparable across FFT lengths
+and radices. Since the kernels are timed in situ, the data strides and cache behavior are those of a real test.
+
+The result is checked against an exact scalar reference: the squarings are done modulo M(q), with q an odd multiple
+of 59 just below the exponent p set up by ernstMain, so M(59) = 2^59-1 divides M(q). Rerunning the LL iteration
+x := x^2-2 on the starting residue reduced modulo 2^59-1 thus must give the final residue reduced likewise; an error
+in any of the kernels shows up as a mismatch with overwhelming probability. Returns 0 on success,
+ERR_INCORRECT_RES64 on a mismatch or the nonzero return value of mers_mod_square(); the per-set results are saved
+for bench_radix() to print.
+*/
+static struct bench_radix_res_t {
+	uint32 nradices, radix_vec[10], blocked;
+	int ierr;
+	double nsec[PERF_NPHASE];	// CPU-nsec per complex datum per pass for each FFT phase
+	double msec_per_iter, maxerr;
+} bench_radix_res[BENCH_RADIX_MAX_SETS];
+static uint32 bench_radix_nset = 0;
+
+// Reduces x to the canonical residue in [0, 2^59-1); x must be < 2^63:
+static uint64 m59_fold(uint64 x)
+{
+	const uint64 m59 = 0x07FFFFFFFFFFFFFFull;
+	x = (x & m59) + (x >> 59);	// <= 2^59-1 + 15
+	return (x >= m59) ? x - m59 : x;
+}
 
-	/* Set the number of residue bytes, which is the same for Mersenne (2^p-1) and Fermat-mod (2^p+1, with p = 2^findex)
-	despite the fact the latter can formally be as large as 2^p, since only ever hit that if it`s the last residue of
-	a Pepin test and the number hqppens to be prime. (We would love for that exception to break some other ASSERTion in the code): */
-	if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE)
-	{
-		ASSERT(TRANSFORM_TYPE == REAL_WRAPPER,"convert_res_bytewise_FP: TRANSFORM_TYPE == REAL_WRAPPER");
+// x^2 - 2 (mod 2^59-1), using x = xh*2^30 + xl and 2^59 == 1:
+static uint64 m59_sqr_sub2(uint64 x)
+{
+	const uint64 m29 = 0x1FFFFFFFull, m30 = 0x3FFFFFFFull;
+	uint64 xh = x >> 30, xl = x & m30, t = 2*xh*xl;
+	x = m59_fold(2*xh*xh + xl*xl);	// xh^2*2^60 == 2*xh^2
+	x = m59_fold(x + ((t & m29) << 30) + (t >> 29));	// t*2^30 == (t%2^29)*2^30 + t/2^29
+	return m59_fold(x + 0x07FFFFFFFFFFFFFDull);	// + (2^59-1) - 2
+}
+
+// The nbits-bit integer stored bytewise (least-significant byte first) in x[], reduced modulo 2^59-1 by Horner's rule
+// from the most-significant byte down; multiplying by 2^8 modulo 2^59-1 is a 59-bit left-rotation by 8 bits:
+static uint64 bytewise_mod_m59(const uint8 x[], uint64 nbits)
+{
+	const uint64 m59 = 0x07FFFFFFFFFFFFFFull;
+	uint64 i = (nbits+7)>>3, r = 0ull;
+	while(i--) {
+		r = m59_fold((((r << 8) & m59) | (r >> 51)) + x[i]);
 	}
-	else if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
-	{
-		ASSERT(TRANSFORM_TYPE == RIGHT_ANGLE,"convert_res_bytewise_FP: TRANSFORM_TYPE == RIGHT_ANGLE");
-		/* If Fermat number, make sure exponent a power of 2: */
-		findex = trailz64(p);
-		ASSERT((p >> findex) == 1,"convert_res_bytewise_FP: (p >> findex) == 1");
+	return r;
+}
 
-		ASSERT(p % 8 == 0,"convert_res_bytewise_FP: p % 8 == 0");
+int bench_radix_set(uint64 p, int n, double a[], uint64 arr_scratch[], uint32 niter, int scrnFlag)
+{
+	const char func[] = "bench_radix_set";
+	const uint64 shift_save = RES_SHIFT;
+	uint64 i, q, nlimb, ref, Res64,Res35m1,Res36m1;
+	uint32 npass;
+	int j;
+	double tdiff, t = 0.0;
+	struct bench_radix_res_t*res;
+	ASSERT(MODULUS_TYPE == MODULUS_TYPE_MERSENNE && TEST_TYPE == TEST_TYPE_PRIMALITY, "-bench-radix only supported for Mersenne-mod LL squaring!");
+	ASSERT(bench_radix_nset < BENCH_RADIX_MAX_SETS, "Too many radix sets for -bench-radix!");
+	res = bench_radix_res + bench_radix_nset++;
+	memset(res, 0, sizeof(*res));
+	res->nradices = NRADICES;	memcpy(res->radix_vec, RADIX_VEC, sizeof(res->radix_vec));	res->blocked = FFT_CACHE_BLOCK;
+	// Largest odd multiple of 59 not exceeding p and coprime to n, as the residue-conversion and carry code require:
+	q = p - p%59;
+	if(!(q & 1)) q -= 59;
+	while(gcd64(q, n) != 1) { q -= 118; }
+	nlimb = (q+63)>>6;
+	// Random residue in [0, 2^q), converted to balanced-digit form with zero shift:
+	for(i = 0; i < nlimb; i++) { arr_scratch[i] = rng_isaac_rand(); }
+	if(q & 63) arr_scratch[nlimb-1] &= (-1ull >> (64 - (q & 63)));
+	ref = bytewise_mod_m59((uint8*)arr_scratch, q);
+	RES_SHIFT = 0ull;
+	if(!convert_res_bytewise_FP((uint8*)arr_scratch, a, n, q)) {
+		sprintf(cbuf, "%s: convert_res_bytewise_FP failed on random benchmark data!\n",func);	ASSERT(0,cbuf);
 	}
-	nbytes = (p + 7)/8;
-	// Apply the circular shift:
-	uint32 is_ferm = (MODULUS_TYPE == MODULUS_TYPE_FERMAT);
-	mi64_shlc((uint64*)ui64_arr_in, (uint64*)ui64_arr_in, p, RES_SHIFT, (p+63+is_ferm)>>6, is_ferm);
+	res->ierr = mers_mod_square(a, (int*)arr_scratch, n, 0, 1, 0ull, q, scrnFlag, &tdiff, FALSE, 0x0);
+	if(!res->ierr) {
+		perf_reset();	AME = MME = 0.0;
+		t = getRealTime();
+		res->ierr = mers_mod_square(a, (int*)arr_scratch, n, 1, niter+1, 0ull, q, scrnFlag, &tdiff, FALSE, 0x0);
+		t = getRealTime() - t;
+	}
+	if(!res->ierr)
+		convert_res_FP_bytewise(a, (uint8*)arr_scratch, n, q, &Res64,&Res35m1,&Res36m1);
+	RES_SHIFT = shift_save;	ROE_ITER = 0;	ROE_VAL = 0.0;
+	if(res->ierr)
+		return res->ierr;
+	for(i = 0; i <= niter; i++) { ref = m59_sqr_sub2(ref); }
+	if(bytewise_mod_m59((uint8*)arr_scratch, q) != ref)
+		res->ierr = ERR_INCORRECT_RES64;
+	res->msec_per_iter = 1000*t/niter;	res->maxerr = MME;
+	for(j = 0; j < PERF_NPHASE; j++) {
+		npass = (j == PERF_PHASE_FWD || j == PERF_PHASE_INV) ? NRADICES-2 : 1;
+		res->nsec[j] = npass ? (double)perf_phase_total(j, PERF_EV_TASK_CLOCK)/((double)niter*(n>>1)*npass) : 0.0;
+	}
+	return res->ierr;
+}
 
-	/* Vector length a power of 2? */
-	pow2_fft = (n >> trailz32(n)) == 1;
+/*
+Driver for -bench-radix: Runs bench_radix_set() on every radix set at the given FFT length in Kdoubles, or if kblocks = 0,
+at both BENCH_RADIX_KCACHE and BENCH_RADIX_KDRAM, using iters timed iterations per set (0 = length-dependent default).
+Prints a table of the per-set results for each length, then a summary of the best time of each kernel over all sets
+using it; the intermediate-pass kernels are only attributed for sets whose intermediate radices are all the same.
+The SIMD mode is fixed at compile time, so comparing it against scalar or other-width code means running each build.
+Returns the number of radix sets which failed their check or hit an error.
+*/
+int bench_radix(uint32 kblocks, uint32 iters)
+{
+	const char*phase_kernel[PERF_NPHASE] = {"dif_pass","wrapper_square","dit_pass","ditN_cy_dif1"};
+  #if defined(USE_AVX512)
+	const char simd_str[] = "AVX-512";
+  #elif defined(USE_AVX2)
+	const char simd_str[] = "AVX2";
+  #elif defined(USE_AVX)
+	const char simd_str[] = "AVX";
+  #elif defined(USE_SSE2)
+	const char simd_str[] = "SSE2";
+  #elif defined(USE_ARM_V8_SIMD)
+	const char simd_str[] = "ARMv8 SIMD";
+  #else
+	const char simd_str[] = "scalar double";
+  #endif
+	static char kname[4*BENCH_RADIX_MAX_SETS][32];
+	static double kbest[4*BENCH_RADIX_MAX_SETS][2];
+	uint32 klen[2] = {BENCH_RADIX_KCACHE, BENCH_RADIX_KDRAM}, nlen = 2, nkern = 0, nfail = 0, il,k,m,niter,rs,nrad,rad,rvec[10];
+	uint64 p, Res64,Res35m1,Res36m1;
+	int ierr, ip;
+	double runtime;
+	char radstr[STR_MAX_LEN], str[STR_MAX_LEN], kstr[32];
+	struct bench_radix_res_t*res;
+
+	if(kblocks) {
+		klen[0] = kblocks;	nlen = 1;
+	}
+	perf_init();
+	for(il = 0; il < nlen; il++) {
+		k = klen[il];
+		if(get_fft_radices(k, 0, 0x0, 0x0, 0) != 0) {
+			sprintf(cbuf, "ERROR: FFT length %u K not available.\n",k);
+			fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf);
+		}
+		// ernstMain needs a prime exponent, so use the largest one not exceeding 95% of the max. recommended for the length:
+		p = (95*given_N_get_maxP(k<<10)/100) | 1;
+		while(!isPRP64(p)) { p -= 2; }
+		niter = iters ? iters : MAX(10, BENCH_RADIX_ITERS*BENCH_RADIX_KCACHE/k);
+		BENCH_RADIX = TRUE;	bench_radix_nset = 0;
+		for(rs = 0; get_fft_radices(k, rs, &nrad, rvec, 10) == 0; rs++) {
+			m = bench_radix_nset;
+			ierr = ernstMain(MODULUS_TYPE_MERSENNE,TEST_TYPE_PRIMALITY,p,k,rs,k,niter,&Res64,&Res35m1,&Res36m1,0,&runtime);
+			if(bench_radix_nset == m) {	// ernstMain returned before reaching bench_radix_set()
+				ASSERT(bench_radix_nset < BENCH_RADIX_MAX_SETS, "Too many radix sets for -bench-radix!");
+				res = bench_radix_res + bench_radix_nset++;
+				memset(res, 0, sizeof(*res));
+				res->nradices = nrad;	memcpy(res->radix_vec, rvec, sizeof(rvec));	res->ierr = (ierr ? ierr : ERR_ASSERT);
+			}
+		}
+		BENCH_RADIX = FALSE;
 
-	bits[0] = p/n;		ASSERT(bits[0] > 1,"convert_res_bytewise_FP: bits[0] > 1");
-	base[0] = 1 << bits[0];
+		printf("\nRadix-kernel benchmark [%s build]: FFT length %uK, %u timed iterations per radix set.\n",simd_str,k,niter);
+		printf("CPU-nsec per complex datum per pass:\n");
+		printf("  set  %-24s %9s %9s %9s %9s %10s %8s  %s\n","radices","DIF-pass","wrapper","DIT-pass","carry","msec/iter","MaxErr","check");
+		for(rs = 0; rs < bench_radix_nset; rs++) {
+			res = bench_radix_res + rs;
+			radstr[0] = '\0';
+			for(m = 0; m < res->nradices; m++) {
+				snprintf(str,STR_MAX_LEN,"%s%u",(m ? "," : ""),res->radix_vec[m]);	strcat(radstr,str);
+			}
+			if(res->blocked) strcat(radstr," [blk]");
+			if(res->ierr) {
+				++nfail;
+				printf("  %3u  %-24s %s\n",rs,radstr,(res->ierr == ERR_INCORRECT_RES64 ? "FAILED: result mismatch vs mod-(2^59-1) reference" : "FAILED: error"));
+				if(res->ierr != ERR_INCORRECT_RES64) printMlucasErrCode(res->ierr);
+				continue;
+			}
+			printf("  %3u  %-24s %9.3f %9.3f %9.3f %9.3f %10.3f %8.5f  ok\n",rs,radstr,res->nsec[PERF_PHASE_FWD],res->nsec[PERF_PHASE_SQR],
+				res->nsec[PERF_PHASE_INV],res->nsec[PERF_PHASE_CARRY],res->msec_per_iter,res->maxerr);
+			// Update the per-kernel bests:
+			for(ip = 0; ip < PERF_NPHASE; ip++) {
+				if(ip == PERF_PHASE_CARRY)
+					rad = res->radix_vec[0];
+				else if(ip == PERF_PHASE_SQR)
+					rad = res->radix_vec[res->nradices-1];
+				else {
+					rad = (res->nradices > 2) ? res->radix_vec[1] : 0;
+					for(m = 2; m < res->nradices-1; m++) { if(res->radix_vec[m] != rad) rad = 0; }
+				}
+				if(!rad) continue;
+				snprintf(kstr,sizeof(kstr),"radix%u_%s",rad,phase_kernel[ip]);
+				for(m = 0; m < nkern && strcmp(kname[m],kstr); m++) {}
+				if(m == nkern) {
+					ASSERT(nkern < 4*BENCH_RADIX_MAX_SETS, "Kernel table overflow!");
+					strcpy(kname[m],kstr);	kbest[m][0] = kbest[m][1] = 0.0;	++nkern;
+				}
+				if(!kbest[m][il] || res->nsec[ip] < kbest[m][il]) kbest[m][il] = res->nsec[ip];
+			}
+		}
+	}
 
-	if(MODULUS_TYPE == MODULUS_TYPE_FERMAT && pow2_fft == TRUE)
-		bits[1] =     bits[0];
-	else
-		bits[1] = 1 + bits[0];
-	base[1] = 1 << bits[1];
+	printf("\nBest CPU-nsec per complex datum per pass, by kernel:\n  %-28s","kernel");
+	for(il = 0; il < nlen; il++) {
+		snprintf(str,STR_MAX_LEN,"%uK",klen[il]);	printf(" %9s",str);
+	}
+	printf("\n");
+	for(m = 0; m < nkern; m++) {
+		printf("  %-28s",kname[m]);
+		for(il = 0; il < nlen; il++) {
+			if(kbest[m][il]) printf(" %9.3f",kbest[m][il]); else printf(" %9s","-");
+		}
+		printf("\n");
+	}
+	if(nfail)
+		printf("\n*** %u radix sets FAILED ***\n",nfail);
+	return nfail;
+}
 
-	bw = p%n;	/* cf. mers_mod_square.c	*/
-	sw = n - bw;
+/*********************/
 
-	/*...Now form the SH residues, converting to positive-digit form along the way...	*/
+/*
+Residue conversions between balanced-digit floating-point and bytewise forms, used for every savefile write|read and
+Gerbicz check, are multithreaded: The n residue digits are taken in "sequence order" - a[0,...,n-1] in the Mersenne-mod
+case; in the Fermat-mod case the even-indexed elements (the lower residue half in the right-angle transform layout)
+followed by the odd-indexed ones - and split into up to NTHREADS contiguous chunks of at least RES_CVT_MIN_CHUNK digits.
+Since the bit offset of any digit is known in closed form (res_cvt_bit_offset), each chunk packs|unpacks at its own
+offset. The carry into each chunk is found by a serial scan of the preceding chunk's top digits, which normally stops
+at the first one examined, and the partial bytes shared by neighboring chunks are merged after the threads complete.
+*/
+#ifndef RES_CVT_MIN_CHUNK
+	#define RES_CVT_MIN_CHUNK	16384	// Min. #digits per thread-processed chunk
+#endif
 
-	curr_char = 0;	/* Current byte to be read from the ui64_arr_in array */
-	nbits = 0;		/* Total bits accumulated so far in the residue	*/
-	rbits = 0;		/* # of bits left in our 64-bit buffer after processing of previous word	*/
-	curr_wd64 = 0;	/*      bits left in our 64-bit buffer after processing of previous word	*/
-	cy = 0;
+struct res_cvt_thread_data_t {
+	int tid;
+	double*a;			// Floating-point residue; read-only in the FP-to-bytewise direction
+	uint8*bytes;		// Bytewise residue; read-only in the bytewise-to-FP direction
+	int n;				// FFT length
+	uint64 p;			// Modulus exponent
+	int t0,t1;			// This chunk = digits [t0,t1) in sequence order...
+	uint64 off0;		// ...whose lowest digit starts at this bit offset into the bytewise residue
+	int cy_in,cy_out;	// Carry into the lowest and out of the highest digit of the chunk
+	uint32 tail,tail_bits;	// FP-to-bytewise: Bits of the last, partial output byte, which the next chunk shares
+	uint64 r35,r36;		// FP-to-bytewise: Partial sums of the unshifted residue (mod 2^35-1, 2^36-1), if do_sh
+	int do_sh;
+};
 
-	/* For right-angle transform, need to process odd and even-index elements
-	separately, via a pair of stride-2 passes through the array:
-	*/
-	if(TRANSFORM_TYPE == REAL_WRAPPER)
-	{
-		bimodn = 0;
-		ii = 0;		/* Index into the BASE array. */
-		/* If bw > 0 (i.e. n does not divide p), lowest-order digit always a bigword:	*/
-		if(bw > 0)
-			ii = 1;
+// Sequence-order digit index t --> padded a[]-array index:
+static int res_cvt_index(int t, int n)
+{
+	int j = t, j1;
+	if(TRANSFORM_TYPE == RIGHT_ANGLE)
+		j = (t < (n>>1)) ? (t<<1) : ((t<<1) - n + 1);
+#ifdef USE_AVX512
+	j1 = (j & mask03) + br16[j&15];
+#elif defined(USE_AVX)
+	j1 = (j & mask02) + br8[j&7];
+#elif defined(USE_SSE2)
+	j1 = (j & mask01) + br4[j&3];
+#else
+	j1 = j;
+#endif
+	return j1 + ( (j1>> DAT_BITS) << PAD_BITS );	/* padded-array fetch index is here */
+}
 
-		for(j = 0; j < n; j++)
-		{
-		#ifdef USE_AVX512
-			j1 = (j & mask03) + br16[j&15];
-		#elif defined(USE_AVX)
-			j1 = (j & mask02) + br8[j&7];
-		#elif defined(USE_SSE2)
-			j1 = (j & mask01) + br4[j&3];
-		#else
-			j1 = j;
-		#endif
-			j1 = j1 + ( (j1>> DAT_BITS) << PAD_BITS );	/* padded-array fetch index is here */
+/* Number of bits in the lowest [i] digits of the residue (Mersenne-mod) or residue half (Fermat-mod). With bw = p%n
+and g = gcd(bw,n), bigword index i > 0 has (i*bw)%n > n-bw in the Mersenne-mod case, additionally (i*bw)%n == 0 in the
+Fermat-mod case; counting those gives 1 + floor(i*bw/n) - floor(i*g/n) [+ floor((i-1)*g/n) for Fermat-mod] bigwords.
+Mersenne-mod has g = 1 since p is prime, in which case this = ceiling(i*p/n) bits:
+*/
+static uint64 res_cvt_nbits(uint64 i, int n, uint64 p)
+{
+	const uint32 bw = p%n, bits0 = p/n, pow2_fft = (n >> trailz32(n)) == 1;
+	uint32 bits1 = bits0 + !(MODULUS_TYPE == MODULUS_TYPE_FERMAT && pow2_fft), ng;
+	uint64 nbig = 0;
+	if(i && bw) {
+		ng = n/gcd32(bw,n);
+		nbig = 1 + (i*bw)/n - i/ng;
+		if(TRANSFORM_TYPE == RIGHT_ANGLE) nbig += (i-1)/ng;
+	}
+	return i*bits0 + nbig*(bits1 - bits0);
+}
 
-			/* If rbits (# of bits left in current 64-bit window of the bytewise residue)
-			is less than bits[ii] (number we need to fill the current digit of a[]), write
-			the bits we have to curr_word, grab the next 8 bytes of ui64_arr_in[] and finish
-			the write of the remaining (bits[ii] - rbits) of curr_word:
-			*/
-			if(rbits < bits[ii])
-			{
-				itmp = curr_wd64;
-				ASSERT(itmp < (1ull<<rbits),"convert_res_bytewise_FP: itmp >= 2^rbits!");
+// Bit offset of sequence-order digit t in the bytewise residue:
+static uint64 res_cvt_bit_offset(int t, int n, uint64 p)
+{
+	if(TRANSFORM_TYPE == RIGHT_ANGLE && t >= (n>>1))
+		return res_cvt_nbits(n>>1,n,p) + res_cvt_nbits(t - (n>>1),n,p);
+	return res_cvt_nbits(t,n,p);
+}
 
-				/* Now grab the next 64 bits of the bytewise residue... */
-				curr_wd64 = 0;
-				for(k = 0; k < 8; k++)
-				{
-					curr_wd64 += (uint64)ui64_arr_in[curr_char++] << (k<<3);	/* left-shift current residue byte k*8 bits and accumulate */
-					if(curr_char == nbytes)
-						break;
-				}
-				/* ...and use the LS (bits[ii] - rbits) of the just-grabbed 64
-				to fill in the high part of the bits[ii] bits of itmp: */
-				curr_word = (curr_wd64 << (64 - (bits[ii] - rbits)));	/* Off-shift everything but the bits we need... */
-				curr_word = (curr_word >> (64 -  bits[ii]));	/* Now right-shift so LSB of the bits we need goes in <rbits> slot... */
-				itmp +=  curr_word;
-				curr_wd64 >>= (bits[ii] - rbits);
-				rbits = 64 - (bits[ii] - rbits);	/* # of bits now left in curr_wd64 */
-			}
-			else	/* Grab the LS bits[ii] bits of curr_wd64 and stick them in itmp */
-			{
-				curr_word = (curr_wd64 << (64 - bits[ii]));			/* Off-shift everything but the bits we need... */
-				itmp = (curr_word >> (64 - bits[ii]));
-				curr_wd64 >>= bits[ii];
-				rbits -= bits[ii];					/* # of bits now left in curr_wd64 */
-			}
+/* Digit-size bookkeeping as in the serial loops of the mod_square routines: Given digit t, inits the bimodn-state and
+the bigword flag ii of digit t. res_cvt_next_digit() then returns the bigword flag of the current digit t and advances
+the state to digit t+1. Mersenne-mod: digit 0 is a bigword if bw > 0, digit t > 0 iff bimodn = (t*bw)%n > sw.
+Fermat-mod: each of the 2 stride-2 passes through the array starts with bimodn = n; bimodn = (i*bw)%n in (0,n]:
+*/
+static void res_cvt_init_digit(int t, int n, uint64 p, int*bimodn, uint32*ii)
+{
+	const int bw = p%n, sw = n - bw;
+	if(TRANSFORM_TYPE == RIGHT_ANGLE) {
+		if(t >= (n>>1)) t -= (n>>1);
+		*bimodn = ((uint64)t*bw) % n;
+		if(!*bimodn) *bimodn = n;
+	} else {
+		*bimodn = ((uint64)t*bw) % n;
+		*ii = t ? (*bimodn > sw) : (bw > 0);
+	}
+}
 
-			itmp += cy;		/* Add in any carry from the previous digit
-							and normalize result so |current digit| <= base[ii]/2. */
-			if(itmp > 0) {
-				cy = itmp >> bits[ii];
-				itmp -= (cy << bits[ii]);
-				if(itmp > (base[ii]>>1))
-				{
-					itmp -= base[ii];
-					cy += 1;
-				}
-			} else {
-				cy = 0;
-			}
-			a[j1]= (double)itmp;
-			nbits += bits[ii];
-			bimodn += bw;
-			if(bimodn >= n) bimodn -= n;
-			ii = (uint32)(sw - bimodn) >> 31;
-		}
+static uint32 res_cvt_next_digit(int t, int n, int bw, int*bimodn, uint32*ii)
+{
+	const int sw = n - bw;
+	uint32 i;
+	if(TRANSFORM_TYPE == RIGHT_ANGLE) {
+		if(t == (n>>1)) *bimodn = n;		// Start of 2nd pass
+		i = (*bimodn > sw);					/*       i = 1 if a bigword,   0 if a smallword */
+		*bimodn -= sw;						/* result >= 0 if a bigword, < 0 if a smallword */
+		*bimodn += ( ((int)i-1) & n);		/*       add 0 if a bigword,   N if a smallword */
+	} else {
+		i = *ii;
+		*bimodn += bw;
+		if(*bimodn >= n) *bimodn -= n;
+		*ii = (uint32)(sw - *bimodn) >> 31;
 	}
-	else
-	{
-	  for(pass = 0; pass <=1; pass++)
-	  {
-		bimodn = n;
+	return i;
+}
 
-		for(j = pass; j < n; j += 2)
-		{
-		#ifdef USE_AVX512
-			j1 = (j & mask03) + br16[j&15];
-		#elif defined(USE_AVX)
-			j1 = (j & mask02) + br8[j&7];
-		#elif defined(USE_SSE2)
-			j1 = (j & mask01) + br4[j&3];
-		#else
-			j1 = j;
-		#endif
-			j1 = j1 + ( (j1>> DAT_BITS) << PAD_BITS );	/* padded-array fetch index is here */
+// Returns bits [off,off+nbits) of the nbytes-byte vector x[], nbits <= 56:
+static uint64 res_cvt_getbits(const uint8 x[], uint32 nbytes, uint64 off, uint32 nbits)
+{
+	uint32 i, i0 = off>>3;
+	uint64 w = 0ull;
+	for(i = 0; i < 8 && i0+i < nbytes; i++) {
+		w += (uint64)x[i0+i] << (i<<3);
+	}
+	return (w >> (off&7)) & ((1ull << nbits) - 1);
+}
 
-			ii = (bimodn > sw);					/*       i = 1 if a bigword,   0 if a smallword */
-			bimodn -= sw;						/* result >= 0 if a bigword, < 0 if a smallword */
-			bimodn += ( ((int)ii-1) & n);		/*       add 0 if a bigword,   N if a smallword */
+// acc += v*2^q (mod 2^b-1), for b = 35|36 and q < b. Multiplication by 2^q mod 2^b-1 is a b-bit left-rotation:
+static void res_cvt_sh_accum(uint64 v, uint32 q, uint32 b, uint64*acc)
+{
+	const uint64 m = (1ull<<b) - 1;
+	v = (v & m) + (v >> b);	v = (v & m) + (v >> b);	// v < 2^b
+	*acc += ((v << q) & m) + (v >> (b-q));
+	if(*acc >> 62) *acc = (*acc & m) + (*acc >> b);
+}
 
-			/* If rbits (# of bits left in current 64-bit window of the bytewise residue)
-			is less than bits[ii] (number we need to fill the current digit of a[]), write
-			the bits we have to curr_word, grab the next 8 bytes of ui64_arr_in[] and finish
-			the write of the remaining (bits[ii] - rbits) of curr_word:
-			*/
-			if(rbits < bits[ii])
-			{
-				itmp = curr_wd64;
-				ASSERT(itmp < (1<<rbits),"convert_res_bytewise_FP: itmp >= 2^rbits!");
+// FP-to-bytewise: Carry out of the chunk [t0,t1) given carry cy into it. The carry out of each digit of the balanced-
+// digit input is -1 if the digit (plus carry in) is < 0, hence is set by the highest nonzero digit above the lowest:
+static int res_cvt_fp_carry(const double a[], int t0, int t1, int n, int cy)
+{
+	int t;
+	double atmp;
+	for(t = t1-1; t > t0; t--) {
+		atmp = a[res_cvt_index(t,n)];
+		if(atmp != 0.0) return -(atmp < 0.0);
+	}
+	return -((int64)a[res_cvt_index(t0,n)] + cy < 0);
+}
 
-				/* Now grab the next 64 bits of the bytewise residue... */
-				curr_wd64 = 0;
-				for(k = 0; k < 8; k++)
-				{
-					curr_wd64 += (uint64)ui64_arr_in[curr_char++] << (k<<3);	/* left-shift current residue byte k*8 bits and accumulate */
-				}
-				/* ...and use the LS (bits[ii] - rbits) of the just-grabbed 64
-				to fill in the high part of the bits[ii] bits of itmp: */
-				curr_word = (curr_wd64 << (64 - (bits[ii] - rbits)));	/* Off-shift everything but the bits we need... */
-				curr_word = (curr_word >> (64 -  bits[ii]));	/* Now right-shift so LSB of the bits we need goes in <rbits> slot... */
-				itmp +=  curr_word;
-				curr_wd64 >>= (bits[ii] - rbits);
-				rbits = 64 - (bits[ii] - rbits);	/* # of bits now left in curr_wd64 */
-			}
-			else	/* Grab the LS bits[ii] bits of curr_wd64 and stick them in itmp */
-			{
-				curr_word = (curr_wd64 << (64 - bits[ii]));			/* Off-shift everything but the bits we need... */
-				itmp = (curr_word >> (64 - bits[ii]));
-				curr_wd64 >>= bits[ii];
-				rbits -= bits[ii];					/* # of bits now left in curr_wd64 */
-			}
+// Bytewise-to-FP: Carry out of the chunk [t0,t1) given carry cy into it. The carry out of each digit v (of size base = 2^b)
+// being normalized to balanced form is 1 if v > base/2, 0 if v < base/2, and the carry in if v == base/2:
+static int res_cvt_byte_carry(const uint8 x[], int t0, int t1, int n, uint64 p, int cy)
+{
+	const uint32 nbytes = (p + 7)/8;
+	int t;
+	uint64 off0, off1 = res_cvt_bit_offset(t1,n,p), v;
+	for(t = t1-1; t >= t0; t--, off1 = off0) {
+		off0 = res_cvt_bit_offset(t,n,p);
+		v = res_cvt_getbits(x, nbytes, off0, off1-off0);
+		if(v != (1ull << (off1-off0-1))) return (v >> (off1-off0-1));
+	}
+	return cy;
+}
 
-			itmp += cy;		/* Add in any carry from the previous digit
-							and normalize result so |current digit| <= base[ii]/2. */
-			if(itmp > 0) {
-				cy = itmp >> bits[ii];
-				itmp -= (cy << bits[ii]);
-				if(itmp > (base[ii]>>1))
-				{
-					itmp -= base[ii];
-					cy += 1;
-				}
-			} else {
-				cy = 0;
+// Partition the n digits into chunks and init the fixed thread-data fields; returns #chunks:
+static int res_cvt_chunks(struct res_cvt_thread_data_t**tdat, double a[], uint8 bytes[], int n, uint64 p)
+{
+	int i, nchunks = 1;
+#ifdef MULTITHREAD
+	nchunks = MAX(1, MIN(NTHREADS, n/RES_CVT_MIN_CHUNK));
+#endif
+	*tdat = (struct res_cvt_thread_data_t *)calloc(nchunks, sizeof(struct res_cvt_thread_data_t));
+	ASSERT(*tdat != 0x0, "alloc failed!");
+	for(i = 0; i < nchunks; i++) {
+		(*tdat)[i].tid = i;
+		(*tdat)[i].a = a;	(*tdat)[i].bytes = bytes;
+		(*tdat)[i].n = n;	(*tdat)[i].p = p;
+		(*tdat)[i].t0 = (int)(((uint64)n* i   )/nchunks);
+		(*tdat)[i].t1 = (int)(((uint64)n*(i+1))/nchunks);
+		(*tdat)[i].off0 = res_cvt_bit_offset((*tdat)[i].t0,n,p);
+	}
+	return nchunks;
+}
+
+// Run func on each chunk, via threadpool if > 1 chunk:
+static void res_cvt_dispatch(void*(*func)(void*), struct res_cvt_thread_data_t tdat[], int nchunks)
+{
+	int i;
+#ifdef MULTITHREAD
+	static struct threadpool *tpool = 0x0;
+	static thread_control_t thread_control = {0,0,0};
+	static task_control_t task_control = {NULL, NULL, NULL, 0x0};
+	struct timespec ns_time;	// We want a sleep interval of 10 nSec here
+	ns_time.tv_sec = 0; ns_time.tv_nsec = 10;
+	if(nchunks > 1) {
+		if(!tpool) {
+			ASSERT(0x0 != (tpool = threadpool_init(NTHREADS, MAX_THREADS, NTHREADS, &thread_control)), "threadpool_init failed!");
+		}
+		task_control.run = (run_func)func;
+		for(i = 0; i < nchunks; ++i) {
+			task_control.data = (void*)(&tdat[i]);
+			threadpool_add_task(tpool, &task_control, TRUE);
+		}
+		while(tpool->free_tasks_queue.num_tasks != NTHREADS) {
+			ASSERT(0 == mlucas_nanosleep(&ns_time), "nanosleep re-call-on-signal fail!");
+		}
+		return;
+	}
+#endif
+	for(i = 0; i < nchunks; ++i) {
+		func((void*)(&tdat[i]));
+	}
+}
+
+// Bytewise-to-FP chunk conversion:
+void*res_cvt_bytewise_FP_chunk(void*targ)
+{
+	struct res_cvt_thread_data_t* thr = targ;
+	const int n = thr->n;
+	const uint64 p = thr->p;
+	const uint32 nbytes = (p + 7)/8, bw = p%n, bits0 = p/n, pow2_fft = (n >> trailz32(n)) == 1;
+	const uint8*x = thr->bytes;
+	double*a = thr->a;
+	int t, bimodn, cy = thr->cy_in;
+	uint32 ii = 0, big, curr_char, rbits, bits[2];
+	uint64 curr_wd64, itmp;
+	bits[0] = bits0;	bits[1] = bits0 + !(MODULUS_TYPE == MODULUS_TYPE_FERMAT && pow2_fft);
+	res_cvt_init_digit(thr->t0, n, p, &bimodn, &ii);
+	curr_char = thr->off0 >> 3;
+	curr_wd64 = (uint64)x[curr_char++] >> (thr->off0 & 7);	rbits = 8 - (thr->off0 & 7);
+	for(t = thr->t0; t < thr->t1; t++) {
+		big = res_cvt_next_digit(t, n, bw, &bimodn, &ii);
+		while(rbits < bits[big]) {	// Grab more bytes of the bytewise residue as needed
+			if(curr_char < nbytes) curr_wd64 += (uint64)x[curr_char] << rbits;
+			curr_char++;	rbits += 8;
+		}
+		itmp = curr_wd64 & ((1ull << bits[big]) - 1);
+		curr_wd64 >>= bits[big];	rbits -= bits[big];
+		/* Add in any carry from the previous digit and normalize result so |current digit| <= base/2: */
+		itmp += cy;
+		cy = (itmp > (1ull << (bits[big]-1)));
+		a[res_cvt_index(t,n)] = (double)((int64)itmp - ((int64)cy << bits[big]));
+	}
+	thr->cy_out = cy;
+	if(thr->t1 == n) {
+		ASSERT(curr_wd64 == 0, "convert_res_bytewise_FP: Nonzero bits above p in bytewise residue!");
+	}
+	return 0x0;
+}
+
+// FP-to-bytewise chunk conversion:
+void*res_cvt_FP_bytewise_chunk(void*targ)
+{
+	struct res_cvt_thread_data_t* thr = targ;
+	const int n = thr->n;
+	const uint64 p = thr->p, s = RES_SHIFT;
+	const uint32 bw = p%n, bits0 = p/n, pow2_fft = (n >> trailz32(n)) == 1;
+	const double*a = thr->a;
+	uint8*x = thr->bytes + (thr->off0 >> 3);
+	int t, bimodn, cy = thr->cy_in;
+	uint32 ii = 0, big, k, rbits, bits[2], q35 = 0, q36 = 0;
+	uint64 curr_wd64 = 0, off = thr->off0, q, v;
+	int64 itmp;
+	double atmp;
+	char cbuf_thr[STR_MAX_LEN];
+	bits[0] = bits0;	bits[1] = bits0 + !(MODULUS_TYPE == MODULUS_TYPE_FERMAT && pow2_fft);
+	res_cvt_init_digit(thr->t0, n, p, &bimodn, &ii);
+	rbits = off & 7;	// Low bits of our first output byte belong to the preceding chunk, leave them 0
+	thr->r35 = thr->r36 = 0ull;
+	if(thr->do_sh) {	// Bit offset of our lowest digit in the unshifted residue:
+		q = (off >= s) ? off - s : off + p - s;
+		q35 = q % 35;	q36 = q % 36;
+	}
+	for(t = thr->t0; t < thr->t1; t++) {
+		big = res_cvt_next_digit(t, n, bw, &bimodn, &ii);
+		atmp = a[res_cvt_index(t,n)];
+		if(atmp != NINT(atmp)) {
+			snprintf(cbuf_thr,STR_MAX_LEN,"convert_res_FP_bytewise: Input float-residue elements must have 0 fractional part! A[%d (of %d)] = %20.10f",res_cvt_index(t,n),n,atmp);
+			ASSERT(0, cbuf_thr);
+		}
+		itmp = (int64)atmp + cy;	/* current digit in int64 form, subtracting any borrow from the previous digit.	*/
+		if(itmp < 0) {			/* If current digit < 0, add the current base and set carry into next-higher digit = -1	*/
+			itmp += (1ll << bits[big]);
+			cy = -1;
+		} else {
+			cy = 0;
+		}
+		ASSERT(itmp >= 0,"convert_res_FP_bytewise: itmp >= 0");
+		v = itmp;
+		curr_wd64 += v << rbits;	rbits += bits[big];
+		while(rbits >= 8) {
+			*x++ = curr_wd64 & 255;	curr_wd64 >>= 8;	rbits -= 8;
+		}
+		// Selfridge-Hurwitz checksums of the unshifted residue, in which the digit at bit [off] sits at bit (off-s) mod p:
+		if(thr->do_sh) {
+			k = bits[big];
+			if(off == s) {	// Digit starts at the shift point, i.e. at bit 0 of the unshifted residue
+				q35 = q36 = 0;
+			} else if(off < s && off + k > s) {	// Digit straddles the shift point: its low (s-off) bits go to the top of the
+				k = s - off;					// unshifted residue, the rest to the bottom
+				res_cvt_sh_accum(v & ((1ull << k) - 1), q35, 35, &thr->r35);
+				res_cvt_sh_accum(v & ((1ull << k) - 1), q36, 36, &thr->r36);
+				v >>= k;	k = bits[big] - k;	q35 = q36 = 0;
 			}
-			a[j1]= (double)itmp;
-			nbits += bits[ii];
+			res_cvt_sh_accum(v, q35, 35, &thr->r35);	q35 += k;	while(q35 >= 35) q35 -= 35;
+			res_cvt_sh_accum(v, q36, 36, &thr->r36);	q36 += k;	while(q36 >= 36) q36 -= 36;
 		}
-	  }
+		off += bits[big];
 	}
+	thr->cy_out = cy;
+	thr->tail = curr_wd64;	thr->tail_bits = rbits;
+	return 0x0;
+}
 
-	ASSERT(curr_char == nbytes, "convert_res_bytewise_FP: curr_char == (p+7)/8");
-	ASSERT(nbits == p    ,"convert_res_bytewise_FP: nbits == p    ");
-	ASSERT(curr_wd64 == 0,"convert_res_bytewise_FP: curr_word == 0");
+/*
+Function to take an n-digit Mersenne or Fermat-mod residue in bytewise savefile form,
+apply the required circular shift read into the global RES_SHIFT during the preceding
+bytewise-savefile read and convert it to balanced-digit floating-point form.
+
+In the Mersenne-mod case the residue digits are stored consecutively in the a[] array.
+
+In the Fermat-mod case the digits are arranged in (j,j+n/2) (i.e. right-angle transform) order.
+*/
+int 	convert_res_bytewise_FP(const uint8 ui64_arr_in[], double a[], int n, const uint64 p)
+{
+	struct res_cvt_thread_data_t *tdat = 0x0;
+	int i,cy,findex,j1,nchunks;
+
+	ASSERT(MODULUS_TYPE,"MODULUS_TYPE not set!");
+	ASSERT(MODULUS_TYPE <= MODULUS_TYPE_MAX,"MODULUS_TYPE out of range!");
+
+	ASSERT(TRANSFORM_TYPE,"TRANSFORM_TYPE not set!");
+	ASSERT(TRANSFORM_TYPE <= TRANSFORM_TYPE_MAX,"TRANSFORM_TYPE out of range!");
+
+	/* Set the number of residue bytes, which is the same for Mersenne (2^p-1) and Fermat-mod (2^p+1, with p = 2^findex)
+	despite the fact the latter can formally be as large as 2^p, since only ever hit that if it`s the last residue of
+	a Pepin test and the number hqppens to be prime. (We would love for that exception to break some other ASSERTion in the code): */
+	if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE)
+	{
+		ASSERT(TRANSFORM_TYPE == REAL_WRAPPER,"convert_res_bytewise_FP: TRANSFORM_TYPE == REAL_WRAPPER");
+	}
+	else if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
+	{
+		ASSERT(TRANSFORM_TYPE == RIGHT_ANGLE,"convert_res_bytewise_FP: TRANSFORM_TYPE == RIGHT_ANGLE");
+		/* If Fermat number, make sure exponent a power of 2: */
+		findex = trailz64(p);
+		ASSERT((p >> findex) == 1,"convert_res_bytewise_FP: (p >> findex) == 1");
+
+		ASSERT(p % 8 == 0,"convert_res_bytewise_FP: p % 8 == 0");
+	}
+	ASSERT(p/n > 1,"convert_res_bytewise_FP: bits[0] > 1");
+	ASSERT(res_cvt_bit_offset(n,n,p) == p, "convert_res_bytewise_FP: nbits == p");
+	// Apply the circular shift:
+	uint32 is_ferm = (MODULUS_TYPE == MODULUS_TYPE_FERMAT);
+	mi64_shlc((uint64*)ui64_arr_in, (uint64*)ui64_arr_in, p, RES_SHIFT, (p+63+is_ferm)>>6, is_ferm);
+
+	/*...Now convert to balanced-digit form, a chunk of digits per thread: */
+	nchunks = res_cvt_chunks(&tdat, a, (uint8*)ui64_arr_in, n, p);
+	for(i = 0, cy = 0; i < nchunks; i++) {
+		tdat[i].cy_in = cy;
+		cy = res_cvt_byte_carry(ui64_arr_in, tdat[i].t0, tdat[i].t1, n, p, cy);
+	}
+	res_cvt_dispatch(res_cvt_bytewise_FP_chunk, tdat, nchunks);
+	for(i = 0; i < nchunks-1; i++) {
+		ASSERT(tdat[i].cy_out == tdat[i+1].cy_in, "convert_res_bytewise_FP: Inter-chunk carry mismatch!");
+	}
+	cy = tdat[nchunks-1].cy_out;
+	free((void *)tdat);	tdat = 0x0;
 
 	/*
 	Fold any carryout from the conversion to balanced-representation form
@@ -5672,9 +6648,10 @@ int 	convert_res_bytewise_FP(const uint8 ui64_arr_in[], double a[], int n, const
 	the modulus from the positive-digit form to get the balanced-digit form):
 	*/
 	/* Should have carryout of +1 Iff MS word < 0; otherwise expect 0 carry: */
+	j1 = res_cvt_index(n-1,n);
 	if(cy && (a[j1] >= 0 || cy != +1))
 	{
-		sprintf(cbuf, "convert_res_bytewise_FP: Illegal combination of nonzero carry = %" PRId64 ", most sig. word = %20.4f\n", cy, a[j]);
+		sprintf(cbuf, "convert_res_bytewise_FP: Illegal combination of nonzero carry = %d, most sig. word = %20.4f\n", cy, a[j1]);
 		ASSERT(0, cbuf);
 	}
 
@@ -5693,6 +6670,8 @@ int 	convert_res_bytewise_FP(const uint8 ui64_arr_in[], double a[], int n, const
 Function to take an n-digit Mersenne or Fermat-mod residue in balanced-digit
 floating-point form, convert it to bytewise form, un-apply circular shift
 stored in the global RES_SHIFT, and (optionally) generate Selfridge-Hurwitz checksums from the result.
+Except in the Fermat-mod case with nonzero shift, where undoing the shift also involves a sign flip,
+Res35m1 and Res36m1 are accumulated by the conversion threads, rather than in 2 more passes over the result.
 
 In the Mersenne-mod case the residue digits are assumed to be stored consecutively in the a[] array.
 
@@ -5704,11 +6683,10 @@ form, use the mi64_cvt_double_uint64() and mi64_cvt_uint64_double() functions in
 */
 void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, const uint64 p, uint64*Res64, uint64*Res35m1, uint64*Res36m1)
 {
-	const char func[] = "convert_res_FP_bytewise";
-	int bimodn,curr_bits,curr_char,cy,findex,ii,j,j1,k,pass,rbits,msw_lt0,bw,sw,bits[2],pow2_fft;
-	uint64 nbits,curr_wd64,base[2];	/* Assume base may be > 2^32 (e.g. for mixed FFT/FGT) but < 2^53, i.e. fits in a double */
+	struct res_cvt_thread_data_t *tdat = 0x0;
+	int i,ii,cy,findex,j,msw_lt0,nchunks,do_sh;
+	uint64 r35 = 0ull, r36 = 0ull;
 	double atmp;
-	int64 itmp;
 	const uint64 two35m1 = (uint64)0x00000007FFFFFFFFull, two36m1 = (uint64)0x0000000FFFFFFFFFull;	/* 2^35,36-1 */
 	uint64*u64_ptr = (uint64*)ui64_arr_out;
 
@@ -5728,21 +6706,7 @@ void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, cons
 		ASSERT(TRANSFORM_TYPE == REAL_WRAPPER,"convert_res_FP_bytewise: TRANSFORM_TYPE == REAL_WRAPPER");
 	else
 		ASSERT(0,"Illegal modulus type!");
-
-	/* Vector length a power of 2? */
-	pow2_fft = (n >> trailz32(n)) == 1;
-
-	bits[0] = p/n;
-	base[0] = 1 << bits[0];
-
-	if(MODULUS_TYPE == MODULUS_TYPE_FERMAT && pow2_fft == TRUE)
-		bits[1] =     bits[0];
-	else
-		bits[1] = 1 + bits[0];
-	base[1] = 1 << bits[1];
-
-	bw = p%n;	/* cf. mers_mod_square.c	*/
-	sw = n - bw;
+	ASSERT(res_cvt_bit_offset(n,n,p) == p, "convert_res_FP_bytewise: nbits == p");
 
 	/*
 	If most-significant digit in the balanced-representation form is < 0, add the modulus to the residue.
@@ -5750,25 +6714,15 @@ void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, cons
 	step (which we do in any event) by simply initializing the carry into the latter to -1 or +1, respectively.
 	In this case we expect the carryout of the normalization loop to = -1, indicating that the MS word has
 	been accordingly normalized during the loop - add an assertion check to that effect.
+	In the Fermat-mod case the sequence-order scan from the top covers the odd-indexed elements (the upper
+	residue half in the right-angle transform data layout) before the even-indexed ones:
 	*/
 	cy=0;		/* init carry.	*/
 	msw_lt0 = 0;
-	atmp = 0.0;	// To make sure the find-most-significant-nonzero-element check below actually finds a nonzero element
-	for(j = n-1; j >= 0; j -= TRANSFORM_TYPE)
+	for(j = n-1; j >= 0; j--)
 	{
-	#ifdef USE_AVX512
-		j1 = (j & mask03) + br16[j&15];
-	#elif defined(USE_AVX)
-		j1 = (j & mask02) + br8[j&7];
-	#elif defined(USE_SSE2)
-		j1 = (j & mask01) + br4[j&3];
-	#else
-		j1 = j;
-	#endif
-		j1 = j1 + ( (j1>> DAT_BITS) << PAD_BITS );	/* padded-array fetch index is here */
-		atmp = a[j1];
+		atmp = a[res_cvt_index(j,n)];
 		if(atmp != 0.0) {
-		//	fprintf(stderr,"convert_res_FP_bytewise: found MSW[%u] = %20.15f, LSW[%u] = %20.15f\n",j,atmp,0,a[0]);
 			if(atmp < 0.0) {
 				msw_lt0 = 1;	/* MS word was < 0 prior to normalization */
 				if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE)
@@ -5779,155 +6733,25 @@ void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, cons
 			break;
 		}
 	}
-	// v18: In Fermat-mod case, if above loop over the odd-indexed elements (the upper residue half
-	// in the right-angle transform data layout) found no nonzero element, try the even-indexed ones:
-	if(atmp == 0.0 && TRANSFORM_TYPE == RIGHT_ANGLE) {
-		for(j = n-2; j >= 0; j -= TRANSFORM_TYPE)
-		{
-		#ifdef USE_AVX512
-			j1 = (j & mask03) + br16[j&15];
-		#elif defined(USE_AVX)
-			j1 = (j & mask02) + br8[j&7];
-		#elif defined(USE_SSE2)
-			j1 = (j & mask01) + br4[j&3];
-		#else
-			j1 = j;
-		#endif
-			j1 = j1 + ( (j1>> DAT_BITS) << PAD_BITS );	/* padded-array fetch index is here */
-			atmp = a[j1];
-			if(atmp != 0.0) {
-			//	fprintf(stderr,"convert_res_FP_bytewise: found MSW[%u] = %20.15f, LSW[%u] = %20.15f\n",j,atmp,0,a[0]);
-				if(atmp < 0.0) {
-					msw_lt0 = 1;	/* MS word was < 0 prior to normalization */
-					if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE)
-						cy = -1;
-					else if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
-						cy = +1;
-				}
-				break;
-			}
-		}
-	}
-
-	/*...Now form the SH residues, converting to positive-digit form along the way...	*/
-
-	curr_char = 0;	/* Current byte to be written to in the ui64_arr_out array */
-	nbits = 0;		/* Total bits accumulated so far in the residue	*/
-	rbits = 0;		/* # of Upper bits left over from processing of previous word	*/
-	curr_wd64 = 0;	/*      Upper bits left over from processing of previous word	*/
 
-	if(TRANSFORM_TYPE == REAL_WRAPPER)
-	{
-		bimodn = 0;
-		ii = 0;		/* Index into the BASE array. */
-		/* If bw > 0 (i.e. n does not divide p), lowest-order digit always a bigword:	*/
-		if(bw > 0)
-			ii = 1;
-
-		for(j = 0; j < n; j++)
-		{
-		#ifdef USE_AVX512
-			j1 = (j & mask03) + br16[j&15];
-		#elif defined(USE_AVX)
-			j1 = (j & mask02) + br8[j&7];
-		#elif defined(USE_SSE2)
-			j1 = (j & mask01) + br4[j&3];
-		#else
-			j1 = j;
-		#endif
-			j1 = j1 + ( (j1>> DAT_BITS) << PAD_BITS );	/* padded-array fetch index is here */
-			atmp = a[j1];
-			if(atmp != NINT(atmp)) {
-				sprintf(cbuf,"%s: Input float-residue elements must have 0 fractional part! A[%u (of %u)] = %20.10f",func,j,n,atmp);
-				ASSERT(0, cbuf);
-			}
-			itmp = (int64)(atmp+ cy);	/* current digit in int64 form, subtracting any borrow from the previous digit.	*/
-			if(itmp < 0) {			/* If current digit < 0, add the current base and set carry into next-higher digit = -1	*/
-				itmp += (base[ii]);
-				cy = -1;
-			} else {
-				cy = 0;
-			}
-			ASSERT(itmp >= 0,"convert_res_FP_bytewise: itmp >= 0");
-
-		/* Update 8-byte residue buffer last, since this one modifies itmp: */
-			ASSERT(rbits < 8,"convert_res_FP_bytewise: rbits < 8");
-			ASSERT(curr_wd64 < (1<<rbits),"convert_res_FP_bytewise: curr_wd64 >= 2^rbits!");
-
-			itmp = (itmp << rbits) + curr_wd64;
-			curr_bits = bits[ii] + rbits;
-
-			rbits = curr_bits;
-			for(k = 0; k < curr_bits/8; k++) {
-				ui64_arr_out[curr_char++] = itmp & 255;
-				itmp = (uint64)itmp>>8;
-				rbits -= 8;
-			}
-			curr_wd64 = (int)itmp;
-
-			nbits += bits[ii];
-
-			bimodn += bw;
-			if(bimodn >= n) bimodn -= n;
-			ii = (uint32)(sw - bimodn) >> 31;
-		}
+	/*...Now convert to positive-digit bytewise form, a chunk of digits per thread, forming the SH residues along the way:	*/
+	do_sh = (Res35m1 || Res36m1) && (MODULUS_TYPE == MODULUS_TYPE_MERSENNE || !RES_SHIFT);
+	nchunks = res_cvt_chunks(&tdat, (double*)a, ui64_arr_out, n, p);
+	for(i = 0; i < nchunks; i++) {
+		tdat[i].cy_in = cy;	tdat[i].do_sh = do_sh;
+		cy = res_cvt_fp_carry(a, tdat[i].t0, tdat[i].t1, n, cy);
 	}
-	else	/* Complex right-angle transform */
-	{
-	  /* For right-angle transform, need to process odd and even-index elements
-	  separately, via a pair of stride-2 passes through the array:
-	  */
-	  for(pass = 0; pass <=1; pass++)
-	  {
-		bimodn = n;
-
-		for(j = pass; j < n; j += 2)
-		{
-			ii = (bimodn > sw);					/*       i = 1 if a bigword,   0 if a smallword */
-			bimodn -= sw;						/* result >= 0 if a bigword, < 0 if a smallword */
-			bimodn += ( ((int)ii-1) & n);		/*       add 0 if a bigword,   N if a smallword */
-		#ifdef USE_AVX512
-			j1 = (j & mask03) + br16[j&15];
-		#elif defined(USE_AVX)
-			j1 = (j & mask02) + br8[j&7];
-		#elif defined(USE_SSE2)
-			j1 = (j & mask01) + br4[j&3];
-		#else
-			j1 = j;
-		#endif
-			j1 = j1 + ( (j1>> DAT_BITS) << PAD_BITS );	/* padded-array fetch index is here */
-			atmp = a[j1];
-			if(atmp != NINT(atmp)) {
-				sprintf(cbuf,"%s: Input float-residue elements must have 0 fractional part! A[%u (of %u) = %20.10f] = ",func,j,n,atmp);
-				ASSERT(0, cbuf);
-			}
-			itmp = (int64)(atmp+ cy);	/* current digit in int64 form, subtracting any borrow from the previous digit.	*/
-			if(itmp < 0) {			/* If current digit < 0, add the current base and set carry into next-higher digit = -1	*/
-				itmp += (base[ii]);
-				cy = -1;
-			} else {
-				cy = 0;
-			}
-			ASSERT(itmp >= 0,"convert_res_FP_bytewise: itmp >= 0");
-
-		/* Update 8-byte residue buffer last, since this one modifies itmp: */
-			ASSERT(rbits < 8,"convert_res_FP_bytewise: rbits < 8");
-			ASSERT(curr_wd64 < (1<<rbits),"convert_res_FP_bytewise: curr_wd64 >= 2^rbits!");
-
-			itmp = (itmp << rbits) + curr_wd64;
-			curr_bits = bits[ii] + rbits;
-
-			rbits = curr_bits;
-			for(k = 0; k < curr_bits/8; k++) {
-				ui64_arr_out[curr_char++] = itmp & 255;
-				itmp = (uint64)itmp>>8;
-				rbits -= 8;
-			}
-			curr_wd64 = (int)itmp;
-			nbits += bits[ii];
-		}
-	  }
+	res_cvt_dispatch(res_cvt_FP_bytewise_chunk, tdat, nchunks);
+	// Merge the partial bytes shared by adjacent chunks, and the SH partial sums:
+	for(i = 0; i < nchunks; i++) {
+		if(i < nchunks-1) {
+			ASSERT(tdat[i].cy_out == tdat[i+1].cy_in, "convert_res_FP_bytewise: Inter-chunk carry mismatch!");
+			ASSERT(tdat[i].tail_bits == (tdat[i+1].off0 & 7), "convert_res_FP_bytewise: Inter-chunk bit offset mismatch!");
+			ui64_arr_out[tdat[i+1].off0 >> 3] |= tdat[i].tail;
+		}
+		r35 += tdat[i].r35 % two35m1;	r36 += tdat[i].r36 % two36m1;
 	}
+	cy = tdat[nchunks-1].cy_out;
 	/* Should have carryout of -1 Iff MS word < 0; otherwise expect 0 carry: */
 	if(cy && (!msw_lt0 || cy != -1))
 	{
@@ -5935,15 +6759,12 @@ void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, cons
 		ASSERT(0, cbuf);
 	}
 	/* Residue should contain ceiling(p/8) bytes: */
-	ASSERT(rbits < 8, "rbits >= 8");
-	if(rbits) {
-		ASSERT(curr_wd64 < (1<<rbits),"convert_res_FP_bytewise: curr_wd64 >= 2^rbits!");
-		ui64_arr_out[curr_char++] = curr_wd64 & 255;
-		curr_wd64 >>= 8;
+	if(tdat[nchunks-1].tail_bits) {
+		ASSERT(tdat[nchunks-1].tail_bits == (p & 7),"convert_res_FP_bytewise: rbits == p%8");
+		ASSERT(tdat[nchunks-1].tail < (1<<(p & 7)),"convert_res_FP_bytewise: curr_wd64 >= 2^rbits!");
+		ui64_arr_out[p>>3] = tdat[nchunks-1].tail;
 	}
-	ASSERT(curr_char == (p+7)/8,"convert_res_FP_bytewise: curr_char == (p+7)/8");
-	ASSERT(nbits == p          ,"convert_res_FP_bytewise: nbits == p          ");
-	ASSERT(curr_wd64 == 0      ,"convert_res_FP_bytewise: curr_wd64 == 0      ");
+	free((void *)tdat);	tdat = 0x0;
 
 	// Remove the circular shift ... have no mi64_shrc function, so use that b-bit rightward cshift equivalent to (p-b)-bit left-cshift.
 	// (But must guard against RES_SHIFT = 0, since in that case the left-shift count == p and mi64_shlc requires shift count strictly < p):
@@ -5952,6 +6773,8 @@ void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, cons
 	must omit said high limb in residue-shift-and-sign-flip below, hence no p+63+(MODULUS_TYPE == MODULUS_TYPE_FERMAT):
 	***/
 	j = (p+63)>>6;	// # of 64-bit limbs
+	// Zero the bits of the top limb above the residue, which are not written by the conversion:
+	for(i = (p+7)>>3; i < (j<<3); i++) { ui64_arr_out[i] = 0; }
 	if(RES_SHIFT) {
 	//	fprintf(stderr,"convert_res_FP_bytewise: removing shift = %" PRIu64 "\n",RES_SHIFT);
 		uint32 sign_flip = (MODULUS_TYPE == MODULUS_TYPE_FERMAT);
@@ -5966,8 +6789,13 @@ void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, cons
 	}
 	/* Checksums: */
 	if(Res64  ) *Res64 = ((uint64*)ui64_arr_out)[0];
-	if(Res35m1) *Res35m1 = mi64_div_by_scalar64((uint64*)ui64_arr_out,two35m1,j,0x0);
-	if(Res36m1) *Res36m1 = mi64_div_by_scalar64((uint64*)ui64_arr_out,two36m1,j,0x0);
+	if(do_sh) {
+		if(Res35m1) *Res35m1 = r35 % two35m1;
+		if(Res36m1) *Res36m1 = r36 % two36m1;
+	} else {
+		if(Res35m1) *Res35m1 = mi64_div_by_scalar64((uint64*)ui64_arr_out,two35m1,j,0x0);
+		if(Res36m1) *Res36m1 = mi64_div_by_scalar64((uint64*)ui64_arr_out,two36m1,j,0x0);
+	}
 //	fprintf(stderr,"Res35m1,Res36m1: %" PRIu64 ",%" PRIu64 "\n",*Res35m1,*Res36m1);
 }
 
@@ -5984,33 +6812,20 @@ void res_SH(uint64 a[], uint32 len, uint64*Res64, uint64*Res35m1, uint64*Res36m1
 /*********************/
 uint32 get_default_factoring_depth(uint64 p)
 {
-/* Sample: here's how to set things to factor to a constant k-depth: */
-#if 1
+/* Sample: here's how to set things to factor to a constant k-depth:
 	const uint32 KMAX_BITS = 40;
 	return (uint32) ceil(log(1.0*p)/log(2.0)) + 1 + KMAX_BITS;
-
-#else
-
-	uint32 qbitsmax;
-/* These default depths are designed to match those of Prime95 v24, as described here:
-	https://www.mersenneforum.org/showthread.php?t=4213
-**** To-do: reverse order, add cases for > pmax, < pmin *****/
-	     if(p <=23390000)
-		qbitsmax = 66;
-	else if(p > 23390000)	/* k ~= 40.5 bits */
-		qbitsmax = 66;
-	else if(p > 29690000)
-		qbitsmax = 67;
-	else if(p > 37800000)
-		qbitsmax = 68;
-	else if(p > 47450000)
-		qbitsmax = 69;
-	else if(p > 58520000)
-		qbitsmax = 70;
-	else if(p > 75670000)
-		qbitsmax = 71;
-	else if(p > 96830000)	/* k ~= 44.5 bits at the starting value of p*/
-		qbitsmax = 72;
+*/
+	/* These default depths are designed to match those of Prime95, as described here:
+		https://www.mersenneforum.org/showthread.php?t=4213
+	The table lists the p at which each further bit becomes worthwhile, starting from 52 bits for p <= 301000: */
+	static const uint32 pbreak[] = {
+		301000,400000,600000,745000,1000000,1480000,1930000,2360000,2950000,3960000,5160000,6515000,8250000,13380000,
+		23390000,29690000,38300000,48800000,60940000,77910000,96830000,120000000,153400000,199500000,253500000,
+		322100000,408400000,516800000,662000000,842000000,1071000000,0};
+	uint32 i, qbitsmax;
+	for(i = 0; pbreak[i] && p > pbreak[i]; i++) {}
+	qbitsmax = 52 + i;
 
 	/* If it's hardware on which factoring (at least my implementation) is slow, allow 64 bits max: */
   #if defined(INTEGER_MUL_32)
@@ -6019,9 +6834,6 @@ uint32 get_default_factoring_depth(uint64 p)
   #endif
 
 	return qbitsmax;
-#endif
-
-
 }
 
 /*********************/
@@ -6438,6 +7250,10 @@ uint32 extract_known_factors(uint64 p, char*fac_start) {
 
 /*********************/
 
+// In GMP-enabled builds, set nonzero to cross-check each raw GMP GCD against the mi64 half-GCD used when INCLUDE_GMP = 0:
+#ifndef GCD_CHECK_NATIVE
+	#define GCD_CHECK_NATIVE	0
+#endif
 /*
 If p != 0 (this requires vec2 == 0x0):
 	For (MODULUS_TYPE == MODULUS_TYPE_[FERMAT|MERSENNE]), take GCD of 2^p[+|-]1 and nlimb resarr[],
@@ -6450,10 +7266,81 @@ The decimal value of the GCD is returned in gcd_str, presumed to be dimensioned
 */
 uint32 gcd(uint32 stage, uint64 p, uint64*vec1, uint64*vec2, uint32 nlimb, char*const gcd_str) {
 #if !INCLUDE_GMP
-	#warning INCLUDE_GMP defined == 0 at compile time ... No GCDs will be done on p-1 outputs.
-	snprintf(cbuf,STR_MAX_LEN*2,"INCLUDE_GMP defined == 0 at compile time ... No GCD will be done.\n");
+	// Sans GMP, use the mi64 half-GCD. Output-message logic mirrors that of the GMP-based version below:
+	uint64 *mvec = 0x0, *gvec = 0x0, *qvec = 0x0, *rvec = 0x0;
+	uint32 i, glen, gsize, ndig = 0, idx, retval = 0;
+	uint64 sz1,sz2;
+	double tdiff = 0.0, clock1, clock2;
+	clock1 = getRealTime();
+	ASSERT(vec1 != 0x0, "Null-pointer vec1 input to GCD()!");
+	ASSERT(!(p && vec2), "One and only one of p and vec2 args to GCD() must be non-null!");
+	// gvec,qvec,rvec get nlimb words each; mvec gets an extra word to hold 2^p prior to the -1 in the Mersenne case:
+	gvec = (uint64 *)calloc(4*nlimb+1, sizeof(uint64));	ASSERT(gvec != 0x0, "alloc failed!");
+	qvec = gvec + nlimb;	rvec = qvec + nlimb;
+	if(p != 0) {
+		ASSERT(nlimb == (p + 63 + (MODULUS_TYPE == MODULUS_TYPE_FERMAT))>>6, "Bad inputs to GCD()!");
+		mvec = rvec + nlimb;
+		mvec[p>>6] = 1ull << (p&63);
+		if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE)	// 2^p-1:
+			mi64_sub_scalar(mvec,1ull,mvec,nlimb+1);
+		else if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)// F(m): p holds 2^m, so F(m) = 2^p+1:
+			mi64_add_scalar(mvec,1ull,mvec,nlimb);
+	} else {
+		mvec = vec2;
+	}
+	sz1 = (nlimb<<6) - mi64_leadz(vec1,nlimb);
+	sz2 = (nlimb<<6) - mi64_leadz(mvec,nlimb);
+	// Take gcd and return in gvec:
+	glen = mi64_gcd_dc(vec1,mvec,nlimb,gvec);
+	gsize = (nlimb<<6) - mi64_leadz(gvec,nlimb);
+	if(gsize < 2) {
+		goto gcd_return;	// GCD = 0 or 1
+	} else {
+		if(KNOWN_FACTORS[0]) fprintf(stderr,"Raw GCD has %u bits ... dividing out any known factors...\n",gsize);
+		for(i = 0; i < 40; i += 4) {	// Current limit = 10 factors, each stored in a 4-limb field, i.e. < 2^256
+			if(!KNOWN_FACTORS[i])
+				break;
+			if(mi64_div(gvec,KNOWN_FACTORS+i, glen,4, qvec,rvec))	// This known factor divides the GCD; replace the latter with the quotient:
+				mi64_set_eq(gvec,qvec,glen);
+		}
+	}
+	// Recompute bitlength of GCD
+	gsize = (nlimb<<6) - mi64_leadz(gvec,nlimb);
+	if(gsize < 2)
+		goto gcd_return;	// GCD = 0 or 1
+	// Now the base-10 digit count - anything >= 900 digits (~90% the value of our STR_MAX_LEN dimensioning of I/O strings)
+	// treated as suspect. 2990 bits ~= 900 digits, larger GCDs must be rejected before the decimal conversion overflows:
+	if(gsize < 2990) {
+		idx = convert_mi64_base10_char(gcd_str,gvec,glen,0);	// Decimal string is right-justified; left-justify it
+		memmove(gcd_str, gcd_str + idx, strlen(gcd_str + idx) + 1);
+		ndig = strlen(gcd_str);
+	} else {
+		ndig = (uint32)ceil(gsize*0.30102999566398119521);
+	}
+	if(ndig >= 900) {
+		snprintf(cbuf,STR_MAX_LEN*2, "GCD has %u digits -- possible data corruption, aborting.\n",ndig);
+		mlucas_fprint(cbuf,0); ASSERT(0,cbuf);
+	}
+	retval = 1;
+gcd_return:
+	if(!p) {
+		if(!retval) {	// GCD = 0 or 1, not yet converted to decimal
+			idx = convert_mi64_base10_char(gcd_str,gvec,nlimb,0);
+			memmove(gcd_str, gcd_str + idx, strlen(gcd_str + idx) + 1);
+		}
+		snprintf(cbuf,STR_MAX_LEN*2,"GCD(A[%" PRIu64 " bits], B[%" PRIu64 " bits]) = %s\n",sz1,sz2,gcd_str);
+	} else if(retval) {
+		snprintf(cbuf,STR_MAX_LEN*2,"Found %u-digit factor in Stage %u: %s\n",ndig,stage,gcd_str);
+	} else {	// Caller can use either return value or empty gcd_str as proxy for "no factor found"
+		gcd_str[0] = '\0';
+		snprintf(cbuf,STR_MAX_LEN*2,"Stage %u: No factor found.\n",stage);
+	}
 	mlucas_fprint(cbuf,1);
-	return 0;	// If user turns off p-1 support, keep the decl of gcd() to allow pm1.c to build
+	clock2 = getRealTime(); tdiff = clock2 - clock1;
+	snprintf(cbuf,STR_MAX_LEN*2,"Time for GCD =%s\n",get_time_str(tdiff));
+	mlucas_fprint(cbuf,1);
+	free((void *)gvec);	gvec = qvec = rvec = 0x0;
+	return retval;
 #else
 	// Unlike standard types and Mlucas internal structs, GMP objects must be declared before any expressions,
 	// else GCC emits "error: a label can only be part of a statement and a declaration is not a statement":
@@ -6485,6 +7372,21 @@ uint32 gcd(uint32 stage, uint64 p, uint64*vec1, uint64*vec2, uint32 nlimb, char*
 	sz2 = mpz_sizeinbase(gmp_arr2,2);// gmp_printf("Input2 has %" PRIu64 " bits\n",sz2);
 	// Take gcd and return in gmp_arr1:
 	mpz_gcd(gmp_arr1, gmp_arr1,gmp_arr2);
+  #if GCD_CHECK_NATIVE
+	// Cross-check the raw GCD against the GMP-free mi64 half-GCD which is used in INCLUDE_GMP = 0 builds:
+	{
+		uint64 *mvec = (uint64 *)calloc(3*nlimb+1, sizeof(uint64)), *gvec = mvec + nlimb+1, *tvec = gvec + nlimb;
+		ASSERT(mvec != 0x0, "alloc failed!");
+		mpz_export(mvec, &gmp_size, -1, sizeof(uint64), 0, 0, gmp_arr2);	ASSERT(gmp_size <= nlimb, "Bad GCD input!");
+		mi64_gcd_dc(vec1,mvec,nlimb,gvec);
+		mpz_export(tvec, &gmp_size, -1, sizeof(uint64), 0, 0, gmp_arr1);
+		if(!mi64_cmp_eq(gvec,tvec,nlimb)) {
+			snprintf(cbuf,STR_MAX_LEN*2,"GCD: mi64_gcd_dc result mismatches GMP one!\n");
+			mlucas_fprint(cbuf,0); ASSERT(0,cbuf);
+		}
+		free((void *)mvec);	mvec = gvec = tvec = 0x0;
+	}
+  #endif
 	gmp_size = mpz_sizeinbase(gmp_arr1,2);
 	if(gmp_size < 2) {
 		goto gcd_return;	// GCD = 0 or 1
@@ -6548,9 +7450,21 @@ GMP mod-inverse; arglist as for mpz_gcd but also returns int:
 */
 void modinv(uint64 p, uint64*vec1, uint64*vec2, uint32 nlimb) {
 #if !INCLUDE_GMP
-	#warning INCLUDE_GMP defined == 0 at compile time ... No MODINV support.
-	// If user turns off p-1 support, keep the decl of modinv() to allow pm1.c to build
-	mi64_clear(vec2,nlimb);	// Return 0
+	// Sans GMP, use the extended form of the mi64 half-GCD:
+	uint64 *mvec = 0x0;
+	ASSERT(vec1 != 0x0 && vec2 != 0x0, "Null-pointer input to MODINV()!");
+	ASSERT((p != 0) && (nlimb == (p + 63 + (MODULUS_TYPE == MODULUS_TYPE_FERMAT))>>6), "Bad inputs to MODINV()!");
+	mvec = (uint64 *)calloc(nlimb+1, sizeof(uint64));	ASSERT(mvec != 0x0, "alloc failed!");
+	mvec[p>>6] = 1ull << (p&63);
+	if(MODULUS_TYPE == MODULUS_TYPE_MERSENNE)	// 2^p-1:
+		mi64_sub_scalar(mvec,1ull,mvec,nlimb+1);
+	else if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)// F(m): p holds 2^m, so F(m) = 2^p+1:
+		mi64_add_scalar(mvec,1ull,mvec,nlimb);
+	if(!mi64_modinv_dc(vec1,mvec,nlimb,vec2)) {
+		snprintf(cbuf,STR_MAX_LEN*2,"MODINV: Fatal error: inverse does not exist.\n");
+		mlucas_fprint(cbuf,0); ASSERT(0,cbuf);
+	}
+	free((void *)mvec);	mvec = 0x0;
 #else
 	// Unlike standard types and Mlucas internal structs, GMP objects must be declared before any expressions,
 	// else GCC emits "error: a label can only be part of a statement and a declaration is not a statement":
@@ -6664,6 +7578,98 @@ uint32 filegrep(const char*fname, const char*find_str, char*cstr, uint32 find_be
 	else return 0;
 }
 
+/*********************/
+// Interim-residue files hold one "[PSTRING] [test] [iteration] [Res64]" line per entry, e.g. "M166013 LL 100000 1F82AF80A5AD9E11",
+// with [test] = LL, Pepin or PRP-[base]. Appends an entry for the current modulus to file fname; returns 1 on success, 0 on failure:
+int interim_res64_write(const char*fname, const char*test_str, uint32 iter, uint64 res64)
+{
+	int retval;
+	FILE*fptr = mlucas_fopen(fname,"a");
+	if(!fptr)
+		return 0;
+	retval = (fprintf(fptr,"%s %s %u %016" PRIX64 "\n",PSTRING,test_str,iter,res64) > 0);
+	fclose(fptr);
+	return retval;
+}
+
+// Looks up the Res64 for the current modulus, the given test type and iteration in interim-residue file fname. If there are
+// multiple entries for the iteration (e.g. the run writing the file restarted from an earlier savefile) the last one is used.
+// Returns 1 and the value in *res64 if found, 0 if not, including the case of no such file:
+int interim_res64_lookup(const char*fname, const char*test_str, uint32 iter, uint64*res64)
+{
+	char pstr[STR_MAX_LEN], tstr[STR_MAX_LEN], rstr[STR_MAX_LEN];
+	uint32 i;
+	int found = 0;
+	FILE*fptr = mlucas_fopen(fname,"r");
+	if(!fptr)
+		return 0;
+	while(fgets(in_line, STR_MAX_LEN, fptr)) {
+		if(sscanf(in_line,"%s %s %u %s",pstr,tstr,&i,rstr) != 4 || i != iter)
+			continue;
+		if(strcmp(pstr,PSTRING) || strcmp(tstr,test_str) || strlen(rstr) != 16)
+			continue;
+		*res64 = strtoull(rstr, 0x0, 16);	found = 1;
+	}
+	fclose(fptr);
+	return found;
+}
+
+#if INCLUDE_TF
+/*********************/
+// Rewrites the TF_BITS field - the one following the exponent, as in Test=[aid,]p,TF_BITS,pm1_done and
+// Factor=[aid,]p,TF_BITS[,bits_todo] - of the current (first) assignment of the worktodo file, which must be for
+// exponent estring. Returns 1 on success, 0 if no such assignment was found, leaving the file as-is in that case:
+int update_tf_bits(const char*estring, uint32 tf_bits)
+{
+	int found = 0;
+	char *char_addr, *cptr, *tail;
+	FILE*fp = mlucas_fopen(WORKFILE,"r"), *fq;
+	if(!fp)
+		return 0;
+	fq = mlucas_fopen("WINI.TMP", "w");
+	if(!fq) {
+		fclose(fp); fp = 0x0;
+		return 0;
+	}
+	while(fgets(in_line, STR_MAX_LEN, fp)) {
+		for(char_addr = in_line; isspace(*char_addr); char_addr++) {}
+		if(!found && isalpha(*char_addr)) {
+			found = -1;	// First assignment line: 1 if its TF_BITS field gets updated, -1 otherwise
+			if((char_addr = strstr(in_line, "=")) != 0x0) {
+				char_addr++;
+				while(isspace(*char_addr)) { ++char_addr; }
+				if(is_hex_string(char_addr, 32))
+					char_addr += 33;
+				else if(STREQN_NOCASE(char_addr,"n/a",3))
+					char_addr += 4;
+				if(strtoull(char_addr, &cptr, 10) == strtoull(estring, 0x0, 10)) {
+					if(*cptr == ',') {
+						strtoul(++cptr, &tail, 10);
+						snprintf(cstr,STR_MAX_LEN,"%u%s",tf_bits,tail);
+					} else	// No TF_BITS field yet, e.g. a bare Factor=p - append one:
+						snprintf(cstr,STR_MAX_LEN,",%u\n",tf_bits);
+					*cptr = '\0';	strcat(in_line, cstr);
+					found = 1;
+				}
+			}
+		}
+		fputs(in_line, fq);
+	}
+	fclose(fp); fp = 0x0;
+	fclose(fq); fq = 0x0;
+	if(found != 1) {
+		remove("WINI.TMP");
+		return 0;
+	}
+	remove(WORKFILE);
+	if(rename("WINI.TMP", WORKFILE)) {
+		sprintf(cbuf,"ERROR: unable to rename WINI.TMP file ==> %s.\n",WORKFILE);
+		ASSERT(0,cbuf);
+	}
+	return 1;
+}
+#endif
+
 /*********************/
 
 void write_fft_debug_data(double a[], int jlo, int jhi)
@@ -30,6 +30,8 @@
 #include "carry.h"
 #include "dft_macro.h"
 #include "factor.h"
+#include "mstatus.h"
+#include "perfctr.h"
 #include "prefetch.h"
 #include "util.h"
 
@@ -38,14 +40,17 @@
 #endif
 
 // Builder to override these (or not) via compile flag:
-#define INCLUDE_TF	0	// Auto-TF-dispatch not supported
+#ifndef INCLUDE_TF
+	#define INCLUDE_TF	0	// Auto-TF-dispatch of Factor= assignments and of Test= ones with TF still due; needs factor.o in the link
+#endif
 #define INCLUDE_ECM	0	// ECM not supported
 #ifndef INCLUDE_GMP
 	#define INCLUDE_GMP	1	// v20: Make INCLUDE_GMP = TRUE the default:
 #endif
+// INCLUDE_GMP = 0 builds take p-1 GCDs and modular inverses via the mi64_gcd_dc and mi64_modinv_dc half-GCD
+// routines; those are several times slower than GMP's at multi-million-digit sizes but remove the dependency:
 #if INCLUDE_GMP
 	#include <gmp.h>
-//	#include "gcd_lehmer.h"	// v20: Use GMP GCD, own-rolled n (log n)^2 one simply not in the cards.
 #endif
 
 /**** HWLOC-header include is in util.h ****/
@@ -92,13 +97,20 @@ uint32	Suyama_CF_PRP(uint64 p, uint64*Res64, uint32 nfac, double a[], double b[]
 	int n, int scrnFlag, double *tdiff, char*const gcd_str);
 int		test_types_compatible(uint32 t1, uint32 t2);
 int		 read_ppm1_residue(const uint32 nbytes, FILE*fp,       uint8 arr_tmp[],       uint64*Res64,       uint64*Res35m1,       uint64*Res36m1);
-void	write_ppm1_residue(const uint32 nbytes, FILE*fp, const uint8 arr_tmp[], const uint64 Res64, const uint64 Res35m1, const uint64 Res36m1);
+int		write_ppm1_residue(const uint32 nbytes, const uint32 blksize, FILE*fp, const uint8 arr_tmp[]);
 int		 read_ppm1_savefiles(const char*fname, uint64 p, uint32*kblocks, FILE*fp, uint64*ilo, uint8 arr1[], uint64*Res64, uint64*Res35m1, uint64*Res36m1, uint8 arr2[], uint64*i1, uint64*i2, uint64*i3);
-void	write_ppm1_savefiles(const char*fname, uint64 p,          int n, FILE*fp, uint64 ihi, uint8 arr1[], uint64 Res64, uint64 Res35m1, uint64 Res36m1, uint8 arr2[], uint64 i1, uint64 i2, uint64 i3);
+int		write_ppm1_savefiles(const char*fname, uint64 p,          int n,          uint64 ihi, uint8 arr1[], uint64 Res64, uint64 Res35m1, uint64 Res36m1, uint8 arr2[], uint64 i1, uint64 i2, uint64 i3);
+int		read_ppm1_nsquares(const char*fname, FILE*fp, uint64*nsquares);
+int		fft_length_roe_probe(uint64 p, int n, double a[], uint64 arr_scratch[], int scrnFlag);
+int		bench_radix_set(uint64 p, int n, double a[], uint64 arr_scratch[], uint32 niter, int scrnFlag);
+int		bench_radix(uint32 kblocks, uint32 iters);
 int		convert_res_bytewise_FP(const uint8 ui64_arr_in[], double a[], int n, const uint64 p);
 void	convert_res_FP_bytewise(const double a[], uint8 ui64_arr_out[], int n, const uint64 p, uint64*Res64, uint64*Res35m1, uint64*Res36m1);
 void	res_SH(uint64 a[], uint32 len, uint64*Res64, uint64*Res35m1, uint64*Res36m1);
 uint32	get_default_factoring_depth(uint64 p);
+#if INCLUDE_TF
+int		update_tf_bits(const char*estring, uint32 tf_bits);
+#endif
 // Sets function pointers for DIF|DIT pass1 based on value of radix0:
 void dif1_dit1_func_name(
 	const int radix0,
@@ -110,6 +122,8 @@ uint32	gcd(uint32 stage, uint64 p, uint64*vec1, uint64*vec2, uint32 nlimb, char*
 void	modinv(uint64 p, uint64*vec1, uint64*vec2, uint32 nlimb);
 int		restart_file_valid(const char*fname, const uint64 p, uint8*arr1, uint8*arr2);
 uint32	filegrep(const char*fname, const char*find_str, char*cstr, uint32 find_before_line_number);
+int		interim_res64_write (const char*fname, const char*test_str, uint32 iter, uint64 res64);
+int		interim_res64_lookup(const char*fname, const char*test_str, uint32 iter, uint64*res64);
 void	write_fft_debug_data(double a[], int jlo, int jhi);
 
 /* pm1.c: */
@@ -133,9 +147,11 @@ void	bit_reverse_int(int vec[], int n, int nradices, int radix[], int incr, int*
 
 /* get_fft_radices.c: */
 int		get_fft_radices			(uint32 kblocks, int radix_set, uint32 *nradices, uint32 radix_vec[], int radix_vec_dim);
+int		fft_radix_set_is_blocked(uint32 kblocks, int radix_set);
 void	test_fft_radixtables	(void);
 uint32	get_default_fft_length	(uint64 p);
 uint32	get_nextlarger_fft_length	(uint32 n);
+uint32	get_nextsmaller_fft_length	(uint32 n);
 uint64	given_N_get_maxP		(uint32 n);
 
 /* get_preferred_fft_radix.c: */
@@ -89,6 +89,28 @@ To build the sieve factoring code in standalone mode, see the compile instructio
 
 	#include "threadpool.h"
 
+	// Pipelined mode (cf. TF_PIPELINE in factor.h): ring buffers via which the sieve threads pass candidates to the modpow threads:
+	#if TF_PIPELINE
+		#define TF_PIPE_CHUNK	1024	// #k's per ring slot; must be a multiple of TRYQ
+		#define TF_PIPE_SLOTS	8		// #slots per ring; must be a power of 2
+		struct tf_chunk_t {
+			uint32 n;		// #k's in the chunk
+			uint32 kidx;	// tf_kernel_tab[] index of the modpow kernel of the sweep which produced them
+			uint32 upass;	// If != -1, the checkpoint unit containing [upass, usweep] is done once the chunk is tested,
+			uint64 usweep, ucount;	// and had ucount candidates
+			uint64 k[TF_PIPE_CHUNK];
+		};
+		// Lock-free ring of chunks, with a single producer - the sieve thread owning the ring - and at most one consumer
+		// at a time, the latter enforced by the consumer-side 'claim' trylock. head and tail are free-running counts of the
+		// chunks pushed and popped, each written only by its own side, and kept in separate cache lines:
+		struct tf_ring_t {
+			uint32 head;	char pad0[60];
+			uint32 tail;	char pad1[60];
+			pthread_mutex_t claim;
+			struct tf_chunk_t slot[TF_PIPE_SLOTS];
+		};
+	#endif
+
 	struct fac_thread_data_t{
 		uint64*count;	// Put function-return value for unthreaded here
 		int tid;	// Thread ID
@@ -130,19 +152,85 @@ To build the sieve factoring code in standalone mode, see the compile instructio
 		int    MODULUS_TYPE;
 		const char  *VERSION;
 		const char  *OFILE;
+		// Class-granular dispatch: tf_class_worker() claims passes via *next_pass until it exceeds passmax,
+		// setting up the above pass-specific fields (pass, interval_lo, incr, kstart, bit_map) from these:
+		uint32*next_pass;
+		uint32 passnow;
+		uint32 passmax;
+		uint64 kmin;
+		uint64 know;
+		uint32*pass_incr;	// Absolute k-increments of the TF_PASSES classes
+		uint64*bit_atlas;
+		uint32 map_words;	// #64-bit words in each sievelet
+	#if TF_PIPELINE
+		struct tf_ring_t*ring;	// Pipelined mode: ring into which PerPass_tfSieve queues the candidates; 0x0 = test them itself
+		double t_wait;			// Pipelined mode: time the current pass spent waiting on a full ring
+	#endif
 	};
+	static pthread_mutex_t tf_pass_mutex = PTHREAD_MUTEX_INITIALIZER;	// Guards *next_pass
+	static pthread_mutex_t mutex_mi64    = PTHREAD_MUTEX_INITIALIZER;	// Serializes the non-thread-safe factor-candidate spot-checks and found-factor processing
+  #if TF_PIPELINE
+	static uint32 tf_pipeline = FALSE;		// Set via -pipeline
+	static struct tf_ring_t *tf_ring = 0x0;	// NTHREADS rings, ring i only ever produced into by thread i
+	// #threads assigned to sieving, and #sieving passes in progress; sieve-thread wait and modpow-thread idle time accumulated
+	// since the last sieve/modpow ratio update, and time of that update. All guarded by tf_pass_mutex:
+	static uint32 tf_pipe_nsieve, tf_pipe_nbusy;
+	static double tf_pipe_twait, tf_pipe_tidle, tf_pipe_tlast;
+  #endif
 #endif
 
-// GPU and legacy-CPU version uses [p,k] (mod 60) classes, leading to 16 passes;
-// in a manycore setting we will want to compile-time -DTF_CLASSES=4620 to keep all the threads busy:
-#if defined(USE_GPU) || !defined(TF_CLASSES) || (TF_CLASSES != 4620)
-	#define TF_CLASSES	60
-	#define TF_PASSES	16
-	#define TF_CLSHIFT	6
-#else	// 4620 = 60*7*11 classes, leading to 960 passes: for CPU-builds targeting manycore architectures
-	#define TF_CLASSES	4620
-	#define TF_PASSES	960
-	#define TF_CLSHIFT	12
+// GPU and legacy-CPU version used [p,k] (mod 60) classes, leading to 16 passes, with 4620 classes only available
+// via compile-time -DTF_CLASSES=4620. The class modulus is now set at runtime, either via the -classes flag or based
+// on the thread count and k-range (tf_select_classes), so a compile-time TF_CLASSES value merely sets the default:
+#ifdef TF_CLASSES
+	#define TF_CLASSES_DEFAULT	TF_CLASSES
+	#undef  TF_CLASSES
+#elif defined(USE_GPU)
+	#define TF_CLASSES_DEFAULT	60
+#else
+	#define TF_CLASSES_DEFAULT	0	// 0 = select at runtime
+#endif
+#define TF_PASSES_MAX	960		// #passes for the largest supported modulus, 4620
+#define TF_UTIL_MIN_PCT	90		// Min. thread utilization (in %) needed to stop tf_select_classes() at a given modulus
+
+/* Supported class moduli NC = 4*[product of small odd primes], with the multiples of those small primes and the
+q == +-3 (mod 8) candidates excluded up front, leaving TF_PASSES = (NC/2)*prod((pr-1)/pr) passes. TF_CLSHIFT is
+set so that NC divides the per-interval k-range, (sieve length)*2^TF_CLSHIFT, and the resulting per-class sievelet
+has a cache-friendly 150-300 Kbits; 60 and 420 also have 64*sieve_len divisible by NC:
+*/
+static const uint32 tf_class_tab[3][3] = {
+	{  60,  16,  6},	// 255255*2^ 6/  60 = 272272 bits per sievelet
+	{ 420,  96,  8},	// 255255*2^ 8/ 420 = 155584 bits
+	{4620, 960, 12}		// 255255*2^12/4620 = 226304 bits
+};
+static uint32 TF_CLASSES = 0, TF_PASSES = 0, TF_CLSHIFT = 0;
+static uint32 tf_classes_fixed = FALSE;	// Set if user fixed the class count via -classes or pass bounds
+
+/* Binary checkpoint (cf. tf_ckpt_write()): Each pass (i.e. k-class) is split into nseg k-segments of seg_sweeps sieve
+sweeps each, and the checkpoint holds a bitmap of the completed (pass, segment) units, plus the run bounds, #q tried and
+the k's of the factors found so far. Units get marked done as their last candidate is tested, so a restart of a many-
+threaded run only redoes the units which were in progress. All fields guarded by tf_ckpt_mutex in multithreaded builds:
+*/
+#define TF_CKPT_MAGIC	0x6b63464du	// "MFck" in little-endian byte order
+#define TF_CKPT_VERSION	1
+#define TF_CKPT_NSEG	64		// Max. #k-segments per pass
+#define TF_CKPT_MAXFAC	64		// Max. #factor k's saved
+#define TF_CKPT_SECS	10		// Min. interval between checkpoint writes, in seconds
+static struct {
+	char fname[STR_MAX_LEN];	// Checkpoint file; nseg = 0 means checkpointing not active
+	char pstring[STR_MAX_LEN];
+	uint32 tf_passes, passmin, passmax, nseg;
+	double bmin, bmax;
+	uint64 kmin, kmax, sweep_lo, sweep_hi, seg_sweeps, count;
+	uint32 nfac, dirty;
+	uint64 fac_k[TF_CKPT_MAXFAC];
+	uint64 done[TF_PASSES_MAX*TF_CKPT_NSEG/64];	// Bit (pass*nseg + seg) set when unit done
+	double tlast;	// Time of last write
+} tf_ckpt;
+#ifdef MULTITHREAD
+	static pthread_mutex_t tf_ckpt_mutex = PTHREAD_MUTEX_INITIALIZER;
+	static pthread_t tf_ckpt_thread;	// Background checkpoint writer
+	static uint32 tf_ckpt_stop;
 #endif
 
 #ifdef	USE_FMADD	// Need to add 100-bit modpow routines before enabling this for build of this file
@@ -208,8 +296,19 @@ int restart;
 
 #endif
 
+/* Bucket sieving of the primes > sievelet length (see PerPass_tfSieve), with the sieve depth tuned at runtime.
+Only in the scalar bit-clear code - the AVX-512 build keeps its vectorized loop over all primes, and DBG_SIEVE
+needs each prime's startval[] updated every sweep:
+*/
+#if !defined(USE_GPU) && !defined(USE_AVX512) && !DBG_SIEVE
+	#define TF_BUCKET_SIEVE	1
+#else
+	#define TF_BUCKET_SIEVE	0
+#endif
+
 /* Adjust the # of sieving primes to reflect that modmul cost
 goes up very quickly with increasing # of 64-bit words in q.
+Where TF_BUCKET_SIEVE = 1 this is just the ceiling on the runtime-tuned sieve depth, hence the larger defaults.
 
 Note that the total allocated memory for the sieve is roughly (17 bytes * NUM_SIEVING_PRIME).
 
@@ -234,18 +333,24 @@ allocated will likely need slightly more than 4GB of working memory with such a
 	#elif(defined(P3WORD))	/* 3-word P: */
 		#ifdef FAC_DEBUG
 			#define NUM_SIEVING_PRIME	10000
+		#elif TF_BUCKET_SIEVE
+			#define NUM_SIEVING_PRIME	1000000
 		#else
 			#define NUM_SIEVING_PRIME	500000
 		#endif
 	#elif(defined(P2WORD))	/* 2-word P: */
 		#ifdef FAC_DEBUG
 			#define NUM_SIEVING_PRIME	10000
+		#elif TF_BUCKET_SIEVE
+			#define NUM_SIEVING_PRIME	1000000
 		#else
 			#define NUM_SIEVING_PRIME	200000
 		#endif
 	#else	/* 1-word P limit is set by #of bits p can have so 120^2*p < 2^64: */
 		#if defined(FAC_DEBUG) || defined(USE_GPU)
 			#define NUM_SIEVING_PRIME	10000
+		#elif TF_BUCKET_SIEVE
+			#define NUM_SIEVING_PRIME	1000000
 		#else
 			#define NUM_SIEVING_PRIME	100000
 		#endif
@@ -256,6 +361,11 @@ allocated will likely need slightly more than 4GB of working memory with such a
 	#error NUM_SIEVING_PRIME exceeds 32-bit-primes-set limit of 203280220!
 #endif
 
+#if TF_BUCKET_SIEVE
+	// Runtime-tuned max. sieving prime, shared by all passes of the current run; 0 = not yet tuned, use all nprime primes:
+	static uint32 tf_sieve_pmax = 0;
+#endif
+
 /*...Known Mersenne prime exponents. This array must be null-terminated.	*/
 const uint32 knowns[] = {2,3,5,7,13,17,19,31,61,89,107,127,521,607,1279,2203,2281,3217,4253,4423,9689,9941
 	,11213,19937,21701,23209,44497,86243,110503,132049,216091,756839,859433,1257787,1398269,2976221,3021377,6972593
@@ -533,6 +643,13 @@ Unlike for (mod 60), use simple utility functions to manage these, rather than a
 		To-Do: Add support for PIPELINE_MUL256
 
 	NWORD - Arbitrary-length p and q, only restriction is that (as for all other size ranges) kmax < 2^64 .
+
+	TF_DISPATCH - default for integer-modmul builds with TRYQ = 4 or 8 (see factor.h): the above word-size flags then
+	only set the p and q size limits and sieve depth, and the modpow kernel for each sieve sweep is picked at runtime
+	from the twopmodq63|64|65|78|96|128_96|128|192|256 and mi64 families, based on the q-size of the sweep and a
+	startup calibration of the kernels able to handle the q-range of the run. Thus an NWORD build covers all q-sizes
+	in a single binary, while still using the fast fixed-width kernels wherever p and q fit. Build with -DTF_DISPATCH=0
+	to instead use the compile-time kernel choice.
 */
 
 /*********************************************************************************************************************************/
@@ -545,18 +662,26 @@ Unlike for (mod 60), use simple utility functions to manage these, rather than a
 	#error FAC_DEBUG only permitted in standalone mode!
   #endif
 
+/* Mlucas-integrated TF, called from the assignment loop in Mlucas.c for builds with INCLUDE_TF = 1: Trial-factors
+M(pstring) over the factor range [2^bmin, 2^bmax], using the NTHREADS and CPU set of the Mlucas run. Uses the same
+code as the standalone main() below, minus the command-line parsing; restart-file handling is the same, that is,
+an interrupted run for the same bounds is resumed from the t[pstring] savefile. Returns the number of factors found.
+*/
 int factor(char *pstring, double bmin, double bmax)
 {
-	ASSERT(0, "TF currently not supported as part of Mlucas, only via standalone Mfactor build - please delete any .o files and retry USING 'makemake.sh mfac' from Mluas dir above /src.");
-	return 1;
-}
+	static int first_entry = TRUE;
 
-#else	// Standalone build - we leave some FACTOR_STANDALONE-wrapped stuff inside code below for future Mlucas integration
+	/*...file pointer	*/
+	FILE *fp = 0x0, *fq = 0x0;
+
+#else	// Standalone build
 
 int main(int argc, char *argv[])
 {
 	static int first_entry = TRUE;
 
+#endif
+
   #ifdef FACTOR_STANDALONE
 
 	/*...file pointer	*/
@@ -571,6 +696,12 @@ int main(int argc, char *argv[])
 	const char OFILE  [] = "results.txt";	/* ASCII logfile containing factors found and/or
 											final factoring-run result ONLY for each assignment */
 	double bmin = 0.0, bmax = 0.0;	/* store log2 of (min|max) factoring bound */
+	// Batch mode: name of worklist file of Factor= assignments, #assignments done, and start time of the batch:
+	char worklist[STR_MAX_LEN] = "";
+	uint32 nassign = 0;
+	double batch_time = 0.0;
+	// Kernel-benchmark mode: name of output file, empty if not a benchmark run:
+	char benchfile[STR_MAX_LEN] = "";
   #endif
 
   #ifdef MULTITHREAD
@@ -583,7 +714,7 @@ int main(int argc, char *argv[])
 	static int task_is_blocking = TRUE;
 	static thread_control_t thread_control = {0,0,0};
 	// First 3 subfields same for all threads, 4th provides thread-specifc data, will be inited at thread dispatch:
-	static task_control_t   task_control = {NULL, (void*)PerPass_tfSieve, NULL, 0x0};
+	static task_control_t   task_control = {NULL, (void*)tf_class_worker, NULL, 0x0};
 
   #endif
 
@@ -593,7 +724,8 @@ int main(int argc, char *argv[])
 	uint32	findex = 0, nbits_in_p = 0, nbits_in_q = 0, lenP = 0, lenQ = 0, bits_in_pq2 = 0;
 	double fbits_in_2p = 0;
 	uint64	*factor_ptmp = 0x0, *factor_k = 0x0;	/* Use this array to store the factor k's (assumed < 2^64) of any factors found. */
-	uint64	*p = 0x0, *two_p = 0x0, *p2NC = 0x0, *q = 0x0, *q2 = 0x0, *k_to_try = 0x0;
+	uint64	*p = 0x0, *two_p = 0x0, *p2NC = 0x0, *q = 0x0, *q2 = 0x0;
+	static uint64 *k_to_try = 0x0;	// Alloc'ed once, on first entry
 
   #ifndef TRYQ
 	#define TRYQ	1
@@ -620,7 +752,10 @@ int main(int argc, char *argv[])
 	#error TRYQ exceeds MAX_TRYQ for this build mode!
   #endif
 
-	int nargs,itmp;
+  #ifdef FACTOR_STANDALONE
+	int nargs;
+  #endif
+	int itmp;
 	/* pdsum stores the sums needed for the base (%30 == 0) candidate of each length-30 interval;
 	pdiff stores the diffs/2 of these absolute offsets, circularly shifted to the right one place,
 	since to update we need diff[j] = curr_p(current) - curr_p(previous) = (pdsum[j] - pdsum[j-1])/2,
@@ -628,38 +763,34 @@ int main(int argc, char *argv[])
 	*/
 	uint32 itmp32, pdiff_8[8] = {2,1,2,1,2,3,1,3}, pdsum_8[8] = { 0, 2, 6, 8,12,18,20,26};
 	uint64 itmp64;
-	uint32 pmodNC,kmodNC,incr[TF_PASSES];
+	uint32 pmodNC,kmodNC,incr[TF_PASSES_MAX];
 	uint64 two64modp;
 	uint32 bit,curr_p,i,ihi,m,ncopies,qmod8,regs_todo;
 	uint32 l,i64,nfactor,word;
 	uint32 nprime = NUM_SIEVING_PRIME;	/* Don't make this const, in case we need to reduce it to satisfy MAX_SIEVING_PRIME < (q_min = 2*p+1) */
+	uint32 nprime_tab, max_sieving_prime_tab;	// Size and largest prime of the shared table, of which each run uses the first nprime
 	uint32 f2psp_idx = 0;	/* Index to next-expected Fermat base-2 pseudoprime in the precomputed table */
 
 	/* LEN is the number of 64-bit words in our sieving bitmap. Successive
 	bits of the sieve bitmap correpond to successive factor k-values, with bit 0
 	corresponding to the smallest possible factor, k = 1 (note the unit-offset!)
-	In practice, this full-sized sieve is split into 16 smaller (i.e. hopefully
+	In practice, this full-sized sieve is split into TF_PASSES smaller (i.e. hopefully
 	cache-sized) "sievelets", each of which contains bits corresponding to
-	successive k's from one of the 16 allowable (k mod TF_CLASSES) families for the given
-	exponent p (more specifically, the given (p mod TF_CLASSES) value.) Both full-length
-	sieve and 1/16-th length sievelets share the property that each time we run
-	through the bits of onesuch we run through 64*LEN worth of k's.
+	successive k's from one of the TF_PASSES allowable (k mod TF_CLASSES) families for the given
+	exponent p (more specifically, the given (p mod TF_CLASSES) value.) Each time we run
+	through the bits of a sievelet we run through LEN*2^TF_CLSHIFT worth of k's.
 	*/
 	const uint32 nclear=6, len = 3*5*7*11*13*17;	// LEN = product of first NCLEAR odd primes [= 255255],
 	const uint32 p_last_small = 17;					// p_last_small = largest prime appearing in the product [= 17].
 	uint32 prime[] = {3,5,7,11,13,17};	// Also need the first [nclear] odd primes - since 'const' is treated as a read-only flag
 								// on *variables*, use [] instead of [nclear] to avoid compiler 'variable-length array init' errors.
-  #if TF_CLASSES == 60
-	const uint32 bit_len = (len << TF_CLSHIFT)/TF_CLASSES; 	// 255255*64  /  60 = 272272: Number of bits in each of the  16 mod-  60 sievelets
-  #else	// 4620 classes:
-	const uint32 bit_len = (len << TF_CLSHIFT)/TF_CLASSES;	// 255255*64^2/4620 = 226304: Number of bits in each of the 960 mod-4620 sievelets
-  #endif
+	uint32 bit_len = 0;	// #bits in each sievelet = (len << TF_CLSHIFT)/TF_CLASSES, set once the class count is known
 	//   bits cleared of multiples of 3,5,7,11,13, 17 and q mod 8 = +-1 are here:
 	uint64 *temp_late = 0x0;		/* Even though we know how large to make this, it's only needed
 									for data inits, so we calloc it at runtime and free it later. */
 	uint32 on_bits = 0;
 	uint64 *bit_map, *bit_map2, *bit_atlas = 0x0;
-	uint32 pass = 0xffffffff, passmin = 0, passnow = 0, passmax = TF_PASSES-1;
+	uint32 passmin = 0, passnow = 0, passmax = 0xffffffff, pass_bounds_set = FALSE;	// passmax default is TF_PASSES-1, set once that is known
 	uint64 count = 0,countmask,j,k,kmin = 0,kmax = 0,know = 0,kplus = 0;
 	uint32 CMASKBITS;	// This is set at runtime based on the operand sizes, but treat as read-only subsequently.
 
@@ -711,7 +842,7 @@ int main(int argc, char *argv[])
   #else	// Multithreaded needs wall-clock, not CPU time:
 	double clock1, clock2;	// Jun 2014: Switched to getRealTime() code
   #endif
-	double td, tdiff;
+	double td, tdiff, dtmp;
 
   #if TEST_TRIALDIV
 	double citer;
@@ -742,7 +873,7 @@ int main(int argc, char *argv[])
 
 /* Allocate factor_k array and align on 16-byte boundary: */
 	factor_ptmp = ALLOC_UINT64(factor_ptmp, 24);
-	factor_k = ALIGN_UINT64(factor_ptmp);	factor_ptmp = 0x0;
+	factor_k = ALIGN_UINT64(factor_ptmp);
 	ASSERT(((uint64)factor_k & 0x3f) == 0, "factor_k not 64-byte aligned!");
 
 /*...initialize logicals and factoring parameters...	*/
@@ -759,7 +890,7 @@ int main(int argc, char *argv[])
 ********** Mfactor command line options: **********
 
 REQUIRED:
-		* One (and ONLY one) of -m|mm|f, followed by a valid numerical exponent;
+		* One (and ONLY one) of -m|mm|f, followed by a valid numerical exponent, or -worklist;
 		* One (and ONLY one) of -bmax|kmax, unless it's a restart, i.e. a valid checkpoint file
 			for the number in question exists. Iff -bmax|kmax specified, an optional lower-bound
 			argument -bmin|kmin may also be specified, which must not exceed the upper bound.
@@ -785,6 +916,14 @@ Others are optional and in some cases mutually exclusive:
 			NOTE:
 				* Fermat number Trial-factoring not currently supported (future release.)
 
+	-worklist [string]  Batch mode: trial-factor the Mersenne numbers of all the Factor=[AID,]p,bmin,bmax lines of
+				the named file (the same format as used by Prime95 and Mlucas worktodo files) in turn.
+			NOTES:
+				* Disallows -m|mm|f and all -b|k|pass bounds options; a fixed -classes and -nthread apply to all runs.
+				* The sieving-prime tables, threadpool and modpow-kernel timings are set up just once for the batch.
+				* Each run writes its results and savefile as usual; its line is deleted from the worklist once
+				  done, so an interrupted batch picks up where it left off when restarted.
+
 	-bmin [float] Log2(min factor to try), in floating form (>= 0, default = 0).
 	-bmax [float] Log2(max factor to try), in floating form ( < 64*NWORDS).
 			NOTES:
@@ -807,8 +946,10 @@ Others are optional and in some cases mutually exclusive:
 				 and (old kmax) + (kplus) serves as kmax for the new run.
 
 	-passmin [int]  Maximum factoring pass for the run (0-TF_PASSES-1, default =  0).
-	-passmax [int]  Maximum factoring pass for the run (0-TF_PASSES-1, default = 15).
+	-passmax [int]  Maximum factoring pass for the run (0-TF_PASSES-1, default = TF_PASSES-1).
 			NOTE:
+				* Pass numbers refer to the class modulus of the run, which is 60 (16 passes)
+				 if either of these is given without -classes.
 				* If passmin|max from a previous run of the number in question found
 				 in a checkpoint file and those pass bounds conflict with the ones
 				 given via the command line, an error message is printed and the
@@ -819,8 +960,24 @@ Others are optional and in some cases mutually exclusive:
 				 saved from previous runs with their current command line and modify
 				 one or the other so as to remove any pass-range conflicts.
 
+	-classes [int]  Number of [p,k] classes, TF_CLASSES = 60, 420 or 4620, giving TF_PASSES = 16, 96 or 960
+				passes, respectively. If not set, the smallest modulus keeping all threads busy is used,
+				subject to the k-range being large enough to fill at least one sieve interval per pass.
+
+	-bench [string]  Benchmark the modpow kernels (TF_DISPATCH builds only): time each kernel single-threaded at each
+				q-size in [2^bmin, 2^bmax), with bmin|bmax set via -bmin|bmax (default 48 and 256), check it against
+				the fac_test_dat*.h known factors and write the results to the named file (default mfactor_bench.csv),
+				in JSON form if the name ends in .json, else CSV.
+			NOTE:
+				* Disallows -m|mm|f, -worklist and all -k|pass bounds options.
+
 	-q [int]    A known factor for the number (only used if FAC_DEBUG def'd).
 */
+	// Class count gets set anew for each run; any compile-time TF_CLASSES serves as default:
+	TF_CLASSES = TF_PASSES = TF_CLSHIFT = 0;	tf_classes_fixed = FALSE;
+	if(TF_CLASSES_DEFAULT)
+		ASSERT(!tf_set_classes(TF_CLASSES_DEFAULT), "Unsupported compile-time TF_CLASSES value: must be one of 60, 420 or 4620.");
+
   #ifdef FACTOR_STANDALONE
 
 	nargs = 1;
@@ -858,6 +1015,12 @@ Others are optional and in some cases mutually exclusive:
 			MODULUS_TYPE = MODULUS_TYPE_FERMAT;
 		}
 
+		/* Batch mode - process all Factor= assignments in the given worklist file: */
+		else if(STREQ(stFlag, "-worklist"))
+		{
+			strncpy(worklist, argv[nargs++], STR_MAX_LEN);
+		}
+
 		/* Factor bounds, in log2(qmin/qmax) (floating double) form: */
 		else if(STREQ(stFlag, "-bmin"))
 		{
@@ -924,14 +1087,25 @@ Others are optional and in some cases mutually exclusive:
 		{
 			strncpy(stFlag, argv[nargs++], STR_MAX_LEN);
 			passmin = (uint32)convert_base10_char_uint64(stFlag);
-			ASSERT(passmin < TF_PASSES,"factor.c: passmin < TF_PASSES");
+			pass_bounds_set = TRUE;	// Pass bounds are checked vs TF_PASSES once the class count is known
 		}
 		else if(STREQ(stFlag, "-passmax"))
 		{
 			strncpy(stFlag, argv[nargs++], STR_MAX_LEN);
 			passmax = (uint32)convert_base10_char_uint64(stFlag);
-			ASSERT(passmax < TF_PASSES,"factor.c: passmax < TF_PASSES");
-			ASSERT(passmax >= passmin       ,"factor.c: passmax >= passmin");
+			pass_bounds_set = TRUE;
+		}
+
+		// Number of [p,k] classes:
+		else if(STREQ(stFlag, "-classes"))
+		{
+			strncpy(stFlag, argv[nargs++], STR_MAX_LEN);
+			itmp = (uint32)convert_base10_char_uint64(stFlag);
+			if(tf_set_classes(itmp)) {
+				fprintf(stderr,"*** ERROR: Unsupported -classes value %u: must be one of 60, 420 or 4620.\n",itmp);
+				goto MFACTOR_HELP;
+			}
+			tf_classes_fixed = TRUE;
 		}
 
 		// Number of threads to use?
@@ -943,18 +1117,39 @@ Others are optional and in some cases mutually exclusive:
 			NTHREADS = 1;
 		#else
 			itmp = (uint32)convert_base10_char_uint64(stFlag);
-			if(itmp > TF_PASSES) {
-				fprintf(stderr, "factor.c: Specifed #nthreads [%u] > TF_PASSES [%u] ... using just %u threads.\n",itmp,TF_PASSES,TF_PASSES);
-				NTHREADS = TF_PASSES;
+			if(itmp > TF_PASSES_MAX) {
+				fprintf(stderr, "factor.c: Specifed #nthreads [%u] > max. #passes [%u] ... using just %u threads.\n",itmp,TF_PASSES_MAX,TF_PASSES_MAX);
+				NTHREADS = TF_PASSES_MAX;
 			} else if(itmp < 1) {
 				fprintf(stderr, "factor.c: Specifed #nthreads [%u] < minimum of 1 ... running 1-threaded.\n",itmp);
 				NTHREADS = 1;
 			} else {
 				NTHREADS = itmp;
 			}
-		  #ifdef NWORD
-			ASSERT(NTHREADS == 1, "Arbitrary-precision build currently only supports single-threaded runs!");
-		  #endif
+		#endif
+		}
+
+		// Pipelined mode, with separate sieve and modpow threads?
+		else if(STREQ(stFlag, "-pipeline"))
+		{
+		#if !TF_PIPELINE
+			fprintf(stderr,"Pipelined mode needs a multithreaded build with runtime modpow-kernel dispatch; ignoring -pipeline argument.\n");
+		#else
+			tf_pipeline = TRUE;
+		#endif
+		}
+
+		// Modpow-kernel benchmark, with optional output filename:
+		else if(STREQ(stFlag, "-bench"))
+		{
+		#if !TF_DISPATCH
+			fprintf(stderr,"*** ERROR: -bench needs a build with runtime modpow-kernel dispatch.\n");
+			goto MFACTOR_HELP;
+		#else
+			if(argv[nargs] && argv[nargs][0] != '-')
+				strncpy(benchfile, argv[nargs++], STR_MAX_LEN);
+			else
+				strcpy(benchfile, TF_BENCH_FILE);
 		#endif
 		}
 		else	// Come again?
@@ -964,6 +1159,15 @@ Others are optional and in some cases mutually exclusive:
 			goto MFACTOR_HELP;
 		}
 	}
+	// In batch mode the exponent and bounds of each run come from the worklist:
+	if(STRNEQ(worklist,"") && (STRNEQ(pstring,"") || bmin || bmax || kmin || kmax || kplus || pass_bounds_set)) {
+		fprintf(stderr,"*** ERROR: -worklist disallows -m|mm|f and all factor- and pass-bounds options.\n");
+		goto MFACTOR_HELP;
+	}
+	if(STRNEQ(benchfile,"") && (STRNEQ(pstring,"") || STRNEQ(worklist,"") || kmin || kmax || kplus || pass_bounds_set)) {
+		fprintf(stderr,"*** ERROR: -bench allows only -bmin|bmax, to set the range of q-sizes to be timed.\n");
+		goto MFACTOR_HELP;
+	}
 
   #else
 
@@ -988,6 +1192,7 @@ Others are optional and in some cases mutually exclusive:
 		ASSERT(NTHREADS == 1, "NTHREADS must == 1 in single-threaded mode!");
 		k_to_try = (uint64 *)calloc(TRYQ * NTHREADS, sizeof(uint64));
 	#else
+	  #ifdef FACTOR_STANDALONE
 		MAX_THREADS = get_num_cores();
 		ASSERT(MAX_THREADS > 0, "Illegal #Cores value stored in MAX_THREADS");
 		ASSERT(MAX_THREADS <= MAX_CORES,"MAX_THREADS exceeds the MAX_CORES setting in Mdata.h .");
@@ -1007,11 +1212,15 @@ Others are optional and in some cases mutually exclusive:
 		}
 		sprintf(cbuf,"0:%d",NTHREADS-1);
 		parseAffinityString(cbuf);
+	  #else
+		// Mlucas has already set NTHREADS and the core affinities based on its -cpu|-nthread|-core arguments:
+		ASSERT(NTHREADS > 0 && MAX_THREADS > 0, "Mlucas threadcount not set!");
+	  #endif
 		k_to_try = (uint64 *)calloc(TRYQ * NTHREADS, sizeof(uint64));
 
 		// Up to TF_PASSES work units (perhaps fewer if a restart) get done by a pool of NTHREADS threads.  Yypically have
 		// NTHREADS <= TF_PASSES, i.e. pool threads get reassigned a fresh work unit as they complete their current one.
-		// We do the || work in discrete (endpoint-sync'ed) 'waves' of NTHREADS each, thus need only that many thread-data allocs:
+		// Each of the NTHREADS pool tasks loops over passes (cf. tf_class_worker), thus need only that many thread-data allocs:
 		if(tdat) {
 			free((void *)tdat); tdat = 0x0;	// Not sure if we might ever have occasion to realloc here, but easy enough to set up for it
 		}
@@ -1027,6 +1236,9 @@ Others are optional and in some cases mutually exclusive:
 		// Apr 2015: Init-calls to any inline-asm-using modpow functions:
 		int thr_id = -1;
 		twopmodq96_q4(0ull, 0ull, 0ull, 0ull, 0ull, NTHREADS, thr_id);
+	  #if TF_DISPATCH
+		twopmodq96_q8(0ull, 0ull,0ull,0ull,0ull,0ull,0ull,0ull,0ull, NTHREADS, thr_id);
+	  #endif
 	  #ifdef USE_SSE2
 		twopmodq78_3WORD_DOUBLE_q2 (0ull, 0ull,0ull, NTHREADS, thr_id);
 		twopmodq78_3WORD_DOUBLE_q4 (0ull, 0ull,0ull,0ull,0ull, NTHREADS, thr_id);
@@ -1042,9 +1254,13 @@ Others are optional and in some cases mutually exclusive:
 	#endif
 	}	// End (inits)
 
-/* Do a quick series of self-tests: */
-  #if 1//def FAC_DEBUG
+/* Do a quick series of self-tests - in Mlucas builds, Mlucas_init() does these at program start: */
+  #ifdef FACTOR_STANDALONE
 	test_fac();
+   #if TF_DISPATCH
+	if(STRNEQ(benchfile,""))
+		return (tf_kernel_bench(VERSION, bmin, bmax, benchfile) != 0);
+   #endif
   #endif
 
 // Oct 2015: GCD-associated self-tests provides a fair bit of added coverage of the mi64 library, so always include:
@@ -1054,723 +1270,787 @@ Others are optional and in some cases mutually exclusive:
 exit(0);
   #endif
 
-	/* Make sure a valid exponent string has been given - if this is the only
-	command-line parameter, will attempt to read the other needed run parameters
-	from the corresponding checkpoint file:
-	*/
-	ASSERT(STRNEQ(pstring,""),"factor.c : pstring empty!");
-
-	/* -bmin/bmax used to set bounds for factoring: */
-	if(bmin || bmax) {
-		ASSERT((kmin==0 && kmax==0 && kplus==0),"(kmin==0 && kmax==0 && kplus==0)");
-
-		if(bmin < 0) {
-			fprintf(stderr,"ERROR: log2(min factor) must be >= 0. Offending entry = %lf.\n", bmin);		ASSERT(0,"0");
-		} else if(bmin >= MAX_BITS_Q) {
-			fprintf(stderr,"ERROR: log2(min factor) exceeds allowable limit of %u. Offending entry = %lf.\n", MAX_BITS_Q, bmin);	ASSERT(0,"0");
-		}
-
-		if(bmax <= 0) {
-			fprintf(stderr,"ERROR: log2(max factor) must be > 0. Offending entry = %lf.\n", bmax);		ASSERT(0,"0");
-		} else if(bmax > MAX_BITS_Q) {
-			fprintf(stderr,"ERROR: log2(max factor) exceeds allowable limit of %u. Offending entry = %lf.\n", MAX_BITS_Q, bmax);	ASSERT(0,"0");
-		}
-
-		if(bmax < bmin) {
-			fprintf(stderr,"ERROR: (bmax = %lf) < (bmin = %lf)!\n", bmax, bmin);	ASSERT(0,"0");
-		}
-	}
-
-	/* -kmin/kmax used to set bounds for factoring: */
-	if(kmin || kmax) {
-		ASSERT(kmax != 0 ,"factor.c: kmax not set!");
-		ASSERT((int64)kmax > 0, "kmax must be 63 bits or less!");
-		ASSERT((bmin==0 && bmax==0 && kplus==0),"(bmin==0 && bmax==0 && kplus==0)");
+/*****************************************************/
+/************** SIEVING-PRIME TABLES: ****************/
+/*****************************************************/
 
-		if(kmax < kmin) {
-			fprintf(stderr,"ERROR: (kmax = %s) < (kmin = %s)!\n", &char_buf0[convert_uint64_base10_char(char_buf0, kmax)], &char_buf1[convert_uint64_base10_char(char_buf1, kmin)]);
-			ASSERT(0,"0");
-		}
+	/* The small-prime difference table and the per-thread sieve-startval arrays do not depend on the exponent, thus
+	are set up just once, before the first assignment. For small p the table gets truncated on a per-exponent basis
+	to satisfy MAX_SIEVING_PRIME < (q_min = 2*p+1), by way of the nprime and MAX_SIEVING_PRIME values used by the run:
+	*/
+	ASSERT(NUM_SIEVING_PRIME > 0, "factor.c : NUM_SIEVING_PRIME > 0");
+  #ifdef USE_AVX512	// Use vector-int math and gather-load/scatter-store to accelerate the bit-clearing
+	psmall = (uint32 *)calloc(NUM_SIEVING_PRIME * NTHREADS, sizeof(uint32));
+	if (psmall == NULL) {
+		fprintf(stderr,"Memory allocation failure for PSMALL array");
+		ASSERT(0,"0");
 	}
+  #endif
 
-	ASSERT(bmax > 0.0 || kmax != 0 ,"factor.c: One of bmax or kmax must be set!");
-
-	ASSERT((MODULUS_TYPE == MODULUS_TYPE_MERSENNE)
-			  || (MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
-			  || (MODULUS_TYPE ==   MODULUS_TYPE_FERMAT)
-				, "Unsupported modulus type!");
-
-	lenQ = ((uint32)MAX_BITS_Q + 63)>>6;	// This sets upper bound on #words needed to store max. factor candidate
-
-	// Convert power-of-2 exponent to unsigned int form and allocate the exponent-storage vector.
-	// We use MAX_BITS_P (defined in Mdata.h) to set the allocated storage here, but use the user-set
-	// exponent to set the number of words of that allocated storage which are actually used:
-	if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
-	{
-		findex = convert_base10_char_uint64(pstring);
-		nbits_in_p = findex+1;
-		lenP = (nbits_in_p + 63)>>6;
-		p     = (uint64 *)calloc( ((uint32)MAX_BITS_P + 63)>>6, sizeof(uint64));
-		p[0] = 1;	mi64_shl(p,p,findex,lenP);	// p = (uint64)1 << findex;
-	}
-	else if(MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
-	{
-		findex = convert_base10_char_uint64(pstring);	// This var was really named as abbreviation of "Fermat index", but re-use for MMp
-		nbits_in_p = findex;
-		if(findex > 1000) {	// Large MMp need deeper sieving on each k passing the default sieve
-			kdeep = (uint32 *)calloc( 1024, sizeof(uint32));
-			ASSERT(kdeep != 0x0, "Calloc of kdeep[] failed!");
-		}
-		lenP = (nbits_in_p + 63)>>6;
-		p     = (uint64 *)calloc( ((uint32)MAX_BITS_P + 63)>>6, sizeof(uint64));
-		p[0] = 1;	mi64_shl(p,p,findex,lenP);
-		mi64_sub_scalar(p,1,p,lenP);	// p = 2^findex - 1;
-	#ifdef FAC_DEBUG
-		printf("%s(%s) = M(p) with p = %s\n", NUM_PREFIX[MODULUS_TYPE], pstring, &char_buf0[convert_mi64_base10_char(char_buf0, p, lenP, 0)]);
-	#endif
-	} else {
-		// Convert stringified exponent to mi64 form, using same #limbs as for factor candidates:
-		p = convert_base10_char_mi64(pstring, &lenQ);	// This does the mem-alloc for us in this case
-		lenP = mi64_getlen(p, lenQ); ASSERT(lenP > 0, "factor.c: Error converting pstring!");
-		nbits_in_p = (lenP<<6) - mi64_leadz(p, lenP);
+	pdiff = (uint8 *)calloc(NUM_SIEVING_PRIME * NTHREADS, sizeof(uint8));
+	if (pdiff == NULL) {
+		fprintf(stderr,"Memory allocation failure for pdiff array");
+		ASSERT(0,"0");
 	}
 
-	// Allocate the other modulus-dependent vectors:
-	two_p   = (uint64 *)calloc(lenQ, sizeof(uint64));
-	p2NC    = (uint64 *)calloc(lenQ, sizeof(uint64));
-	q       = (uint64 *)calloc(lenQ * NTHREADS, sizeof(uint64));
-	q2      = (uint64 *)calloc(lenQ * NTHREADS, sizeof(uint64));
-	u64_arr = (uint64 *)calloc(lenQ * NTHREADS, sizeof(uint64));
-
-	// Now use the just-allocated vector storage to compute how many words are really needed for qmax.
-	// Since the sieving always proceeds in full passes through the bit-cleared sieve, the actual kmax used
-	// may be up to (len*64)-1 larger than the user-specified kmax:
-	if(kmax) {
-		interval_hi = (uint64)ceil( (double)kmax / ((uint64)len << TF_CLSHIFT) );	// Copied from restart-file code below
-		// Actual kmax used at runtime = interval_hi*(len << TF_CLSHIFT);
-		u64_arr[lenP] = mi64_mul_scalar( p, 2*interval_hi*(len << TF_CLSHIFT), u64_arr, lenP);
-		lenQ = lenP + (u64_arr[lenP] != 0);
-	} else {
-		lenQ = ( (uint32)(ceil(bmax)) + 63 ) >> 6;
+	startval = (uint32 *)calloc(NUM_SIEVING_PRIME * NTHREADS, sizeof(uint32));
+	if (startval == NULL) {
+		fprintf(stderr,"Memory allocation failure for STARTVAL array");
+		ASSERT(0,"0");
 	}
 
-	// Mersenne numbers must have odd (check primality further on) exponents:
-	if((MODULUS_TYPE != MODULUS_TYPE_FERMAT) && (p[0] & 1) == 0)
-    {
-		fprintf(stderr,"p must be odd! Offending p = %s\n", pstring); ASSERT(0,"0");
+	pinv = (uint32 *)calloc(NUM_SIEVING_PRIME, sizeof(uint32));
+	if (pinv == NULL) {
+		fprintf(stderr,"Memory allocation failure for PINV array");
+		ASSERT(0,"0");
 	}
 
-	/* For purposes of the bits-in-p limit, treat Fermat numbers as having 2^findex rather than 2^findex + 1 bits: */
-	if((nbits_in_p - (MODULUS_TYPE == MODULUS_TYPE_FERMAT)) > MAX_BITS_P)
-	{
-		fprintf(stderr,"p too large - limit is %u bits. Offending p = %s\n", MAX_BITS_P, pstring);
+  #if DBG_SIEVE
+	startval_incr = (uint32 *)calloc(NUM_SIEVING_PRIME, sizeof(uint32));
+	if (startval_incr == NULL) {
+		fprintf(stderr,"Memory allocation failure for STARTVAL_INCR array");
 		ASSERT(0,"0");
 	}
-	// To track lg(q) = lg(2.k.p+1), use approximation q ~= 2.k.p, thus lg(q) ~= lg(2.p) + lg(k).
-	fbits_in_2p = (double)mi64_extract_lead64(p, lenP, &itmp64) - 64;
-//printf("fbits_in_2p = mi64_extract_lead64[= %10u] - 64 = %10.4f\n",mi64_extract_lead64(p, lenP, &itmp64),fbits_in_2p);
-	fbits_in_2p += log((double)itmp64)*ILG2 + 1;	// Add 1 to lg(p) to get lg(2p)
-//printf("fbits_in_2p += log((double)itmp64)*ILG2 [= %10.4f] = %10.4f\n",log((double)itmp64)*ILG2,fbits_in_2p);
-  #if 0	// 11/2013: No clue what I was thinking here...
-	// If 2p < 2^64 we left-justify the leading bits to make result lie in [2^63, 2^64), so result here must always be > 2^63:
-	ASSERT(fbits_in_2p >= 63, "fbits_in_2p out of range!");
-	fbits_in_2p += nbits_in_p - 64.0;	// lg(2.p) ... Cast 64 to double to avoid signed-int subtract of RHS terms.
   #endif
-	// Do some quick sanity tests of exponent for the various kinds of moduli:
-	if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
-	{
-		ASSERT(findex == mi64_trailz(p, lenP), "Internal Fermat-exponent bad power of 2!");
-		mi64_shrl(p, q, findex, lenP,lenP);
-		mi64_sub_scalar(q, 1ull, q, lenP);
-		ASSERT(mi64_iszero(q, lenP), "Internal Fermat-exponent not a power of 2!");
-	}
-	else
-	{
-		// For M(M(p)), make sure the M(p) is actually prime:
-		if(MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
-		{
-			for(i=0; knowns[i] != 0; i++)
-			{
-				if(findex == knowns[i]) { break; }
-			}
-			ASSERT((knowns[i] != 0), "Double-Mersenne exponent not a known Mersenne prime!");
 
-			// And now proceed to all-binary-ones test of vector-form M(p):
-			mi64_add_scalar(p, 1ull, q, lenP);
-			ASSERT(findex == mi64_trailz(q, lenP), "Internal M(M(p))-exponent bad power of 2!");
-			mi64_shrl(q, q, findex, lenP,lenP);
-			mi64_sub_scalar(q, 1ull, q, lenP);
-			ASSERT(mi64_iszero(q, lenP), "Internal M(M(p))-exponent fails all-binary-ones check!");
-		}
-		// We can use a lookup table vs known M(p) for all cases, but if Mersenne or M(M(p)) with suitably small p,
-		// add a base-2 Fermat PRP test, more as a self-test of the various modpow routines than anything else:
-		if(lenP < 1000) {
-			mi64_sub_scalar(p, 1ull, q, lenP);	/* q = p-1 */
-			if(!mi64_twopmodq(q, lenP, 0, p, lenP, 0x0))
-			{
-				fprintf(stderr,"WARNING: p = %s is not prime ... proceeding anyway, on presumption user wants this.\n", pstring);
-			//	ASSERT(0,"0");	Dec 2019 ... allowing odd composite exponents can still be useful, e.g. ATH used to TF M(p^2) for known Mersenne primes
-			}
+		/* Check integrity (at least in the sense of monotonicity) for the precomputed pseudoprime table: */
+		for(i = 1; i < 9366; ++i) {
+			ASSERT(f2psp[i] > f2psp[i-1],"Misplaced pseudoprime!");
 		}
-	}
-
-	/* 2*p: Don't need to worry about overflow here since we've allocated two*p, p2NC, q, etc to be of lenQ, not lenP: */
-	two_p[lenP] = mi64_add(p, p, two_p, lenP);	// Need to account for fact that 2p may have 1 more word than p
-												// (I.e. use lenQ rather than lenP for multiword ops on two_p).
-	/* 2*p*[number of classes]: */
-	p2NC[lenP] = mi64_mul_scalar(p, (uint64)2*TF_CLASSES, p2NC, lenP);
 
-  #ifdef FAC_DEBUG
-	u64_arr[lenP] = mi64_mul_scalar(two_p,k_targ,u64_arr,lenP);	u64_arr[0] += 1;	// q = 2.k.p + 1
-	printf("FAC_DEBUG: Doing targeted debug-TF of %s(%s) with target factor candidate q = %s\n",NUM_PREFIX[MODULUS_TYPE],pstring,&char_buf0[convert_mi64_base10_char(char_buf0, u64_arr, lenQ, 0)]);
-	printf("two_p        = %s\n", &char_buf0[convert_mi64_base10_char(char_buf0, two_p, lenQ, 0)]);
-	printf("TF_CLASSES = %u\n",(uint32)TF_CLASSES);
-  #endif
-
-	// p mod TF_CLASSES:
-	if(MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
-	{
-		pmodNC = twopmmodq64(findex, (uint64)TF_CLASSES) - 1;	// For double-Mersenne factoring need M(p) mod #TF_CLASSES
-		/*
-		The above routine computes 2^p (mod 60) via Montgomery-mul-based powering. That requires an odd modulus,
-		so the actual powering step computes 2^(p-2) (mod 15), multiplies the result by 4 to get 2^p (mod 60),
-		and subtracts 1 to get M(p) (mod 60).
-
-		Note that there is a shortcut to obtaining 2^(p-2) (mod 15), namely summing the hex digits of 2^(p-2)
-		(mod 15). Since the hexadecimal base 16 == 1 (mod 15), this sum gives the desired result (mod 15).
-		Since 2^(p-2) i binary is just a 1 followed by (p-2) binary zeros, in base-16 it is just a leading hex
-		digit d = 2^((p-2)%4) followed by a string of (p-2)/4 hexadecimal zeros, the latter of which contribute
-		0 to the hex-digit sum (mod 15). Thus
+		/* Test some near-2^32 known-prime cases: */
+		curr_p = (uint32)-5;
+		itmp32 = twopmodq32(curr_p-1, curr_p);
+		ASSERT(itmp32 == 1,"twopmodq32: 2^32 - 5 test fails!");
+		curr_p = (uint32)-17;
+		itmp32 = twopmodq32(curr_p-1, curr_p);
+		ASSERT(itmp32 == 1,"twopmodq32: 2^32 -17 test fails!");
+		curr_p = (uint32)-35;	/* Start of the last length-30 curr_p%30 == 11 interval < 2^32; the 6th candidate in that interval, 2^32-17, is prime */
+		itmp32 = twopmodq32_x8(curr_p, curr_p+ 2, curr_p+ 6, curr_p+ 8, curr_p+12, curr_p+18, curr_p+20, curr_p+26);
+		ASSERT(itmp32 ==32,"twopmodq32_x8: 2^32 -35 test fails!");
 
-			2^(p-2) == 2^((p-2)%4) (mod 15), whence
+		fprintf(stderr,"Generating difference table of first %u small primes\n", nprime);
+		curr_p = 3;	/* Current prime stored in l. */
+		max_diff = 0;
 
-			M(p) == 4*2^((p-2)%4) - 1 (mod 60).
+		f2psp_idx = 0;	/* Index to next-expected Fermat base-2 pseudoprime in the precomputed table */
 
-		For example, for p = 521 we have 2^(p-2) == 2^3 == 8 (mod 15), whence M(p) == 31 (mod 60).
+		/* Init first few diffs between 3/5, 5/7, 7/11, so can start loop with curr_p = 11 == 1 (mod 10), as required by twopmodq32_x8(): */
+		pdiff[0] = 0;	pdiff[1] = pdiff[2] = 1;
+		ihi = curr_p = 11;
+	#ifdef USE_AVX512	// Use vector-int math and gather-load/scatter-store to accelerate the bit-clearing
+		psmall[0] = 3; psmall[1] = 5; psmall[2] = 7;
+	#endif
+		/* Process chunks of length 30, starting with curr_p == 11 (mod 30). Applying the obvious divide-by-3,5 mini-sieve,
+		we have 8 candidates in each interval: curr_p + [ 0, 2, 6, 8,12,18,20,26].
+		For example: curr_p = 11 gives the 8 candidates: 11,13,17,19,23,29,31,37.
+		*/
+		for(i = 3; i < nprime; curr_p += 30)
+		{
+			/* Make sure (curr_p + 29) < 2^32: */
+			if(curr_p > 0xffffffe3) {
+				fprintf(stderr,"curr_p overflows 32 bits!");
+				nprime = i;
+				break;
+			}
 
-		For p = 607 we 2^(p-2) == 2^1 == 2 (mod 15), whence M(p) == 7 (mod 60).
+			/* Do a quick Fermat base-2 compositeness test before invoking the more expensive mod operations: */
+			itmp32 = twopmodq32_x8(curr_p, curr_p+ 2, curr_p+ 6, curr_p+ 8, curr_p+12, curr_p+18, curr_p+20, curr_p+26);
+			for(j = 0; j < 8; ++j)
+			{
+				if((itmp32 >> j)&0x1)	// It's a PRP, so check against the table of known pseudoprimes and
+				{						// (if it's not a PSP) init for the next gap
+					ASSERT(curr_p <= f2psp[f2psp_idx],"Error in pseudoprime sieve");
+					if((curr_p + pdsum_8[j]) == f2psp[f2psp_idx])	/* It's a base-2 pseudoprime */
+					{
+						++f2psp_idx;
+						pdiff[i] += pdiff_8[j];
+						continue;
+					}
+					else	/* It's prime - add final increment to current pdiff[i] and then increment i: */
+					{
+						ihi = (curr_p + pdsum_8[j]);
+					#ifdef USE_AVX512	// Use vector-int math and gather-load/scatter-store to accelerate the bit-clearing
+						psmall[i] = ihi;
+					#endif
+						pdiff[i] += pdiff_8[j];
+						if(pdiff[i] > max_diff)
+						{
+							max_diff = pdiff[i];
+						#if DBG_SIEVE
+							printf("pdiff = %d at curr_p = %u\n", 2*max_diff,ihi);
+						#endif
+						}
+						if(++i == nprime)
+						{
+							break;
+						}
+					}
+				}
+				else
+				{
+					pdiff[i] += pdiff_8[j];
+				}
+			}
+		}
+		MAX_SIEVING_PRIME = ihi;
+	#ifdef MULTITHREAD
+		uint8 *byteptr = pdiff;	// Each thread gets its own copy of the pdiff data:
+		for(thr_id = 1; thr_id < NTHREADS; thr_id++) {
+			byteptr += NUM_SIEVING_PRIME;
+			memcpy(byteptr, pdiff, NUM_SIEVING_PRIME);
+		}
+	#endif
 
-		In fact for any odd-exponent M(p) there are only the two possibilities p == 1 or 3 (mod 4), for
-		which 2^(p-2) == 2^3 or 2^1 (mod 15) and M(p) == 31 or 7 (mod 60), respectively.
+	#if 1//def FAC_DEBUG
+		printf("Using first %u odd primes; max gap = %u\n",nprime,2*max_diff);
+		printf("max sieving prime = %u\n",MAX_SIEVING_PRIME);
+	#endif
 
-		For these two M(p) (mod 60) values the respective sets of 16 eligible k (mod 60) values of possible factors
-		q = 2.k.M(p) + 1 are
+  #if 0
+	// Oct 2015: Play with Smarandache numbers ():
+	i = 2000000;	ASSERT(i <= nprime, "prime limit exceeded in testSmarandache!");
+	testSmarandache(100001,101000, pdiff, i);
+	exit(0);
+  #endif
+  #if 0
+	// Oct 2018: Play with "sieve survivors" stats: lim(n --> oo) prod_(p <= n)(1-1/p)/(1/ln(p^2))
+	i = 1000000000;	ASSERT(i <= MAX_SIEVING_PRIME, "prime limit exceeded in testSieveProdAsymp!");
+	struct qfloat qfprod = QHALF, qt;
+	double prod = 0.5, log_psq = log((double)i*i);
+	for(m = 0, curr_p = 3; m < nprime; m++) {
+		curr_p += (pdiff[m] << 1);
+		if(curr_p > i) break;
+		prod *= (1-1./curr_p);
+//	printf("p = %u: prod = %18.15f\n",curr_p,prod);
+		qt = qfsub(QONE,qf_rational_quotient(1ull,(uint64)curr_p));
+		qfprod = qfmul(qfprod,qt);
+	}
+	printf("Used primes <= %u: 1/ln(p^2) = %18.15f, prod_(p <= n)(1-1/p) = %18.15f, ratio = %18.15f, qfprod = %18.15f\n",i,log_psq,prod,log_psq*qfdbl(qfprod),qfdbl(qfprod));
+	exit(0);
+  #endif
+/* Time the vector trialdiv stuff: */
+  #if TEST_TRIALDIV
+	for(i = 0; i < vec_len; i++)
+	{
+		xvec[i]  = rng_isaac_rand();
+	}
 
-			p == 1 (mod 4), M(p) == 31 (mod 60) : k (mod 60) = (any of) 0, 5, 8, 9,20,21,24,29,33,36,41,44,45,48,53,56
+	clock1 = clock();
+	curr_p = 3;
+	for(m = 0; m < nprime; m++)
+	{
+		curr_p += (pdiff[m] << 1);
+		if(mi64_is_div_by_scalar32(xvec, curr_p, vec_len) == TRUE)
+			printf("mi64_is_div_by_scalar32 test: %10u is a divisor\n", curr_p);
+	}
 
-			p == 3 (mod 4), M(p) ==  7 (mod 60) : k (mod 60) = (any of) 0, 5, 8, 9,12,17,20,24,29,32,33,44,45,48,53,57 .
+	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
+	tdiff = (double)(clock2 - clock1);
+	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
+	citer /= (double)vec_len*nprime;
+	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
 
-		M(p) == 31 or 7 (mod 60) also implies that the following check is not needed, but include it for formal completeness,
-		and in case someone else modifies this code for a purpose where the above call might in fact return 0 (mod 60):
-		*/
-		printf("p mod %u = %d\n", TF_CLASSES, pmodNC);
-		itmp32 = mi64_div_y32(p, TF_CLASSES, 0x0, lenP);
-		if(pmodNC != itmp32) {
-			printf("p mod %u v2 = %d\n", TF_CLASSES, itmp32);
-			fprintf(stderr,"Warning: Differing (p %% TF_CLASSES) values from Powering and direct-long-div! Proceeding using the 2nd result (%u).\n",itmp32);
-			pmodNC = itmp32;
+	clock1 = clock();
+	curr_p = 3;
+	for(m = 0; m < nprime; m+=4)
+	{
+		curr_p += (pdiff[m  ] << 1); tryq[0] = curr_p;
+		curr_p += (pdiff[m+1] << 1); tryq[1] = curr_p;
+		curr_p += (pdiff[m+2] << 1); tryq[2] = curr_p;
+		curr_p += (pdiff[m+3] << 1); tryq[3] = curr_p;
+		j = mi64_is_div_by_scalar32_x4(xvec, tryq[0], tryq[1], tryq[2], tryq[3], vec_len);
+		if(j != 0)
+		{
+			for(i = 0; i < 4; ++i)
+			{
+				if((j >> i)&1)
+					printf("mi64_is_div_by_scalar32_x4 test: %10u is a divisor\n", tryq[i]);
+			}
 		}
-	} else {
-		pmodNC = mi64_div_y32(p, TF_CLASSES, 0x0, lenP);
 	}
 
-	// If user-set kmax, test factoring range vs internal limits
-	if(kmax) {
-		interval_hi = (uint64)ceil((double)kmax/((uint64)len << TF_CLSHIFT));	// Copied from restart-file code below
-		u64_arr[lenP] = mi64_mul_scalar( p, 2*interval_hi*(len << TF_CLSHIFT), u64_arr, lenP);
-		ASSERT(lenQ == lenP+(u64_arr[lenP] != 0), "");
-
-		nbits_in_q = (lenQ<<6) - mi64_leadz(u64_arr, lenQ);
+	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
+	tdiff = (double)(clock2 - clock1);
+	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
+	citer /= (double)vec_len*nprime;
+	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
 
-		if(nbits_in_q > MAX_BITS_Q)
+	clock1 = clock();
+	curr_p = 3;
+	for(m = 0; m < nprime; m += 8)
+	{
+		curr_p += (pdiff[m  ] << 1); tryq[0] = curr_p;
+		curr_p += (pdiff[m+1] << 1); tryq[1] = curr_p;
+		curr_p += (pdiff[m+2] << 1); tryq[2] = curr_p;
+		curr_p += (pdiff[m+3] << 1); tryq[3] = curr_p;
+		curr_p += (pdiff[m+4] << 1); tryq[4] = curr_p;
+		curr_p += (pdiff[m+5] << 1); tryq[5] = curr_p;
+		curr_p += (pdiff[m+6] << 1); tryq[6] = curr_p;
+		curr_p += (pdiff[m+7] << 1); tryq[7] = curr_p;
+		j = mi64_is_div_by_scalar32_x8(xvec, tryq[0], tryq[1], tryq[2], tryq[3], tryq[4], tryq[5], tryq[6], tryq[7], vec_len);
+		if(j != 0)
 		{
-			fprintf(stderr,"qmax too large - limit is %u bits. Offending p, kmax = %s, %s\n", MAX_BITS_Q, pstring, &char_buf0[convert_uint64_base10_char(char_buf0, kmax)]);
-			ASSERT(0,"0");
+			for(i = 0; i < 8; ++i)
+			{
+				if((j >> i)&1)
+					printf("mi64_is_div_by_scalar32_x8 test: %10u is a divisor\n", tryq[i]);
+			}
 		}
 	}
 
-	/* log2[nearest power of 2 to (nbits_in_p)*lenQ^2)] */
-	bits_in_pq2 = nbits_in_p*lenQ*lenQ;
-	bits_in_pq2 = 32 - leadz32(bits_in_pq2);
-	CMASKBITS = (30 - (bits_in_pq2>>1));
-	countmask = (1ull << CMASKBITS) - 1;
-
-/*****************************************************/
-/****************** RESTART STUFF: *******************/
-/*****************************************************/
-
-	/* Restart file for a given exponent is named 't{exponent}'.
-	Since Fermat-number exponents are so much smaller than Mersenne-number ones,
-	we assume there is no overlap, i.e. if pstring <= MAX_BITS_P, it's a
-	Fermat-number factoring run, pstring > MAX_BITS_P is a Mersenne-number run.
-	*/
-	RESTARTFILE[0] = 't'; RESTARTFILE[1] = '\0'; strcat(RESTARTFILE, pstring);
-	// Checkpointing only supported for single-threaded runs:
-	if(NTHREADS > 1)
-		fprintf(stderr,"WARN: Checkpointing only supported for single-threaded runs!\n");
-	else
-		fprintf(stderr,"INFO: Will write checkpoint data to savefile %s.\n",RESTARTFILE);
-
-	fprintf(stderr,"INFO: Will write savefile %s every 2^%u = %" PRIu64 " factor candidates tried.\n",RESTARTFILE,CMASKBITS,countmask+1);
-
-	/**** process restart-file and any command-line params: ****/
-	// Note: return value of read_savefile is signed:
-	itmp = read_savefile(RESTARTFILE, pstring, &bmin_file,&bmax_file, &kmin_file,&know_file,&kmax_file, &passmin_file,&passnow_file,&passmax_file, &count);
-	if(itmp == -1) {
-		sprintf(cbuf,"INFO: No factoring savefile %s found ... starting from scratch.\n",RESTARTFILE);
-		fprintf(stderr,"%s",cbuf);
-	#ifndef FACTOR_STANDALONE
-		fq = mlucas_fopen(STATFILE,"a"); fprintf(fq,"%s",cbuf); fclose(fq); fq = 0x0;
-	#endif
-		// Init savefile with above read_savefile fields so ensuing checkpoint-writes only need to update the pass# and k:
-//		ASSERT(0 == init_savefile(RESTARTFILE, pstring, bmin,bmax, kmin,know,kmax, passmin,passnow,passmax, count),"init_savefile failed!");
-	} else {
-		ASSERT(!itmp,"There were errors reading the savefile ... aborting");
-		count = 0ull;	// Need to reset == 0 prior to sieving so kvector-fill code works properly
+	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
+	tdiff = (double)(clock2 - clock1);
+	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
+	citer /= (double)vec_len*nprime;
+	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
 
-		/* If previous run is not yet complete, ignore any increased factor-bound-related
-		command-line parameters and instead proceed to complete the previous run first:
-		*/
-		if((know_file < kmax_file) || (passnow_file < passmax_file)) {
-			incomplete_run = TRUE;
-			fprintf(stderr,"INFO: Previous run to kmax = %s not yet complete.\n"  , &char_buf0[convert_uint64_base10_char(char_buf0, kmax_file)]);
-			fprintf(stderr,"Ignoring any increased factor-bound-related command-line parameters and proceeding to complete previous run.\n");
-			bmin = bmin_file; bmax = bmax_file;
-			passmin = passmin_file; passnow = passnow_file; passmax = passmax_file;
-			kmin = kmin_file; know = know_file; kmax = kmax_file;
-			kplus = 0;
-		} else {
-			/**** Previous run was completed - check that current params satisfy one (and only one)
-			of the following sets of conditions:
-				1) -bmin/bmax used to set bounds for factoring:
-					In this case we expect any command-line bmin will be >= that in the restart file
-					(in fact we expect bmin >= bmax_file, i.e. that the runs are nonoverlapping -
-					if not we warn and set bmin = bmax_file), and that bmax > bmax_file.
-			****/
-			if(bmin || bmax) {
-			#if(!defined(P1WORD))
-			//	ASSERT(0,"bmin/bmax form of bounds-setting only allowed for single-word-p case!");
-			#endif
-				ASSERT((kmin==0 && kmax==0 && kplus==0),"(kmin==0 && kmax==0 && kplus==0) - please delete any restart files for this p and retry debug run.");
+	clock1 = clock();
+	curr_p = 3;
+	for(m = 0; m < nprime; m++)
+	{
+		curr_p += (pdiff[m] << 1);
+		if(mi64_is_div_by_scalar64(xvec, (uint64)curr_p, vec_len) == TRUE)
+			printf("mi64_is_div_by_scalar64 test: %10u is a divisor\n", curr_p);
+	}
+	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
+	tdiff = (double)(clock2 - clock1);
+	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
+	citer /= (double)vec_len*nprime;
+	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
 
-				if(bmin) {
-					ASSERT(bmin >= bmin_file - 0.0000000001,"bmin >= bmin_file");
-					if(bmin < bmax_file)
-						fprintf(stderr,"WARNING: Specified bmin (%lf) smaller than previous-run bmax = %lf. Setting equal to avoid overlapping runs.\n", bmin, bmax_file);
-				}
-				bmin = bmax_file;
-				/* We expect any command-line bmax will be > that in the restart file: */
-				if(bmax)
-					ASSERT(bmax > bmax_file - 0.0000000001,"bmax >= bmax_file");
-			}
+	free((void*)xvec);
+  #endif
 
-			/****
-				2) -kmin/kmax used to set bounds for factoring:
-					In this case we expect any command-line kmin will be >= that in the restart file
-					(in fact we expect kmin >= kmax_file, i.e. that the runs are nonoverlapping -
-					if not we warn and set kmin = kmax_file), and that kmax > kmax_file.
-			****/
-			if(kmin || kmax) {
-				ASSERT((bmin==0 && bmax==0 && kplus==0),"(bmin==0 && bmax==0 && kplus==0)");
-				if(kmin) {
-					ASSERT(kmin >= kmin_file,"kmin >= kmin_file");
-					if(kmin < kmax_file)
-						fprintf(stderr,"WARNING: Specified kmin (%s) smaller than previous-run kmax = %s. Setting equal to avoid overlapping runs.\n", &char_buf0[convert_uint64_base10_char(char_buf0, kmax)], &char_buf1[convert_uint64_base10_char(char_buf1, kmax_file)]);
-				}
-				kmin = kmax_file;
-				/* We expect any command-line kmax will be > that in the restart file: */
-				if(kmax)
-					ASSERT(kmax > kmax_file,"kmax >= kmax_file");
-			}
+/*   for p < max prime in precomputed table, need to truncate the range of primes...	*/
+	/*********** WHY WAS THIS HERE? *************
+	curr_p = MAX_SIEVING_PRIME;
+	for(;;)
+	{
+		if(p > curr_p) break;
+		curr_p -= (pdiff[nprime--] << 1);
+	#ifdef FAC_DEBUG
+		ASSERT(curr_p == prime[nprime], "factor.c : curr_p == prime[nprime]");
+	#endif
+	}
+	MAX_SIEVING_PRIME = curr_p;
+	***********/
+	nprime_tab = nprime;	max_sieving_prime_tab = MAX_SIEVING_PRIME;
 
-			/****
-				3) -kplus used to increment an upper bound from a previous factoring run:
-			****/
-			if(kplus) {
-				ASSERT((bmin==0 && bmax==0 && kmin==0 && kmax==0),"(bmin==0 && bmax==0 && kmin==0 && kmax==0)");
-				kmin = kmax_file;
-				/* Ensure incremented value kmax fits into a 64-bit unsigned int: */
-				ASSERT((kmin + kplus) > kplus, "kmax_file + kplus exceeds 2^64!");
-				kmax = kmin + kplus;
-				kplus = 0;	/* If kplus != 0 detected further on, that indicates that no valid restart
-							file was found for factoring-bounds incrementing. */
-			}
+/*****************************************************/
+/************** PER-ASSIGNMENT STUFF: ****************/
+/*****************************************************/
+
+  #ifdef FACTOR_STANDALONE
+	// Batch mode: pick up the next Factor= assignment of the worklist. Bounds and pass settings are per-assignment:
+	batch_time = getRealTime();
+RANGE_BEG:
+	if(STRNEQ(worklist,"")) {
+		if(!read_tf_assignment(worklist, pstring, &bmin, &bmax)) {
+			fprintf(stderr,"INFO: No Factor= assignments left in %s ... done.\n",worklist);
+			goto MFACTOR_DONE;
 		}
-		/* Successfully processed restart file: */
-		restart = TRUE;
+		fprintf(stderr,"INFO: %s assignment %u: M(%s), bmin = %.2f, bmax = %.2f\n",worklist,++nassign,pstring,bmin,bmax);
+		MODULUS_TYPE = MODULUS_TYPE_MERSENNE;
+		kmin = kmax = know = kplus = 0ull;
+		passmin = passnow = 0;	passmax = 0xffffffff;
+		incomplete_run = restart = FALSE;
+		findex = nbits_in_p = nbits_in_q = on_bits = 0;
+		count = 0ull;	kdeep = 0x0;	ndeep = 0;
+		if(!tf_classes_fixed)	// Else leave any user-set class count in place
+			TF_CLASSES = TF_PASSES = TF_CLSHIFT = 0;
 	}
+  #endif
 
-/************************ END(RESTART STUFF) *******************/
+	/* Make sure a valid exponent string has been given - if this is the only
+	command-line parameter, will attempt to read the other needed run parameters
+	from the corresponding checkpoint file:
+	*/
+	ASSERT(STRNEQ(pstring,""),"factor.c : pstring empty!");
 
-  #warning bmax/kmax-synchro needs re-do!
-	/* If it's not a restart of an as-yet-uncompleted run, synchronize the factoring-bound params: */
-	if(!incomplete_run)
-	{
-		/* Double-check factoring pass bounds: */
-		if(passmin > (TF_PASSES-1) )
-		{
-			fprintf(stderr,"ERROR: passmin must be <= %u. Offending entry = %u.\n", TF_PASSES-1, passmin);
-			ASSERT(0,"0");
+	/* -bmin/bmax used to set bounds for factoring: */
+	if(bmin || bmax) {
+		ASSERT((kmin==0 && kmax==0 && kplus==0),"(kmin==0 && kmax==0 && kplus==0)");
+
+		if(bmin < 0) {
+			fprintf(stderr,"ERROR: log2(min factor) must be >= 0. Offending entry = %lf.\n", bmin);		ASSERT(0,"0");
+		} else if(bmin >= MAX_BITS_Q) {
+			fprintf(stderr,"ERROR: log2(min factor) exceeds allowable limit of %u. Offending entry = %lf.\n", MAX_BITS_Q, bmin);	ASSERT(0,"0");
 		}
 
-		if(passmax < passmin)
-		{
-			fprintf(stderr,"ERROR: (passmax = %u) < (passmin = %u)!\n", passmax, passmin);
-			ASSERT(0,"0");
+		if(bmax <= 0) {
+			fprintf(stderr,"ERROR: log2(max factor) must be > 0. Offending entry = %lf.\n", bmax);		ASSERT(0,"0");
+		} else if(bmax > MAX_BITS_Q) {
+			fprintf(stderr,"ERROR: log2(max factor) exceeds allowable limit of %u. Offending entry = %lf.\n", MAX_BITS_Q, bmax);	ASSERT(0,"0");
 		}
-		if(passmax > (TF_PASSES-1) )
-		{
-			fprintf(stderr,"ERROR: passmax must be <= %u. Offending entry = %u.\n", TF_PASSES-1, passmax);
-			ASSERT(0,"0");
+
+		if(bmax < bmin) {
+			fprintf(stderr,"ERROR: (bmax = %lf) < (bmin = %lf)!\n", bmax, bmin);	ASSERT(0,"0");
 		}
+	}
 
-		/**** Process factor candidate bounds: ****/
+	/* -kmin/kmax used to set bounds for factoring: */
+	if(kmin || kmax) {
+		ASSERT(kmax != 0 ,"factor.c: kmax not set!");
+		ASSERT((int64)kmax > 0, "kmax must be 63 bits or less!");
+		ASSERT((bmin==0 && bmax==0 && kplus==0),"(bmin==0 && bmax==0 && kplus==0)");
 
-		/* If any of bmin|kmin, bmax|kmax nonzero, calculate its counterpart: */
-	#ifdef P1WORD
-		/* Find FP approximation to 2*p - can't use this for multiword case, because double approximation tp 2*p may overflow: */
-		twop_float = (double)two_p[0];
-	#endif
-		/* Compute kmax if not already set: */
-		if(!kmax) {
-			ASSERT(bmax <= (nbits_in_p+65), "Specified bmax implies kmax > 64-bit, which exceeds the program's limit ... aborting.");
-			kmax = given_b_get_k(bmax, two_p, lenQ);
-			ASSERT(kmax > 0, "Something went wrong with the computation of kmax ... possibly your bmax implies kmax > 64-bit?");
-		}
-		if(kmin || bmin) {
-			if(kmin == 0ull) {	/* Lower Bound given in log2rithmic form */
-				ASSERT(bmin <= bmax, "bmin >= bmax!");
-				kmin = given_b_get_k(bmin, two_p, lenQ);
-			} else {
-				ASSERT(kmin <= kmax, "kmin >= kmax!");
-			#ifdef P1WORD
-				fqlo = kmin*twop_float + 1.0;
-				bmin = log(fqlo)*ILG2;
-			#endif
-			}
-		} else {
-		#ifdef P1WORD
-			fqlo = 1.0;
-		#endif
+		if(kmax < kmin) {
+			fprintf(stderr,"ERROR: (kmax = %s) < (kmin = %s)!\n", &char_buf0[convert_uint64_base10_char(char_buf0, kmax)], &char_buf1[convert_uint64_base10_char(char_buf1, kmin)]);
+			ASSERT(0,"0");
 		}
-ASSERT(0 == init_savefile(RESTARTFILE, pstring, bmin,bmax, kmin,know,kmax, passmin,passnow,passmax, count),"init_savefile failed!");
-//**** Do savefile-init here? ******
-		if(kmax || bmax) {
-			if(kmax == 0ull) {	/* Upper Bound given in log2rithmic form */
-				kmax = given_b_get_k(bmax, two_p, lenQ);
- 			} else {
-			#ifdef P1WORD
-				fqhi = kmax*twop_float + 1.0;
-				bmax = log(fqhi)*ILG2;
-			#endif
-			}
-		} else
-			ASSERT(0 ,"factor.c : One of bmax, kmax must be nonzero!");
-
-		/**** At this point the paired elements bmin|kmin, bmax|kmax are in synchrony. ****/
+	}
 
-		/* If kplus given on command line, a valid restart file should have been found
-		and kmax incremented at this point, i.e. kplus should have been reset to zero:
-		*/
-		ASSERT(kplus == 0, "kplus must be zero here!");
+	ASSERT(bmax > 0.0 || kmax != 0 ,"factor.c: One of bmax or kmax must be set!");
 
-		know = kmin;
-		passnow = passmin;
+	ASSERT((MODULUS_TYPE == MODULUS_TYPE_MERSENNE)
+			  || (MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
+			  || (MODULUS_TYPE ==   MODULUS_TYPE_FERMAT)
+				, "Unsupported modulus type!");
 
-	}	/* endif(!incomplete_run) */
+	lenQ = ((uint32)MAX_BITS_Q + 63)>>6;	// This sets upper bound on #words needed to store max. factor candidate
 
-/*****************************************************/
-/****************** SIEVE STUFF: *********************/
-/*****************************************************/
+	// Convert power-of-2 exponent to unsigned int form and allocate the exponent-storage vector.
+	// We use MAX_BITS_P (defined in Mdata.h) to set the allocated storage here, but use the user-set
+	// exponent to set the number of words of that allocated storage which are actually used:
+	if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
+	{
+		findex = convert_base10_char_uint64(pstring);
+		nbits_in_p = findex+1;
+		lenP = (nbits_in_p + 63)>>6;
+		p     = (uint64 *)calloc( ((uint32)MAX_BITS_P + 63)>>6, sizeof(uint64));
+		p[0] = 1;	mi64_shl(p,p,findex,lenP);	// p = (uint64)1 << findex;
+	}
+	else if(MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
+	{
+		findex = convert_base10_char_uint64(pstring);	// This var was really named as abbreviation of "Fermat index", but re-use for MMp
+		nbits_in_p = findex;
+		if(findex > 1000) {	// Large MMp need deeper sieving on each k passing the default sieve
+			kdeep = (uint32 *)calloc( 1024, sizeof(uint32));
+			ASSERT(kdeep != 0x0, "Calloc of kdeep[] failed!");
+		}
+		lenP = (nbits_in_p + 63)>>6;
+		p     = (uint64 *)calloc( ((uint32)MAX_BITS_P + 63)>>6, sizeof(uint64));
+		p[0] = 1;	mi64_shl(p,p,findex,lenP);
+		mi64_sub_scalar(p,1,p,lenP);	// p = 2^findex - 1;
+	#ifdef FAC_DEBUG
+		printf("%s(%s) = M(p) with p = %s\n", NUM_PREFIX[MODULUS_TYPE], pstring, &char_buf0[convert_mi64_base10_char(char_buf0, p, lenP, 0)]);
+	#endif
+	} else {
+		// Convert stringified exponent to mi64 form, using same #limbs as for factor candidates:
+		p = convert_base10_char_mi64(pstring, &lenQ);	// This does the mem-alloc for us in this case
+		lenP = mi64_getlen(p, lenQ); ASSERT(lenP > 0, "factor.c: Error converting pstring!");
+		nbits_in_p = (lenP<<6) - mi64_leadz(p, lenP);
+	}
 
-	ASSERT(NUM_SIEVING_PRIME > 0, "factor.c : NUM_SIEVING_PRIME > 0");
+	// Allocate the other modulus-dependent vectors:
+	two_p   = (uint64 *)calloc(lenQ, sizeof(uint64));
+	p2NC    = (uint64 *)calloc(lenQ, sizeof(uint64));
+	q       = (uint64 *)calloc(lenQ * NTHREADS, sizeof(uint64));
+	q2      = (uint64 *)calloc(lenQ * NTHREADS, sizeof(uint64));
+	u64_arr = (uint64 *)calloc(lenQ * NTHREADS, sizeof(uint64));
 
-/*   allocate the arrays and initialize the array of sieving primes	*/
-	temp_late = (uint64 *)calloc(len, sizeof(uint64));
+	// Set the [p,k] class count, if not fixed by the user or at compile time. User-set pass bounds are taken to refer to
+	// the legacy 60-class scheme; otherwise pick based on #threads and the approximate k-range, using q ~= 2.k.p:
+	if(!TF_CLASSES) {
+		if(pass_bounds_set) {
+			tf_set_classes(60);	tf_classes_fixed = TRUE;
+		} else {
+			if(kplus)
+				dtmp = (double)kplus;
+			else if(kmax)
+				dtmp = (double)(kmax - kmin);
+			else
+				dtmp = pow(2.0, bmax - nbits_in_p - 1) - (bmin > 0 ? pow(2.0, bmin - nbits_in_p - 1) : 0.0);
+			tf_set_classes(tf_select_classes(NTHREADS, dtmp, len));
+		}
+	} else if(pass_bounds_set || TF_CLASSES_DEFAULT) {
+		tf_classes_fixed = TRUE;
+	}
+	fprintf(stderr,"INFO: Using TF_CLASSES = %u, i.e. %u passes, for %u thread(s).\n",TF_CLASSES,TF_PASSES,NTHREADS);
+	if(NTHREADS > TF_PASSES)
+		fprintf(stderr,"WARN: NTHREADS = %u exceeds #passes = %u ... excess threads will be idle.\n",NTHREADS,TF_PASSES);
 
-  #if TF_CLASSES == 60
-	i = len/TF_CLASSES + 1;	// len not divisible by TF_CLASSES, so add a pad-word
-  #else
-	i = (len*64)/TF_CLASSES + 1;	// 64*len divisible by TF_CLASSES, no need for padding
-		//**** Oct 2016: AVX-512 vector-bit-clear needs a padding element, so add one. ****
-  #endif
-	bit_map = (uint64 *)calloc(i * NTHREADS, sizeof(uint64));
-	bit_map2= (uint64 *)calloc(i * NTHREADS, sizeof(uint64));	// 2nd alloc to give each thread 1 bit-clearable copy of master bit_map
-	if (bit_map == NULL) {
-		fprintf(stderr,"Memory allocation failure for BITMAP array");
-		ASSERT(0,"0");
+	// Now use the just-allocated vector storage to compute how many words are really needed for qmax.
+	// Since the sieving always proceeds in full passes through the bit-cleared sieve, the actual kmax used
+	// may be up to (len*64)-1 larger than the user-specified kmax:
+	if(kmax) {
+		interval_hi = (uint64)ceil( (double)kmax / ((uint64)len << TF_CLSHIFT) );	// Copied from restart-file code below
+		// Actual kmax used at runtime = interval_hi*(len << TF_CLSHIFT);
+		u64_arr[lenP] = mi64_mul_scalar( p, 2*interval_hi*(len << TF_CLSHIFT), u64_arr, lenP);
+		lenQ = lenP + (u64_arr[lenP] != 0);
+	} else {
+		lenQ = ( (uint32)(ceil(bmax)) + 63 ) >> 6;
 	}
-	bit_atlas = (uint64 *)calloc(i * TF_PASSES, sizeof(uint64));
-	if (bit_atlas == NULL) {
-		fprintf(stderr,"Memory allocation failure for TEMPLATE array");
-		ASSERT(0,"0");
+
+	// Mersenne numbers must have odd (check primality further on) exponents:
+	if((MODULUS_TYPE != MODULUS_TYPE_FERMAT) && (p[0] & 1) == 0)
+    {
+		fprintf(stderr,"p must be odd! Offending p = %s\n", pstring); ASSERT(0,"0");
 	}
-printf("Allocated %u words in master template, %u in per-pass bit_map [%u x that in bit_atlas]\n",len,i,TF_PASSES);
 
-  #ifdef USE_AVX512	// Use vector-int math and gather-load/scatter-store to accelerate the bit-clearing
-	psmall = (uint32 *)calloc(NUM_SIEVING_PRIME * NTHREADS, sizeof(uint32));
-	if (psmall == NULL) {
-		fprintf(stderr,"Memory allocation failure for PSMALL array");
+	/* For purposes of the bits-in-p limit, treat Fermat numbers as having 2^findex rather than 2^findex + 1 bits: */
+	if((nbits_in_p - (MODULUS_TYPE == MODULUS_TYPE_FERMAT)) > MAX_BITS_P)
+	{
+		fprintf(stderr,"p too large - limit is %u bits. Offending p = %s\n", MAX_BITS_P, pstring);
 		ASSERT(0,"0");
 	}
+	// To track lg(q) = lg(2.k.p+1), use approximation q ~= 2.k.p, thus lg(q) ~= lg(2.p) + lg(k).
+	fbits_in_2p = (double)mi64_extract_lead64(p, lenP, &itmp64) - 64;
+//printf("fbits_in_2p = mi64_extract_lead64[= %10u] - 64 = %10.4f\n",mi64_extract_lead64(p, lenP, &itmp64),fbits_in_2p);
+	fbits_in_2p += log((double)itmp64)*ILG2 + 1;	// Add 1 to lg(p) to get lg(2p)
+//printf("fbits_in_2p += log((double)itmp64)*ILG2 [= %10.4f] = %10.4f\n",log((double)itmp64)*ILG2,fbits_in_2p);
+  #if 0	// 11/2013: No clue what I was thinking here...
+	// If 2p < 2^64 we left-justify the leading bits to make result lie in [2^63, 2^64), so result here must always be > 2^63:
+	ASSERT(fbits_in_2p >= 63, "fbits_in_2p out of range!");
+	fbits_in_2p += nbits_in_p - 64.0;	// lg(2.p) ... Cast 64 to double to avoid signed-int subtract of RHS terms.
   #endif
-
-	pdiff = (uint8 *)calloc(NUM_SIEVING_PRIME * NTHREADS, sizeof(uint8));
-	if (pdiff == NULL) {
-		fprintf(stderr,"Memory allocation failure for pdiff array");
-		ASSERT(0,"0");
+	// Do some quick sanity tests of exponent for the various kinds of moduli:
+	if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
+	{
+		ASSERT(findex == mi64_trailz(p, lenP), "Internal Fermat-exponent bad power of 2!");
+		mi64_shrl(p, q, findex, lenP,lenP);
+		mi64_sub_scalar(q, 1ull, q, lenP);
+		ASSERT(mi64_iszero(q, lenP), "Internal Fermat-exponent not a power of 2!");
 	}
+	else
+	{
+		// For M(M(p)), make sure the M(p) is actually prime:
+		if(MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
+		{
+			for(i=0; knowns[i] != 0; i++)
+			{
+				if(findex == knowns[i]) { break; }
+			}
+			ASSERT((knowns[i] != 0), "Double-Mersenne exponent not a known Mersenne prime!");
 
-	startval = (uint32 *)calloc(NUM_SIEVING_PRIME * NTHREADS, sizeof(uint32));
-	if (startval == NULL) {
-		fprintf(stderr,"Memory allocation failure for STARTVAL array");
-		ASSERT(0,"0");
+			// And now proceed to all-binary-ones test of vector-form M(p):
+			mi64_add_scalar(p, 1ull, q, lenP);
+			ASSERT(findex == mi64_trailz(q, lenP), "Internal M(M(p))-exponent bad power of 2!");
+			mi64_shrl(q, q, findex, lenP,lenP);
+			mi64_sub_scalar(q, 1ull, q, lenP);
+			ASSERT(mi64_iszero(q, lenP), "Internal M(M(p))-exponent fails all-binary-ones check!");
+		}
+		// We can use a lookup table vs known M(p) for all cases, but if Mersenne or M(M(p)) with suitably small p,
+		// add a base-2 Fermat PRP test, more as a self-test of the various modpow routines than anything else:
+		if(lenP < 1000) {
+			mi64_sub_scalar(p, 1ull, q, lenP);	/* q = p-1 */
+			if(!mi64_twopmodq(q, lenP, 0, p, lenP, 0x0))
+			{
+				fprintf(stderr,"WARNING: p = %s is not prime ... proceeding anyway, on presumption user wants this.\n", pstring);
+			//	ASSERT(0,"0");	Dec 2019 ... allowing odd composite exponents can still be useful, e.g. ATH used to TF M(p^2) for known Mersenne primes
+			}
+		}
 	}
 
-	pinv = (uint32 *)calloc(NUM_SIEVING_PRIME, sizeof(uint32));
-	if (pinv == NULL) {
-		fprintf(stderr,"Memory allocation failure for PINV array");
-		ASSERT(0,"0");
-	}
+	/* 2*p: Don't need to worry about overflow here since we've allocated two*p, p2NC, q, etc to be of lenQ, not lenP: */
+	two_p[lenP] = mi64_add(p, p, two_p, lenP);	// Need to account for fact that 2p may have 1 more word than p
+												// (I.e. use lenQ rather than lenP for multiword ops on two_p).
+	// If user-set kmax, test factoring range vs internal limits
+	if(kmax) {
+		interval_hi = (uint64)ceil((double)kmax/((uint64)len << TF_CLSHIFT));	// Copied from restart-file code below
+		u64_arr[lenP] = mi64_mul_scalar( p, 2*interval_hi*(len << TF_CLSHIFT), u64_arr, lenP);
+		ASSERT(lenQ == lenP+(u64_arr[lenP] != 0), "");
 
-  #if DBG_SIEVE
-	startval_incr = (uint32 *)calloc(NUM_SIEVING_PRIME, sizeof(uint32));
-	if (startval_incr == NULL) {
-		fprintf(stderr,"Memory allocation failure for STARTVAL_INCR array");
-		ASSERT(0,"0");
-	}
-  #endif
+		nbits_in_q = (lenQ<<6) - mi64_leadz(u64_arr, lenQ);
 
-		/* Check integrity (at least in the sense of monotonicity) for the precomputed pseudoprime table: */
-		for(i = 1; i < 9366; ++i) {
-			ASSERT(f2psp[i] > f2psp[i-1],"Misplaced pseudoprime!");
+		if(nbits_in_q > MAX_BITS_Q)
+		{
+			fprintf(stderr,"qmax too large - limit is %u bits. Offending p, kmax = %s, %s\n", MAX_BITS_Q, pstring, &char_buf0[convert_uint64_base10_char(char_buf0, kmax)]);
+			ASSERT(0,"0");
 		}
+	}
 
-		/* Test some near-2^32 known-prime cases: */
-		curr_p = (uint32)-5;
-		itmp32 = twopmodq32(curr_p-1, curr_p);
-		ASSERT(itmp32 == 1,"twopmodq32: 2^32 - 5 test fails!");
-		curr_p = (uint32)-17;
-		itmp32 = twopmodq32(curr_p-1, curr_p);
-		ASSERT(itmp32 == 1,"twopmodq32: 2^32 -17 test fails!");
-		curr_p = (uint32)-35;	/* Start of the last length-30 curr_p%30 == 11 interval < 2^32; the 6th candidate in that interval, 2^32-17, is prime */
-		itmp32 = twopmodq32_x8(curr_p, curr_p+ 2, curr_p+ 6, curr_p+ 8, curr_p+12, curr_p+18, curr_p+20, curr_p+26);
-		ASSERT(itmp32 ==32,"twopmodq32_x8: 2^32 -35 test fails!");
+	/* log2[nearest power of 2 to (nbits_in_p)*lenQ^2)] */
+	bits_in_pq2 = nbits_in_p*lenQ*lenQ;
+	bits_in_pq2 = 32 - leadz32(bits_in_pq2);
+	CMASKBITS = (30 - (bits_in_pq2>>1));
+	countmask = (1ull << CMASKBITS) - 1;
 
-		fprintf(stderr,"Generating difference table of first %u small primes\n", nprime);
-		curr_p = 3;	/* Current prime stored in l. */
-		max_diff = 0;
+/*****************************************************/
+/****************** RESTART STUFF: *******************/
+/*****************************************************/
 
-		f2psp_idx = 0;	/* Index to next-expected Fermat base-2 pseudoprime in the precomputed table */
+	/* Restart file for a given exponent is named 't{exponent}'.
+	Since Fermat-number exponents are so much smaller than Mersenne-number ones,
+	we assume there is no overlap, i.e. if pstring <= MAX_BITS_P, it's a
+	Fermat-number factoring run, pstring > MAX_BITS_P is a Mersenne-number run.
+	*/
+	RESTARTFILE[0] = 't'; RESTARTFILE[1] = '\0'; strcat(RESTARTFILE, pstring);
+	fprintf(stderr,"INFO: Will write checkpoint data to savefile %s at most every %u seconds.\n",RESTARTFILE,TF_CKPT_SECS);
+	tf_ckpt.nseg = 0;	// Set if read_savefile() finds a binary checkpoint
 
-		/* Init first few diffs between 3/5, 5/7, 7/11, so can start loop with curr_p = 11 == 1 (mod 10), as required by twopmodq32_x8(): */
-		pdiff[0] = 0;	pdiff[1] = pdiff[2] = 1;
-		ihi = curr_p = 11;
-	#ifdef USE_AVX512	// Use vector-int math and gather-load/scatter-store to accelerate the bit-clearing
-		psmall[0] = 3; psmall[1] = 5; psmall[2] = 7;
+	/**** process restart-file and any command-line params: ****/
+	// Note: return value of read_savefile is signed:
+	itmp = read_savefile(RESTARTFILE, pstring, &bmin_file,&bmax_file, &kmin_file,&know_file,&kmax_file, &passmin_file,&passnow_file,&passmax_file, &count);
+	if(itmp == -1) {
+		sprintf(cbuf,"INFO: No factoring savefile %s found ... starting from scratch.\n",RESTARTFILE);
+		fprintf(stderr,"%s",cbuf);
+	#ifndef FACTOR_STANDALONE
+		fq = mlucas_fopen(STATFILE,"a"); fprintf(fq,"%s",cbuf); fclose(fq); fq = 0x0;
 	#endif
-		/* Process chunks of length 30, starting with curr_p == 11 (mod 30). Applying the obvious divide-by-3,5 mini-sieve,
-		we have 8 candidates in each interval: curr_p + [ 0, 2, 6, 8,12,18,20,26].
-		For example: curr_p = 11 gives the 8 candidates: 11,13,17,19,23,29,31,37.
+		// Init savefile with above read_savefile fields so ensuing checkpoint-writes only need to update the pass# and k:
+//		ASSERT(0 == init_savefile(RESTARTFILE, pstring, bmin,bmax, kmin,know,kmax, passmin,passnow,passmax, count),"init_savefile failed!");
+	} else {
+		ASSERT(!itmp,"There were errors reading the savefile ... aborting");
+		count = 0ull;	// Need to reset == 0 prior to sieving so kvector-fill code works properly
+
+		/* If previous run is not yet complete, ignore any increased factor-bound-related
+		command-line parameters and instead proceed to complete the previous run first:
 		*/
-		for(i = 3; i < nprime; curr_p += 30)
-		{
-			/* Make sure (curr_p + 29) < 2^32: */
-			if(curr_p > 0xffffffe3) {
-				fprintf(stderr,"curr_p overflows 32 bits!");
-				nprime = i;
-				break;
-			}
+		if((know_file < kmax_file) || (passnow_file < passmax_file)) {
+			incomplete_run = TRUE;
+			fprintf(stderr,"INFO: Previous run to kmax = %s not yet complete.\n"  , &char_buf0[convert_uint64_base10_char(char_buf0, kmax_file)]);
+			fprintf(stderr,"Ignoring any increased factor-bound-related command-line parameters and proceeding to complete previous run.\n");
+			bmin = bmin_file; bmax = bmax_file;
+			passmin = passmin_file; passnow = passnow_file; passmax = passmax_file;
+			kmin = kmin_file; know = know_file; kmax = kmax_file;
+			kplus = 0;
+		} else {
+			/**** Previous run was completed - check that current params satisfy one (and only one)
+			of the following sets of conditions:
+				1) -bmin/bmax used to set bounds for factoring:
+					In this case we expect any command-line bmin will be >= that in the restart file
+					(in fact we expect bmin >= bmax_file, i.e. that the runs are nonoverlapping -
+					if not we warn and set bmin = bmax_file), and that bmax > bmax_file.
+			****/
+			if(bmin || bmax) {
+			#if(!defined(P1WORD))
+			//	ASSERT(0,"bmin/bmax form of bounds-setting only allowed for single-word-p case!");
+			#endif
+				ASSERT((kmin==0 && kmax==0 && kplus==0),"(kmin==0 && kmax==0 && kplus==0) - please delete any restart files for this p and retry debug run.");
 
-			/* Max sieving prime must be < smallest candidate factor of M(p) */
-		#ifdef P1WORD
-			if((curr_p+29) > two_p[0]) {
-				nprime = i;
-				break;
+				if(bmin) {
+					ASSERT(bmin >= bmin_file - 0.0000000001,"bmin >= bmin_file");
+					if(bmin < bmax_file)
+						fprintf(stderr,"WARNING: Specified bmin (%lf) smaller than previous-run bmax = %lf. Setting equal to avoid overlapping runs.\n", bmin, bmax_file);
+				}
+				// A bmin beyond the previous run's bmax is respected - e.g. Mlucas, whose worktodo TF_BITS field may be
+				// ahead of the savefile if some TF levels were done elsewhere:
+				if(bmin < bmax_file)
+					bmin = bmax_file;
+				/* We expect any command-line bmax will be > that in the restart file: */
+				if(bmax)
+					ASSERT(bmax > bmax_file - 0.0000000001,"bmax >= bmax_file");
 			}
-		#endif
 
-			/* Do a quick Fermat base-2 compositeness test before invoking the more expensive mod operations: */
-			itmp32 = twopmodq32_x8(curr_p, curr_p+ 2, curr_p+ 6, curr_p+ 8, curr_p+12, curr_p+18, curr_p+20, curr_p+26);
-			for(j = 0; j < 8; ++j)
-			{
-				if((itmp32 >> j)&0x1)	// It's a PRP, so check against the table of known pseudoprimes and
-				{						// (if it's not a PSP) init for the next gap
-					ASSERT(curr_p <= f2psp[f2psp_idx],"Error in pseudoprime sieve");
-					if((curr_p + pdsum_8[j]) == f2psp[f2psp_idx])	/* It's a base-2 pseudoprime */
-					{
-						++f2psp_idx;
-						pdiff[i] += pdiff_8[j];
-						continue;
-					}
-					else	/* It's prime - add final increment to current pdiff[i] and then increment i: */
-					{
-						ihi = (curr_p + pdsum_8[j]);
-					#ifdef USE_AVX512	// Use vector-int math and gather-load/scatter-store to accelerate the bit-clearing
-						psmall[i] = ihi;
-					#endif
-						pdiff[i] += pdiff_8[j];
-						if(pdiff[i] > max_diff)
-						{
-							max_diff = pdiff[i];
-						#if DBG_SIEVE
-							printf("pdiff = %d at curr_p = %u\n", 2*max_diff,ihi);
-						#endif
-						}
-						if(++i == nprime)
-						{
-							break;
-						}
-					}
-				}
-				else
-				{
-					pdiff[i] += pdiff_8[j];
+			/****
+				2) -kmin/kmax used to set bounds for factoring:
+					In this case we expect any command-line kmin will be >= that in the restart file
+					(in fact we expect kmin >= kmax_file, i.e. that the runs are nonoverlapping -
+					if not we warn and set kmin = kmax_file), and that kmax > kmax_file.
+			****/
+			if(kmin || kmax) {
+				ASSERT((bmin==0 && bmax==0 && kplus==0),"(bmin==0 && bmax==0 && kplus==0)");
+				if(kmin) {
+					ASSERT(kmin >= kmin_file,"kmin >= kmin_file");
+					if(kmin < kmax_file)
+						fprintf(stderr,"WARNING: Specified kmin (%s) smaller than previous-run kmax = %s. Setting equal to avoid overlapping runs.\n", &char_buf0[convert_uint64_base10_char(char_buf0, kmax)], &char_buf1[convert_uint64_base10_char(char_buf1, kmax_file)]);
 				}
+				if(kmin < kmax_file)
+					kmin = kmax_file;
+				/* We expect any command-line kmax will be > that in the restart file: */
+				if(kmax)
+					ASSERT(kmax > kmax_file,"kmax >= kmax_file");
+			}
+
+			/****
+				3) -kplus used to increment an upper bound from a previous factoring run:
+			****/
+			if(kplus) {
+				ASSERT((bmin==0 && bmax==0 && kmin==0 && kmax==0),"(bmin==0 && bmax==0 && kmin==0 && kmax==0)");
+				kmin = kmax_file;
+				/* Ensure incremented value kmax fits into a 64-bit unsigned int: */
+				ASSERT((kmin + kplus) > kplus, "kmax_file + kplus exceeds 2^64!");
+				kmax = kmin + kplus;
+				kplus = 0;	/* If kplus != 0 detected further on, that indicates that no valid restart
+							file was found for factoring-bounds incrementing. */
 			}
 		}
-		MAX_SIEVING_PRIME = ihi;
-	#ifdef MULTITHREAD
-		uint8 *byteptr = pdiff;	// Each thread gets its own copy of the pdiff data:
-		for(thr_id = 1; thr_id < NTHREADS; thr_id++) {
-			byteptr += NUM_SIEVING_PRIME;
-			memcpy(byteptr, pdiff, NUM_SIEVING_PRIME);
-		}
-	#endif
+		/* Successfully processed restart file: */
+		restart = TRUE;
+	}
 
-	#if 1//def FAC_DEBUG
-		printf("Using first %u odd primes; max gap = %u\n",nprime,2*max_diff);
-		printf("max sieving prime = %u\n",MAX_SIEVING_PRIME);
-	#endif
+/************************ END(RESTART STUFF) *******************/
 
-  #if 0
-	// Oct 2015: Play with Smarandache numbers ():
-	i = 2000000;	ASSERT(i <= nprime, "prime limit exceeded in testSmarandache!");
-	testSmarandache(100001,101000, pdiff, i);
-	exit(0);
-  #endif
-  #if 0
-	// Oct 2018: Play with "sieve survivors" stats: lim(n --> oo) prod_(p <= n)(1-1/p)/(1/ln(p^2))
-	i = 1000000000;	ASSERT(i <= MAX_SIEVING_PRIME, "prime limit exceeded in testSieveProdAsymp!");
-	struct qfloat qfprod = QHALF, qt;
-	double prod = 0.5, log_psq = log((double)i*i);
-	for(m = 0, curr_p = 3; m < nprime; m++) {
-		curr_p += (pdiff[m] << 1);
-		if(curr_p > i) break;
-		prod *= (1-1./curr_p);
-//	printf("p = %u: prod = %18.15f\n",curr_p,prod);
-		qt = qfsub(QONE,qf_rational_quotient(1ull,(uint64)curr_p));
-		qfprod = qfmul(qfprod,qt);
-	}
-	printf("Used primes <= %u: 1/ln(p^2) = %18.15f, prod_(p <= n)(1-1/p) = %18.15f, ratio = %18.15f, qfprod = %18.15f\n",i,log_psq,prod,log_psq*qfdbl(qfprod),qfdbl(qfprod));
-	exit(0);
+	/* 2*p*[number of classes] - done post-restart-file-read, since an incomplete run resumes using the class count it was started with: */
+	p2NC[lenP] = mi64_mul_scalar(p, (uint64)2*TF_CLASSES, p2NC, lenP);
+
+  #ifdef FAC_DEBUG
+	u64_arr[lenP] = mi64_mul_scalar(two_p,k_targ,u64_arr,lenP);	u64_arr[0] += 1;	// q = 2.k.p + 1
+	printf("FAC_DEBUG: Doing targeted debug-TF of %s(%s) with target factor candidate q = %s\n",NUM_PREFIX[MODULUS_TYPE],pstring,&char_buf0[convert_mi64_base10_char(char_buf0, u64_arr, lenQ, 0)]);
+	printf("two_p        = %s\n", &char_buf0[convert_mi64_base10_char(char_buf0, two_p, lenQ, 0)]);
+	printf("TF_CLASSES = %u\n",(uint32)TF_CLASSES);
   #endif
-/* Time the vector trialdiv stuff: */
-  #if TEST_TRIALDIV
-	for(i = 0; i < vec_len; i++)
+
+	// p mod TF_CLASSES:
+	if(MODULUS_TYPE == MODULUS_TYPE_MERSMERS)
 	{
-		xvec[i]  = rng_isaac_rand();
-	}
+		pmodNC = twopmmodq64(findex, (uint64)TF_CLASSES) - 1;	// For double-Mersenne factoring need M(p) mod #TF_CLASSES
+		/*
+		The above routine computes 2^p (mod 60) via Montgomery-mul-based powering. That requires an odd modulus,
+		so the actual powering step computes 2^(p-2) (mod 15), multiplies the result by 4 to get 2^p (mod 60),
+		and subtracts 1 to get M(p) (mod 60).
+
+		Note that there is a shortcut to obtaining 2^(p-2) (mod 15), namely summing the hex digits of 2^(p-2)
+		(mod 15). Since the hexadecimal base 16 == 1 (mod 15), this sum gives the desired result (mod 15).
+		Since 2^(p-2) i binary is just a 1 followed by (p-2) binary zeros, in base-16 it is just a leading hex
+		digit d = 2^((p-2)%4) followed by a string of (p-2)/4 hexadecimal zeros, the latter of which contribute
+		0 to the hex-digit sum (mod 15). Thus
 
-	clock1 = clock();
-	curr_p = 3;
-	for(m = 0; m < nprime; m++)
-	{
-		curr_p += (pdiff[m] << 1);
-		if(mi64_is_div_by_scalar32(xvec, curr_p, vec_len) == TRUE)
-			printf("mi64_is_div_by_scalar32 test: %10u is a divisor\n", curr_p);
-	}
+			2^(p-2) == 2^((p-2)%4) (mod 15), whence
 
-	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
-	tdiff = (double)(clock2 - clock1);
-	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
-	citer /= (double)vec_len*nprime;
-	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
+			M(p) == 4*2^((p-2)%4) - 1 (mod 60).
 
-	clock1 = clock();
-	curr_p = 3;
-	for(m = 0; m < nprime; m+=4)
-	{
-		curr_p += (pdiff[m  ] << 1); tryq[0] = curr_p;
-		curr_p += (pdiff[m+1] << 1); tryq[1] = curr_p;
-		curr_p += (pdiff[m+2] << 1); tryq[2] = curr_p;
-		curr_p += (pdiff[m+3] << 1); tryq[3] = curr_p;
-		j = mi64_is_div_by_scalar32_x4(xvec, tryq[0], tryq[1], tryq[2], tryq[3], vec_len);
-		if(j != 0)
-		{
-			for(i = 0; i < 4; ++i)
-			{
-				if((j >> i)&1)
-					printf("mi64_is_div_by_scalar32_x4 test: %10u is a divisor\n", tryq[i]);
-			}
+		For example, for p = 521 we have 2^(p-2) == 2^3 == 8 (mod 15), whence M(p) == 31 (mod 60).
+
+		For p = 607 we 2^(p-2) == 2^1 == 2 (mod 15), whence M(p) == 7 (mod 60).
+
+		In fact for any odd-exponent M(p) there are only the two possibilities p == 1 or 3 (mod 4), for
+		which 2^(p-2) == 2^3 or 2^1 (mod 15) and M(p) == 31 or 7 (mod 60), respectively.
+
+		For these two M(p) (mod 60) values the respective sets of 16 eligible k (mod 60) values of possible factors
+		q = 2.k.M(p) + 1 are
+
+			p == 1 (mod 4), M(p) == 31 (mod 60) : k (mod 60) = (any of) 0, 5, 8, 9,20,21,24,29,33,36,41,44,45,48,53,56
+
+			p == 3 (mod 4), M(p) ==  7 (mod 60) : k (mod 60) = (any of) 0, 5, 8, 9,12,17,20,24,29,32,33,44,45,48,53,57 .
+
+		M(p) == 31 or 7 (mod 60) also implies that the following check is not needed, but include it for formal completeness,
+		and in case someone else modifies this code for a purpose where the above call might in fact return 0 (mod 60):
+		*/
+		printf("p mod %u = %d\n", TF_CLASSES, pmodNC);
+		itmp32 = mi64_div_y32(p, TF_CLASSES, 0x0, lenP);
+		if(pmodNC != itmp32) {
+			printf("p mod %u v2 = %d\n", TF_CLASSES, itmp32);
+			fprintf(stderr,"Warning: Differing (p %% TF_CLASSES) values from Powering and direct-long-div! Proceeding using the 2nd result (%u).\n",itmp32);
+			pmodNC = itmp32;
 		}
+	} else {
+		pmodNC = mi64_div_y32(p, TF_CLASSES, 0x0, lenP);
 	}
 
-	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
-	tdiff = (double)(clock2 - clock1);
-	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
-	citer /= (double)vec_len*nprime;
-	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
+  #ifdef P1WORD
+	/* Find FP approximation to 2*p - can't use this for multiword case, because double approximation tp 2*p may overflow.
+	Needed for the q-interval printout below even when resuming an incomplete run: */
+	twop_float = (double)two_p[0];
+  #endif
 
-	clock1 = clock();
-	curr_p = 3;
-	for(m = 0; m < nprime; m += 8)
+  #warning bmax/kmax-synchro needs re-do!
+	/* If it's not a restart of an as-yet-uncompleted run, synchronize the factoring-bound params: */
+	if(!incomplete_run)
 	{
-		curr_p += (pdiff[m  ] << 1); tryq[0] = curr_p;
-		curr_p += (pdiff[m+1] << 1); tryq[1] = curr_p;
-		curr_p += (pdiff[m+2] << 1); tryq[2] = curr_p;
-		curr_p += (pdiff[m+3] << 1); tryq[3] = curr_p;
-		curr_p += (pdiff[m+4] << 1); tryq[4] = curr_p;
-		curr_p += (pdiff[m+5] << 1); tryq[5] = curr_p;
-		curr_p += (pdiff[m+6] << 1); tryq[6] = curr_p;
-		curr_p += (pdiff[m+7] << 1); tryq[7] = curr_p;
-		j = mi64_is_div_by_scalar32_x8(xvec, tryq[0], tryq[1], tryq[2], tryq[3], tryq[4], tryq[5], tryq[6], tryq[7], vec_len);
-		if(j != 0)
+		/* Double-check factoring pass bounds: */
+		if(passmax == 0xffffffff)
+			passmax = TF_PASSES-1;
+		if(passmin > (TF_PASSES-1) )
 		{
-			for(i = 0; i < 8; ++i)
-			{
-				if((j >> i)&1)
-					printf("mi64_is_div_by_scalar32_x8 test: %10u is a divisor\n", tryq[i]);
+			fprintf(stderr,"ERROR: passmin must be <= %u. Offending entry = %u.\n", TF_PASSES-1, passmin);
+			ASSERT(0,"0");
+		}
+
+		if(passmax < passmin)
+		{
+			fprintf(stderr,"ERROR: (passmax = %u) < (passmin = %u)!\n", passmax, passmin);
+			ASSERT(0,"0");
+		}
+		if(passmax > (TF_PASSES-1) )
+		{
+			fprintf(stderr,"ERROR: passmax must be <= %u. Offending entry = %u.\n", TF_PASSES-1, passmax);
+			ASSERT(0,"0");
+		}
+
+		/**** Process factor candidate bounds: ****/
+
+		/* If any of bmin|kmin, bmax|kmax nonzero, calculate its counterpart: */
+		/* Compute kmax if not already set: */
+		if(!kmax) {
+			ASSERT(bmax <= (nbits_in_p+65), "Specified bmax implies kmax > 64-bit, which exceeds the program's limit ... aborting.");
+			kmax = given_b_get_k(bmax, two_p, lenQ);
+			ASSERT(kmax > 0, "Something went wrong with the computation of kmax ... possibly your bmax implies kmax > 64-bit?");
+		}
+		if(kmin || bmin) {
+			if(kmin == 0ull) {	/* Lower Bound given in log2rithmic form */
+				ASSERT(bmin <= bmax, "bmin >= bmax!");
+				kmin = given_b_get_k(bmin, two_p, lenQ);
+			} else {
+				ASSERT(kmin <= kmax, "kmin >= kmax!");
+			#ifdef P1WORD
+				fqlo = kmin*twop_float + 1.0;
+				bmin = log(fqlo)*ILG2;
+			#endif
 			}
+		} else {
+		#ifdef P1WORD
+			fqlo = 1.0;
+		#endif
 		}
-	}
+		if(kmax || bmax) {
+			if(kmax == 0ull) {	/* Upper Bound given in log2rithmic form */
+				kmax = given_b_get_k(bmax, two_p, lenQ);
+ 			} else {
+			#ifdef P1WORD
+				fqhi = kmax*twop_float + 1.0;
+				bmax = log(fqhi)*ILG2;
+			#endif
+			}
+		} else
+			ASSERT(0 ,"factor.c : One of bmax, kmax must be nonzero!");
 
-	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
-	tdiff = (double)(clock2 - clock1);
-	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
-	citer /= (double)vec_len*nprime;
-	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
+		/**** At this point the paired elements bmin|kmin, bmax|kmax are in synchrony. ****/
 
-	clock1 = clock();
-	curr_p = 3;
-	for(m = 0; m < nprime; m++)
-	{
-		curr_p += (pdiff[m] << 1);
-		if(mi64_is_div_by_scalar64(xvec, (uint64)curr_p, vec_len) == TRUE)
-			printf("mi64_is_div_by_scalar64 test: %10u is a divisor\n", curr_p);
-	}
-	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that is violated it's no big deal at this point. */
-	tdiff = (double)(clock2 - clock1);
-	citer = tdiff*2000000000.0/CLOCKS_PER_SEC;
-	citer /= (double)vec_len*nprime;
-	printf	("Elapsed Time =%s; cycles/iter = %10.2f\n",get_time_str(tdiff),citer);
+		/* If kplus given on command line, a valid restart file should have been found
+		and kmax incremented at this point, i.e. kplus should have been reset to zero:
+		*/
+		ASSERT(kplus == 0, "kplus must be zero here!");
 
-	free((void*)xvec);
-  #endif
+		know = kmin;
+		passnow = passmin;
 
-/*   for p < max prime in precomputed table, need to truncate the range of primes...	*/
-	/*********** WHY WAS THIS HERE? *************
-	curr_p = MAX_SIEVING_PRIME;
-	for(;;)
-	{
-		if(p > curr_p) break;
-		curr_p -= (pdiff[nprime--] << 1);
-	#ifdef FAC_DEBUG
-		ASSERT(curr_p == prime[nprime], "factor.c : curr_p == prime[nprime]");
-	#endif
+	}	/* endif(!incomplete_run) */
+
+/*****************************************************/
+/****************** SIEVE STUFF: *********************/
+/*****************************************************/
+
+	bit_len = (len << TF_CLSHIFT)/TF_CLASSES;	// E.g. 255255*64/60 = 272272 bits in each of the 16 mod-60 sievelets
+
+/*   allocate the arrays and initialize the array of sieving primes	*/
+	temp_late = (uint64 *)calloc(len, sizeof(uint64));
+
+	i = (bit_len + 63)>>6;	// Round up for bit_len not divisible by 64, e.g. 60 classes
+	i++;	//**** Oct 2016: AVX-512 vector-bit-clear needs a padding element, so add one. ****
+	bit_map = (uint64 *)calloc(i * NTHREADS, sizeof(uint64));
+	bit_map2= (uint64 *)calloc(i * NTHREADS, sizeof(uint64));	// 2nd alloc to give each thread 1 bit-clearable copy of master bit_map
+	if (bit_map == NULL) {
+		fprintf(stderr,"Memory allocation failure for BITMAP array");
+		ASSERT(0,"0");
 	}
-	MAX_SIEVING_PRIME = curr_p;
-	***********/
+	bit_atlas = (uint64 *)calloc(i * TF_PASSES, sizeof(uint64));
+	if (bit_atlas == NULL) {
+		fprintf(stderr,"Memory allocation failure for TEMPLATE array");
+		ASSERT(0,"0");
+	}
+printf("Allocated %u words in master template, %u in per-pass bit_map [%u x that in bit_atlas]\n",len,i,TF_PASSES);
+
+	// Use as much of the shared sieving-prime table as is allowed by the exponent - this follows the chunking of the table
+	// generation loop, i.e. the table is cut off at the first length-30 chunk [curr_p, curr_p+29] not entirely < 2*p:
+	nprime = nprime_tab;	MAX_SIEVING_PRIME = max_sieving_prime_tab;
+  #ifdef P1WORD
+	if((uint64)MAX_SIEVING_PRIME+29 > two_p[0]) {
+		for(i = 0, curr_p = 3; i < nprime_tab; i++) {
+			curr_p += (pdiff[i] << 1);
+			if(curr_p >= 11 && (uint64)(curr_p - (curr_p - 11)%30) + 29 > two_p[0])
+				break;
+			MAX_SIEVING_PRIME = curr_p;
+		}
+		nprime = i;
+		printf("Using first %u odd primes; max sieving prime = %u\n",nprime,MAX_SIEVING_PRIME);
+	}
+  #endif
+  #if TF_BUCKET_SIEVE
+	tf_sieve_pmax = 0;	// Sieve depth is retuned for each run
+  #endif
 
 	/****************** KNOWN-TEST-FACTOR STUFF: *******************/
   #ifdef FAC_DEBUG
@@ -1784,24 +2064,17 @@ printf("Allocated %u words in master template, %u in per-pass bit_map [%u x that
 		printf("k mod %u = %d\n",TF_CLASSES, kmodNC);
 
 		/* ...and get the pass number on which the factor should be found.
-		(Remember that the pass number returned by CHECK_PKMOD[60|4620] is unit-offset).
+		(Remember that the pass number returned by CHECK_PKMOD is unit-offset).
 		If a known factor given, only process the given k/log2 range for that pass:
 		*/
-	#if TF_CLASSES == 60
-		pass_targ = CHECK_PKMOD60  (p,lenP, k_targ, 0x0) - 1;
-	#else	// 4620 classes:
-		pass_targ = CHECK_PKMOD4620(p,lenP, k_targ, 0x0) - 1;
-	#endif
+		pass_targ = CHECK_PKMOD(p,lenP, k_targ, 0x0, TF_CLASSES) - 1;
 		ASSERT((pass_targ < TF_PASSES), "Candidate factor set via k_targ is not a possible factor for this exponent!");
 		printf("Target pass for debug-factor = %u\n",pass_targ);
 	}
 
   #endif
 
-	itmp64 = (uint64)mi64_div_y32(p,TF_CLASSES,0x0,lenP);
-//	printf("p %% 60 = %" PRIu64 "\n",itmp64);
 
-  #if TF_CLASSES == 60
 /*
 	const int pmod_vec[] = { 1, 7,11,13,17,19,23,29,31,37,41,43,47,49,53,59, 2,4,8,16,32, 0x0};
 	for(i = 0; pmod_vec[i] != 0; i++) {
@@ -1832,8 +2105,12 @@ Fermat Fn (n > 0): 0,Acceptable km-values for the ? possible pm (= p%60) values:
 	pm = 16: 0, 6, 8,14,18,20,24,26,30,36,38,44,48,50,54,56	<*** F36 factor has k = 20 ... why do I miss? ***
 	pm = 32: 0, 4,10,12,18,22,24,28,30,34,40,42,48,52,54,58
 */
-	i = CHECK_PKMOD60  (&itmp64,1, k, incr);
-	ASSERT(i == TF_PASSES, "CHECK_PKMOD60 returns something other than the expected #TF_PASSES! Exponent not of the required form (odd prime or odd composite == any_of[1,7,11,13,17,19,23,29,31,37,41,43,47,49,53,59] (mod 60).\n");
+	// Pass the unmodded p here, since power-of-2-ness of Fermat-number exponents is not preserved (mod TF_CLASSES) in general:
+	i = CHECK_PKMOD(p,lenP, k, incr, TF_CLASSES);
+	if(i != TF_PASSES) {
+		sprintf(cbuf,"CHECK_PKMOD returns something other than the expected #TF_PASSES = %u! Exponent not of the required form, i.e. odd prime or odd composite coprime to %u.\n",TF_PASSES,TF_CLASSES);
+		ASSERT(0,cbuf);
+	}
 /*
 	printf("k mod 60 = [");
 	for(i = 0, j = 0; i < 16; i++) {
@@ -1843,10 +2120,6 @@ Fermat Fn (n > 0): 0,Acceptable km-values for the ? possible pm (= p%60) values:
 	printf("]\n");
 	exit(0);
 */
-  #else	// 4620 classes:
-	i = CHECK_PKMOD4620(&itmp64,1, k, incr);
-	ASSERT(i == TF_PASSES, "CHECK_PKMOD4620 returns something other than the expected #TF_PASSES! Exponent not of the required form (odd prime or odd composite == any_of[960 possible values] (mod 4620).\n");
-  #endif
 
 	/* If it's a restart, interval_lo for the initial pass will be based
 	on (know), rather than (kmin) - handle that just inside the pass-loop: */
@@ -1922,6 +2195,12 @@ Fermat Fn (n > 0): 0,Acceptable km-values for the ? possible pm (= p%60) values:
 	count = 0;	// Reset == 0 prior to sieving so kvector-fill code works properly
 	}
 
+  #if !FAC_DEBUG
+	tf_ckpt_init(RESTARTFILE, pstring, bmin,bmax, kmin,kmax, passmin,passnow,passmax, interval_lo,interval_now,interval_hi);
+  #else
+	tf_ckpt.nseg = 0;	// No checkpointing of debug runs
+  #endif
+
   #ifndef FACTOR_STANDALONE
 	fclose(fp);
   #endif
@@ -2078,8 +2357,10 @@ Fermat Fn (n > 0): 0,Acceptable km-values for the ? possible pm (= p%60) values:
 	for each of 960 sievelets concatenated into our bit_atlas, which thus has 226304/64 = 3536 words, with high word
 	[3535] using all its bits, as 226304 is divisible by 64.
 
+	TF_CLASSES = 420 is analogous, using 4 copies of the template, for 155584 bits = 2431 words per sievelet.
+
 	Now, we prefer not to have to allocate the full-length template array unless absolutely necessary, but for
-	the 4620 case we can simply re-use the 60-class version 64 times.
+	the larger moduli we can simply re-use the 60-class version 2^(TF_CLSHIFT-6) times.
 	*/
 	i = incr[0] - 1;
 	j = k = 0;
@@ -2089,11 +2370,7 @@ Fermat Fn (n > 0): 0,Acceptable km-values for the ? possible pm (= p%60) values:
 	{
 		l = 0;
 L3:
-	#if TF_CLASSES == 60
-		if(k == 0 && ncopies == 1) break;
-	#else	// 4620 classes:
-		if(k == 0 && ncopies == 64) break;
-	#endif
+		if(k == 0 && ncopies == (1u << (TF_CLSHIFT-6))) break;
 		for(;;) /* I loops over bits...	*/
 		{
 			word = (uint32)(j>>6);
@@ -2120,22 +2397,14 @@ L3:
 		} /* end of I loop	*/
 	}	/* end of K loop	*/
 //printf("L3: template word %u [used %u copies] bit_atlas chart %u, word %u, bit %u\n",(uint32)k,ncopies,l,word,bit);	exit(0);
-	// For 60|4620 classes expect to end at bit 15|63 of the last word of each of the TF_PASSES = 16|960 sievelets (a.k.a. charts in our atlas):
+	// Expect to end at the last bit of each of the TF_PASSES sievelets (a.k.a. charts in our atlas), e.g. for 60|4620 classes
+	// that is bit 15|63 of the last word of each of the TF_PASSES = 16|960 sievelets:
 	ASSERT((k == 0) && (l == 0), "bit_atlas init: Exit check 1 failed!");
-  #if TF_CLASSES == 60
-	ASSERT((word == 4254) && (bit == 15), "bit_atlas init: Exit check 2 failed!");
-  #else	// 4620 classes:
-	ASSERT((word == 3535) && (bit == 63), "bit_atlas init: Exit check 2 failed!");
-  #endif
+	ASSERT((word == (bit_len-1)>>6) && (bit == ((bit_len-1)&63)), "bit_atlas init: Exit check 2 failed!");
 
   #ifdef FAC_DEBUG
-  #if TF_CLASSES == 60
-	i = len/TF_CLASSES + 1;	// len not divisible by TF_CLASSES, so add a pad-word
-	j = i*64 - 48;	// #bits
-  #else
-	i = (len*64)/TF_CLASSES;	// 64*len divisible by TF_CLASSES, no need for padding
-	j = i*64;	// #bits
-  #endif
+	i = (bit_len + 63)>>6;
+	j = bit_len;	// #bits
 	l = 0;	// accum popc
 	for(m = 0; m < i; m++) {
 		l += popcount64(bit_atlas[m]);
@@ -2152,34 +2421,35 @@ L3:
 	for(i = 1; i < TF_PASSES; i++) {	// Skip pass 0 here
 		incr[i] = incr[i-1] + incr[i];
 	}
-  #if TF_CLASSES == 60
-	i = 0;
-	switch(pmodNC)
-	{
-		/*   p mod 12 = 1:	*/
-		case  1:ASSERT(incr[i++]== 3&&incr[i++]== 8&&incr[i++]==11&&incr[i++]==15&&incr[i++]==20&&incr[i++]==23&&incr[i++]==24&&incr[i++]==35&&incr[i++]==36&&incr[i++]==39&&incr[i++]==44&&incr[i++]==48&&incr[i++]==51&&incr[i++]==56&&incr[i++]==59&&incr[i++]==60, "factor.c : case  1"); break;	/* k mod 5 .ne. 2	*/
-		case 37:ASSERT(incr[i++]== 3&&incr[i++]== 8&&incr[i++]==12&&incr[i++]==15&&incr[i++]==20&&incr[i++]==23&&incr[i++]==24&&incr[i++]==27&&incr[i++]==32&&incr[i++]==35&&incr[i++]==39&&incr[i++]==44&&incr[i++]==47&&incr[i++]==48&&incr[i++]==59&&incr[i++]==60, "factor.c : case 37"); break;	/* k mod 5 .ne. 1	*/
-		case 13:ASSERT(incr[i++]== 3&&incr[i++]== 8&&incr[i++]==11&&incr[i++]==12&&incr[i++]==15&&incr[i++]==20&&incr[i++]==23&&incr[i++]==27&&incr[i++]==32&&incr[i++]==35&&incr[i++]==36&&incr[i++]==47&&incr[i++]==48&&incr[i++]==51&&incr[i++]==56&&incr[i++]==60, "factor.c : case 13"); break;	/* k mod 5 .ne. 4	*/
-		case 49:ASSERT(incr[i++]==11&&incr[i++]==12&&incr[i++]==15&&incr[i++]==20&&incr[i++]==24&&incr[i++]==27&&incr[i++]==32&&incr[i++]==35&&incr[i++]==36&&incr[i++]==39&&incr[i++]==44&&incr[i++]==47&&incr[i++]==51&&incr[i++]==56&&incr[i++]==59&&incr[i++]==60, "factor.c : case 49"); break;	/* k mod 5 .ne. 3	*/
-		/*   p mod 12 == 7:	*/
-		case 31:ASSERT(incr[i++]== 5&&incr[i++]== 8&&incr[i++]== 9&&incr[i++]==20&&incr[i++]==21&&incr[i++]==24&&incr[i++]==29&&incr[i++]==33&&incr[i++]==36&&incr[i++]==41&&incr[i++]==44&&incr[i++]==45&&incr[i++]==48&&incr[i++]==53&&incr[i++]==56&&incr[i++]==60, "factor.c : case 31"); break;	/* k mod 5 .ne. 2	*/
-		case  7:ASSERT(incr[i++]== 5&&incr[i++]== 8&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==17&&incr[i++]==20&&incr[i++]==24&&incr[i++]==29&&incr[i++]==32&&incr[i++]==33&&incr[i++]==44&&incr[i++]==45&&incr[i++]==48&&incr[i++]==53&&incr[i++]==57&&incr[i++]==60, "factor.c : case  7"); break;	/* k mod 5 .ne. 1	*/
-		case 43:ASSERT(incr[i++]== 5&&incr[i++]== 8&&incr[i++]==12&&incr[i++]==17&&incr[i++]==20&&incr[i++]==21&&incr[i++]==32&&incr[i++]==33&&incr[i++]==36&&incr[i++]==41&&incr[i++]==45&&incr[i++]==48&&incr[i++]==53&&incr[i++]==56&&incr[i++]==57&&incr[i++]==60, "factor.c : case 43"); break;	/* k mod 5 .ne. 4	*/
-		case 19:ASSERT(incr[i++]== 5&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==17&&incr[i++]==20&&incr[i++]==21&&incr[i++]==24&&incr[i++]==29&&incr[i++]==32&&incr[i++]==36&&incr[i++]==41&&incr[i++]==44&&incr[i++]==45&&incr[i++]==56&&incr[i++]==57&&incr[i++]==60, "factor.c : case 19"); break;	/* k mod 5 .ne. 3	*/
-		/*   p mod 12 == 5:	*/
-		case 41:ASSERT(incr[i++]== 3&&incr[i++]== 4&&incr[i++]==15&&incr[i++]==16&&incr[i++]==19&&incr[i++]==24&&incr[i++]==28&&incr[i++]==31&&incr[i++]==36&&incr[i++]==39&&incr[i++]==40&&incr[i++]==43&&incr[i++]==48&&incr[i++]==51&&incr[i++]==55&&incr[i++]==60, "factor.c : case 41"); break;	/* k mod 5 .ne. 2	*/
-		case 17:ASSERT(incr[i++]== 3&&incr[i++]== 4&&incr[i++]== 7&&incr[i++]==12&&incr[i++]==15&&incr[i++]==19&&incr[i++]==24&&incr[i++]==27&&incr[i++]==28&&incr[i++]==39&&incr[i++]==40&&incr[i++]==43&&incr[i++]==48&&incr[i++]==52&&incr[i++]==55&&incr[i++]==60, "factor.c : case 17"); break;	/* k mod 5 .ne. 1	*/
-		case 53:ASSERT(incr[i++]== 3&&incr[i++]== 7&&incr[i++]==12&&incr[i++]==15&&incr[i++]==16&&incr[i++]==27&&incr[i++]==28&&incr[i++]==31&&incr[i++]==36&&incr[i++]==40&&incr[i++]==43&&incr[i++]==48&&incr[i++]==51&&incr[i++]==52&&incr[i++]==55&&incr[i++]==60, "factor.c : case 53"); break;	/* k mod 5 .ne. 4	*/
-		case 29:ASSERT(incr[i++]== 4&&incr[i++]== 7&&incr[i++]==12&&incr[i++]==15&&incr[i++]==16&&incr[i++]==19&&incr[i++]==24&&incr[i++]==27&&incr[i++]==31&&incr[i++]==36&&incr[i++]==39&&incr[i++]==40&&incr[i++]==51&&incr[i++]==52&&incr[i++]==55&&incr[i++]==60, "factor.c : case 29"); break;	/* k mod 5 .ne. 3	*/
-		/*   p mod 12 == 11:	*/
-		case 11:ASSERT(incr[i++]== 1&&incr[i++]== 4&&incr[i++]== 9&&incr[i++]==13&&incr[i++]==16&&incr[i++]==21&&incr[i++]==24&&incr[i++]==25&&incr[i++]==28&&incr[i++]==33&&incr[i++]==36&&incr[i++]==40&&incr[i++]==45&&incr[i++]==48&&incr[i++]==49&&incr[i++]==60, "factor.c : case 11"); break;	/* k mod 5 .ne. 2	*/
-		case 47:ASSERT(incr[i++]== 4&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==13&&incr[i++]==24&&incr[i++]==25&&incr[i++]==28&&incr[i++]==33&&incr[i++]==37&&incr[i++]==40&&incr[i++]==45&&incr[i++]==48&&incr[i++]==49&&incr[i++]==52&&incr[i++]==57&&incr[i++]==60, "factor.c : case 47"); break;	/* k mod 5 .ne. 1	*/
-		case 23:ASSERT(incr[i++]== 1&&incr[i++]==12&&incr[i++]==13&&incr[i++]==16&&incr[i++]==21&&incr[i++]==25&&incr[i++]==28&&incr[i++]==33&&incr[i++]==36&&incr[i++]==37&&incr[i++]==40&&incr[i++]==45&&incr[i++]==48&&incr[i++]==52&&incr[i++]==57&&incr[i++]==60, "factor.c : case 23"); break;	/* k mod 5 .ne. 4	*/
-		case 59:ASSERT(incr[i++]== 1&&incr[i++]== 4&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==16&&incr[i++]==21&&incr[i++]==24&&incr[i++]==25&&incr[i++]==36&&incr[i++]==37&&incr[i++]==40&&incr[i++]==45&&incr[i++]==49&&incr[i++]==52&&incr[i++]==57&&incr[i++]==60, "factor.c : case 59"); break;	/* k mod 5 .ne. 3	*/
-		default:
-			ASSERT(MODULUS_TYPE == MODULUS_TYPE_FERMAT,"Only Mersenne and fermat-number factoring supported!");
+	// Spot-check the on-the-fly-generated tables vs hardcoded ones for the 60-class case:
+	if(TF_CLASSES == 60) {
+		i = 0;
+		switch(pmodNC)
+		{
+			/*   p mod 12 = 1:	*/
+			case  1:ASSERT(incr[i++]== 3&&incr[i++]== 8&&incr[i++]==11&&incr[i++]==15&&incr[i++]==20&&incr[i++]==23&&incr[i++]==24&&incr[i++]==35&&incr[i++]==36&&incr[i++]==39&&incr[i++]==44&&incr[i++]==48&&incr[i++]==51&&incr[i++]==56&&incr[i++]==59&&incr[i++]==60, "factor.c : case  1"); break;	/* k mod 5 .ne. 2	*/
+			case 37:ASSERT(incr[i++]== 3&&incr[i++]== 8&&incr[i++]==12&&incr[i++]==15&&incr[i++]==20&&incr[i++]==23&&incr[i++]==24&&incr[i++]==27&&incr[i++]==32&&incr[i++]==35&&incr[i++]==39&&incr[i++]==44&&incr[i++]==47&&incr[i++]==48&&incr[i++]==59&&incr[i++]==60, "factor.c : case 37"); break;	/* k mod 5 .ne. 1	*/
+			case 13:ASSERT(incr[i++]== 3&&incr[i++]== 8&&incr[i++]==11&&incr[i++]==12&&incr[i++]==15&&incr[i++]==20&&incr[i++]==23&&incr[i++]==27&&incr[i++]==32&&incr[i++]==35&&incr[i++]==36&&incr[i++]==47&&incr[i++]==48&&incr[i++]==51&&incr[i++]==56&&incr[i++]==60, "factor.c : case 13"); break;	/* k mod 5 .ne. 4	*/
+			case 49:ASSERT(incr[i++]==11&&incr[i++]==12&&incr[i++]==15&&incr[i++]==20&&incr[i++]==24&&incr[i++]==27&&incr[i++]==32&&incr[i++]==35&&incr[i++]==36&&incr[i++]==39&&incr[i++]==44&&incr[i++]==47&&incr[i++]==51&&incr[i++]==56&&incr[i++]==59&&incr[i++]==60, "factor.c : case 49"); break;	/* k mod 5 .ne. 3	*/
+			/*   p mod 12 == 7:	*/
+			case 31:ASSERT(incr[i++]== 5&&incr[i++]== 8&&incr[i++]== 9&&incr[i++]==20&&incr[i++]==21&&incr[i++]==24&&incr[i++]==29&&incr[i++]==33&&incr[i++]==36&&incr[i++]==41&&incr[i++]==44&&incr[i++]==45&&incr[i++]==48&&incr[i++]==53&&incr[i++]==56&&incr[i++]==60, "factor.c : case 31"); break;	/* k mod 5 .ne. 2	*/
+			case  7:ASSERT(incr[i++]== 5&&incr[i++]== 8&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==17&&incr[i++]==20&&incr[i++]==24&&incr[i++]==29&&incr[i++]==32&&incr[i++]==33&&incr[i++]==44&&incr[i++]==45&&incr[i++]==48&&incr[i++]==53&&incr[i++]==57&&incr[i++]==60, "factor.c : case  7"); break;	/* k mod 5 .ne. 1	*/
+			case 43:ASSERT(incr[i++]== 5&&incr[i++]== 8&&incr[i++]==12&&incr[i++]==17&&incr[i++]==20&&incr[i++]==21&&incr[i++]==32&&incr[i++]==33&&incr[i++]==36&&incr[i++]==41&&incr[i++]==45&&incr[i++]==48&&incr[i++]==53&&incr[i++]==56&&incr[i++]==57&&incr[i++]==60, "factor.c : case 43"); break;	/* k mod 5 .ne. 4	*/
+			case 19:ASSERT(incr[i++]== 5&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==17&&incr[i++]==20&&incr[i++]==21&&incr[i++]==24&&incr[i++]==29&&incr[i++]==32&&incr[i++]==36&&incr[i++]==41&&incr[i++]==44&&incr[i++]==45&&incr[i++]==56&&incr[i++]==57&&incr[i++]==60, "factor.c : case 19"); break;	/* k mod 5 .ne. 3	*/
+			/*   p mod 12 == 5:	*/
+			case 41:ASSERT(incr[i++]== 3&&incr[i++]== 4&&incr[i++]==15&&incr[i++]==16&&incr[i++]==19&&incr[i++]==24&&incr[i++]==28&&incr[i++]==31&&incr[i++]==36&&incr[i++]==39&&incr[i++]==40&&incr[i++]==43&&incr[i++]==48&&incr[i++]==51&&incr[i++]==55&&incr[i++]==60, "factor.c : case 41"); break;	/* k mod 5 .ne. 2	*/
+			case 17:ASSERT(incr[i++]== 3&&incr[i++]== 4&&incr[i++]== 7&&incr[i++]==12&&incr[i++]==15&&incr[i++]==19&&incr[i++]==24&&incr[i++]==27&&incr[i++]==28&&incr[i++]==39&&incr[i++]==40&&incr[i++]==43&&incr[i++]==48&&incr[i++]==52&&incr[i++]==55&&incr[i++]==60, "factor.c : case 17"); break;	/* k mod 5 .ne. 1	*/
+			case 53:ASSERT(incr[i++]== 3&&incr[i++]== 7&&incr[i++]==12&&incr[i++]==15&&incr[i++]==16&&incr[i++]==27&&incr[i++]==28&&incr[i++]==31&&incr[i++]==36&&incr[i++]==40&&incr[i++]==43&&incr[i++]==48&&incr[i++]==51&&incr[i++]==52&&incr[i++]==55&&incr[i++]==60, "factor.c : case 53"); break;	/* k mod 5 .ne. 4	*/
+			case 29:ASSERT(incr[i++]== 4&&incr[i++]== 7&&incr[i++]==12&&incr[i++]==15&&incr[i++]==16&&incr[i++]==19&&incr[i++]==24&&incr[i++]==27&&incr[i++]==31&&incr[i++]==36&&incr[i++]==39&&incr[i++]==40&&incr[i++]==51&&incr[i++]==52&&incr[i++]==55&&incr[i++]==60, "factor.c : case 29"); break;	/* k mod 5 .ne. 3	*/
+			/*   p mod 12 == 11:	*/
+			case 11:ASSERT(incr[i++]== 1&&incr[i++]== 4&&incr[i++]== 9&&incr[i++]==13&&incr[i++]==16&&incr[i++]==21&&incr[i++]==24&&incr[i++]==25&&incr[i++]==28&&incr[i++]==33&&incr[i++]==36&&incr[i++]==40&&incr[i++]==45&&incr[i++]==48&&incr[i++]==49&&incr[i++]==60, "factor.c : case 11"); break;	/* k mod 5 .ne. 2	*/
+			case 47:ASSERT(incr[i++]== 4&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==13&&incr[i++]==24&&incr[i++]==25&&incr[i++]==28&&incr[i++]==33&&incr[i++]==37&&incr[i++]==40&&incr[i++]==45&&incr[i++]==48&&incr[i++]==49&&incr[i++]==52&&incr[i++]==57&&incr[i++]==60, "factor.c : case 47"); break;	/* k mod 5 .ne. 1	*/
+			case 23:ASSERT(incr[i++]== 1&&incr[i++]==12&&incr[i++]==13&&incr[i++]==16&&incr[i++]==21&&incr[i++]==25&&incr[i++]==28&&incr[i++]==33&&incr[i++]==36&&incr[i++]==37&&incr[i++]==40&&incr[i++]==45&&incr[i++]==48&&incr[i++]==52&&incr[i++]==57&&incr[i++]==60, "factor.c : case 23"); break;	/* k mod 5 .ne. 4	*/
+			case 59:ASSERT(incr[i++]== 1&&incr[i++]== 4&&incr[i++]== 9&&incr[i++]==12&&incr[i++]==16&&incr[i++]==21&&incr[i++]==24&&incr[i++]==25&&incr[i++]==36&&incr[i++]==37&&incr[i++]==40&&incr[i++]==45&&incr[i++]==49&&incr[i++]==52&&incr[i++]==57&&incr[i++]==60, "factor.c : case 59"); break;	/* k mod 5 .ne. 3	*/
+			default:
+				ASSERT(MODULUS_TYPE == MODULUS_TYPE_FERMAT,"Only Mersenne and fermat-number factoring supported!");
+		}
 	}
-  #endif
 
 	clock2 = clock();	/* Assume sieve setup time < 2^32 cycles - even if that
 							that is violated it's no big deal at this point. */
@@ -2198,6 +2468,15 @@ L3:
   #ifdef FACTOR_STANDALONE
 	if(!restart)
 		printf("Time to set up sieve =%s\n",get_time_str(td));
+  #else
+	fp = mlucas_fopen(STATFILE,"a");
+	fprintf(fp,"Time to set up sieve =%s\n",get_time_str(td));
+	fclose(fp); fp = 0x0;
+  #endif
+
+  #if TF_DISPATCH
+	// Pick the fastest modpow kernel for each q-size covered by the run; the per-thread q,q2 slices of thread 0 serve as scratch:
+	tf_kernel_calibrate(MODULUS_TYPE, p, lenP, fbits_in_2p, know, interval_hi*((uint64)len << TF_CLSHIFT), q, lenQ, q2);
   #endif
 
 /* Run through each of the 16 "sievelets" as many times as necessary, each time copying
@@ -2205,7 +2484,8 @@ the appropriate q mod 8 and small-prime bit-cleared bit_atlas into memory, clear
 corresponding to multiples of the larger tabulated primes, and trial-factoring any
 candidate factors that survive sieving.	*/
 
-	nfactor = 0;
+	nfactor = tf_ckpt_factors(factor_k, 16);	// Any factors found prior to a restart; factor_k[] has room for 24
+	tf_ckpt_start();
 
   #ifdef FAC_DEBUG
 	/* If a known factor given, only process the given k/log2 range for that pass: */
@@ -2231,141 +2511,122 @@ candidate factors that survive sieving.	*/
 
 	// Populate the work-unit-encoding data structs which will get done by our pool of threads.
 	// Current assignment may be restart of a partially-completed run, in which case npass < TF_PASSES
-  #if TF_CLASSES == 60
-	m = len/TF_CLASSES + 1;	// len not divisible by TF_CLASSES, so add a pad-word
-  #else
-	m = (len*64)/TF_CLASSES;	// 64*len divisible by TF_CLASSES, no need for padding
-  #endif
-	uint32 npass = passmax - passnow + 1;
+	m = (bit_len + 63)>>6;	// Round up for bit_len not divisible by 64, e.g. 60 classes
+	uint32 npass = passmax - passnow + 1, next_pass = passnow;
 	fprintf(stderr, "INFO: %u passes to do; bit_map has %u 64-bit words.\n",npass,m);
 	/*
-	Break overall work into ceil(npass/NTHREADS) 'waves' of NTHREADS each, i.e. each wave using all
-	threads in the pool, with thread-synchronization at the end of each thread's factoring interval.
-	We need to sync up (rather than just allowing each thread to grab more work as soon as it's done
-	with its current (k mod) interval) because we memalloc for only NTHREADS concurrent threads, thus
-	e.g. using NTHREADS = 4 if we start with passes 0-3 and the pass 0 and 2 threads finish ahead of 1 and 3,
-	those 2 faster threads will get assigned the pass 4 and 5 work, and since 5 == 1 (mod NTHREADS), that
-	thread's memory footprint will overlap that of the not-yet-complete pass 1 thread's.
+	Work is dispatched at class granularity: each of the NTHREADS pool tasks claims the next as-yet-undone pass
+	(i.e. k-class) as soon as it finishes its current one, until all passes are done. Each task uses its own thread-local
+	slice of the bit_map, q, etc arrays for all the passes it does, so there is no need to sync up the threads after
+	every NTHREADS passes, which would leave threads idle while the slowest pass of each such 'wave' completes.
+	Together with a class count giving many more passes than threads (e.g. 960 for 64 threads) this gives near-full utilization.
+	*/
+	ASSERT(know == (know/((uint64)len << TF_CLSHIFT))*((uint64)len << TF_CLSHIFT), "know not a multiple of the sieve interval!");
+	ASSERT(kmin == (kmin/((uint64)len << TF_CLSHIFT))*((uint64)len << TF_CLSHIFT), "kmin not a multiple of the sieve interval!");
+  #if TF_PIPELINE
+	/*
+	Pipelined mode: the first tf_pipe_nsieve threads claim passes as above, but queue their surviving k's into their own ring
+	rather than testing them, and the others test the queued k's. Start with an even split, which tf_pipe_worker()
+	then rebalances based on the time the sieve threads spend waiting on full rings vs the modpow threads spend idle:
 	*/
-	uint32 wave, wave_max = ceil( (double)npass/NTHREADS );
-	fprintf(stderr,"INFO: Doing %u threadpool-waves of %u pool threads each:\n",wave_max,NTHREADS);
-	for(wave = 0; wave < wave_max; wave++)
+	if(tf_pipeline && NTHREADS < 2) {
+		fprintf(stderr,"INFO: Pipelined mode needs at least 2 threads; running unpipelined.\n");
+	}
+	if(tf_pipeline && NTHREADS > 1) {
+		tf_ring = (struct tf_ring_t *)calloc(NTHREADS, sizeof(struct tf_ring_t));	ASSERT(tf_ring != 0x0, "FATAL: unable to allocate tf_ring[].");
+		for(i = 0; i < NTHREADS; i++) {
+			pthread_mutex_init(&tf_ring[i].claim, NULL);
+		}
+		tf_pipe_nsieve = MAX(NTHREADS/2, 1);	tf_pipe_nbusy = 0;
+		tf_pipe_twait = tf_pipe_tidle = 0;	tf_pipe_tlast = getRealTime();
+		task_control.run = (void*)tf_pipe_worker;
+		fprintf(stderr,"INFO: Pipelined mode: starting with %u sieve + %u modpow threads.\n",tf_pipe_nsieve,NTHREADS - tf_pipe_nsieve);
+	} else {
+		task_control.run = (void*)tf_class_worker;
+	}
+  #endif
+	fprintf(stderr,"INFO: Dispatching %u passes to %u pool threads:\n",npass,MIN(NTHREADS,npass));
+	for(thr_id = 0; thr_id < NTHREADS; thr_id++)	// Unique task ID used for slotting thread-local accesses to shared data arrays
 	{
-		for(thr_id = 0; thr_id < NTHREADS; thr_id++)	// Unique (within the context of the current wave) task ID
-		{												// used for slotting thread-local accesses to shared data arrays
-			i = wave*NTHREADS + thr_id;
-			pass = passnow + i;
-			// For partial-waves, easiest is to proceed as usual, 'init' the full NTHREADS pool tasks,
-			// but make the extra ones no-ops. But also need to avoid reading nonexistent bitmap data:
-			if(pass <= passmax) {
-				// Load 'master copy' of sievelet for the current pass number:
-				for(l = 0; l < m; l++) {
-					bit_map[l + m * thr_id] = *(bit_atlas + (l * TF_PASSES) + pass);
-				}
-
-				/* Starting no.-of-times-through-sieve = kmin/(64*len) : */
-				if(pass == passnow && (know > kmin)) {
-					interval_lo = know/((uint64)len << TF_CLSHIFT);
-					ASSERT(know == interval_lo *(len << TF_CLSHIFT),"know == interval_lo*(len << TF_CLSHIFT)");
-				} else {
-					interval_lo = kmin/((uint64)len << TF_CLSHIFT);
-					ASSERT(kmin == interval_lo *(len << TF_CLSHIFT),"kmin == interval_lo*(len << TF_CLSHIFT)");
-				}
-			} else {
-				interval_lo = interval_hi;	// This is what defines a 'no-op' pool task.
-			}
-			/* Set initial k for this pass to default value (= incr[pass]) + interval_lo*(64*len),
-			(assume this could be as large as 64 bits), then use it to set initial q for this pass:
-			*/
-			ASSERT((double)interval_lo*(len << TF_CLSHIFT) < TWO64FLOAT, "(double)interval_lo*len < TWO64FLOAT");
-			k = (uint64)incr[pass] + interval_lo*(len << TF_CLSHIFT);
-		//	fprintf(stderr," [*** Init pass %u data: k0 = %" PRIu64 ", word0 = %16" PRIX64 "\n",pass,k,bit_map[0]);
-			struct fac_thread_data_t* targ = tdat + thr_id;
-			targ->count = &count;
-			targ->tid = thr_id;		// Within the per-thread TFing, only the pool-thread ID matters
-			targ->pass = pass;
-			targ->interval_lo = interval_lo;
-			targ->interval_hi = interval_hi;
-			targ->fbits_in_2p = fbits_in_2p;
-		#ifdef USE_AVX512
-			targ->psmall = psmall;
-		#endif
-			targ->nclear = nclear;
-			targ->sieve_len = len;
-			targ->p_last_small = p_last_small;
-			targ->nprime = nprime;
-			targ->MAX_SIEVING_PRIME = MAX_SIEVING_PRIME;
-			targ->pdiff = pdiff + NUM_SIEVING_PRIME * thr_id;
-			targ->startval = startval + NUM_SIEVING_PRIME * thr_id;
-			targ->k_to_try = k_to_try + TRYQ              * thr_id;
-			targ->factor_k = factor_k + TRYQ              * thr_id;
-			targ->nfactor = &nfactor;
-			targ->findex = findex;
-			targ->pstring = pstring;
-			targ->p     = p;
-			targ->two_p = two_p;
-			targ->q       = q       + lenQ * thr_id;
-			targ->q2      = q2      + lenQ * thr_id;
-			targ->u64_arr = u64_arr + lenQ * thr_id;
-			targ->lenP = lenP;
-			targ->lenQ = lenQ;
-			targ->kdeep = kdeep;
-			targ->ndeep = &ndeep;
-			targ->countmask = countmask;
-			targ->CMASKBITS = CMASKBITS;
-			targ->incr = incr[pass];
-			targ->kstart = k;
-			targ->bit_map  = bit_map  + m * thr_id;
-			targ->bit_map2 = bit_map2 + m * thr_id;
-			targ->tdiff = &tdiff;	// In || mode update tdiff directly, but only from the 0-thread
-			targ->MODULUS_TYPE = MODULUS_TYPE;
-			targ->VERSION      = VERSION;
-			targ->OFILE        = OFILE;
-
-		}	// thr_id-loop
-		// Use exit value of [pass] here: If doing only a subset of the full 'current wave' complement
-		// of NTHREADS passes - this can only occur during the final wave - adjust pool_work_units accordingly:
-		if(pass > passmax) {
-			pool_work_units = NTHREADS - (pass - passmax);	// Subtract excess #passes from default pool_work_units value
-			fprintf(stderr,"INFO: Final threadpool wave will use only %u of the %u pool threads.\n",pool_work_units,NTHREADS);
-		}
-
-		if(pool_work_units > 1)
-			fprintf(stderr, "Passes %u - %u: ",pass-NTHREADS+1, pass-NTHREADS+pool_work_units);
-		else
-			fprintf(stderr, "Pass %u: ",pass);
+		struct fac_thread_data_t* targ = tdat + thr_id;
+		targ->count = &count;
+		targ->tid = thr_id;		// Within the per-thread TFing, only the pool-thread ID matters
+		targ->interval_hi = interval_hi;
+		targ->fbits_in_2p = fbits_in_2p;
+	#ifdef USE_AVX512
+		targ->psmall = psmall;
+	#endif
+		targ->nclear = nclear;
+		targ->sieve_len = len;
+		targ->p_last_small = p_last_small;
+		targ->nprime = nprime;
+		targ->MAX_SIEVING_PRIME = MAX_SIEVING_PRIME;
+		targ->pdiff = pdiff + NUM_SIEVING_PRIME * thr_id;
+		targ->startval = startval + NUM_SIEVING_PRIME * thr_id;
+		targ->k_to_try = k_to_try + TRYQ              * thr_id;
+		targ->factor_k = factor_k + TRYQ              * thr_id;
+		targ->nfactor = &nfactor;
+		targ->findex = findex;
+		targ->pstring = pstring;
+		targ->p     = p;
+		targ->two_p = two_p;
+		targ->q       = q       + lenQ * thr_id;
+		targ->q2      = q2      + lenQ * thr_id;
+		targ->u64_arr = u64_arr + lenQ * thr_id;
+		targ->lenP = lenP;
+		targ->lenQ = lenQ;
+		targ->kdeep = kdeep;
+		targ->ndeep = &ndeep;
+		targ->countmask = countmask;
+		targ->CMASKBITS = CMASKBITS;
+		targ->bit_map  = bit_map  + m * thr_id;
+		targ->bit_map2 = bit_map2 + m * thr_id;
+		targ->tdiff = &tdiff;	// In || mode update tdiff directly, but only from the 0-thread
+		targ->MODULUS_TYPE = MODULUS_TYPE;
+		targ->VERSION      = VERSION;
+		targ->OFILE        = OFILE;
+		// Per-pass fields get set by tf_class_worker() from these:
+		targ->next_pass = &next_pass;
+		targ->passnow = passnow;
+		targ->passmax = passmax;
+		targ->kmin = kmin;
+		targ->know = know;
+		targ->pass_incr = incr;
+		targ->bit_atlas = bit_atlas;
+		targ->map_words = m;
+	#if TF_PIPELINE
+		targ->ring = 0x0;
+	#endif
+	}	// thr_id-loop
 
-		// For partial-waves, easiest is to proceed as usual, 'init' the full NTHREADS pool tasks,
-		// but make the extra ones no-ops. Here that means adding the full complement of NTHREADS tasks to the pool:
-		for(thr_id = 0; thr_id < NTHREADS; ++thr_id)
-		{
-			task_control.data = (void*)(&tdat[thr_id]);
-			threadpool_add_task(tpool, &task_control, task_is_blocking);
-		#if 0
-			printf("adding pool task %d with pool ID [%d]\n",thr_id,((struct thread_init *)(&task_control)->data)->thread_num);
-			struct fac_thread_data_t* targ = tdat + thr_id;
-			printf("This task has: pass %u, interval_[lo,hi] = [%" PRIu64 ",%" PRIu64 "]\n",targ->pass,targ->interval_lo,targ->interval_hi);
-			printf("; #tasks = %d, #free_tasks = %d\n", tpool->tasks_queue.num_tasks, tpool->free_tasks_queue.num_tasks);
-		#endif
-		}
+	// Tasks which find no pass left to claim return immediately, so simply add the full complement of NTHREADS tasks to the pool:
+	for(thr_id = 0; thr_id < NTHREADS; ++thr_id)
+	{
+		task_control.data = (void*)(&tdat[thr_id]);
+		threadpool_add_task(tpool, &task_control, task_is_blocking);
+	}
 
-		while(tpool->free_tasks_queue.num_tasks != NTHREADS) {
-			// Posix sleep() too granular here; use finer-resolution, declared in <time.h>; cf. http://linux.die.net/man/2/nanosleep
-			ASSERT(0 == mlucas_nanosleep(&ns_time), "nanosleep fail!");
+	while(tpool->free_tasks_queue.num_tasks != NTHREADS) {
+		// Posix sleep() too granular here; use finer-resolution, declared in <time.h>; cf. http://linux.die.net/man/2/nanosleep
+		ASSERT(0 == mlucas_nanosleep(&ns_time), "nanosleep fail!");
+	}
+	fprintf(stderr,"\n");
+  #if TF_PIPELINE
+	if(tf_ring) {
+		fprintf(stderr,"INFO: Pipelined mode: ended with %u sieve + %u modpow threads.\n",tf_pipe_nsieve,NTHREADS - tf_pipe_nsieve);
+		for(i = 0; i < NTHREADS; i++) {
+			pthread_mutex_destroy(&tf_ring[i].claim);
 		}
-		fprintf(stderr,"\n");	// For pretty-printing, have the inline-pass-printing reflect || work, newlines reflect sync-points
-	};	// wave-loop
+		free((void *)tf_ring);	tf_ring = 0x0;
+	}
+  #endif
 
   #else	// Single-threaded execution:
 
 	for(pass = passnow; pass <= passmax; pass++)
 	{
 		// Load 'master copy' of sievelet for the current pass number:
-	  #if TF_CLASSES == 60
-		m = len/TF_CLASSES + 1;	// len not divisible by TF_CLASSES, so add a pad-word
-	  #else
-		m = (len*64)/TF_CLASSES;	// 64*len divisible by TF_CLASSES, no need for padding
-	  #endif
+		m = (bit_len + 63)>>6;	// Round up for bit_len not divisible by 64, e.g. 60 classes
 		for(i = 0; i < m; i++) {
 			bit_map[i] = *(bit_atlas + (i * TF_PASSES) + pass);
 		}
@@ -2397,6 +2658,10 @@ candidate factors that survive sieving.	*/
 			interval_lo = kmin/((uint64)len << TF_CLSHIFT);
 			ASSERT(kmin == interval_lo*((uint64)len << TF_CLSHIFT),"kmin == interval_lo*((uint64)len << TF_CLSHIFT)");
 		}
+		// Skip any k-segments of the pass done prior to a restart:
+		interval_lo = tf_ckpt_resume(pass, interval_lo);
+		if(interval_lo == interval_hi)
+			continue;
 
 		/* Set initial k for this pass to default value (= incr[pass]) + interval_lo*(64*len),
 		(assume this could be as large as 64 bits), then use it to set initial q for this pass:
@@ -2461,6 +2726,8 @@ candidate factors that survive sieving.	*/
 
   #endif	// MULTITHREAD ?
 
+	ASSERT(0 == tf_ckpt_finish(), "There were errors writing the checkpoint ... aborting");
+
 /*...all done.	*/
   #ifdef FACTOR_STANDALONE
 	if(!restart)
@@ -2468,6 +2735,10 @@ candidate factors that survive sieving.	*/
 		printf(   "%s(%s) has %u factors in range k = [%" PRIu64 ", %" PRIu64 "], passes %u-%u\n",
 	 	NUM_PREFIX[MODULUS_TYPE], pstring, nfactor, kmin, kmax, passmin, passmax);
 		printf(   "Performed %s trial divides\n", &char_buf0[convert_uint64_base10_char(char_buf0, count)]);
+	  #if TF_BUCKET_SIEVE
+		if(tf_sieve_pmax)
+			printf(   "Sieve depth tuned to primes <= %u\n",tf_sieve_pmax);
+	  #endif
 		/* Since we're done accumulating cycle count, divide to get total time in seconds: */
 		printf(   "Clocks =%s\n",get_time_str(tdiff));
 	}
@@ -2508,26 +2779,46 @@ candidate factors that survive sieving.	*/
 		}
 	}
 
-	// Free the allocated memory:
-	free((void *)factor_ptmp);
+	// Free the per-assignment allocated memory:
 	free((void *)p);
 	free((void *)kdeep);
 	free((void *)bit_map);
 	free((void *)bit_map2);
 	free((void *)bit_atlas);
-	free((void *)pdiff);
-	free((void *)startval);
-	free((void *)pinv);
 	free((void *)two_p);
 	free((void *)p2NC);
 	free((void *)q);
 	free((void *)q2);
 	free((void *)u64_arr);
-  #ifdef MULTITHREAD
-	free((void *)tdat); tdat = 0x0;
+
+  #ifdef FACTOR_STANDALONE
+	// Batch mode: remove the just-completed assignment from the worklist and move on to the next one:
+	if(STRNEQ(worklist,"")) {
+		ASSERT(0 == delete_tf_assignment(worklist, pstring), "delete_tf_assignment failed!");
+		goto RANGE_BEG;
+	}
+MFACTOR_DONE:
+	if(nassign)
+		printf("Batch of %u assignments: Clocks =%s\n",nassign,get_time_str(getRealTime() - batch_time));
   #endif
 
+	// Free the shared allocated memory:
+	free((void *)factor_ptmp);
+	free((void *)pdiff);
+	free((void *)startval);
+	free((void *)pinv);
+  #ifdef USE_AVX512
+	free((void *)psmall);
+  #endif
+  #ifdef FACTOR_STANDALONE
+   #ifdef MULTITHREAD
+	free((void *)tdat); tdat = 0x0;
+   #endif
 	return(0);
+  #else
+	// The threadpool and thread data persist, for use by any subsequent TF assignments of the Mlucas run:
+	return(nfactor);
+  #endif
 
 	/* Only reachable from argc/argv section: */
   #ifdef FACTOR_STANDALONE
@@ -2543,6 +2834,8 @@ MFACTOR_HELP:
 	printf("\n");
 	printf(" -f {num}    Trial-factor the Fermat number F(num) = 2^(2^num) + 1.\n");
 	printf("\n");
+	printf(" -worklist {string}  Batch mode: trial-factor each Mersenne number in the named file of\n\t\t Factor=[AID,]p,bmin,bmax assignments in turn, deleting each line once done.\n");
+	printf("\n");
 	printf(" -file {string}    Name of checkpoint file (needed for restart-from-interrupt)\n");
 	printf("\n");
   #ifdef P1WORD
@@ -2557,12 +2850,21 @@ MFACTOR_HELP:
 	printf("\n");
 	printf(" -kmax {num} Highest factor K value to be tried in each pass ( < 2^64).\n");
 	printf("\n");
-	printf(" -passmin {num}  Current factoring pass (0-%d).\n",TF_PASSES-1);
+	printf(" -passmin {num}  Current factoring pass (0-[TF_PASSES-1]). If given without -classes, 60 classes are used.\n");
 	printf("\n");
-	printf(" -passmax {num}  Maximum pass for the run (0-%d).\n",TF_PASSES-1);
+	printf(" -passmax {num}  Maximum pass for the run (0-[TF_PASSES-1]).\n");
+	printf("\n");
+	printf(" -classes {num}  Number of [p,k] classes: 60, 420 or 4620, giving TF_PASSES = 16, 96 or 960 passes.\n\t\t If not set, picked at runtime based on #threads and the k-range.\n");
   #ifdef MULTITHREAD
 	printf("\n");
-	printf(" -nthread {num}  Number of threads to use (1-%u). Each pass gets done by\n\t\t a separate thread; if #passes > #threads, some threads will do multiple passes.\n",TF_PASSES);
+	printf(" -nthread {num}  Number of threads to use (1-%u). Each pass gets done by\n\t\t a single thread; threads claim a fresh pass as soon as they complete their current one.\n",TF_PASSES_MAX);
+   #if TF_PIPELINE
+	printf(" -pipeline       Split the threads into sieve threads, which queue the surviving candidates, and modpow\n\t\t threads, which test them in full batches. The split is rebalanced automatically.\n");
+   #endif
+  #endif
+  #if TF_DISPATCH
+	printf("\n");
+	printf(" -bench [string] Time each modpow kernel at each q-size in [2^bmin, 2^bmax) (default [2^%u, 2^%u)),\n\t\t check it against the known-factor tables and write the results to the named file\n\t\t (default %s), as JSON if the name ends in .json, else as CSV.\n",TF_BENCH_BMIN,TF_BENCH_BMAX+1,TF_BENCH_FILE);
   #endif
 	/* If we reached here other than via explicit invocation of the help menu, assert: */
 	if(!STREQ(stFlag, "-h"))
@@ -2571,12 +2873,121 @@ MFACTOR_HELP:
   #endif
 }
 
-#endif	/* #ifdef FACTOR_STANDALONE */
-
 /******************/
 
+#if defined(MULTITHREAD) && TF_PIPELINE
+
+	// Producer side: returns the ring's next free slot, emptied, first waiting for the consumer side to free one if the ring
+	// is full, adding the time spent waiting to *t_wait:
+	static struct tf_chunk_t* tf_ring_slot(struct tf_ring_t*ring, double*t_wait)
+	{
+		uint32 head = ring->head;	// Only the producer writes head
+		double t0;
+		if(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == TF_PIPE_SLOTS) {
+			t0 = getRealTime();
+			while(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == TF_PIPE_SLOTS)
+				sched_yield();
+			*t_wait += getRealTime() - t0;
+		}
+		ring->slot[head & (TF_PIPE_SLOTS-1)].n = 0;
+		ring->slot[head & (TF_PIPE_SLOTS-1)].upass = -1;
+		return ring->slot + (head & (TF_PIPE_SLOTS-1));
+	}
+
+	// Producer side: publishes the slot returned by the preceding tf_ring_slot() call. The release store makes the slot
+	// contents visible to the consumer before the new head value is:
+	static void tf_ring_push(struct tf_ring_t*ring)
+	{
+		__atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+	}
+
+#endif
+
 #ifndef USE_GPU
 
+/* Post-checks a factor candidate q = 2.k.p+1 flagged by a modpow kernel and, if q divides the modulus, records k in factor_k[]
+and reports the factor, first dividing out any previously-found factors should q be composite. Uses the caller's q, q2 and
+u64_arr scratch arrays. Not thread-safe: in || mode the caller must hold mutex_mi64. Returns TRUE if a factor was reported:
+*/
+int tf_found_factor(uint64 k, const uint64*p, uint32 lenP, uint64*q, uint64*q2, uint64*u64_arr, uint32 lenQ,
+	uint64*factor_k, uint32*nfactor, uint32 findex, int MODULUS_TYPE, const char*OFILE)
+{
+	uint32 j;
+	FILE *fp = 0x0;
+	char cbuf[STR_MAX_LEN*2], cstr[STR_MAX_LEN*2];
+	/* Recover the factor: */
+	q[lenP] = mi64_mul_scalar( p, 2*k, q, lenP);
+	q[0] += 1;	// q = 2.k.p + 1; No need to check for carry since 2.k.p even
+	if(mi64_twopmodq(p, lenP, k, q, lenQ, q2) != 1)
+	{
+		fprintf(stderr, "ERROR: k = %" PRIu64 ", post-check indicates this does not yield a factor.\n", k);
+	//	printf("Args sent to mi64_twopmodq:\n");
+	//	printf("p = %s\n", &cbuf[convert_mi64_base10_char(cbuf, p, lenP, 0)]);
+	//	printf("q = %s\n", &cbuf[convert_mi64_base10_char(cbuf, q, lenQ, 0)]);
+	//	printf("res = %s\n", &cbuf[convert_mi64_base10_char(cbuf, q2, lenQ, 0)]);
+	} else {
+		/* Do a quick base-3 compositeness check (base-2 would be much faster due to
+		our fast Montgomery arithmetic-based powering for that, but it's useless for
+		weeding out composite Mersenne factors since those are all base-2 Fermat pseudoprimes).
+		If it's composite we skip it, since we expect to recover the individual prime subfactors
+		on subsequent passes (although this should only ever happen for small p and q > (2p+1)^2 :
+		*/
+		uint32 known_factor_div_check_done = 0;
+	TEST_FAC_PRIM:
+		if(mi64_pprimeF(q, 3ull, lenQ)) {
+			factor_k[(*nfactor)++] = k;
+			tf_ckpt_add_factor(k);
+			if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
+				sprintf(cbuf,"\n\tFactor found: q = %s = 2^(%u+2)*%" PRIu64 ". This factor is a probable prime.\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)],findex,k/2);
+			else
+				sprintf(cbuf,"\n\tFactor found: q = %s = 2*p*k + 1 with k = %" PRIu64 ". This factor is a probable prime.\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)],k);
+		} else {	// Composite factor; this should only occur in "single-word" (q < 2^96) mode:
+			if(known_factor_div_check_done) {	// Already divided out all pvsly-found factors
+				sprintf(cbuf,"\n\tComposite Factor found: q = %s; you will have to factor this one separately.\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)]);
+			} else {
+				printf("\n\tComposite Factor found: q = %s; checking if any previously-found ones divide it...\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)]);
+				for(j = 0; j < *nfactor; j++) {
+					q2[lenP] = mi64_mul_scalar( p, 2*factor_k[j], q2, lenP);
+					ASSERT(lenP == 1 && q2[lenP] == 0ull, "Unexpected carryout in known-factor computation!");
+					q2[0] += 1;	// q2 = 2.k.p + 1; No need to check for carry since 2.k.p even
+					mi64_clear(u64_arr, lenQ);	// Use u64_arr for quotient; only care if remainder == 0 or not
+					if(mi64_div(q,q2,lenQ,lenQ,u64_arr,0x0)) {
+						/* in this case, need to update factor_k entry to reflect k of cofactor>
+						Given factor q which is product of 2 factors f1 = 2.k1.p+1 and f2 = 2.k2.p+1,
+						the first of which has been previously found, we have
+						q = f1*f2 = (2.k1.p+1).(2.k2.p+1) = 4.k1.k2.p^2 + 2.(k1+k2).p + 1 = 2.k.p+1,
+						so k = 2.k1.k2.p + (k1+k2) = k1 + k2.(2.k1.p + 1) = k1 + f1.k2 .
+						Thus if have pvsly found f1 and now find the composite factor q = f1.f2,
+						to get k2 from k and k1, use k2 = (k - k1)/f1: */
+						factor_k[*nfactor-1] = (factor_k[*nfactor-1] - factor_k[j])/q2[0];
+						if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
+							sprintf(cbuf,"\n\tFactor divisible by previously-found factor 2^(%u+2)*%" PRIu64 ".\n",findex,factor_k[j]);
+						else
+							sprintf(cbuf,"\n\tFactor divisible by previously-found factor 2*p*k + 1 with k = %" PRIu64 ".\n",factor_k[j]);
+					}
+					mi64_set_eq(q, u64_arr, lenQ);
+				}
+				known_factor_div_check_done = 1;
+				// If dividing out any previously-found factors leaves a nontrivial cofactor, send it back to above is-PRP check:
+				if(!mi64_cmp_eq_scalar(q, 1ull, lenQ))
+					goto TEST_FAC_PRIM;
+			}
+		}	/* endif(factor a probable prime?) */
+	#ifdef FACTOR_STANDALONE
+		fprintf(stderr,"%s", cbuf);
+	#else
+		fp = mlucas_fopen(STATFILE,"a");	ASSERT(fp != 0x0,"0");
+		fprintf(fp,"%s", cbuf);
+		fclose(fp); fp = 0x0;
+	#endif
+		fp = mlucas_fopen(   OFILE,"a");	ASSERT(fp != 0x0,"0");
+		fprintf(fp,"%s", cbuf);
+		fclose(fp); fp = 0x0;
+		return TRUE;
+	}
+	return FALSE;
+}
+
   #ifndef MULTITHREAD
 
 	uint64 PerPass_tfSieve(
@@ -2587,7 +2998,7 @@ MFACTOR_HELP:
 		const uint32 nclear,
 		const uint32 sieve_len,
 		const uint32 p_last_small,	//largest odd prime appearing in the product; that is, the (nclear)th odd prime.
-		const uint32 nprime,	// #sieving primes (counting from 3)
+		const uint32 nprime_max,	// #sieving primes (counting from 3) in pdiff[]; the pass uses the first nprime <= nprime_max of them
 		const uint32 MAX_SIEVING_PRIME,
 		const uint8 *pdiff,
 			  uint32*startval,
@@ -2624,7 +3035,7 @@ MFACTOR_HELP:
 		uint32 nclear       = targ->nclear;
 		uint32 sieve_len    = targ->sieve_len;
 		uint32 p_last_small = targ->p_last_small;	//largest odd prime appearing in the product; that is = targ->; the (nclear)th odd prime.
-		uint32 nprime       = targ->nprime;			// #sieving primes (counting from 3)
+		uint32 nprime_max   = targ->nprime;			// #sieving primes (counting from 3); the pass uses the first nprime <= nprime_max of them
 		uint32 MAX_SIEVING_PRIME = targ->MAX_SIEVING_PRIME;
 		uint8 *pdiff        = targ->pdiff;
 		uint32*startval     = targ->startval;
@@ -2632,7 +3043,6 @@ MFACTOR_HELP:
 		uint64*factor_k     = targ->factor_k;		// List of found factors for each p gets updated (we hope) within
 		uint32*nfactor      = targ->nfactor;		// Here the '*' is to denote a writeable scalar
 		uint32 findex       = targ->findex;
-		const char *pstring = targ->pstring;
 		uint64*p            = targ->p;
 		uint64*two_p        = targ->two_p;
 		uint64*q            = targ->q;
@@ -2652,27 +3062,39 @@ MFACTOR_HELP:
 		int    MODULUS_TYPE = targ->MODULUS_TYPE;
 		const char *VERSION = targ->VERSION;
 		const char *OFILE   = targ->OFILE;
+	#if TF_PIPELINE
+		struct tf_ring_t*ring = targ->ring;
+		struct tf_chunk_t*chunk = 0x0;	// Ring slot currently being filled
+	#endif
   #endif
 		int found_pass = FALSE;
 	#ifdef MULTITHREAD
 		// Proper init (as opposed to no-init) key to avoiding deadlock here.
 		// Started with 2 separate _checkpoint and _foundfactor mutexes here, but since both code sections
-		// in question call some of the same mi64 functions, replaced with 'one mutex to rule them all' model:
-		pthread_mutex_t mutex_mi64        = PTHREAD_MUTEX_INITIALIZER,
-						mutex_updatecount = PTHREAD_MUTEX_INITIALIZER;	// No mi64 calls here.
+		// in question call some of the same mi64 functions, replaced with 'one mutex to rule them all' model, mutex_mi64,
+		// now at file scope, since tf_found_factor() callers outside this function need it too.
+		// This must be static, i.e. shared by all the threads running this function:
+		static pthread_mutex_t mutex_updatecount = PTHREAD_MUTEX_INITIALIZER;	// No mi64 calls here.
 	#endif
 		FILE *fp = 0x0;
 		char *char_addr;
-	#if TF_CLASSES == 60
-		const uint32 TRYQM1 = TRYQ-1, bit_len = (sieve_len << TF_CLSHIFT)/TF_CLASSES; 	// 255255*64  /  60 = 272272: Number of bits in each of the  16 mod-  60 sievelets
-	#else	// 4620 classes:
-		const uint32 TRYQM1 = TRYQ-1, bit_len = (sieve_len << TF_CLSHIFT)/TF_CLASSES;	// 255255*64^2/4620 = 226304: Number of bits in each of the 960 mod-4620 sievelets
-	#endif
+		// Number of bits in each sievelet, e.g. 255255*64/60 = 272272 for 60 classes, 255255*64^2/4620 = 226304 for 4620:
+		const uint32 TRYQM1 = TRYQ-1, bit_len = (sieve_len << TF_CLSHIFT)/TF_CLASSES;
 		int itmp;
 		uint32 bit,bit_hi,curr_p,i,ihi,idx,j,l,m;
-		uint64 count = 0ull, itmp64, k = 0ull, sweep, res;
+		uint64 count = 0ull, count_ckpt = 0ull, itmp64, k = 0ull, sweep, res;
 		int32 q_index = -1;
+		uint32 nprime = nprime_max, m_big = nprime_max;	// Sieve depth for this pass, and index of the first prime > bit_len
+	#if TF_BUCKET_SIEVE
+		uint32 nbkt, p_run = MAX_SIEVING_PRIME, *bkt_len, *bkt_cap;
+		uint64 **bkt, nhit = 0ull;
+		double t_setup, t_bkt = 0, t_scan = 0, tsweep;	// Runtimes of the per-pass sieve setup and of the bucket-sieve and candidate-TF phases of the sweeps
+		double c_hit, c_setup, t_q, dens, lnp, lnp_lo, lnp_hi;
+	#endif
 		double fbits_in_k = 0, fbits_in_q = 0;
+	#if TF_DISPATCH
+		uint32 kidx = 0;	// tf_kernel_tab[] index of the modpow kernel used for the current sweep
+	#endif
 	#ifdef P1WORD
 		double twop_float = 0,fqlo,fqhi;
 		uint128 p128,q128,t128;	// Despite the naming, these are needed for nominal 1-word runs with moduli exceeding 64 bits
@@ -3002,6 +3424,8 @@ MFACTOR_HELP:
 		k = kstart;
 	#endif	// #if 0
 /************************ END(RESTART STUFF) *******************/
+		// Starting k for the pass, = incr + interval_lo*(len << TF_CLSHIFT); must be set regardless of the above disabled per-pass restart code:
+		k = kstart;
 
 	#ifdef MULTITHREAD
 	//	fprintf(stderr, "In PerPass_tfSieve task_id = %u, worker thread id %u\n", tid, ((struct thread_init *)targ)->thread_num);
@@ -3022,12 +3446,70 @@ MFACTOR_HELP:
 	  #endif
 //if(pass==4)
 //	printf("\nPass %u: k0 = %u, word0 prior to deep-prime clearing = %16" PRIX64 "\n",pass,(uint32)kstart,bit_map[0]);
+	#if TF_BUCKET_SIEVE
+		// Sieve with the primes up to the runtime-tuned depth, if set:
+	  #ifdef MULTITHREAD
+		pthread_mutex_lock(&mutex_updatecount);
+	  #endif
+		j = tf_sieve_pmax;
+	  #ifdef MULTITHREAD
+		pthread_mutex_unlock(&mutex_updatecount);
+	  #endif
+		if(j) {
+			curr_p = p_last_small;
+			for(m = nclear; m < nprime_max; m++) {
+				if(curr_p + (pdiff[m] << 1) > j) break;
+				curr_p += (pdiff[m] << 1);
+			}
+			nprime = m;	p_run = curr_p;
+		}
+		t_setup = getRealTime();
+	#endif
 		// Compute startbit k (occurrence of first multiple of prime curr_p in first pass through the relevant sievelet:
 		if((lenP == 1) && (p[0] <= MAX_SIEVING_PRIME))
 			get_startval(MODULUS_TYPE, p[0], findex, two_p, lenQ, bit_len, interval_lo, incr, nclear, nprime, p_last_small, pdiff, startval);
 		else
 			get_startval(MODULUS_TYPE, 0ull, findex, two_p, lenQ, bit_len, interval_lo, incr, nclear, nprime, p_last_small, pdiff, startval);
 
+	#if TF_BUCKET_SIEVE
+		/* Bucket sieve: A prime > bit_len hits at most one bit per sweep, so rather than visiting it every sweep, file it -
+		as a packed (p << 32) + [bit offset] pair - in the bucket for the sweep of its next hit. The nbkt buckets are used
+		circularly, bucket (sweep - interval_lo) % nbkt holding the hits for the sweep in question; a prime's next hit is
+		at most MAX_SIEVING_PRIME/bit_len + 1 sweeps ahead, hence nbkt = MAX_SIEVING_PRIME/bit_len + 2 buckets suffice.
+		First find m_big, the index of the first prime > bit_len, then count the initial entries of each bucket, then fill:
+		*/
+		curr_p = p_last_small;
+		for(m = nclear; m < nprime; m++) {
+			if(curr_p + (pdiff[m] << 1) > bit_len) break;
+			curr_p += (pdiff[m] << 1);
+		}
+		m_big = m;
+		nbkt = MAX_SIEVING_PRIME/bit_len + 2;
+		bkt_len = (uint32 *)calloc(2*nbkt, sizeof(uint32));	bkt_cap = bkt_len + nbkt;
+		bkt = (uint64**)malloc(nbkt*sizeof(uint64*));
+		ASSERT(bkt_len != 0x0 && bkt != 0x0, "Unable to allocate sieve buckets!");
+		for(j = 0; j < 2; j++) {
+			for(m = m_big, i = curr_p; m < nprime; m++) {
+				i += (pdiff[m] << 1);
+				l = startval[m];
+				if(l == 0xffffffff)	// p == curr_p case
+					continue;
+				idx = l/bit_len;
+				if(j)
+					bkt[idx][bkt_len[idx]++] = ((uint64)i << 32) + (l - idx*bit_len);
+				else
+					++bkt_cap[idx];
+			}
+			if(!j) {
+				for(idx = 0; idx < nbkt; idx++) {
+					bkt_cap[idx] = 2*bkt_cap[idx] + 64;	// Headroom, since the near buckets gain entries faster than they lose them early on
+					bkt[idx] = (uint64 *)malloc(bkt_cap[idx]*sizeof(uint64));	ASSERT(bkt[idx] != 0x0, "Unable to allocate sieve buckets!");
+				}
+			}
+		}
+		t_setup = getRealTime() - t_setup;
+	#endif
+
 		for(sweep = interval_lo; sweep < interval_hi; ++sweep)
 		{
 #ifdef MULTITHREAD
@@ -3044,11 +3526,7 @@ MFACTOR_HELP:
 			#endif
 			}
 
-		  #if TF_CLASSES == 60
-			ihi = sieve_len/TF_CLASSES + 1;	// sieve_len not divisible by TF_CLASSES, so add a pad-word
-		  #else
-			ihi = (sieve_len*64)/TF_CLASSES;	// 64*sieve_len divisible by TF_CLASSES, no need for padding
-		  #endif
+			ihi = (bit_len + 63)>>6;	// Round up for bit_len not divisible by 64, e.g. 60 classes
 			memcpy(bit_map2, bit_map, (ihi<<3));	// Load fresh copy of master sievelet
 
 		#ifdef FAC_DEBUG	// If enable this, make sure to also uncomment "# survived" complement below!
@@ -3067,6 +3545,9 @@ MFACTOR_HELP:
 			// to bound qmax from above, and compute lg(qmax) using the above logarithmic sum.
 			fbits_in_k = log((double)k + TF_CLASSES*bit_len)*ILG2;	// Use k-value at end of upcoming pass thru sieve as upper-bound
 			fbits_in_q = fbits_in_2p + fbits_in_k;
+		#if TF_DISPATCH
+			kidx = tf_kernel_select(fbits_in_q);
+		#endif
 	//	if(fbits_in_q > 64)
 	//	printf("sweep = %" PRIu64 ": fbits_in_q = fbits_in_2p [%10.4f] + fbits_in_k [%10.4f] = %10.4f\n",sweep,fbits_in_2p,fbits_in_k,fbits_in_q);
 
@@ -3075,12 +3556,12 @@ MFACTOR_HELP:
 			if(k_targ)
 			{
 				/* See if k_targ falls in the range of k's for the current sieve interval: */
-				k = (uint64)incr + sweep*(sieve_len<<6);	/* Starting k for the current interval: */
+				k = (uint64)incr + sweep*((uint64)sieve_len<<TF_CLSHIFT);	/* Starting k for the current interval: */
 
 				/* If so, calculate the location of the critical bit
 				and allow execution to proceed as normal to bit-clearing step:
 				*/
-				if((k <= k_targ) && (k_targ < (k+(sieve_len<<6))))
+				if((k <= k_targ) && (k_targ < (k+((uint64)sieve_len<<TF_CLSHIFT))))
 				{
 					itmp64 = k_targ - k;
 					ASSERT(itmp64%TF_CLASSES == 0,"(k_targ - k)%TF_CLASSES == 0");
@@ -3200,7 +3681,7 @@ MFACTOR_HELP:
 			uint32 cq[4], ncq = 0;	// mnemonic: ncq = 'Number in to-be-Cleared Queue', cq[] stores said queue
 		  #endif
 			curr_p = p_last_small;
-			for(m = nclear; m < nprime; m++)
+			for(m = nclear; m < m_big; m++)	// m_big = nprime unless bucket-sieving the primes > bit_len
 			{
 				curr_p += (pdiff[m] << 1);	//	if(current_prime == 107) printf("   prime %8d has offset = %8d\n", curr_p, startval[m]);	//	if(pass == 4 && startval[m] < 100) printf("1: Found a multiple of %u in bit %u\n", curr_p,startval[m]);
 				l = startval[m];
@@ -3238,18 +3719,32 @@ MFACTOR_HELP:
 					startval[m] = l-bit_len;
 				}
 			}
+		  #if TF_BUCKET_SIEVE
+			// Clear the hits of the primes filed in this sweep's bucket, refiling each in the bucket of its next hit,
+			// m sweeps ahead with 0 < m < nbkt:
+			tsweep = getRealTime();
+			j = (sweep - interval_lo) % nbkt;
+			for(i = 0; i < bkt_len[j]; i++) {
+				curr_p = bkt[j][i] >> 32;	l = (uint32)bkt[j][i];
+				bit_clr32((uint32 *)bit_map2,l);
+				l += curr_p;	m = l/bit_len;
+				idx = j + m;	idx -= nbkt & -(idx >= nbkt);
+				if(bkt_len[idx] == bkt_cap[idx]) {
+					bkt_cap[idx] <<= 1;
+					bkt[idx] = (uint64 *)realloc(bkt[idx], bkt_cap[idx]*sizeof(uint64));	ASSERT(bkt[idx] != 0x0, "Unable to grow sieve bucket!");
+				}
+				bkt[idx][bkt_len[idx]++] = ((uint64)curr_p << 32) + (l - m*bit_len);
+			}
+			nhit += bkt_len[j];	bkt_len[j] = 0;
+			t_bkt += getRealTime() - tsweep;
+		  #endif
 
 		#endif	// USE_AVX512 ?
 
 //	if(pass==4)printf("\nPass %u: word0 after deep-prime clearing = %16" PRIX64 "\n",pass,bit_map2[0]);
 
 			// Now run through the bits of the current copy of the sieve, trial dividing if a bit = 1:
-		  #if TF_CLASSES == 60
-			ihi = sieve_len/TF_CLASSES + 1;	// sieve_len not divisible by TF_CLASSES, so add a pad-word
-		  #else
-			ihi = (sieve_len*64)/TF_CLASSES;	// 64*sieve_len divisible by TF_CLASSES, no need for padding
-		  #endif
-			ASSERT(ihi == ((bit_len+63)>>6), "Ihi value-check failed!");
+			ihi = (bit_len + 63)>>6;
 		#ifdef FAC_DEBUG
 			m = 0;	// accum popc
 			for(i = 0; i < ihi; i++) {
@@ -3265,6 +3760,9 @@ MFACTOR_HELP:
 			printf("%u [%6.2f%%] survived; count = %" PRIu64 "\n",m,100.*(float)m/bit_len,count);
 		#endif
 
+		#if TF_BUCKET_SIEVE
+			tsweep = getRealTime();
+		#endif
 			bit_hi = 64;
 			for(i = 0; i < ihi; i++)	/* K loops over 64-bit registers. Don't assume bit_len a multiple of 64.	*/
 			{
@@ -3389,6 +3887,22 @@ MFACTOR_HELP:
 						#endif
 						}	/* endif((count & countmask) == 0) */
 
+					#if TF_PIPELINE
+						// Pipelined mode: queue k for the modpow threads rather than testing it here. The current chunk
+						// gets pushed once full, or when the modpow kernel changes between sweeps:
+						if(ring) {
+							if(chunk && (chunk->n == TF_PIPE_CHUNK || chunk->kidx != kidx)) {
+								tf_ring_push(ring);	chunk = 0x0;
+							}
+							if(!chunk) {
+								chunk = tf_ring_slot(ring, &targ->t_wait);	chunk->kidx = kidx;
+							}
+							chunk->k[chunk->n++] = k;
+							k += TF_CLASSES;
+							continue;
+						}
+					#endif
+
 					/***************************************************************************************/
 					#if(TRYQ == 0)	/* If testing speed of sieve alone, skip to incrementing of q. */
 					/***************************************************************************************/
@@ -3403,7 +3917,13 @@ MFACTOR_HELP:
 											it will be, after we test the current batch of candidates. */
 
 					/***************************************************************************************/
-						#if(TRYQ == 1)		/************** try 1 factor candidates at a time **************/
+						#if TF_DISPATCH		/********* TRYQ candidates via runtime-selected modpow kernel *********/
+					/***************************************************************************************/
+
+							res = tf_kernel_modpow(kidx, p,lenP, k_to_try, q,lenQ, q2, tid);
+
+					/***************************************************************************************/
+						#elif(TRYQ == 1)	/************** try 1 factor candidates at a time **************/
 					/***************************************************************************************/
 
 						  #ifdef NWORD
@@ -3737,85 +4257,19 @@ MFACTOR_HELP:
 									pthread_mutex_lock(&mutex_mi64);
 								//	printf("Found Factor: Thread %u locked mutex_mi64 ... ",tid);
 								#endif
-									/* Recover the factor: */
-									q[lenP] = mi64_mul_scalar( p, 2*k_to_try[l], q, lenP);
-									q[0] += 1;	// q = 2.k.p + 1; No need to check for carry since 2.k.p even
-									if(mi64_twopmodq(p, lenP, k_to_try[l], q, lenQ, q2) != 1)
-									{
-										fprintf(stderr, "ERROR: k = %" PRIu64 ", post-check indicates this does not yield a factor.\n", k_to_try[l]);
-									//	printf("Args sent to mi64_twopmodq:\n");
-									//	printf("p = %s\n", &cbuf[convert_mi64_base10_char(cbuf, p, lenP, 0)]);
-									//	printf("q = %s\n", &cbuf[convert_mi64_base10_char(cbuf, q, lenQ, 0)]);
-									//	printf("res = %s\n", &cbuf[convert_mi64_base10_char(cbuf, q2, lenQ, 0)]);
-									} else {
-										/* Do a quick base-3 compositeness check (base-2 would be much faster due to
-										our fast Montgomery arithmetic-based powering for that, but it's useless for
-										weeding out composite Mersenne factors since those are all base-2 Fermat pseudoprimes).
-										If it's composite we skip it, since we expect to recover the individual prime subfactors
-										on subsequent passes (although this should only ever happen for small p and q > (2p+1)^2 :
-										*/
-										uint32 known_factor_div_check_done = 0;
-									TEST_FAC_PRIM:
-										if(mi64_pprimeF(q, 3ull, lenQ)) {
-											factor_k[(*nfactor)++] = k_to_try[l];
-											if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
-												sprintf(cbuf,"\n\tFactor found: q = %s = 2^(%u+2)*%" PRIu64 ". This factor is a probable prime.\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)],findex,k_to_try[l]/2);
-											else
-												sprintf(cbuf,"\n\tFactor found: q = %s = 2*p*k + 1 with k = %" PRIu64 ". This factor is a probable prime.\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)],k_to_try[l]);
-										#ifdef FAC_DEBUG
-											if(TRYQM1 > 1)
-												printf("factor was number %u of 0-%u in current batch.\n", l, TRYQM1);
-										#endif
-										} else {	// Composite factor; this should only occur in "single-word" (q < 2^96) mode:
-											if(known_factor_div_check_done) {	// Already divided out all pvsly-found factors
-												sprintf(cbuf,"\n\tComposite Factor found: q = %s; you will have to factor this one separately.\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)]);
-											} else {
-												printf("\n\tComposite Factor found: q = %s; checking if any previously-found ones divide it...\n",&cstr[convert_mi64_base10_char(cstr, q, lenQ, 0)]);
-												for(j = 0; j < *nfactor; j++) {
-													q2[lenP] = mi64_mul_scalar( p, 2*factor_k[j], q2, lenP);
-													ASSERT(lenP == 1 && q2[lenP] == 0ull, "Unexpected carryout in known-factor computation!");
-													q2[0] += 1;	// q2 = 2.k.p + 1; No need to check for carry since 2.k.p even
-													mi64_clear(u64_arr, lenQ);	// Use u64_arr for quotient; only care if remainder == 0 or not
-													if(mi64_div(q,q2,lenQ,lenQ,u64_arr,0x0)) {
-														/* in this case, need to update factor_k entry to reflect k of cofactor>
-														Given factor q which is product of 2 factors f1 = 2.k1.p+1 and f2 = 2.k2.p+1,
-														the first of which has been previously found, we have
-														q = f1*f2 = (2.k1.p+1).(2.k2.p+1) = 4.k1.k2.p^2 + 2.(k1+k2).p + 1 = 2.k.p+1,
-														so k = 2.k1.k2.p + (k1+k2) = k1 + k2.(2.k1.p + 1) = k1 + f1.k2 .
-														Thus if have pvsly found f1 and now find the composite factor q = f1.f2,
-														to get k2 from k and k1, use k2 = (k - k1)/f1: */
-														factor_k[*nfactor-1] = (factor_k[*nfactor-1] - factor_k[j])/q2[0];
-														if(MODULUS_TYPE == MODULUS_TYPE_FERMAT)
-															sprintf(cbuf,"\n\tFactor divisible by previously-found factor 2^(%u+2)*%" PRIu64 ".\n",findex,factor_k[j]);
-														else
-															sprintf(cbuf,"\n\tFactor divisible by previously-found factor 2*p*k + 1 with k = %" PRIu64 ".\n",factor_k[j]);
-													}
-													mi64_set_eq(q, u64_arr, lenQ);
-												}
-												known_factor_div_check_done = 1;
-												// If dividing out any previously-found factors leaves a nontrivial cofactor, send it back to above is-PRP check:
-												if(!mi64_cmp_eq_scalar(q, 1ull, lenQ))
-													goto TEST_FAC_PRIM;
-											}
-										}	/* endif(factor a probable prime?) */
-									#ifdef FACTOR_STANDALONE
-										fprintf(stderr,"%s", cbuf);
-									#else
-										fp = mlucas_fopen(STATFILE,"a");	ASSERT(fp != 0x0,"0");
-										fprintf(fp,"%s", cbuf);
-										fclose(fp); fp = 0x0;
-									#endif
-										fp = mlucas_fopen(   OFILE,"a");	ASSERT(fp != 0x0,"0");
-										fprintf(fp,"%s", cbuf);
-										fclose(fp); fp = 0x0;
-									#ifdef QUIT_WHEN_FACTOR_FOUND
-										return 0;
-									#endif
-									}	// end(L-loop)
+									j = tf_found_factor(k_to_try[l], p,lenP, q,q2,u64_arr,lenQ, factor_k,nfactor, findex, MODULUS_TYPE, OFILE);
+								#ifdef FAC_DEBUG
+									if(j && TRYQM1 > 1)
+										printf("factor was number %u of 0-%u in current batch.\n", l, TRYQM1);
+								#endif
 								#ifdef MULTITHREAD
 								//	printf("Thread %u unlocking mutex_mi64.",tid);
 									pthread_mutex_unlock(&mutex_mi64);
 								#endif
+								#ifdef QUIT_WHEN_FACTOR_FOUND
+									if(j)
+										return 0;
+								#endif
 								}	/* endif((res >> l) & 1)		*/
 							}	/* endfor(l = 0; l < TRYQ; l++)	*/
 						}	/* endif(q_index == TRYQM1)		*/
@@ -3828,6 +4282,9 @@ MFACTOR_HELP:
 
 				} /* end of BIT loop	*/
 			}	/* end of K loop	*/
+		#if TF_BUCKET_SIEVE
+			t_scan += getRealTime() - tsweep;
+		#endif
 
 		#if 0	//(TRYQ > 1)	Aug 2022: This code no longer needed; use 'run -bmin 57 -bmax 64 -m 7962742673' to see why
 			#error Aug 2022: This code no longer needed!
@@ -3913,17 +4370,22 @@ MFACTOR_HELP:
 			}	/* endif(q_index >= 0) */
 		#endif	/* end #if(TRYQ > 1) */
 
-	/******************* MOVE CHKPT STUFF TO FACTOR-MAIN?? ***********************/
-	// Checkpointing only supported for single-threaded runs:
-	if(NTHREADS == 1) {
-	#if !FAC_DEBUG
-		// Every 1024th pass, write the checkpoint file, with format as described previously:
-		if(((sweep + 1) %(1024/lenQ + 1)) == 0 || ((sweep + 1) == interval_hi)) {
-			i = write_savefile(RESTARTFILE, pstring, pass, k, count);	// Only overwrite passnow, know and count fields of savefile
-			ASSERT(!i,"There were errors writing the savefile ... aborting");
-		}	/* Successfully wrote restart file. */
-	#endif /* #if !FAC_DEBUG */
-	}
+		/* Checkpointing: Once the last sweep of a k-segment is done, mark the (pass, segment) unit done. In pipelined
+		mode the sweep's candidates have yet to be tested, so instead tag the current chunk with the unit, which
+		the consumer then marks done after testing it - this may need an otherwise-empty chunk: */
+		if(tf_ckpt.nseg && (((sweep + 1 - tf_ckpt.sweep_lo) % tf_ckpt.seg_sweeps) == 0 || (sweep + 1) == interval_hi)) {
+		#if TF_PIPELINE
+			if(ring) {
+				if(!chunk) {
+					chunk = tf_ring_slot(ring, &targ->t_wait);	chunk->kidx = kidx;
+				}
+				chunk->upass = pass;	chunk->usweep = sweep;	chunk->ucount = count - count_ckpt;
+				tf_ring_push(ring);	chunk = 0x0;
+			} else
+		#endif
+			tf_ckpt_mark(pass, sweep, count - count_ckpt);
+			count_ckpt = count;
+		}
 #if 0
 	#error Multithreaded checkpointing stuff needs debug & test!
 	else {
@@ -4031,6 +4493,48 @@ MFACTOR_HELP:
 		#endif
 			continue;
 		} /* end of sweep loop	*/
+	#if TF_PIPELINE
+		if(chunk)	// Push the final, partial chunk of the pass
+			tf_ring_push(ring);
+	#endif
+
+	#if TF_BUCKET_SIEVE
+		for(idx = 0; idx < nbkt; idx++) {
+			free((void *)bkt[idx]);
+		}
+		free((void *)bkt);	free((void *)bkt_len);
+		/* Sieve-depth tuning: Each prime P in the sieve costs c_setup per pass - its get_startval() and bucket setup -
+		plus c_hit per hit, and there are bit_len/P hits per sweep, each removing a candidate with probability dens(P),
+		the fraction of sievelet bits surviving sieving to depth P, and so saving t_q, the time per candidate of the TF
+		phase. dens(P) goes as 1/ln(P) [Mertens], so with nsweep sweeps per pass the optimal depth P* solves
+			g(P) := (dens(P_run)*ln(P_run)/ln(P) * t_q - c_hit) * bit_len*nsweep/P - c_setup = 0 ,
+		with P_run the depth of this pass. g is decreasing in P, so bisect for ln(P*) on [ln(2*bit_len), ln(MAX_SIEVING_PRIME)]
+		- the lower bound keeps some primes in the buckets, so subsequent passes can still measure c_hit - and set the depth
+		used by subsequent passes to the geometric mean of the current one and P*, to damp pass-to-pass timing noise:
+		*/
+		if(nhit && count && t_bkt > 0 && t_scan > 0) {
+			itmp64 = interval_hi - interval_lo;	// nsweep
+			c_hit = t_bkt/nhit;	c_setup = t_setup/(nprime - nclear);	t_q = t_scan/count;
+			dens = (double)count/((double)itmp64*bit_len) * log((double)p_run);	// dens(P)*ln(P)
+			lnp_lo = log(2.0*bit_len);	lnp_hi = log((double)MAX_SIEVING_PRIME);
+			for(i = 0; i < 32; i++) {
+				lnp = 0.5*(lnp_lo + lnp_hi);
+				if((dens/lnp*t_q - c_hit)*bit_len*itmp64/exp(lnp) > c_setup)
+					lnp_lo = lnp;
+				else
+					lnp_hi = lnp;
+			}
+		  #ifdef MULTITHREAD
+			pthread_mutex_lock(&mutex_updatecount);
+		  #endif
+			if(tf_sieve_pmax)
+				lnp = 0.5*(lnp + log((double)tf_sieve_pmax));
+			tf_sieve_pmax = MIN((uint32)(exp(lnp) + 0.5), MAX_SIEVING_PRIME);
+		  #ifdef MULTITHREAD
+			pthread_mutex_unlock(&mutex_updatecount);
+		  #endif
+		}
+	#endif
 
 	  #ifdef MULTITHREAD
 
@@ -4045,154 +4549,837 @@ MFACTOR_HELP:
 	  #endif
 	}
 
+  #ifdef MULTITHREAD
+
+	// Sets up the task-local bit_map and the pass-specific thread data for the given pass (i.e. k-class). Returns FALSE
+	// if there's nothing to do, i.e. the pass was completed prior to a restart:
+	static int tf_pass_setup(struct fac_thread_data_t*targ, uint32 pass)
+	{
+		const uint64 interval_len = (uint64)targ->sieve_len << TF_CLSHIFT;	// #k's per pass through the sieve
+		uint32 l;
+		// Load 'master copy' of sievelet for the current pass number:
+		for(l = 0; l < targ->map_words; l++) {
+			targ->bit_map[l] = targ->bit_atlas[l * TF_PASSES + pass];
+		}
+		/* Starting no.-of-times-through-sieve = kmin/(64*len) : */
+		if(pass == targ->passnow && (targ->know > targ->kmin))
+			targ->interval_lo = targ->know/interval_len;
+		else
+			targ->interval_lo = targ->kmin/interval_len;
+		// Skip any k-segments of the pass done prior to a restart:
+		targ->interval_lo = tf_ckpt_resume(pass, targ->interval_lo);
+		if(targ->interval_lo == targ->interval_hi)
+			return FALSE;
+		/* Set initial k for this pass to default value (= incr[pass]) + interval_lo*(64*len): */
+		targ->pass = pass;
+		targ->incr = targ->pass_incr[pass];
+		targ->kstart = (uint64)targ->incr + targ->interval_lo*interval_len;
+		fprintf(stderr,"[%u]",pass);	// Passes may complete out of order, so just print as each is started
+		return TRUE;
+	}
+
+	// Pool-task wrapper for class-granular dispatch: Claims the next as-yet-undone pass (i.e. k-class), loads its
+	// sievelet from the bit_atlas into the task-local bit_map, sets up the pass-specific thread data and calls
+	// PerPass_tfSieve, until all passes are done:
+	void*
+	tf_class_worker(void*thread_arg)
+	{
+		struct fac_thread_data_t* targ = thread_arg;
+		uint32 pass;
+		for(;;) {
+			pthread_mutex_lock(&tf_pass_mutex);
+			pass = (*targ->next_pass)++;
+			pthread_mutex_unlock(&tf_pass_mutex);
+			if(pass > targ->passmax)
+				break;
+			if(tf_pass_setup(targ, pass))
+				PerPass_tfSieve(thread_arg);
+		}
+		return 0x0;
+	}
+
+   #if TF_PIPELINE
+
+	// Pipelined mode: Runs the chunk's candidates through the modpow kernel in TRYQ-sized batches, using the consumer
+	// thread's own scratch arrays. A partial final batch is padded with copies of its last k, with the padding masked
+	// off the result:
+	static void tf_pipe_test(struct fac_thread_data_t*targ, const struct tf_chunk_t*chunk)
+	{
+		uint64*k_to_try = targ->k_to_try;
+		uint32 i,l,nk;
+		uint64 res;
+		for(i = 0; i < chunk->n; i += TRYQ) {
+			nk = MIN(chunk->n - i, TRYQ);
+			for(l = 0; l < TRYQ; l++) {
+				k_to_try[l] = chunk->k[i + MIN(l, nk-1)];
+			}
+			res = tf_kernel_modpow(chunk->kidx, targ->p,targ->lenP, k_to_try, targ->q,targ->lenQ, targ->q2, targ->tid);
+			if(nk < 64) res &= (1ull << nk) - 1;
+			for(l = 0; res; l++, res >>= 1) {
+				if(res & 1) {
+					pthread_mutex_lock(&mutex_mi64);
+					tf_found_factor(k_to_try[l], targ->p,targ->lenP, targ->q,targ->q2,targ->u64_arr,targ->lenQ,
+						targ->factor_k,targ->nfactor, targ->findex, targ->MODULUS_TYPE, targ->OFILE);
+					pthread_mutex_unlock(&mutex_mi64);
+				}
+			}
+		}
+	}
+
+	// Pipelined mode, consumer side: Claims the first ring, scanning from that following the caller's own, which has
+	// queued chunks and no other consumer, and tests up to TF_PIPE_SLOTS of its chunks. Returns the #chunks tested.
+	// The consumer claim is a trylock, so the ring tails are only ever advanced by one thread at a time:
+	static uint32 tf_pipe_drain(struct fac_thread_data_t*targ)
+	{
+		struct tf_ring_t*ring;
+		struct tf_chunk_t*chunk;
+		uint32 i,n,tail;
+		for(i = 1; i <= NTHREADS; i++) {
+			ring = tf_ring + (targ->tid + i) % NTHREADS;
+			if(ring->tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) || pthread_mutex_trylock(&ring->claim))
+				continue;
+			for(n = 0, tail = ring->tail; n < TF_PIPE_SLOTS && tail != __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE); n++) {
+				chunk = ring->slot + (tail & (TF_PIPE_SLOTS-1));
+				tf_pipe_test(targ, chunk);
+				if(chunk->upass != (uint32)-1)
+					tf_ckpt_mark(chunk->upass, chunk->usweep, chunk->ucount);
+				__atomic_store_n(&ring->tail, ++tail, __ATOMIC_RELEASE);	// Hand the slot back to the producer
+			}
+			pthread_mutex_unlock(&ring->claim);
+			if(n) return n;
+		}
+		return 0;
+	}
+
+	// Pipelined mode: Adjusts the sieve/modpow thread split, moving a thread to the sieving side if the modpow threads
+	// spent more time idle than the sieve threads spent waiting on full rings since the last update, and vice versa.
+	// Differences within 5% of the elapsed thread-time are ignored. Caller must hold tf_pass_mutex:
+	static void tf_pipe_balance(void)
+	{
+		double tnow = getRealTime(), slack = 0.05*(tnow - tf_pipe_tlast)*NTHREADS;
+		if(tf_pipe_twait > tf_pipe_tidle + slack && tf_pipe_nsieve > 1)
+			tf_pipe_nsieve--;
+		else if(tf_pipe_tidle > tf_pipe_twait + slack && tf_pipe_nsieve < NTHREADS-1)
+			tf_pipe_nsieve++;
+		tf_pipe_twait = tf_pipe_tidle = 0;	tf_pipe_tlast = tnow;
+	}
+
+	// Pool-task wrapper for pipelined dispatch: Threads with index < tf_pipe_nsieve claim and sieve passes, queueing the
+	// surviving candidates into their own ring; the remaining threads, and sieve threads finding no pass left to claim,
+	// test the queued candidates. The sieve/modpow split is rebalanced after each pass:
+	void*
+	tf_pipe_worker(void*thread_arg)
+	{
+		struct fac_thread_data_t* targ = thread_arg;
+		struct timespec ns_time = {0, 100000};	// 0.1 mSec backoff when there is nothing to do
+		uint32 i, pass, done;
+		double tidle;
+		for(;;) {
+			pass = -1;
+			pthread_mutex_lock(&tf_pass_mutex);
+			if(targ->tid < tf_pipe_nsieve && *targ->next_pass <= targ->passmax) {
+				pass = (*targ->next_pass)++;	tf_pipe_nbusy++;
+			}
+			done = (*targ->next_pass > targ->passmax) && !tf_pipe_nbusy;
+			pthread_mutex_unlock(&tf_pass_mutex);
+			if(pass != (uint32)-1) {
+				targ->ring = tf_ring + targ->tid;	targ->t_wait = 0;
+				if(tf_pass_setup(targ, pass))
+					PerPass_tfSieve(thread_arg);
+				targ->ring = 0x0;
+				pthread_mutex_lock(&tf_pass_mutex);
+				tf_pipe_nbusy--;	tf_pipe_twait += targ->t_wait;
+				tf_pipe_balance();
+				pthread_mutex_unlock(&tf_pass_mutex);
+			} else if(tf_pipe_drain(targ)) {
+				continue;
+			} else {
+				if(done) {	// No sieving left to do, so once all rings are empty, so are we:
+					for(i = 0; i < NTHREADS; i++) {
+						if(tf_ring[i].tail != __atomic_load_n(&tf_ring[i].head, __ATOMIC_ACQUIRE)) break;
+					}
+					if(i == NTHREADS) break;
+				}
+				tidle = getRealTime();
+				ASSERT(0 == mlucas_nanosleep(&ns_time), "nanosleep fail!");
+				tidle = getRealTime() - tidle;
+				pthread_mutex_lock(&tf_pass_mutex);
+				tf_pipe_tidle += tidle;
+				pthread_mutex_unlock(&tf_pass_mutex);
+			}
+		}
+		return 0x0;
+	}
+
+   #endif
+
+  #endif
+
 #endif	// USE_GPU ?
 
 /******************/
 
-/* For an exponent p and a factor index k, each either unmodded or (mod 60), does one of 2 things, depending
-on the nullity (or not) of the input array pointer *incr:
+/* For an exponent p and a factor index k, each either unmodded or (mod nclass), does one of 2 things, depending
+on the nullity (or not) of the input array pointer *incr:
+
+[1] incr == 0x0: Checks validity of the input [p,k] (mod nclass) combination, by returning the
+factoring pass number (in unit-offset form, i.e. 1-TF_PASSES) on which the factor with the given k-mod value
+should occur if it's one of the valid combinations of p%nclass and k%nclass. If invalid, returns 0.
+
+[2] incr != 0x0: Checks validity of the input p (mod nclass) value, i.e. checks that p can possibly be prime
+according to its (mod nclass) residue. (We assume the unmodded p > nclass here.) If invalid, returns 0;
+otherwise populates the arglist incr[] array with the TF_PASSES increments in k (mod nclass) covering all the
+valid residue classes for the given p (mod nclass). These increments sum to nclass, i.e. the final pass
+will be the k == 0 (mod nclass) one.
+
+nclass must be one of the moduli in tf_class_tab[], i.e. 4 times a product of the leading small odd primes;
+the increments are generated on the fly by excluding q = 2.k.p+1 == +-3 (mod 8) and q divisible by any of those
+small primes, which for nclass = 60|420|4620 leaves 16|96|960 classes.
+*/
+uint32 CHECK_PKMOD(uint64*p, uint32 lenP, uint64 k, uint32*incr, uint32 nclass)
+{
+	const uint32 smallp[4] = {3,5,7,11};
+	uint32 i,j,kcur,nsmall,npass, *iptr = 0x0;	// iptr will point to either the in-array (if one provided) or the following local array:
+	uint32 iloc[TF_PASSES_MAX];
+	uint32 pm = 0, km = k%nclass, FERMAT = 0;
+	uint64 q = 0ull;
+	// #small odd primes built into the modulus, and the resulting expected #passes:
+	for(nsmall = 0, npass = nclass>>1; nsmall < 4 && (nclass%smallp[nsmall] == 0); nsmall++) {
+		npass = (npass/smallp[nsmall])*(smallp[nsmall]-1);
+	}
+	ASSERT((nclass & 3) == 0 && nsmall > 0 && npass <= TF_PASSES_MAX, "CHECK_PKMOD: Unsupported class modulus!");
+	pm = mi64_div_by_scalar64(p,(uint64)nclass,lenP,0x0);
+	 q = 2*km*pm + 1;
+	// For general moduli we do not have the property that isPow2 works the same for unmodded and modded power-of-2
+	// exponents that we do (mod 60), so infer Fermat-ness by call to the mi64 library:
+	FERMAT = mi64_isPow2(p,lenP,&i);	// If p a power of 2, binary exponent returned in i
+
+	for(j = 0; j < nsmall; j++) {
+		if(pm%smallp[j] == 0)
+			return 0;
+	}
+
+	if(incr == 0x0) {	// If no incr-array, check the validity of the km := k (mod nclass) value:
+		iptr = iloc;
+		// Fermat: For a valid p-mod, only possible values of km in a factor q = 2.k.p+1 are those for which k even [as shown by Lucas];
+		// Mersenne: only possible values of km are those for which q == +-1 (mod 8) [by quadratic residuacity].
+		// In both cases also need GCD(2*km*pm + 1, 2*nclass) = 1, i.e. (2*km*pm + 1) not divisible by any of the small primes:
+		if(FERMAT ? (km&1) : (((q&7) != 1) && ((q&7) != 7)))
+			return 0;
+		for(j = 0; j < nsmall; j++) {
+			if(q%smallp[j] == 0)
+				return 0;
+		}
+	} else {
+		iptr = incr;
+	}
+
+	// Populate the incr-array (either the arglist one, if provided, or the local one)
+	// with the km-increments of valid factor candidates classes corresponding for the given pm-value:
+	i = 0;	// Index of current array slot
+	kcur = 0;
+	for(k = 1; k <= nclass; k++) {	// Unit-offset pass values here!
+		q = 2*k*pm + 1;
+		if(FERMAT && (k&1))
+			continue;
+		else if(((q&7) == 3) || ((q&7) == 5))
+			continue;
+		for(j = 0; j < nsmall; j++) {
+			if(q%smallp[j] == 0) break;
+		}
+		if(j < nsmall)
+			continue;
+
+		iptr[i++] = k - kcur;	kcur = k;	// iptr stores the *increments* between adjacent km-values
+		if(!incr && (k == km)) {	// In Check-pair-valid mode can exit as soon as we have the input-km's pass
+			return i;
+		}
+	}
+	if(i != npass) {
+		sprintf(cbuf,"Expect precisely %u valid k (mod %u) classes, got %u!",npass,nclass,i); ASSERT(0,cbuf);
+	}
+	return i;	// Nonzero return value indicates success
+}
+
+// Fixed-modulus wrappers for the above, used by the self-tests:
+uint32 CHECK_PKMOD60(uint64*p, uint32 lenP, uint64 k, uint32*incr)
+{
+	return CHECK_PKMOD(p,lenP,k,incr,60);
+}
+
+// (mod 4620) - i.e. small-primes 3,5,7,11 built into the sieve length - and 960 resulting passes:
+uint32 CHECK_PKMOD4620(uint64*p, uint32 lenP, uint64 k, uint32*incr)
+{
+	return CHECK_PKMOD(p,lenP,k,incr,4620);
+}
+
+// Sets the [p,k] class modulus and the associated TF_PASSES and TF_CLSHIFT values; nclass must be one of the
+// entries of tf_class_tab[]. Returns 0 on success, 1 if nclass not supported:
+int tf_set_classes(uint32 nclass)
+{
+	uint32 i;
+	for(i = 0; i < 3; i++) {
+		if(tf_class_tab[i][0] == nclass) {
+			TF_CLASSES = nclass;	TF_PASSES = tf_class_tab[i][1];	TF_CLSHIFT = tf_class_tab[i][2];
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Picks the class modulus for a run using [nthreads] threads to cover a k-range of [kspan], using a sieve of
+[sieve_len] 64-bit words. Each pass is a work unit for the threadpool, so we want TF_PASSES to be large enough
+to keep all threads busy through the final batch of passes, i.e. we take the smallest modulus giving at least
+TF_UTIL_MIN_PCT% utilization. But every pass covers at least one full sieve interval of (sieve_len << TF_CLSHIFT)
+k's, so a larger modulus is only considered if kspan is at least that large - otherwise rounding kmax up to the
+next interval boundary would swamp the gain from the added threads.
+*/
+uint32 tf_select_classes(uint32 nthreads, double kspan, uint32 sieve_len)
+{
+	uint32 i, best = 0, npass, nwave;
+	if(!nthreads) nthreads = 1;
+	for(i = 0; i < 3; i++) {
+		if(i && kspan < (double)sieve_len * (double)(1ull << tf_class_tab[i][2]))
+			break;
+		best = i;
+		npass = tf_class_tab[i][1];
+		nwave = (npass + nthreads - 1)/nthreads;
+		if(100*npass >= TF_UTIL_MIN_PCT*nwave*nthreads)
+			break;
+	}
+	return tf_class_tab[best][0];
+}
+
+#if TF_DISPATCH
+
+/******************* Runtime modpow-kernel dispatch: *******************/
+/*
+Each entry of tf_kernel_tab[] wraps one of the twopmodq* families in a common interface, returning the usual
+bitmask of which of the [nq] inputs k yield a factor q = 2.k.p+1. The families are listed in order of increasing
+q-size and, for each size, fewest-candidates-per-call first; the entry handles 2^qlo <= q < 2^qbits and p of at most
+[pwords] 64-bit words. tf_kernel_calibrate() checks all entries usable for the q-range of the current run against known
+factors, times those which pass and sets up the tf_kern_sel[] table, which maps lg(qmax) of each sieve sweep to the
+fastest entry able to handle that size; tf_kernel_modpow() then calls the selected entry TRYQ/nq times per batch of
+TRYQ candidates.
+*/
+#define TFK_ARGS	uint64*p, uint32 lenP, uint64 k[], uint64*q, uint32 lenQ, uint64*res, int tid
+
+static uint64 tfk_63_q4(TFK_ARGS) { return twopmodq63_q4(p[0],k[0],k[1],k[2],k[3]); }
+static uint64 tfk_63_q8(TFK_ARGS) { return twopmodq63_q8(p[0],k[0],k[1],k[2],k[3],k[4],k[5],k[6],k[7]); }
+static uint64 tfk_64_q4(TFK_ARGS) { return twopmodq64_q4(p[0],k[0],k[1],k[2],k[3]); }
+static uint64 tfk_64_q8(TFK_ARGS) { return twopmodq64_q8(p[0],k[0],k[1],k[2],k[3],k[4],k[5],k[6],k[7]); }
+static uint64 tfk_65_q4(TFK_ARGS) { return twopmodq65_q4(p[0],k[0],k[1],k[2],k[3]); }
+static uint64 tfk_65_q8(TFK_ARGS) { return twopmodq65_q8(p[0],k[0],k[1],k[2],k[3],k[4],k[5],k[6],k[7]); }
+#ifndef USE_SSE2	// No 78-bit entries in SIMD builds - see the note at tf_kernel_tab[]
+static uint64 tfk_78_q4(TFK_ARGS) { return twopmodq78_3WORD_DOUBLE_q4(p[0],k[0],k[1],k[2],k[3], 0,tid); }
+#endif
+static uint64 tfk_96_q4(TFK_ARGS) { return twopmodq96_q4(p[0],k[0],k[1],k[2],k[3], 0,tid); }
+static uint64 tfk_96_q8(TFK_ARGS) { return twopmodq96_q8(p[0],k[0],k[1],k[2],k[3],k[4],k[5],k[6],k[7], 0,tid); }
+static uint64 tfk_128_96_q4(TFK_ARGS) { return twopmodq128_96_q4(p[0],k[0],k[1],k[2],k[3]); }
+static uint64 tfk_128_96_q8(TFK_ARGS) { return twopmodq128_96_q8(p[0],k[0],k[1],k[2],k[3],k[4],k[5],k[6],k[7]); }
+// The multiword-p routines read a fixed number of p-words, so give them a zero-padded copy:
+static uint64 tfk_128_q4(TFK_ARGS) {
+	uint64 pp[2] = {0ull,0ull};	mi64_set_eq(pp,p,lenP);
+	return twopmodq128_q4(pp,k[0],k[1],k[2],k[3]);
+}
+static uint64 tfk_128_q8(TFK_ARGS) {
+	uint64 pp[2] = {0ull,0ull};	mi64_set_eq(pp,p,lenP);
+	return twopmodq128_q8(pp,k[0],k[1],k[2],k[3],k[4],k[5],k[6],k[7]);
+}
+static uint64 tfk_192_q4(TFK_ARGS) {
+	uint64 pp[3] = {0ull,0ull,0ull};	mi64_set_eq(pp,p,lenP);
+	return twopmodq192_q4(pp,k[0],k[1],k[2],k[3]);
+}
+static uint64 tfk_192_q8(TFK_ARGS) {
+	uint64 pp[3] = {0ull,0ull,0ull};	mi64_set_eq(pp,p,lenP);
+	return twopmodq192_q8(pp,k[0],k[1],k[2],k[3],k[4],k[5],k[6],k[7]);
+}
+// Fermat-specific, for p = 2^n; the specialized kernels need n large enough that (q-1)^2 == 0 (mod 2^128|192),
+// so fall back to the generic ones for smaller n:
+static uint64 tfk_128f_q4(TFK_ARGS) {
+	uint64 pp[2] = {0ull,0ull};	mi64_set_eq(pp,p,lenP);
+	if(mi64_trailz(p,lenP) >= 63)
+		return twopmodq128_q4_qferm(pp,k[0],k[1],k[2],k[3]);
+	return twopmodq128_q4(pp,k[0],k[1],k[2],k[3]);
+}
+static uint64 tfk_192f_q4(TFK_ARGS) {
+	uint64 pp[3] = {0ull,0ull,0ull};	mi64_set_eq(pp,p,lenP);
+	if(mi64_trailz(p,lenP) >= 95)
+		return twopmodq192_q4_qferm(pp,k[0],k[1],k[2],k[3]);
+	return twopmodq192_q4(pp,k[0],k[1],k[2],k[3]);
+}
+static uint64 tfk_256(TFK_ARGS) {
+	uint256 p256 = {0ull,0ull,0ull,0ull}, q256, t256;
+	mi64_set_eq((uint64*)&p256,p,lenP);
+	mi64_mul_scalar((uint64*)&p256,k[0],(uint64*)&q256,4);
+	mi64_add((uint64*)&q256,(uint64*)&q256,(uint64*)&q256,4);
+	q256.d0 += 1;	// q = 2.k.p + 1; No need to check for carry since 2.k.p even
+	t256 = twopmodq256(p256,q256);
+	return CMPEQ256(t256, ONE256);
+}
+// Double-Mersenne-specific, for p = M(findex) - findex is just the bitlength of p:
+static uint64 tfk_qmmp(TFK_ARGS) {
+	uint32 findex = (lenP<<6) - mi64_leadz(p,lenP);
+	return (mi64_twopmodq_qmmp(findex, k[0], res) == 1);
+}
+// Generic any-length fallback; uses the caller's q and res arrays, of [lenQ] words each:
+static uint64 tfk_mi64(TFK_ARGS) {
+	if(lenQ > lenP)
+		q[lenP] = mi64_mul_scalar(p,k[0],q,lenP);
+	else
+		ASSERT(0ull == mi64_mul_scalar(p,k[0],q,lenP), "k.p overflows!");
+	mi64_add(q,q,q,lenQ);
+	q[0] += 1;	// q = 2.k.p + 1; No need to check for carry since 2.k.p even
+	return (mi64_twopmodq(p, lenP, k[0], q, lenQ, res) == 1);
+}
+
+static const struct tf_kernel_t {
+	const char*name;
+	uint32 qbits;	// Handles q < 2^qbits (and q >= 2^qlo, see below)...
+	uint32 pwords;	// ...and p of at most this many 64-bit words
+	uint32 nq;		// #candidates per call; only entries with nq dividing TRYQ are usable
+	uint64 (*fn)(TFK_ARGS);
+	int modtype;	// If nonzero, entry only usable for this MODULUS_TYPE
+	uint32 qlo;		// If nonzero, entry only handles q >= 2^qlo
+	uint32 pbits;	// If nonzero, entry only handles p < 2^pbits
+} tf_kernel_tab[] = {
+	{"twopmodq63_q4"             ,  63,1,4,tfk_63_q4},
+	{"twopmodq63_q8"             ,  63,1,8,tfk_63_q8},
+	{"twopmodq64_q4"             ,  64,1,4,tfk_64_q4},
+	{"twopmodq64_q8"             ,  64,1,8,tfk_64_q8},
+	{"twopmodq65_q4"             ,  65,1,4,tfk_65_q4,0,64},	// Assume q has a hidden 65th bit
+	{"twopmodq65_q8"             ,  65,1,8,tfk_65_q8,0,64},
+/* The SIMD-asm twopmodq78_3WORD_DOUBLE_q* estimate the carry out of the low 78 bits of q*lo in MULH78 from rounded
+partial sums, which comes out 1 too small whenever the low half of x^2 is near 0, as it always is for x < 2^26, and the
+modpow then silently misses the factor (for ~2/3 of q < 2^30 in testing). Only the scalar C version, which now does
+that carry exactly, is listed; SIMD builds use the 96-bit kernels for those q-sizes instead: */
+#ifndef USE_SSE2
+	{"twopmodq78_3WORD_DOUBLE_q4",  78,1,4,tfk_78_q4,0,0,63},
+#endif
+	{"twopmodq96_q4"             ,  96,1,4,tfk_96_q4,0,0,63},
+	{"twopmodq96_q8"             ,  96,1,8,tfk_96_q8,0,0,63},
+	{"twopmodq128_96_q4"         ,  96,1,4,tfk_128_96_q4,0,0,63},
+	{"twopmodq128_96_q8"         ,  96,1,8,tfk_128_96_q8,0,0,63},
+	{"twopmodq128_q4"            , 128,2,4,tfk_128_q4},
+	{"twopmodq128_q8"            , 128,2,8,tfk_128_q8},
+	{"twopmodq192_q4"            , 192,3,4,tfk_192_q4},
+	{"twopmodq192_q8"            , 192,3,8,tfk_192_q8},
+	{"twopmodq128_q4_qferm"      , 128,2,4,tfk_128f_q4,MODULUS_TYPE_FERMAT},
+	{"twopmodq192_q4_qferm"      , 192,3,4,tfk_192f_q4,MODULUS_TYPE_FERMAT},
+	{"twopmodq256"               , 256,4,1,tfk_256},
+	{"mi64_twopmodq_qmmp"        , 0xffffffff,0xffffffff,1,tfk_qmmp,MODULUS_TYPE_MERSMERS},
+	{"mi64_twopmodq"             , 0xffffffff,0xffffffff,1,tfk_mi64}	// Must come last
+};
+#define TF_NKERNEL	(sizeof(tf_kernel_tab)/sizeof(tf_kernel_tab[0]))
+#define TF_KBITS_MAX	256	// All q-sizes >= this map to tf_kern_sel[TF_KBITS_MAX]
+#define TF_KCAL_SEC		0.01	// Minimum timing interval per calibrated kernel, in seconds
+// Entry [i] is usable for a [lenP]-word exponent of the given modulus type:
+#define TF_KERNEL_USABLE(i,lenP,modtype)	((lenP) <= tf_kernel_tab[i].pwords && (TRYQ % tf_kernel_tab[i].nq) == 0\
+		&& (!tf_kernel_tab[i].modtype || tf_kernel_tab[i].modtype == (modtype)))
+// Entry [i] handles q-size b, i.e. q in [2^b, 2^(b+1)):
+#define TF_KERNEL_QSIZE_OK(i,b)	((b) < tf_kernel_tab[i].qbits && (b) >= tf_kernel_tab[i].qlo)
+// Entry [i] handles an exponent of bitlength [nbits]:
+#define TF_KERNEL_PBITS_OK(i,nbits)	(!tf_kernel_tab[i].pbits || (nbits) <= tf_kernel_tab[i].pbits)
+
+// Entry b holds the tf_kernel_tab[] index used for sieve sweeps with floor(lg(qmax)) = b; tf_kern_cal[b] is set once
+// q-size b has been calibrated for exponents of tf_kern_lenP words and modulus type tf_kern_modtype:
+static uint8 tf_kern_sel[TF_KBITS_MAX+1], tf_kern_cal[TF_KBITS_MAX+1];
+// Entry i holds the result of the known-factor check of tf_kernel_tab[i] for modulus type tf_kern_modtype: 0 = not yet run, 1 = pass, -1 = fail:
+static int8 tf_kern_known[TF_NKERNEL];
+static uint32 tf_kern_lenP = 0;
+static int tf_kern_modtype = -1;
+
+/******************* Known-factor checks of the modpow kernels: *******************/
+
+// Also included by test_fac(); having them at file scope makes the known-factor tables visible here, too:
+#include "fac_test_dat64.h"
+#include "fac_test_dat96.h"
+#include "fac_test_dat128.h"
+#include "fac_test_dat192.h"
+#include "fac_test_dat256.h"
+
+// A known factor q = 2.k.p+1 of M(p), as needed to feed it to the tf_kernel_tab[] entries. Factors q = k'.2^(n+2)+1
+// of Fn are stored in the same form the sieve uses for them, i.e. with p = 2^n and k = 2.k':
+struct tf_known_fac_t {
+	uint256 p;
+	uint64 k;
+	uint32 lenP;	// #64-bit words of p
+	uint32 qbits;	// Bitlength of q
+	int modtype;	// MODULUS_TYPE_FERMAT for factors of Fn; for factors of M(p), MODULUS_TYPE_MERSMERS if p = 2^m-1, else MODULUS_TYPE_MERSENNE
+};
+
+// Stores (p,q) in *f, returning 1, unless q = 1 (mod 2p) fails or k > 64 bits, in which case returns 0:
+static uint32 tf_set_known_fac(struct tf_known_fac_t *f, uint256 p, uint256 q, int modtype)
+{
+	uint256 two_p, x;
+	ADD256(p,p,two_p);
+	if(!CMPEQ256(xmody256(q, two_p, &x), ONE256) || x.d3 || x.d2 || x.d1)
+		return 0;
+	f->p = p;	f->k = x.d0;
+	f->lenP = mi64_getlen((uint64*)&p, 4);
+	f->qbits = 256 - mi64_leadz((uint64*)&q, 4);
+	ADD256(p,ONE256,x);	// p+1 a power of 2?
+	if(modtype == MODULUS_TYPE_MERSENNE && mi64_trailz((uint64*)&x, 4) + mi64_leadz((uint64*)&x, 4) == 255)
+		modtype = MODULUS_TYPE_MERSMERS;
+	f->modtype = modtype;
+	return 1;
+}
+
+// Fn-factor wrapper for the above: q = k.2^(n+2)+1, with k = k1*2^64 + k0:
+static uint32 tf_set_known_ffac(struct tf_known_fac_t *f, uint32 n, uint64 k1, uint64 k0)
+{
+	uint256 p = {0ull,0ull,0ull,0ull}, q = {k0,k1,0ull,0ull};
+	if(n+2 > mi64_leadz((uint64*)&q, 4))	// q >= 2^256
+		return 0;
+	p.d0 = 1ull;	mi64_shl((uint64*)&p,(uint64*)&p,n  ,4);
+	mi64_shl((uint64*)&q,(uint64*)&q,n+2,4);	q.d0 += 1ull;
+	return tf_set_known_fac(f, p, q, MODULUS_TYPE_FERMAT);
+}
 
-[1] incr == 0x0: Checks validity of the input [p,k] (mod 60) combination, by returning the
-factoring pass number (in unit-offset form, i.e. 1-16) on which the factor with the given k-mod value
-should occur if it's one of the valid combinations of p%60 and k%60. If invalid, returns 0.
+/* Returns the known Mersenne- and Fermat-number factors of the fac_test_dat*.h tables, gathered into a single array
+on the first call, with the number of entries in *nfac:
+*/
+static const struct tf_known_fac_t* tf_known_factors(uint32*nfac)
+{
+	static struct tf_known_fac_t *fac = 0x0;
+	static uint32 n = 0;
+	uint32 i;
+	uint256 p, q;
+	if(fac) {
+		*nfac = n;	return fac;
+	}
+	for(i = 0; fac63   [i].p    != 0; i++, n++) {}
+	for(i = 0; fac64   [i].p    != 0; i++, n++) {}
+	for(i = 0; fac65   [i].p    != 0; i++, n++) {}
+	for(i = 0; fac96   [i].p    != 0; i++, n++) {}
+	for(i = 0; fac128  [i].p    != 0; i++, n++) {}
+	for(i = 0; fac128x2[i].plo  != 0; i++, n++) {}
+	for(i = 0; fac160  [i].p    != 0; i++, n++) {}
+	for(i = 0; fac192  [i].p    != 0; i++, n++) {}
+	for(i = 0; STRNEQ(fac256[i].p, ""); i++, n++) {}
+	for(i = 0; ffac64  [i].p    != 0; i++, n++) {}
+	for(i = 0; ffac128 [i].p    != 0; i++, n++) {}
+	for(i = 0; ffac192 [i].p    != 0; i++, n++) {}
+	for(i = 0; ffac256 [i].n    != 0; i++, n++) {}
+	fac = (struct tf_known_fac_t *)calloc(n, sizeof(struct tf_known_fac_t));
+	ASSERT(fac != 0x0, "Memory allocation failure for known-factor table!");
+	n = 0;
+	p.d3 = p.d2 = p.d1 = q.d3 = q.d2 = q.d1 = 0ull;
+	for(i = 0; fac63[i].p != 0; i++) {
+		p.d0 = fac63[i].p;	q.d0 = fac63[i].q;	n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	for(i = 0; fac64[i].p != 0; i++) {
+		p.d0 = fac64[i].p;	q.d0 = fac64[i].q;	n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	for(i = 0; fac65[i].p != 0; i++) {	// Hi bit of q implied
+		p.d0 = fac65[i].p;	q.d0 = fac65[i].q;	q.d1 = 1ull;	n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	for(i = 0; fac96[i].p != 0; i++) {
+		p.d0 = fac96[i].p;	q.d0 = fac96[i].d0;	q.d1 = fac96[i].d1;	n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	for(i = 0; fac128[i].p != 0; i++) {
+		p.d0 = fac128[i].p;	q.d0 = fac128[i].d0;	q.d1 = fac128[i].d1;	n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	for(i = 0; fac128x2[i].plo != 0; i++) {
+		p.d0 = fac128x2[i].plo;	p.d1 = fac128x2[i].phi;	q.d0 = fac128x2[i].d0;	q.d1 = fac128x2[i].d1;
+		n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	p.d1 = 0ull;
+	for(i = 0; fac160[i].p != 0; i++) {
+		p.d0 = fac160[i].p;	q.d0 = fac160[i].d0;	q.d1 = fac160[i].d1;	q.d2 = fac160[i].d2;	n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	for(i = 0; fac192[i].p != 0; i++) {
+		p.d0 = fac192[i].p;	q.d0 = fac192[i].d0;	q.d1 = fac192[i].d1;	q.d2 = fac192[i].d2;	n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	for(i = 0; STRNEQ(fac256[i].p, ""); i++) {
+		p = convert_base10_char_uint256(fac256[i].p);	q = convert_base10_char_uint256(fac256[i].q);
+		n += tf_set_known_fac(fac+n, p, q, MODULUS_TYPE_MERSENNE);
+	}
+	// Fermat-number factors; the tables give these in [n,k]-form, q = k.2^(n+2)+1:
+	for(i = 0; ffac64 [i].p != 0; i++) { n += tf_set_known_ffac(fac+n, ffac64 [i].p, 0ull, ffac64 [i].q); }
+	for(i = 0; ffac128[i].p != 0; i++) { n += tf_set_known_ffac(fac+n, ffac128[i].p, ffac128[i].d1, ffac128[i].d0); }
+	for(i = 0; ffac192[i].p != 0; i++) {	// As of 2015, no k > 64-bit known
+		if(!ffac192[i].d2)
+			n += tf_set_known_ffac(fac+n, ffac192[i].p, ffac192[i].d1, ffac192[i].d0);
+	}
+	for(i = 0; ffac256[i].n != 0; i++) { n += tf_set_known_ffac(fac+n, ffac256[i].n, 0ull, ffac256[i].k); }
+	*nfac = n;
+	return fac;
+}
 
-[2] incr != 0x0: Checks validity of the input p (mod 60) value, i.e. checks that p can possibly be prime
-according to its (mod 60) residue. (We assume the unmodded p > 60 here.) If invalid, returns 0;
-otherwise populates the arglist incr[] array with the 16 increments in k (mod 60) covering all the
-valid residue classes for the given p (mod 60). These increments sum to 60, i.e. te final pass
-will be the k == 0 (mod 60) one.
+/* Runs entry [i] of tf_kernel_tab[] on each known factor it can handle in a run of modulus type [modtype], each as a
+batch of TRYQ copies of the same k, all of which must be flagged as factors. Fn factors are only used for Fermat-number
+runs, and the M(M(m))-specific entry only gets factors of M(p) with p = 2^m-1. Factors with p < 2^8 (small-index Fn) are
+skipped, since the fixed-width kernels do the leading 8 bits of the powering via a shift. Returns the number of factors
+tested, with the number passing written to *nok:
 */
-uint32 CHECK_PKMOD60(uint64*p, uint32 lenP, uint64 k, uint32*incr)
+static uint32 tf_kernel_check_known(uint32 i, int modtype, uint32*nok)
 {
-	uint32 i,kcur, *iptr = 0x0;	// iptr will point to either the in-array (if one provided) or the following local array:
-	uint32 iloc[16];
-	uint32 pm = 0, km = k%60, FERMAT = 0;
-	uint64 q = 0ull;
-	pm = mi64_div_by_scalar64(p,60ull,lenP,0x0);
-	 q = 2*km*pm + 1;
-	// Note isPow2 works the same for unmodded and modded exponent, e.g. 2^[2,3,4,5,6,...]%60 = [4,8,16,32,4,...]:
-	FERMAT = (pm > 1) && isPow2(pm);
+	const uint64 mask = (TRYQ < 64) ? (1ull << TRYQ) - 1 : ~0ull;
+	const struct tf_known_fac_t *fac = 0x0;
+	uint32 b,j,lenQ,pbits,nfac,ntest = 0;
+	uint64 p[4], q[5], res[5], k[TRYQ];
+
+	fac = tf_known_factors(&nfac);
+	for(j = 0, *nok = 0; j < nfac; j++) {
+		pbits = 256 - mi64_leadz((uint64*)&fac[j].p, 4);
+		if(pbits < 9 || !TF_KERNEL_PBITS_OK(i,pbits)
+		|| !TF_KERNEL_QSIZE_OK(i,fac[j].qbits-1) || !TF_KERNEL_USABLE(i,fac[j].lenP,modtype))
+			continue;
+		if((fac[j].modtype == MODULUS_TYPE_FERMAT) != (modtype == MODULUS_TYPE_FERMAT)
+		|| (tf_kernel_tab[i].modtype == MODULUS_TYPE_MERSMERS && fac[j].modtype != MODULUS_TYPE_MERSMERS))
+			continue;
+		mi64_set_eq(p, (uint64*)&fac[j].p, 4);
+		for(b = 0; b < TRYQ; b++) { k[b] = fac[j].k; }
+		lenQ = (fac[j].qbits + 63)>>6;	lenQ = MAX(lenQ, fac[j].lenP);
+		++ntest;	*nok += (tf_kernel_modpow(i,p,fac[j].lenP,k,q,lenQ,res,0) == mask);
+	}
+	return ntest;
+}
 
-	if((pm%3 == 0) || (pm%5 == 0))
-		return 0;
+/* Times entry [i] of tf_kernel_tab[] on the batch of TRYQ candidates in k[], repeating the batch until the timing
+interval is at least TF_KCAL_SEC. Returns the time per candidate in nanoseconds; the bitmask returned by the kernel
+for the batch is written to *r:
+*/
+static double tf_kernel_time(uint32 i, uint64*p, uint32 lenP, uint64 k[], uint64*q, uint32 lenQ, uint64*res, uint64*r)
+{
+	uint32 j, nrep = 1;
+	double dt;
+	do {
+		dt = getRealTime();
+		for(j = 0; j < nrep; j++) { *r = tf_kernel_modpow(i,p,lenP,k,q,lenQ,res,0); }
+		dt = getRealTime() - dt;
+		nrep <<= 1;
+	} while(dt < TF_KCAL_SEC);
+	return 1e9*dt/((nrep>>1)*TRYQ);
+}
 
-	if(incr == 0x0) {	// If no incr-array, check the validity of the km := k (mod 60) value:
-		iptr = iloc;
-		if(FERMAT) {
-			// Fermat: For a valid p-mod, only possible values of km in a factor q = 2.k.p+1 are those for which k even [as shown by Lucas]
-			// and for which GCD(2*km*pm + 1, 2*60) = 1, i.e. (2*km*pm + 1) is not divisible by 3 or 5.
-			if((km&1) == 0) {
-				if((q%3 == 0) || (q%5 == 0))
-					return 0;
-			} else {
-			//	printf("CHECK_PKMOD60: q mod 8 = %u ... invalid.\n",q&7);
-				return 0;
-			}
-		} else {
-			// Mersenne: For a valid p-mod, only possible values of km are those for which k == +-1 (mod 8) [by quadratic residuacity]
-			// and for which GCD(2*km*pm + 1, 2*60) = 1, i.e. (2*km*pm + 1) is not divisible by 3 or 5.
-			if(((q&7) == 1) || ((q&7) == 7)) {
-				if((q%3 == 0) || (q%5 == 0))
-					return 0;
-			} else {
-			//	printf("CHECK_PKMOD60: q mod 8 = %u ... invalid.\n",q&7);
-				return 0;
+/* Sets up tf_kern_sel[] for a run covering k in [kmin,kmax]. All q-sizes get the first usable entry in the table
+by default; for the q-sizes covered by the run, each usable entry is first checked against the known factors in its
+q-range (once per modulus type), then timed on a batch of TRYQ candidates of the largest q-size it would serve, with
+the results cross-checked against the generic mi64 routine. Entries failing either check are excluded, and each size
+gets the fastest of the remaining entries able to handle it. [modtype] is the MODULUS_TYPE of the run; [q] and [res] are
+[lenQ]-word scratch arrays. In batch mode, q-sizes already calibrated for a previous run with the same exponent length
+and modulus type keep their selection, i.e. only runs extending the range of covered q-sizes incur a recalibration.
+*/
+void tf_kernel_calibrate(int modtype, uint64*p, uint32 lenP, double fbits_in_2p, uint64 kmin, uint64 kmax, uint64*q, uint32 lenQ, uint64*res)
+{
+	uint32 b,blo,bhi,i,j,ntest,nok,nuse = 0;
+	uint64 k[TRYQ], r, rref;
+	double kf, dt, nsec[TF_NKERNEL];
+
+	if(lenP != tf_kern_lenP || modtype != tf_kern_modtype) {
+		for(b = 0; b <= TF_KBITS_MAX; b++) {
+			for(i = 0; i < TF_NKERNEL; i++) {
+				if(TF_KERNEL_QSIZE_OK(i,b) && TF_KERNEL_USABLE(i,lenP,modtype))
+					break;
 			}
+			ASSERT(i < TF_NKERNEL, "No usable modpow kernel!");
+			tf_kern_sel[b] = i;	tf_kern_cal[b] = FALSE;
 		}
-	} else {
-		iptr = incr;
+		if(modtype != tf_kern_modtype) {
+			for(i = 0; i < TF_NKERNEL; i++) { tf_kern_known[i] = 0; }
+		}
+		tf_kern_lenP = lenP;	tf_kern_modtype = modtype;
 	}
-
-	// Populate the incr-array (either the arglist one, if provided, or the local one)
-	// with the km-increments of valid factor candidates classes corresponding for the given pm-value:
-//printf("pm = %u: Acceptable km-values = ",pm);
-	i = 0;	// Index of current array slot
-	kcur = 0;
-	for(k = 1; k <= 60; k++) {	// Unit-offset pass values here!
-		q = 2*k*pm + 1;
-		if( FERMAT && ( (k&1) || (q%3 == 0) || (q%5 == 0) ) )
-			continue;
-		else if( ((q&7) == 3) || ((q&7) == 5) || (q%3 == 0) || (q%5 == 0) )
+	blo = (uint32)(fbits_in_2p + log((double)MAX(kmin,1ull))*ILG2);	blo = MIN(blo, TF_KBITS_MAX);
+	bhi = (uint32)(fbits_in_2p + log((double)MAX(kmax,1ull))*ILG2);	bhi = MIN(bhi, TF_KBITS_MAX);
+	ASSERT(blo <= bhi, "tf_kernel_calibrate: kmin > kmax!");
+	for(b = blo; b <= bhi && tf_kern_cal[b]; b++);
+	if(b > bhi)	// All q-sizes of the run already calibrated
+		return;
+	for(b = blo; b <= bhi; b++) { tf_kern_cal[b] = TRUE; }
+	for(i = 0; i < TF_NKERNEL; i++) {
+		nsec[i] = -1;	// Flags entries not usable for this run
+		if(blo >= tf_kernel_tab[i].qbits || bhi < tf_kernel_tab[i].qlo || !TF_KERNEL_USABLE(i,lenP,modtype)
+		|| !TF_KERNEL_PBITS_OK(i,(lenP<<6) - mi64_leadz(p,lenP)))
 			continue;
-
-		iptr[i++] = k - kcur;	kcur = k;	// iptr stores the *increments* between adjacent km-values
-//printf("%u .. ",kcur);
-		if(!incr && (k == km)) {	// In Check-pair-valid mode can exit as soon as we have the input-km's pass
-			return i;
+		// Entries must find all the known factors in their q-range before they can be selected:
+		if(!tf_kern_known[i]) {
+			ntest = tf_kernel_check_known(i,modtype,&nok);
+			tf_kern_known[i] = (ntest && nok == ntest) ? 1 : -1;
+			if(!ntest)
+				fprintf(stderr,"WARN: No known factors to check %s against ... excluding it.\n",tf_kernel_tab[i].name);
+			else if(nok < ntest)
+				fprintf(stderr,"WARN: %s finds only %u of %u known factors ... excluding it.\n",tf_kernel_tab[i].name,nok,ntest);
+		}
+		if(tf_kern_known[i] > 0) {
+			nsec[i] = 0;	++nuse;
 		}
 	}
-	ASSERT(i == 16, "Expect precisely 16 valid k (mod 60) classes!");
-//printf("\n");
-	return i;	// Nonzero return value indicates success
+	if(nuse < 2) {	// Nothing to choose from, but make sure any entry failing the above check is not selected:
+		for(b = blo; b <= bhi; b++) {
+			for(i = 0; i < TF_NKERNEL && !(nsec[i] >= 0 && TF_KERNEL_QSIZE_OK(i,b)); i++);
+			if(i < TF_NKERNEL)
+				tf_kern_sel[b] = i;
+		}
+		return;
+	}
+	printf("INFO: Calibrating modpow kernels for q in [2^%u, 2^%u):\n",blo,bhi+1);
+	for(i = 0; i < TF_NKERNEL; i++) {
+		if(nsec[i] < 0) continue;
+		// Time using the largest q-size this entry would serve, with q ~= 2^(b+0.5) to stay clear of the 2^qbits bound:
+		b = MIN(bhi, tf_kernel_tab[i].qbits-1);
+		kf = pow(2.0, b + 0.5 - fbits_in_2p);
+		kf = MAX(kf, 1.0);	kf = MIN(kf, (double)0x7fffffffffffffffull);
+		for(j = 0; j < TRYQ; j++) { k[j] = (uint64)kf + j; }
+		for(j = 0, rref = 0ull; j < TRYQ; j++) { rref |= tfk_mi64(p,lenP,k+j,q,lenQ,res,0) << j; }
+		dt = tf_kernel_time(i,p,lenP,k,q,lenQ,res,&r);
+		if(r != rref) {
+			fprintf(stderr,"WARN: %s returns %" PRIX64 " for test batch, expected %" PRIX64 " ... excluding it.\n",tf_kernel_tab[i].name,r,rref);
+			nsec[i] = -1;	continue;
+		}
+		nsec[i] = dt;
+		printf("\t%-28s %10.1f nsec/q\n",tf_kernel_tab[i].name,nsec[i]);
+	}
+	for(b = blo; b <= bhi; b++) {
+		for(i = 0, j = TF_NKERNEL; i < TF_NKERNEL; i++) {
+			if(nsec[i] >= 0 && TF_KERNEL_QSIZE_OK(i,b) && (j == TF_NKERNEL || nsec[i] < nsec[j]))
+				j = i;
+		}
+		if(j < TF_NKERNEL)
+			tf_kern_sel[b] = j;
+	}
+	// Print the resulting crossover points:
+	for(b = blo; b <= bhi; b = j) {
+		for(j = b+1; j <= bhi && tf_kern_sel[j] == tf_kern_sel[b]; j++);
+		printf("INFO: Using %s for q in [2^%u, 2^%u).\n",tf_kernel_tab[tf_kern_sel[b]].name,b,j);
+	}
 }
 
-// Same as above, but (mod 4620) - i.e. small-primes 3,5,7,11 built into the sieve length - and 960 resulting passes:
-uint32 CHECK_PKMOD4620(uint64*p, uint32 lenP, uint64 k, uint32*incr)
+uint32 tf_kernel_select(double fbits_in_q)
 {
-	uint32 i,kcur, *iptr = 0x0;	// iptr will point to either the in-array (if one provided) or the following local array:
-	uint32 iloc[960];
-	uint32 pm = 0, km = k%4620, FERMAT = 0;
-	uint64 q = 0ull;
-	pm = mi64_div_by_scalar64(p,4620ull,lenP,0x0);
-	 q = 2*km*pm + 1;
-	// For (mod 4620) we do not have the property that isPow2 works the same for unmodded and modded power-of-2
-	// exponents that we do (mod 60), so must infer Fermat-ness based simply on evenness of exponent (modded or not).
-	// or better, by call to the mi64 library:
-	FERMAT = mi64_isPow2(p,lenP,&i);	// If p a power of 2, binary exponent returned in i
+	uint32 b = (uint32)fbits_in_q;
+	return tf_kern_sel[MIN(b, TF_KBITS_MAX)];
+}
 
-	if((pm%3 == 0) || (pm%5 == 0) || (pm%7 == 0) || (pm%11 == 0))
-		return 0;
+uint64 tf_kernel_modpow(uint32 kidx, uint64*p, uint32 lenP, uint64 k[], uint64*q, uint32 lenQ, uint64*res, int tid)
+{
+	const struct tf_kernel_t *kern = tf_kernel_tab + kidx;
+	uint32 j;
+	uint64 r = 0ull;
+	for(j = 0; j < TRYQ; j += kern->nq) {
+		r |= kern->fn(p,lenP,k+j,q,lenQ,res,tid) << j;
+	}
+	return r;
+}
 
-	if(incr == 0x0) {	// If no incr-array, check the validity of the km := k (mod 60) value:
-		iptr = iloc;
-		if(FERMAT) {
-			// Fermat: For a valid p-mod, only possible values of km in a factor q = 2.k.p+1 are those for which k even [as shown by Lucas]
-			// and for which GCD(2*km*pm + 1, 2*4620) = 1, i.e. (2*km*pm + 1) is not divisible by 3,5,7 or 11.
-			if((km&1) == 0) {
-				if((q%3 == 0) || (q%5 == 0) || (q%7 == 0) || (q%11 == 0))
-					return 0;
-			} else {
-			//	printf("CHECK_PKMOD4620: q mod 8 = %u ... invalid.\n",q&7);
-				return 0;
-			}
-		} else {
-			// Mersenne: For a valid p-mod, the only possible value of km are those for which k == +-1 (mod 8) [by quadratic residuacity]
-			// and for which GCD(2*km*pm + 1, 2*4620) = 1, i.e. (2*km*pm + 1) is not divisible by 3,5,7 or 11.
-		//	printf("CHECK_PKMOD4620: pm,km = %u,%u: q = %" PRIu64 " [mod 8 = %u]\n",pm,km,q,(uint32)q&7);
-			if(((q&7) == 1) || ((q&7) == 7)) {
-				if((q%3 == 0) || (q%5 == 0) || (q%7 == 0) || (q%11 == 0))
-					return 0;
-			} else {
-			//	printf("CHECK_PKMOD4620: q mod 8 = %u ... invalid.\n",q&7);
-				return 0;
-			}
-		}
-	} else {
-		iptr = incr;
+#ifdef FACTOR_STANDALONE
+
+/******************* Modpow-kernel benchmark (Mfactor -bench): *******************/
+
+#if defined(USE_AVX512)
+	#define TF_BENCH_SIMD	"avx512"
+#elif defined(USE_AVX2)
+	#define TF_BENCH_SIMD	"avx2"
+#elif defined(USE_AVX)
+	#define TF_BENCH_SIMD	"avx"
+#elif defined(USE_SSE2)
+	#define TF_BENCH_SIMD	"sse2"
+#elif defined(USE_ARM_V8_SIMD)
+	#define TF_BENCH_SIMD	"asimd"
+#else
+	#define TF_BENCH_SIMD	"none"
+#endif
+
+/* Benchmarks the tf_kernel_tab[] entries usable for Mersenne-number TF, single-threaded:
+	o Each entry is run on every known Mersenne-number factor of the fac_test_dat*.h tables it can handle, using the
+	  same tf_kernel_check_known() as tf_kernel_calibrate();
+	o For each q-size b in [bmin,bmax] it can handle, each entry is timed on a batch of TRYQ candidates with q ~= 2^(b+0.5),
+	  using the same timing loop as tf_kernel_calibrate(), with the result cross-checked against the generic mi64 routine.
+	  The exponent is a synthetic odd p of max(27, b-60) bits, thus k < 2^61 and for b <= 88 p is GIMPS-sized.
+The results go to the file [fname], one row per (kernel, q-size), in JSON form if the filename ends in ".json", else CSV;
+a summary is printed to stdout. Returns the number of entries failing one or more checks.
+*/
+int tf_kernel_bench(const char*version, double bmin, double bmax, const char*fname)
+{
+	const int modtype = MODULUS_TYPE_MERSENNE;
+	uint32 b,b0,blo,bhi,i,j,lenP,lenQ,pbits,nfac,ntest,nok,nxok,nrow,nkern = 0,nbad = 0,json;
+	uint64 p[4], q[5], res[5], k[TRYQ], r, rref;
+	double kf, fbits_in_2p, nsec, nsec_min, nsec_max;
+	const struct tf_known_fac_t *fac = 0x0;
+	FILE *fp;
+
+	blo = bmin ? (uint32)bmin : TF_BENCH_BMIN;
+	bhi = bmax ? (uint32)ceil(bmax) - 1 : TF_BENCH_BMAX;
+	if(blo > bhi || bhi >= TF_KBITS_MAX) {
+		fprintf(stderr,"*** ERROR: -bench q-size range [2^%u, 2^%u) illegal: need bmin < bmax <= %u.\n",blo,bhi+1,TF_KBITS_MAX);
+		return 1;
+	}
+	j = strlen(fname);
+	json = (j > 5 && STREQ(fname+j-5, ".json"));
+	fp = fopen(fname, "w");
+	if(!fp) {
+		fprintf(stderr,"*** ERROR: Unable to open benchmark file %s for writing.\n",fname);
+		return 1;
 	}
+	fac = tf_known_factors(&j);
+	for(nfac = 0; j--; ) { nfac += (fac[j].modtype != MODULUS_TYPE_FERMAT); }
+	printf("INFO: Benchmarking modpow kernels for q in [2^%u, 2^%u), TRYQ = %u, checking vs %u known factors...\n",blo,bhi+1,TRYQ,nfac);
+	if(json)
+		fprintf(fp,"{\n\"program\": \"Mfactor\", \"version\": \"%s\", \"tryq\": %u, \"simd\": \"%s\",\n\"kernels\": [",version,TRYQ,TF_BENCH_SIMD);
+	else
+		fprintf(fp,"# Mfactor %s, TRYQ = %u, SIMD = %s\nkernel,nq,qmin_bits,qmax_bits,known_tested,known_ok,qbits,nsec_per_q,xcheck\n",version,TRYQ,TF_BENCH_SIMD);
 
-	// Populate the incr-array (either the arglist one, if provided, or the local one)
-	// with the km-increments of valid factor candidates classes corresponding for the given pm-value:
-//printf("pm = %u: Acceptable km-values = ",pm);
-	i = 0;	// Index of current array slot
-	kcur = 0;
-	for(k = 1; k <= 4620; k++) {	// Unit-offset pass values here!
-		q = 2*k*pm + 1;
-		if( FERMAT && ( (k&1) || (q%3 == 0) || (q%5 == 0) || (q%7 == 0) || (q%11 == 0) ) )
-			continue;
-		else if( ((q&7) == 3) || ((q&7) == 5) || (q%3 == 0) || (q%5 == 0) || (q%7 == 0) || (q%11 == 0) )
+	for(i = 0; i < TF_NKERNEL; i++) {
+		if(!TF_KERNEL_USABLE(i,1,modtype))	// Skip entries not used by this build, or for other modulus types
 			continue;
-
-		iptr[i++] = k - kcur;	kcur = k;	// iptr stores the *increments* between adjacent km-values
-//printf("%u .. ",kcur);
-		if(!incr && (k == km)) {	// In Check-pair-valid mode can exit as soon as we have the input-km's pass
-			return i;
+		ntest = tf_kernel_check_known(i,modtype,&nok);
+		// Timings:
+		if(json)
+			fprintf(fp,"%s\n  {\"name\": \"%s\", \"nq\": %u, \"qmin_bits\": %u, \"qmax_bits\": %u, \"known_tested\": %u, \"known_ok\": %u, \"rows\": [",
+				(nkern++ ? "," : ""),tf_kernel_tab[i].name,tf_kernel_tab[i].nq,tf_kernel_tab[i].qlo,MIN(tf_kernel_tab[i].qbits,TF_KBITS_MAX),ntest,nok);
+		nsec_min = 1e30;	nsec_max = 0;
+		b0 = MAX(blo, tf_kernel_tab[i].qlo);
+		for(b = b0, nrow = nxok = 0; b <= bhi && b < tf_kernel_tab[i].qbits; b++) {
+			pbits = (b > 87) ? b-60 : 27;	lenP = (pbits + 63)>>6;
+			if(!TF_KERNEL_USABLE(i,lenP,modtype))
+				break;
+			// p = 2^(pbits-1) + [a fixed pattern of lower bits] + 1:
+			mi64_clear(p, 4);
+			p[0] = 0x9E3779B97F4A7C15ull;	// Odd
+			if(pbits <= 64) {
+				p[0] &= (1ull << (pbits-1)) - 1;	p[0] |= 1ull;
+				p[0] += 1ull << (pbits-1);
+				fbits_in_2p = log((double)p[0])*ILG2 + 1;
+			} else {
+				p[lenP-1] = 1ull << ((pbits-1) & 63);
+				fbits_in_2p = pbits;	// Error in lg(2p) < 2^-60
+			}
+			kf = pow(2.0, b + 0.5 - fbits_in_2p);
+			for(j = 0; j < TRYQ; j++) { k[j] = (uint64)kf + j; }
+			lenQ = (b + 1 + 63)>>6;	lenQ = MAX(lenQ, lenP);
+			for(j = 0, rref = 0ull; j < TRYQ; j++) { rref |= tfk_mi64(p,lenP,k+j,q,lenQ,res,0) << j; }
+			nsec = tf_kernel_time(i,p,lenP,k,q,lenQ,res,&r);
+			++nrow;	nxok += (r == rref);
+			nsec_min = MIN(nsec, nsec_min);	nsec_max = MAX(nsec, nsec_max);
+			if(json)
+				fprintf(fp,"%s\n    {\"qbits\": %u, \"nsec_per_q\": %.2f, \"xcheck\": %u}",(nrow > 1 ? "," : ""),b,nsec,(r == rref));
+			else
+				fprintf(fp,"%s,%u,%u,%u,%u,%u,%u,%.2f,%u\n",tf_kernel_tab[i].name,tf_kernel_tab[i].nq,tf_kernel_tab[i].qlo,MIN(tf_kernel_tab[i].qbits,TF_KBITS_MAX),ntest,nok,b,nsec,(r == rref));
 		}
+		if(json)
+			fprintf(fp,"%s]}",(nrow ? "\n  " : ""));
+		if(nok < ntest || nxok < nrow) {
+			++nbad;
+			fprintf(stderr,"WARN: %s fails %u of %u known-factor checks, %u of %u test batches!\n",tf_kernel_tab[i].name,ntest-nok,ntest,nrow-nxok,nrow);
+		}
+		if(nrow)
+			printf("\t%-28s known factors %4u/%-4u  q in [2^%u, 2^%u): %8.1f - %8.1f nsec/q\n",tf_kernel_tab[i].name,nok,ntest,b0,b0+nrow,nsec_min,nsec_max);
+		else
+			printf("\t%-28s known factors %4u/%-4u  not usable for q in [2^%u, 2^%u)\n",tf_kernel_tab[i].name,nok,ntest,blo,bhi+1);
 	}
-	ASSERT(i == 960, "Expect precisely 960 valid k (mod 4620) classes!");
-	return i;	// Nonzero return value indicates success
+	if(json)
+		fprintf(fp,"\n]\n}\n");
+	fclose(fp);
+	printf("INFO: Benchmark results written to %s.\n",fname);
+	return nbad;
 }
 
+#endif	// FACTOR_STANDALONE ?
+
+#endif	// TF_DISPATCH ?
+
 // Computes 2*p (mod curr_p):
 uint32 twop_mod_smallp(const int MODULUS_TYPE, const uint64*two_p, const uint32 findex, const uint32 len2P, const uint32 curr_p)
 {
@@ -4373,7 +5560,7 @@ uint64 given_b_get_k(double bits, const uint64 two_p[], uint32 len)
 
 /* The factoring checkpoint file is assumed to have the format:
 	Line 1:		{string containing the current exponent stored in pstring}
-	Line 2:		TF_PASSES; supporte values are 16 and 960
+	Line 2:		TF_PASSES; supported values are 16, 96 and 960
 
 	Line 3:		bmin = {Log2(minimum factor to try), in floating double form}
 				If > 10^9 its whole-number part is taken as the KMin value instead.
@@ -4393,18 +5580,25 @@ uint64 given_b_get_k(double bits, const uint64 two_p[], uint32 len)
 	Line 12+:	Any diagnostic info not needed for restarting from interrupt
 				(mainly, in standalone mode can use this in place of STATFILE.)
 */
+static int read_tf_ckpt(const char*fname, const char*pstring, double*bmin, double*bmax,
+uint64*kmin, uint64*know, uint64*kmax, uint32*passmin, uint32*passnow, uint32*passmax, uint64*count);
+
 int read_savefile(const char*fname, const char*pstring, double*bmin, double*bmax,
 uint64*kmin, uint64*know, uint64*kmax, uint32*passmin, uint32*passnow, uint32*passmax, uint64*count)
 {
 	int itmp;
-	uint32 curr_line = 0, nerr = 0;
+	uint32 i, curr_line = 0, nerr = 0;
 	uint64 tf_passes = 0;
 	char *char_addr;
-	/* TF restart files are in HRF, not binary: */
+	/* Legacy TF restart files are in HRF; binary checkpoints are recognized by their leading magic number: */
 	fp = mlucas_fopen(fname, "r");
 	if(!fp) {
 		return -1;
+	} else if(fread(&i, sizeof(uint32), 1, fp) == 1 && i == TF_CKPT_MAGIC) {
+		fclose(fp); fp = 0x0;
+		return read_tf_ckpt(fname, pstring, bmin,bmax, kmin,know,kmax, passmin,passnow,passmax, count);
 	} else {
+		rewind(fp);
 		sprintf(cbuf,"Factoring savefile %s found ... reading ...\n",fname);
 		fprintf(stderr,"%s",cbuf);
 	#ifndef FACTOR_STANDALONE
@@ -4439,8 +5633,17 @@ uint64*kmin, uint64*know, uint64*kmax, uint32*passmin, uint32*passnow, uint32*pa
 			}
 			char_addr++;
 			tf_passes = convert_base10_char_uint64(char_addr);
+			// Unless the user fixed the class count, resume using that of the savefile:
 			if(tf_passes != TF_PASSES) {
-				++nerr; fprintf(stderr,"ERROR: Line %d of factoring restart file %s: TF_PASSES value [%" PRIu64 "] mismatches that of build [%u]!\n",curr_line,fname, tf_passes, (uint32)TF_PASSES);
+				for(i = 0; i < 3; i++) {
+					if(tf_class_tab[i][1] == tf_passes) break;
+				}
+				if(tf_classes_fixed || i == 3) {
+					++nerr; fprintf(stderr,"ERROR: Line %d of factoring restart file %s: TF_PASSES value [%" PRIu64 "] mismatches that of run [%u]!\n",curr_line,fname, tf_passes, (uint32)TF_PASSES);
+				} else {
+					fprintf(stderr,"INFO: Factoring restart file %s has TF_PASSES = %" PRIu64 " ... switching to TF_CLASSES = %u.\n",fname, tf_passes, tf_class_tab[i][0]);
+					tf_set_classes(tf_class_tab[i][0]);
+				}
 			}
 		}
 
@@ -4456,7 +5659,7 @@ uint64*kmin, uint64*know, uint64*kmax, uint32*passmin, uint32*passnow, uint32*pa
 				++nerr; fprintf(stderr,"ERROR: Line %d of factoring restart file %s lacks the required = sign!\n",curr_line,fname);
 			}
 		}
-		itmp = sscanf(char_addr, "%lf",bmin);
+		itmp = sscanf(char_addr+1, "%lf",bmin);
 		if(itmp != 1) {
 			++nerr; fprintf(stderr,"ERROR: unable to parse Line %d (bmin) of factoring restart file %s. Offending input = %s\n",curr_line,fname, in_line);
 		}
@@ -4473,7 +5676,7 @@ uint64*kmin, uint64*know, uint64*kmax, uint32*passmin, uint32*passnow, uint32*pa
 				++nerr; fprintf(stderr,"ERROR: Line %d of factoring restart file %s lacks the required = sign!\n",curr_line,fname);
 			}
 		}
-		itmp = sscanf(char_addr, "%lf",bmax);
+		itmp = sscanf(char_addr+1, "%lf",bmax);
 		if(itmp != 1) {
 			++nerr; fprintf(stderr,"ERROR: unable to parse Line %d (bmax) of factoring restart file %s. Offending input = %s\n",curr_line,fname, in_line);
 		}
@@ -4805,6 +6008,444 @@ int write_savefile(const char*fname, const char*pstring, uint32 passnow, uint64
 	}
 }
 
+/*
+Binary checkpoint, cf. tf_ckpt at top of file. File layout, all fields in host byte order:
+
+	uint32	TF_CKPT_MAGIC, TF_CKPT_VERSION
+	uint32	strlen(pstring), followed by the pstring chars
+	uint32	tf_passes, passmin, passmax, nseg
+	double	bmin, bmax
+	uint64	kmin, kmax, sweep_lo, sweep_hi, seg_sweeps, count
+	uint32	nfac, followed by nfac uint64 factor k's
+	uint64	(tf_passes*nseg + 63)/64 words of done-unit bitmap
+	uint32	CRC-32 of all the preceding bytes
+
+Checkpoints get written to [fname].tmp, synced to disk and then renamed to [fname], so an interrupted write leaves the
+previous checkpoint intact. In multithreaded builds the writes are done by a background thread, every TF_CKPT_SECS
+seconds if any units were completed in the meantime, in unthreaded ones by tf_ckpt_mark(). The checkpoint shares the
+t{exponent} name of the legacy text savefile, which read_savefile() tells apart by the leading magic number.
+*/
+#ifndef OS_TYPE_WINDOWS
+	#include <unistd.h>	// fsync()
+#else
+	#define fsync(_fd)	0	// fflush() has to do
+#endif
+#define TF_CKPT_PUT(_x)	{ memcpy(buf + n, &(_x), sizeof(_x)); n += sizeof(_x); }
+#define TF_CKPT_GET(_x)	{ if(n + sizeof(_x) > len) goto CKPT_SHORT; memcpy(&(_x), buf + n, sizeof(_x)); n += sizeof(_x); }
+
+// Standard (reflected, IEEE 802.3 polynomial) CRC-32; bitwise, since only needed for the few-KB checkpoint:
+static uint32 tf_crc32(const uint8*buf, uint32 len)
+{
+	uint32 i,j, crc = 0xffffffff;
+	for(i = 0; i < len; i++) {
+		crc ^= buf[i];
+		for(j = 0; j < 8; j++)
+			crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+	}
+	return ~crc;
+}
+
+// Is unit [pass, seg] done? Caller must hold tf_ckpt_mutex in multithreaded builds:
+static int tf_ckpt_isdone(uint32 pass, uint32 seg)
+{
+	uint32 bit = pass*tf_ckpt.nseg + seg;
+	return (tf_ckpt.done[bit>>6] >> (bit & 63)) & 1;
+}
+
+// Returns #units of passes passmin-passmax done:
+static uint32 tf_ckpt_ndone(void)
+{
+	uint32 pass,seg, ndone = 0;
+	for(pass = tf_ckpt.passmin; pass <= tf_ckpt.passmax; pass++) {
+		for(seg = 0; seg < tf_ckpt.nseg; seg++) { ndone += tf_ckpt_isdone(pass,seg); }
+	}
+	return ndone;
+}
+
+// Reads binary checkpoint [fname] into tf_ckpt and returns the run parameters in the same form as read_savefile(),
+// with an incomplete run flagged via know = kmin. Returns 0 on success, else the #errors:
+static int read_tf_ckpt(const char*fname, const char*pstring, double*bmin, double*bmax,
+uint64*kmin, uint64*know, uint64*kmax, uint32*passmin, uint32*passnow, uint32*passmax, uint64*count)
+{
+	uint8*buf;
+	uint32 i, n = 0, len, nerr = 0, itmp32, nword;
+	FILE*fp = mlucas_fopen(fname, "rb");
+	if(!fp)
+		return -1;
+	fseek(fp, 0, SEEK_END);	len = (uint32)ftell(fp);	rewind(fp);
+	buf = (uint8 *)malloc(len + 1);	ASSERT(buf != 0x0, "FATAL: unable to allocate checkpoint buffer.");
+	i = (fread(buf, 1, len, fp) != len);
+	fclose(fp); fp = 0x0;
+	if(i || len < 12 || (memcpy(&itmp32, buf + len - 4, 4), itmp32 != tf_crc32(buf, len - 4))) {
+		fprintf(stderr,"ERROR: Factoring checkpoint %s is truncated or corrupt (checksum mismatch)!\n",fname);
+		free((void *)buf);
+		return 1;
+	}
+	len -= 4;
+	memset(&tf_ckpt, 0, sizeof(tf_ckpt));
+	TF_CKPT_GET(itmp32);	// Magic number, already checked by caller
+	TF_CKPT_GET(itmp32);
+	if(itmp32 != TF_CKPT_VERSION) {
+		++nerr; fprintf(stderr,"ERROR: Factoring checkpoint %s has unsupported format version %u!\n",fname,itmp32);
+		goto CKPT_DONE;
+	}
+	TF_CKPT_GET(itmp32);
+	if(itmp32 >= STR_MAX_LEN || n + itmp32 > len)
+		goto CKPT_SHORT;
+	memcpy(tf_ckpt.pstring, buf + n, itmp32);	n += itmp32;
+	if(STRNEQ(tf_ckpt.pstring, pstring)) {
+		++nerr; fprintf(stderr,"ERROR: current exponent %s != that of factoring checkpoint %s [%s]!\n",pstring,fname,tf_ckpt.pstring);
+	}
+	TF_CKPT_GET(tf_ckpt.tf_passes);	TF_CKPT_GET(tf_ckpt.passmin);	TF_CKPT_GET(tf_ckpt.passmax);	TF_CKPT_GET(tf_ckpt.nseg);
+	TF_CKPT_GET(tf_ckpt.bmin);	TF_CKPT_GET(tf_ckpt.bmax);
+	TF_CKPT_GET(tf_ckpt.kmin);	TF_CKPT_GET(tf_ckpt.kmax);	TF_CKPT_GET(tf_ckpt.sweep_lo);	TF_CKPT_GET(tf_ckpt.sweep_hi);
+	TF_CKPT_GET(tf_ckpt.seg_sweeps);	TF_CKPT_GET(tf_ckpt.count);
+	TF_CKPT_GET(tf_ckpt.nfac);
+	if(tf_ckpt.nseg == 0 || tf_ckpt.nseg > TF_CKPT_NSEG || tf_ckpt.nfac > TF_CKPT_MAXFAC || tf_ckpt.seg_sweeps == 0
+	|| tf_ckpt.passmin > tf_ckpt.passmax || tf_ckpt.passmax >= tf_ckpt.tf_passes) {
+		++nerr; fprintf(stderr,"ERROR: Factoring checkpoint %s has invalid run parameters!\n",fname);
+		goto CKPT_DONE;
+	}
+	for(i = 0; i < tf_ckpt.nfac; i++) { TF_CKPT_GET(tf_ckpt.fac_k[i]); }
+	nword = (tf_ckpt.tf_passes*tf_ckpt.nseg + 63)>>6;
+	if(nword > TF_PASSES_MAX*TF_CKPT_NSEG/64)
+		goto CKPT_SHORT;
+	for(i = 0; i < nword; i++) { TF_CKPT_GET(tf_ckpt.done[i]); }
+	if(n != len)
+		goto CKPT_SHORT;
+
+	// Unless the user fixed the class count, resume using that of the checkpoint:
+	if(tf_ckpt.tf_passes != TF_PASSES) {
+		for(i = 0; i < 3; i++) {
+			if(tf_class_tab[i][1] == tf_ckpt.tf_passes) break;
+		}
+		if(tf_classes_fixed || i == 3) {
+			++nerr; fprintf(stderr,"ERROR: Factoring checkpoint %s: TF_PASSES value [%u] mismatches that of run [%u]!\n",fname, tf_ckpt.tf_passes, (uint32)TF_PASSES);
+		} else {
+			fprintf(stderr,"INFO: Factoring checkpoint %s has TF_PASSES = %u ... switching to TF_CLASSES = %u.\n",fname, tf_ckpt.tf_passes, tf_class_tab[i][0]);
+			tf_set_classes(tf_class_tab[i][0]);
+		}
+	}
+	*bmin = tf_ckpt.bmin;	*bmax = tf_ckpt.bmax;
+	*kmin = tf_ckpt.kmin;	*kmax = tf_ckpt.kmax;
+	*passmin = tf_ckpt.passmin;	*passmax = tf_ckpt.passmax;
+	*count = tf_ckpt.count;
+	// Incomplete runs resume from the bitmap, not from any current pass and k, so flag them via passnow = passmin, know = kmin:
+	i = tf_ckpt_ndone();
+	if(i == (tf_ckpt.passmax - tf_ckpt.passmin + 1)*tf_ckpt.nseg) {
+		*passnow = tf_ckpt.passmax;	*know = tf_ckpt.kmax;
+	} else {
+		*passnow = tf_ckpt.passmin;	*know = tf_ckpt.kmin;
+	}
+	sprintf(cbuf,"Factoring checkpoint %s found: %u of %u class/k-segment units done, %u factors found.\n",fname, i, (tf_ckpt.passmax - tf_ckpt.passmin + 1)*tf_ckpt.nseg, tf_ckpt.nfac);
+	fprintf(stderr,"%s",cbuf);
+  #ifndef FACTOR_STANDALONE
+	fq = mlucas_fopen(STATFILE,"a"); fprintf(fq,"%s",cbuf); fclose(fq); fq = 0x0;
+  #endif
+	goto CKPT_DONE;
+CKPT_SHORT:
+	++nerr; fprintf(stderr,"ERROR: Factoring checkpoint %s has inconsistent length!\n",fname);
+CKPT_DONE:
+	if(nerr)
+		tf_ckpt.nseg = 0;
+	free((void *)buf);
+	return (int)nerr;
+}
+
+/* Sets up checkpointing to [fname] for the run with the given parameters. If tf_ckpt holds an incomplete run read
+from a checkpoint, that must be the same run, and is resumed; otherwise tf_ckpt is reset to the given run, with
+the units preceding [passnow, sweep_now] marked done if it's a restart from a legacy text savefile:
+*/
+void tf_ckpt_init(const char*fname, const char*pstring, double bmin, double bmax, uint64 kmin, uint64 kmax,
+	uint32 passmin, uint32 passnow, uint32 passmax, uint64 sweep_lo, uint64 sweep_now, uint64 sweep_hi)
+{
+	uint32 pass,seg,bit;
+	uint64 nsweep = sweep_hi - sweep_lo;
+	if(tf_ckpt.nseg && tf_ckpt_ndone() < (tf_ckpt.passmax - tf_ckpt.passmin + 1)*tf_ckpt.nseg) {
+		if(tf_ckpt.sweep_lo != sweep_lo || tf_ckpt.sweep_hi != sweep_hi || tf_ckpt.tf_passes != TF_PASSES
+		|| tf_ckpt.passmin != passmin || tf_ckpt.passmax != passmax) {
+			sprintf(cbuf,"ERROR: Factoring checkpoint %s run parameters mismatch those of the run ... please delete it and retry.\n",fname);
+			ASSERT(0,cbuf);
+		}
+		fprintf(stderr,"INFO: Resuming from checkpoint, %s q tried so far.\n",&char_buf0[convert_uint64_base10_char(char_buf0, tf_ckpt.count)]);
+	} else {
+		memset(&tf_ckpt, 0, sizeof(tf_ckpt));
+		strcpy(tf_ckpt.pstring, pstring);
+		tf_ckpt.tf_passes = TF_PASSES;	tf_ckpt.passmin = passmin;	tf_ckpt.passmax = passmax;
+		tf_ckpt.bmin = bmin;	tf_ckpt.bmax = bmax;	tf_ckpt.kmin = kmin;	tf_ckpt.kmax = kmax;
+		tf_ckpt.sweep_lo = sweep_lo;	tf_ckpt.sweep_hi = sweep_hi;
+		// Make the segments as even as possible, no more than TF_CKPT_NSEG of them:
+		tf_ckpt.nseg = (uint32)MIN(nsweep, TF_CKPT_NSEG);
+		tf_ckpt.seg_sweeps = (nsweep + tf_ckpt.nseg - 1)/tf_ckpt.nseg;
+		tf_ckpt.nseg = (uint32)((nsweep + tf_ckpt.seg_sweeps - 1)/tf_ckpt.seg_sweeps);
+		for(pass = passmin; pass <= passnow; pass++) {
+			for(seg = 0; seg < tf_ckpt.nseg && (pass < passnow || (seg+1)*tf_ckpt.seg_sweeps <= sweep_now - sweep_lo); seg++) {
+				bit = pass*tf_ckpt.nseg + seg;
+				tf_ckpt.done[bit>>6] |= 1ull << (bit & 63);
+			}
+		}
+	}
+	strcpy(tf_ckpt.fname, fname);
+	tf_ckpt.dirty = FALSE;	tf_ckpt.tlast = getRealTime();
+}
+
+// Returns the first sweep of the first not-yet-done k-segment of the given pass, or sweep_hi if all are done,
+// but no less than sweep_lo:
+uint64 tf_ckpt_resume(uint32 pass, uint64 sweep_lo)
+{
+	uint32 seg;
+	uint64 sweep;
+	if(!tf_ckpt.nseg)
+		return sweep_lo;
+  #ifdef MULTITHREAD
+	pthread_mutex_lock(&tf_ckpt_mutex);
+  #endif
+	for(seg = 0; seg < tf_ckpt.nseg && tf_ckpt_isdone(pass,seg); seg++) {}
+	sweep = MIN(tf_ckpt.sweep_lo + seg*tf_ckpt.seg_sweeps, tf_ckpt.sweep_hi);
+  #ifdef MULTITHREAD
+	pthread_mutex_unlock(&tf_ckpt_mutex);
+  #endif
+	return MAX(sweep, sweep_lo);
+}
+
+// Marks the unit containing [pass, sweep] done, once all its candidates have been tested, and adds the unit's
+// #candidates to the #q-tried count:
+void tf_ckpt_mark(uint32 pass, uint64 sweep, uint64 count)
+{
+	uint32 bit;
+	if(!tf_ckpt.nseg)
+		return;
+  #ifdef MULTITHREAD
+	pthread_mutex_lock(&tf_ckpt_mutex);
+  #endif
+	bit = pass*tf_ckpt.nseg + (uint32)((sweep - tf_ckpt.sweep_lo)/tf_ckpt.seg_sweeps);
+	tf_ckpt.done[bit>>6] |= 1ull << (bit & 63);
+	tf_ckpt.count += count;	tf_ckpt.dirty = TRUE;
+  #ifdef MULTITHREAD
+	pthread_mutex_unlock(&tf_ckpt_mutex);
+  #else
+	if(getRealTime() - tf_ckpt.tlast >= TF_CKPT_SECS)
+		ASSERT(0 == tf_ckpt_write(), "There were errors writing the checkpoint ... aborting");
+  #endif
+}
+
+// Records the k of a factor found, for reporting after a restart:
+void tf_ckpt_add_factor(uint64 k)
+{
+	if(!tf_ckpt.nseg)
+		return;
+  #ifdef MULTITHREAD
+	pthread_mutex_lock(&tf_ckpt_mutex);
+  #endif
+	if(tf_ckpt.nfac < TF_CKPT_MAXFAC)
+		tf_ckpt.fac_k[tf_ckpt.nfac++] = k;
+	tf_ckpt.dirty = TRUE;
+  #ifdef MULTITHREAD
+	pthread_mutex_unlock(&tf_ckpt_mutex);
+  #endif
+}
+
+// Copies up to [nmax] factor k's from the checkpoint into factor_k[], returns the #copied:
+uint32 tf_ckpt_factors(uint64*factor_k, uint32 nmax)
+{
+	uint32 i;
+	for(i = 0; i < tf_ckpt.nfac && i < nmax; i++) { factor_k[i] = tf_ckpt.fac_k[i]; }
+	return i;
+}
+
+// Writes the checkpoint. The file I/O is done outside tf_ckpt_mutex, on a snapshot taken under it. Returns 0 on success:
+int tf_ckpt_write(void)
+{
+	uint8*buf;
+	uint32 i, n = 0, itmp32, nword;
+	char tmpname[STR_MAX_LEN+4];
+	FILE*fp;
+	if(!tf_ckpt.nseg)
+		return 0;
+	buf = (uint8 *)malloc(STR_MAX_LEN + sizeof(tf_ckpt));	ASSERT(buf != 0x0, "FATAL: unable to allocate checkpoint buffer.");
+  #ifdef MULTITHREAD
+	pthread_mutex_lock(&tf_ckpt_mutex);
+  #endif
+	itmp32 = TF_CKPT_MAGIC;		TF_CKPT_PUT(itmp32);
+	itmp32 = TF_CKPT_VERSION;	TF_CKPT_PUT(itmp32);
+	itmp32 = strlen(tf_ckpt.pstring);	TF_CKPT_PUT(itmp32);
+	memcpy(buf + n, tf_ckpt.pstring, itmp32);	n += itmp32;
+	TF_CKPT_PUT(tf_ckpt.tf_passes);	TF_CKPT_PUT(tf_ckpt.passmin);	TF_CKPT_PUT(tf_ckpt.passmax);	TF_CKPT_PUT(tf_ckpt.nseg);
+	TF_CKPT_PUT(tf_ckpt.bmin);	TF_CKPT_PUT(tf_ckpt.bmax);
+	TF_CKPT_PUT(tf_ckpt.kmin);	TF_CKPT_PUT(tf_ckpt.kmax);	TF_CKPT_PUT(tf_ckpt.sweep_lo);	TF_CKPT_PUT(tf_ckpt.sweep_hi);
+	TF_CKPT_PUT(tf_ckpt.seg_sweeps);	TF_CKPT_PUT(tf_ckpt.count);
+	TF_CKPT_PUT(tf_ckpt.nfac);
+	for(i = 0; i < tf_ckpt.nfac; i++) { TF_CKPT_PUT(tf_ckpt.fac_k[i]); }
+	nword = (tf_ckpt.tf_passes*tf_ckpt.nseg + 63)>>6;
+	for(i = 0; i < nword; i++) { TF_CKPT_PUT(tf_ckpt.done[i]); }
+	tf_ckpt.dirty = FALSE;	tf_ckpt.tlast = getRealTime();
+  #ifdef MULTITHREAD
+	pthread_mutex_unlock(&tf_ckpt_mutex);
+  #endif
+	itmp32 = tf_crc32(buf, n);	TF_CKPT_PUT(itmp32);
+
+	sprintf(tmpname,"%s.tmp",tf_ckpt.fname);
+	fp = mlucas_fopen(tmpname, "wb");
+	if(!fp) {
+		fprintf(stderr,"ERROR: unable to open factoring checkpoint %s for writing.\n",tmpname);
+		free((void *)buf);
+		return 1;
+	}
+	i = (fwrite(buf, 1, n, fp) != n) || fflush(fp) || fsync(fileno(fp));
+	fclose(fp); fp = 0x0;
+	free((void *)buf);
+	if(i || rename(tmpname, tf_ckpt.fname)) {
+		fprintf(stderr,"ERROR: unable to write factoring checkpoint %s.\n",tf_ckpt.fname);
+		return 1;
+	}
+	return 0;
+}
+
+#ifdef MULTITHREAD
+	// Background checkpoint writer: Wakes every 0.1 sec, writes the checkpoint if units were completed and it's been at
+	// least TF_CKPT_SECS since the last write, until told to stop by tf_ckpt_finish():
+	static void* tf_ckpt_writer(void*arg)
+	{
+		struct timespec ns_time = {0, 100000000};
+		int due;
+		while(!__atomic_load_n(&tf_ckpt_stop, __ATOMIC_ACQUIRE)) {
+			ASSERT(0 == mlucas_nanosleep(&ns_time), "nanosleep fail!");
+			pthread_mutex_lock(&tf_ckpt_mutex);
+			due = tf_ckpt.dirty && (getRealTime() - tf_ckpt.tlast >= TF_CKPT_SECS);
+			pthread_mutex_unlock(&tf_ckpt_mutex);
+			if(due && tf_ckpt_write())
+				fprintf(stderr,"WARN: Checkpoint write failed ... will retry.\n");
+		}
+		return 0x0;
+	}
+#endif
+
+// Starts the background checkpoint writer, if any:
+void tf_ckpt_start(void)
+{
+  #ifdef MULTITHREAD
+	if(tf_ckpt.nseg) {
+		tf_ckpt_stop = FALSE;
+		ASSERT(0 == pthread_create(&tf_ckpt_thread, NULL, tf_ckpt_writer, NULL), "Unable to create checkpoint-writer thread!");
+	}
+  #endif
+}
+
+// Stops the background checkpoint writer, if any, and writes the final checkpoint. Returns 0 on success:
+int tf_ckpt_finish(void)
+{
+	if(!tf_ckpt.nseg)
+		return 0;
+  #ifdef MULTITHREAD
+	__atomic_store_n(&tf_ckpt_stop, TRUE, __ATOMIC_RELEASE);
+	pthread_join(tf_ckpt_thread, NULL);
+  #endif
+	return tf_ckpt_write();
+}
+
+/*
+Batch-mode worklist handling. Assignments use the Prime95/Mlucas worktodo format Factor=[AID,]p,bmin,bmax, where bmin
+is the bit depth to which M(p) has already been trial-factored and bmax the one to factor to. Lines not starting with a
+letter (blank lines, comments) are ignored, other lines which are not Factor= assignments are skipped with a warning.
+*/
+// Parses the portion of a Factor= line following the '='. Returns 0 on success, nonzero if the line is malformed:
+static int parse_tf_assignment(const char*char_addr, char*pstring, double*bmin, double*bmax)
+{
+	uint32 i, ncomma = 0;
+	char *cptr;
+	for(i = 0; char_addr[i]; i++) { ncomma += (char_addr[i] == ','); }
+	if(ncomma == 3)	// Skip the assignment ID
+		char_addr = strchr(char_addr, ',') + 1;
+	else if(ncomma != 2)
+		return 1;
+	while(isspace(*char_addr)) { ++char_addr; }
+	for(i = 0; isdigit(char_addr[i]) && i < STR_MAX_LEN-1; i++) { pstring[i] = char_addr[i]; }
+	pstring[i] = '\0';
+	if(!i || char_addr[i] != ',')
+		return 1;
+	*bmin = strtod(char_addr+i+1, &cptr);
+	if(*cptr != ',')
+		return 1;
+	*bmax = strtod(cptr+1, &cptr);
+	while(isspace(*cptr)) { ++cptr; }
+	return (*cptr != '\0' || *bmin < 0 || *bmax <= *bmin);
+}
+
+// Reads the first Factor= line of worklist [fname]. Returns 1 if one was found, 0 if none (or no such file):
+int read_tf_assignment(const char*fname, char*pstring, double*bmin, double*bmax)
+{
+	uint32 i;
+	char *char_addr;
+	FILE *fp = mlucas_fopen(fname, "r");
+	if(!fp)
+		return 0;
+	while(fgets(in_line, STR_MAX_LEN, fp)) {
+		if((char_addr = strchr(in_line, '\n')) != 0x0)
+			*char_addr = '\0';
+		for(i = 0; isspace(in_line[i]); i++) {}
+		if(!isalpha(in_line[i]))
+			continue;
+		if(!STREQN_NOCASE(in_line+i, "Factor=", 7)) {
+			fprintf(stderr,"WARN: %s entry '%s' is not a Factor= assignment ... skipping.\n",fname,in_line+i);
+			continue;
+		}
+		fclose(fp); fp = 0x0;
+		if(parse_tf_assignment(in_line+i+7, pstring, bmin, bmax)) {
+			snprintf(cbuf,STR_MAX_LEN*2,"ERROR: %s entry %s is not of the form Factor=[AID,]p,bmin,bmax with bmin < bmax.\n",fname,in_line+i);
+			ASSERT(0,cbuf);
+		}
+		return 1;
+	}
+	fclose(fp); fp = 0x0;
+	return 0;
+}
+
+// Deletes the first Factor= line of worklist [fname], which must be for exponent [pstring], by copying the other lines
+// to a temp-file which then replaces the worklist. Returns 0 on success:
+int delete_tf_assignment(const char*fname, const char*pstring)
+{
+	uint32 i;
+	int found = FALSE;
+	double bmin, bmax;
+	char tmpname[STR_MAX_LEN+4], estr[STR_MAX_LEN];
+	FILE *fp = mlucas_fopen(fname, "r"), *fq;
+	if(!fp) {
+		fprintf(stderr,"ERROR: unable to open %s file for reading.\n",fname);
+		return 1;
+	}
+	sprintf(tmpname,"%s.tmp",fname);
+	fq = mlucas_fopen(tmpname, "w");
+	if(!fq) {
+		fprintf(stderr,"ERROR: unable to open %s file for writing.\n",tmpname);
+		fclose(fp); fp = 0x0;
+		return 1;
+	}
+	while(fgets(in_line, STR_MAX_LEN, fp)) {
+		if(!found) {
+			for(i = 0; isspace(in_line[i]); i++) {}
+			if(STREQN_NOCASE(in_line+i, "Factor=", 7)) {
+				found = TRUE;
+				// Make sure it's the assignment just done, e.g. that the user did not edit the file in the meantime:
+				if(parse_tf_assignment(in_line+i+7, estr, &bmin, &bmax) || STRNEQ(estr, pstring)) {
+					fprintf(stderr,"ERROR: Current exponent %s not found in first Factor= line of %s file.\n",pstring,fname);
+					fclose(fp); fp = 0x0;	fclose(fq); fq = 0x0;	remove(tmpname);
+					return 1;
+				}
+				continue;
+			}
+		}
+		fputs(in_line, fq);
+	}
+	fclose(fp); fp = 0x0;
+	fclose(fq); fq = 0x0;
+	remove(fname);
+	if(rename(tmpname, fname)) {
+		fprintf(stderr,"ERROR: unable to rename %s file ==> %s.\n",tmpname,fname);
+		return 1;
+	}
+	return 0;
+}
+
 /* This is actually an auxiliary source file, but give it a .h extension to allow wildcarded project builds of form 'gcc -c *.c' */
 #include "factor_test.h"
 
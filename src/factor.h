@@ -177,6 +177,27 @@ PLEASE REFER TO FACTOR.C FOR A DESCRIPTION OF THE APPLICABLE #DEFINES
 	#error	TRYQ = 2 and TRYQ > 8 only allowed if USE_FLOAT is defined
 #endif
 
+/* TF_DISPATCH: select the batched modpow kernel at runtime, per sieve sweep, based on the current q-size and a
+startup calibration of the kernels able to handle the q-range of the run (cf. tf_kernel_tab[] in factor.c).
+Default for integer-modmul builds with TRYQ = 4 or 8; build with -DTF_DISPATCH=0 to use the compile-time kernel choice: */
+#ifndef TF_DISPATCH
+	#if(TRYQ == 4 || TRYQ == 8) && !defined(USE_FMADD) && !defined(USE_GPU)
+		#define TF_DISPATCH	1
+	#else
+		#define TF_DISPATCH	0
+	#endif
+#endif
+
+/* TF_PIPELINE: multithreaded builds support a pipelined mode (-pipeline), in which rather than each thread both sieving its
+pass and testing the surviving k's, sieve threads queue the survivors, in chunks of TF_PIPE_CHUNK, in single-producer/
+single-consumer rings, and modpow threads test them in full TRYQ-sized batches. Needs the runtime modpow-kernel dispatch,
+since each chunk carries the kernel index of the sweep which produced it: */
+#if defined(MULTITHREAD) && TF_DISPATCH
+	#define TF_PIPELINE	1
+#else
+	#define TF_PIPELINE	0
+#endif
+
 /* Make sure the TRYQ = 4 fused macros are only used on the PPC32: */
 #ifdef MOD_INI_Q4
 	#ifndef CPU_SUBTYPE_PPC32
@@ -280,6 +301,7 @@ uint128	twopmodq128		(uint128 p, uint128 q);	// q, not k!
 uint64	twopmodq128x2	(uint64 *p, uint64 k);
 uint64	twopmodq128x2B	(uint64 *p, uint128 q);	// q, not k!
 uint64	twopmodq128_q4	(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3);
+uint64	twopmodq128_q4_qferm(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3);	// p = 2^n, n >= 63
 uint64	twopmodq128_q8	(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3, uint64 k4, uint64 k5, uint64 k6, uint64 k7);
 
 uint64	twopmodq160   (uint64 *p, uint64 k);
@@ -290,6 +312,7 @@ uint192 twopmmodq192	(uint192 p, uint192 q);
 uint192	twopmodq192		(uint192 p, uint192 q);	// q, not k!
 uint64	twopmodq192_q4	(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3);
 uint64	twopmodq192_q4_qmmp(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3);
+uint64	twopmodq192_q4_qferm(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3);	// p = 2^n, 95 <= n <= 190
 uint64	twopmodq192_q8	(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3, uint64 k4, uint64 k5, uint64 k6, uint64 k7);
 
 uint256	twopmodq200_8WORD_DOUBLE(uint64 *p, uint64 k);
@@ -300,8 +323,23 @@ uint256	twopmodq256		(uint256 p, uint256 q);	// q, not k!
 uint64	twopmodq256_q4	(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3);
 uint64	twopmodq256_q8	(uint64 *p, uint64 k0, uint64 k1, uint64 k2, uint64 k3, uint64 k4, uint64 k5, uint64 k6, uint64 k7);
 
+uint32	CHECK_PKMOD    (uint64 *p, uint32 lenP, uint64 k, uint32*incr, uint32 nclass);
 uint32	CHECK_PKMOD60  (uint64 *p, uint32 lenP, uint64 k, uint32*incr);
 uint32	CHECK_PKMOD4620(uint64 *p, uint32 lenP, uint64 k, uint32*incr);
+int		tf_set_classes   (uint32 nclass);
+uint32	tf_select_classes(uint32 nthreads, double kspan, uint32 sieve_len);
+#if TF_DISPATCH
+void	tf_kernel_calibrate(int modtype, uint64*p, uint32 lenP, double fbits_in_2p, uint64 kmin, uint64 kmax, uint64*q, uint32 lenQ, uint64*res);
+uint32	tf_kernel_select(double fbits_in_q);
+uint64	tf_kernel_modpow(uint32 kidx, uint64*p, uint32 lenP, uint64 k[], uint64*q, uint32 lenQ, uint64*res, int tid);
+  #ifdef FACTOR_STANDALONE
+// Mfactor -bench: default q-size range [2^TF_BENCH_BMIN, 2^(TF_BENCH_BMAX+1)) and output file:
+#define TF_BENCH_BMIN	48
+#define TF_BENCH_BMAX	255
+#define TF_BENCH_FILE	"mfactor_bench.csv"
+int		tf_kernel_bench(const char*version, double bmin, double bmax, const char*fname);
+  #endif
+#endif
 
 /******************************************/
 /*            GPU-TF stuff:               */
@@ -313,10 +351,20 @@ uint32	CHECK_PKMOD4620(uint64 *p, uint32 lenP, uint64 k, uint32*incr);
 #endif
 
 	// Top-level routines for CPU-parallel and GPU-side sieving and testing of resulting factor candidates:
+#ifndef USE_GPU
+int		tf_found_factor(uint64 k, const uint64*p, uint32 lenP, uint64*q, uint64*q2, uint64*u64_arr, uint32 lenQ,
+			uint64*factor_k, uint32*nfactor, uint32 findex, int MODULUS_TYPE, const char*OFILE);
+#endif
 #ifdef MULTITHREAD
 
 	void*				// Thread-arg pointer *must* be cast to void and specialized inside the function
 	PerPass_tfSieve(void*thread_arg);
+	void*
+	tf_class_worker(void*thread_arg);	// Pool-task wrapper which loops over PerPass_tfSieve calls, one per k-class
+  #if TF_PIPELINE
+	void*
+	tf_pipe_worker(void*thread_arg);	// Pool-task wrapper for pipelined mode, in which sieving and modpow run in separate threads
+  #endif
 
 #else
 
@@ -333,7 +381,7 @@ uint32	CHECK_PKMOD4620(uint64 *p, uint32 lenP, uint64 k, uint32*incr);
 								// This routine uses only a specific (len/60)-sized "sievelet" excerpt.
 								// sieve_len = 64*(product of first NCLEAR odd primes)
 		const uint32 p_last_small,	//largest odd prime appearing in the product; that is, the (nclear)th odd prime.
-		const uint32 nprime,		// #sieving primes (counting from 3)
+		const uint32 nprime_max,	// #sieving primes (counting from 3); the pass may use fewer, per the runtime-tuned sieve depth
 		const uint32 MAX_SIEVING_PRIME,
 		const uint8 *pdiff,
 		      uint32*startval,	// This gets updated within
@@ -504,6 +552,19 @@ uint64 kmin, uint64 know, uint64 kmax, uint32 passmin, uint32 passnow, uint32 pa
 
 int write_savefile(const char*fname, const char*pstring, uint32 passnow, uint64 know, uint64 count);
 
+void	tf_ckpt_init(const char*fname, const char*pstring, double bmin, double bmax, uint64 kmin, uint64 kmax,
+			uint32 passmin, uint32 passnow, uint32 passmax, uint64 sweep_lo, uint64 sweep_now, uint64 sweep_hi);
+uint64	tf_ckpt_resume(uint32 pass, uint64 sweep_lo);
+void	tf_ckpt_mark(uint32 pass, uint64 sweep, uint64 count);
+void	tf_ckpt_add_factor(uint64 k);
+uint32	tf_ckpt_factors(uint64*factor_k, uint32 nmax);
+int		tf_ckpt_write(void);
+void	tf_ckpt_start(void);
+int		tf_ckpt_finish(void);
+
+int read_tf_assignment  (const char*fname, char*pstring, double*bmin, double*bmax);
+int delete_tf_assignment(const char*fname, const char*pstring);
+
 #ifdef __cplusplus
 }
 #endif
@@ -167,13 +167,12 @@ int test_fac()
 		printf("NUM_SIEVING_PRIME = %u\n", i);
 	#endif
 
-	/* TF_CLASSES: */
-	#ifndef TF_CLASSES
-		/* This flag is required: */
-		ASSERT(0,"TF_CLASSES not defined!");
-	#else
-		i = TF_CLASSES;
+	/* TF_CLASSES: Compile-time default, if any - otherwise set at runtime */
+	#if TF_CLASSES_DEFAULT
+		i = TF_CLASSES_DEFAULT;
 		printf("TF_CLASSES = %u\n", i);
+	#else
+		printf("TF_CLASSES = [set at runtime]\n");
 	#endif
 
 	/* MUL_LOHI64_SUBROUTINE: */
@@ -218,6 +218,7 @@ int fermat_mod_square(double a[], int arr_scratch[], int n, int ilo, int ihi, ui
 	static int pow2_fft;
 	static uint32 findex = 0;
 	double fracmax,wt,wtinv;
+	uint64 perf_snap[PERF_NEVENT];
 	double max_fp = 0.0, frac_fp, atmp;
 	static int first_entry = TRUE;
 	// Function pointers for DIF|DIT pass1; get set in init-block based on value of radix0:
@@ -351,7 +352,10 @@ int fermat_mod_square(double a[], int arr_scratch[], int n, int ilo, int ihi, ui
 		for(i = 0; i < NRADICES; i++)
 		{
 			sprintf(char_addr,"%10d",RADIX_VEC[i]); char_addr += 10;
-		}; sprintf(char_addr,"\n");
+		};
+		if(FFT_CACHE_BLOCK)
+			char_addr += sprintf(char_addr,"  [cache-blocked: %u-double sub-blocks]",FFT_CACHE_BLOCK);
+		sprintf(char_addr,"\n");
 
 		if(INTERACT)
 			fprintf(stderr,"%s",cbuf);
@@ -1143,7 +1147,8 @@ int fermat_mod_square(double a[], int arr_scratch[], int n, int ilo, int ihi, ui
 		// Threadpool-based dispatch:
 		ASSERT(MAX_THREADS == get_num_cores(), "MAX_THREADS not set or incorrectly set!");
 
-		if(radix0 % NTHREADS != 0) fprintf(stderr,"%s: radix0 not exactly divisible by NTHREADS - This will hurt performance.\n",func);
+		// Work units are dequeued dynamically, so a non-dividing thread count costs only the partially-filled last round:
+		if(radix0 % NTHREADS != 0) fprintf(stderr,"%s: radix0 = %d not exactly divisible by NTHREADS - expect ~%4.1f%% thread utilization in FFT passes.\n",func,radix0,100.0*radix0/(NTHREADS*((radix0 + NTHREADS-1)/NTHREADS)));
 
 		main_work_units = 0;
 		pool_work_units = radix0;
@@ -1396,6 +1401,8 @@ for(iter=ilo+1; iter <= ihi && MLUCAS_KEEP_RUNNING; iter++)
 
 	fracmax = 0.0;
 //printf("Exit(0) from %s\n",func); exit(0);
+	// Threadpool tasks run during the carry step also get credited to that phase:
+	if(PERF_COUNTERS) { PERF_TASK_PHASE = PERF_PHASE_CARRY; perf_read(perf_snap); }
 	switch(radix0)
 	{
 		case  5:
@@ -1475,6 +1482,7 @@ for(iter=ilo+1; iter <= ihi && MLUCAS_KEEP_RUNNING; iter++)
 		default:
 			sprintf(cbuf,"ERROR: radix %d not available for ditN_cy_dif1. Halting...\n",radix0); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf);
 	}
+	if(PERF_COUNTERS) { perf_end(PERF_PHASE_CARRY, perf_snap); PERF_TASK_PHASE = PERF_PHASE_NONE; }
 
 	// v19: Nonzero exit carries used to be fatal, added retry-from-last-savefile handling for these
 	if(ierr)
@@ -1544,6 +1552,9 @@ for(iter=ilo+1; iter <= ihi && MLUCAS_KEEP_RUNNING; iter++)
 	*tdiff += (double)(clock2 - clock1);
 	clock1 = clock2;
 #endif
+	// Publish progress to the live status page - only for the main-residue iterations, which are the ones with a scratch array:
+	if(arr_scratch)
+		mstatus_update(iter, MME);
 #ifndef NO_USE_SIGNALS
 	// Listen for interrupts:
 	if (signal(SIGINT, sig_handler) == SIG_ERR)
@@ -1765,8 +1776,10 @@ void fermat_process_chunk(
 #endif	// #ifdef MULTITHREAD
 
 	const char func[] = "fermat_process_chunk";
+	uint64 perf_snap[PERF_NEVENT];
 	int radix0 = RADIX_VEC[0];
 	int i,incr,istart,jstart,k,koffset,l,mm;
+	int ib,incrb = 0,joff,kb = 0,mmb = 1,s, incrf,kf,mmf;	// Cache-blocked-pass-ordering params, see mers_process_chunk for notes
 	int init_sse2 = FALSE;	// Init-calls to various radix-pass routines presumed done prior to entry into this routine
 	uint64 bptr = 0x0;	// Pointer to B-array, if one is supplied in guise of the uint64 fwd_fft arg
 	double*cptr = 0x0;
@@ -1792,8 +1805,14 @@ void fermat_process_chunk(
 	ASSERT(((fwd_fft & 0xF) == 0xC) && ((fwd_fft>>4) != 0x0), "Bits 2:3 of fwd_fft == 3: Expect Bits 0:1 == 0 and nonzero b[] = hi60! *");
 	incr = RADIX_VEC[NRADICES-1]<<1;
   }	else {
+	if(PERF_COUNTERS) perf_read(perf_snap);
+	// Cache-blocked pass ordering - breadth-first until sub-blocks fit in FFT_CACHE_BLOCK doubles, then depth-first:
+	ib = NRADICES-1;
 	for(i=1; i <= NRADICES-2; i++)
 	{
+		if(FFT_CACHE_BLOCK && incr <= FFT_CACHE_BLOCK) {
+			ib = i;	break;
+		}
 		/* Offset from base address of index array = L*NLOOPS = L*MM: */
 		koffset = l*mm;
 		switch(RADIX_VEC[i])
@@ -1811,6 +1830,35 @@ void fermat_process_chunk(
 		mm   *= RADIX_VEC[i];
 		incr /= RADIX_VEC[i];
 	}	/* end i-loop. */
+
+	if(ib <= NRADICES-2) {
+		ASSERT(DAT_BITS == 31 || !(incr & ((1 << DAT_BITS)-1)), "Cache-block sub-block length must be a multiple of 2^DAT_BITS!");
+		kb = k;	mmb = mm;	incrb = incr;
+		for(s = 0; s < mmb; s++)
+		{
+			joff = s*incrb;	joff += ((joff >> DAT_BITS) << PAD_BITS);
+			k = kb;	mm = mmb;	incr = incrb;
+			for(i = ib; i <= NRADICES-2; i++)
+			{
+				koffset = l*mm + s*(mm/mmb);
+				switch(RADIX_VEC[i])
+				{
+				case  8:
+					 radix8_dif_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+				case 16:
+					radix16_dif_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+				case 32:
+					radix32_dif_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+				default:
+					sprintf(cbuf,"ERROR: radix %d not available for dif_pass. Halting...\n",RADIX_VEC[i]); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf);
+				}
+				k    += mm*radix0;
+				mm   *= RADIX_VEC[i];
+				incr /= RADIX_VEC[i];
+			}
+		}	/* end s-loop */
+	}
+	if(PERF_COUNTERS) perf_end(PERF_PHASE_FWD, perf_snap);
   }	// v20: endif((fwd_fft & 0xC) != 0)
 
 #ifdef DBG_TIME
@@ -1818,6 +1866,7 @@ void fermat_process_chunk(
 	*dt_fwd += (double)(clock1 - clock0);
 #endif
 	/*...Final DIF pass, dyadic squaring and initial DIT pass are all done via a fused 1-pass procedure: */
+	if(PERF_COUNTERS) perf_read(perf_snap);
 	koffset = l*mm;
 	/* The roots-block-re-use param mm not needed for innermost pass, since there each set of inputs gets its own set of roots: */
 	switch(RADIX_VEC[NRADICES-1])
@@ -1833,6 +1882,7 @@ void fermat_process_chunk(
 	clock2 = clock();
 	*dt_sqr += (double)(clock2 - clock1);
 #endif
+	if(PERF_COUNTERS) perf_end(PERF_PHASE_SQR, perf_snap);
 
 	if(fwd_fft == 1) {
 	#ifdef MULTITHREAD
@@ -1854,16 +1904,49 @@ void fermat_process_chunk(
 	mm   = 1;
 	incr = n/radix0;
 
+	ib = NRADICES-1;
 	for(i=1; i <= NRADICES-2; i++)
 	{
+		if(FFT_CACHE_BLOCK && incr <= FFT_CACHE_BLOCK && ib > NRADICES-2) {
+			ib = i;	kb = k;	mmb = mm;	incrb = incr;
+		}
 		k    += mm*radix0;
 		mm   *= RADIX_VEC[i];
 		incr /= RADIX_VEC[i];
 	}
 
 	/* Now do the DIT loop, running the radices (and hence the values of k, mm and incr) in reverse: */
+	if(PERF_COUNTERS) perf_read(perf_snap);
+
+	// Cache-blocked mode mirrors the DIF ordering: depth-first passes on each sub-block, then the breadth-first ones:
+	if(ib <= NRADICES-2) {
+		kf = k;	mmf = mm;	incrf = incr;
+		for(s = 0; s < mmb; s++)
+		{
+			joff = s*incrb;	joff += ((joff >> DAT_BITS) << PAD_BITS);
+			k = kf;	mm = mmf;	incr = incrf;
+			for(i=NRADICES-2; i >= ib; i--)
+			{
+				incr *= RADIX_VEC[i];
+				mm   /= RADIX_VEC[i];
+				k    -= mm*radix0;
+				koffset = l*mm + s*(mm/mmb);
+				switch(RADIX_VEC[i])
+				{
+				case  8:
+					 radix8_dit_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+				case 16:
+					radix16_dit_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+				case 32:
+					radix32_dit_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+				default:
+					sprintf(cbuf,"ERROR: radix %d not available for dit_pass. Halting...\n",RADIX_VEC[i]); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf);
+				}
+			}
+		}	/* end s-loop */
+	}
 
-	for(i=NRADICES-2; i >= 1; i--)
+	for(i=ib-1; i >= 1; i--)
 	{
 		incr *= RADIX_VEC[i];
 		mm   /= RADIX_VEC[i];
@@ -1887,6 +1970,7 @@ void fermat_process_chunk(
 	*dt_inv += (double)(clock3 - clock2);
 	*dt_tot += (double)(clock3 - clock0);
 #endif
+	if(PERF_COUNTERS) perf_end(PERF_PHASE_INV, perf_snap);
 
 #ifdef MULTITHREAD
 	*(thread_arg->retval) = 0;	// 0 indicates successful return of current thread
@@ -61,9 +61,47 @@
 
 	Especially for large lengths we can gain a small amount of speed by restricting
 	ourselves to radices >= 8 in the power-of-2 part.
+
+	Cache-blocked radix sets: For FFT lengths >= FFT_CACHE_BLOCK_MIN_KBLOCKS (32M), each radix set in the table
+	below gets a twin: if the table has [nset] entries for the length in question, radix-set index [nset + j]
+	maps to the same radices as index j, but with the intermediate FFT passes done in cache-blocked order (see
+	the FFT_CACHE_BLOCK notes in mers_process_chunk). The number of available radix sets returned via *nradices
+	on ERR_RADIXSET_UNAVAILABLE is then 2*nset, so the self-test loop over radix-set indices times the blocked
+	variants against the breadth-first ones. Use fft_radix_set_is_blocked() to query whether a given index
+	maps to a cache-blocked variant.
 */
+static int	get_fft_radices_table(uint32 kblocks, int radix_set, uint32 *nradices, uint32 radix_vec[], int radix_vec_dim);
 
 int	get_fft_radices(uint32 kblocks, int radix_set, uint32 *nradices, uint32 radix_vec[], int radix_vec_dim)
+{
+	uint32 nset = 0;
+	int retval;
+	if(kblocks < FFT_CACHE_BLOCK_MIN_KBLOCKS)
+		return get_fft_radices_table(kblocks, radix_set, nradices, radix_vec, radix_vec_dim);
+	retval = get_fft_radices_table(kblocks, radix_set, &nset, radix_vec, radix_vec_dim);
+	if(retval != ERR_RADIXSET_UNAVAILABLE) {
+		if(nradices && !retval) *nradices = nset;
+		return retval;
+	}
+	// Cache-blocked twin of radix set (radix_set - nset):
+	if(radix_set < 2*(int)nset)
+		return get_fft_radices_table(kblocks, radix_set - nset, nradices, radix_vec, radix_vec_dim);
+	if(nradices) *nradices = 2*nset;
+	return ERR_RADIXSET_UNAVAILABLE;
+}
+
+/* Returns 1 if the radix-set index maps to a cache-blocked twin of one of the table entries, 0 otherwise: */
+int	fft_radix_set_is_blocked(uint32 kblocks, int radix_set)
+{
+	uint32 nset;
+	if(kblocks < FFT_CACHE_BLOCK_MIN_KBLOCKS || radix_set < 0)
+		return 0;
+	if(get_fft_radices_table(kblocks, 0x7fffffff, &nset, 0x0, 0) != ERR_RADIXSET_UNAVAILABLE)
+		return 0;
+	return (radix_set >= (int)nset && radix_set < 2*(int)nset);
+}
+
+static int	get_fft_radices_table(uint32 kblocks, int radix_set, uint32 *nradices, uint32 radix_vec[], int radix_vec_dim)
 {
 	uint32 rvec[10] = {0,0,0,0,0,0,0,0,0,0};	// Temporary storage for FFT radices
 	uint32 i, n, numrad, rad_prod;
@@ -2703,6 +2741,38 @@ uint32 get_nextlarger_fft_length(uint32 n)
 		return fftLen;
 }
 
+/*
+!...Given a legal FFT length, return the next-smaller supported length, or 0 if there is none.
+Returns: raw FFT length in units of doubles, as for get_nextlarger_fft_length():
+*/
+uint32 get_nextsmaller_fft_length(uint32 n)
+{
+	uint32 fftLen, lead4, rem2;
+
+	if(get_fft_radices((n >> 10), 0, 0x0, 0x0, 0) != 0)
+	{
+		sprintf(cbuf, "get_nextsmaller_fft_length: Illegal or Unsupported input FFT length %u\n", n);
+		ASSERT(0, cbuf);
+	}
+	/* Same n = lead4*2^rem2 decomposition as in get_nextlarger_fft_length, but now decrement the leading portion,
+	wrapping 8*2^rem2 to 15*2^(rem2-1):
+	*/
+	rem2 = 32 - leadz32(n) - 4;
+	lead4 = n >> rem2;
+	ASSERT(lead4 > 7 && lead4 < 16,"get_nextsmaller_fft_length: leading 4 bits of input FFT length out of range!");
+	if(lead4 == 8) {
+		if(!rem2) return 0;
+		lead4 = 15;	--rem2;
+	} else
+		--lead4;
+	fftLen = lead4 << rem2;
+	/* Make sure next-smaller FFT length is a multiple of 1K and supported: */
+	if((fftLen & 1023) || get_fft_radices((fftLen >> 10), 0, 0x0, 0x0, 0) != 0)
+		return 0;
+	else
+		return fftLen;
+}
+
 /*
 For a given FFT length, estimate maximum exponent that can be tested.
 
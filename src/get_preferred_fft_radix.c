@@ -69,13 +69,16 @@
 		  our smallest permitted intermediate FFT radix is 8 and these must be powers of 2, this
 		  again permits radices up to 64 to be stored using just 2 bits. Radix-8 of course maps to 0
 		  under this scheme, but we know when to stop because bits <10:13> tell us the number of radices,
-		  which can be as large as 10 under this scheme.
+		  which can be as large as 9 under this scheme (the radix tables currently use at most 6);
+		- Bit 31 stores the optional cache-blocked-pass-ordering flag, i.e. the 'blocked = 1' cfg-file
+		  entry for FFT lengths >= FFT_CACHE_BLOCK_MIN_KBLOCKS. Bit 30 is unused.
 
 	In order to make it easy for the user to extract these bitwise FFT-radix data from the function
 	return value, we define 2 handy utility functions in util.c:
 
 		uint32	extractFFTlengthFrom32Bit (uint32 n) - returns the (real-vector) FFT length encoded by n according to the above scheme
-		void	extractFFTradicesFrom32Bit(uint32 n) - extracts the FFT-radix data encoded by n and stores in the NRADICES and RADIX_VEC[] globals
+		void	extractFFTradicesFrom32Bit(uint32 n) - extracts the FFT-radix data encoded by n and stores in the NRADICES, RADIX_VEC[]
+												  and FFT_CACHE_BLOCK globals
 
 	If the return FFT-length value differs from the input [kblocks] (which implies that a better timing
 	datum was found for at least one larger FFT length in the .cfg file), caller must decide whether
@@ -196,7 +199,14 @@ uint32	get_preferred_fft_radix(uint32 kblocks)
 									ASSERT(0, cbuf);
 								}
 								retval = i;			/* Preferred FFT length */
+								// Optional cache-blocked-pass-ordering flag, only written for lengths >= FFT_CACHE_BLOCK_MIN_KBLOCKS:
+								FFT_CACHE_BLOCK = 0;
+								if((char_addr = strstr(in_line, "blocked =")) != 0x0 && sscanf(char_addr + 9, "%u", &k) == 1 && k)
+									FFT_CACHE_BLOCK = FFT_CACHE_BLOCK_DEF;
 							} else {
+								ASSERT(((retval >> 10) & 0xf) <= 9, "get_preferred_fft_radix: Compact encoding holds at most 9 radices!");
+								if((char_addr = strstr(in_line, "blocked =")) != 0x0 && sscanf(char_addr + 9, "%u", &k) == 1 && k)
+									retval |= 0x80000000;
 								ASSERT(i == extractFFTlengthFrom32Bit(retval), "get_preferred_fft_radix: i != extractFFTlengthFrom32Bit(retval)!");
 							}
 						}
@@ -216,7 +226,7 @@ uint32	get_preferred_fft_radix(uint32 kblocks)
 	if(!found) {
 		retval = 0;
 		for(j=0; j<10; j++) { RADIX_VEC[j] = 0; }
-		NRADICES = 0;
+		NRADICES = 0;	FFT_CACHE_BLOCK = 0;
 	}
 	return retval;
 }
@@ -242,10 +252,12 @@ uint32	extractFFTlengthFrom32Bit (uint32 n)
 	return (retval >> 9);
 }
 
-/* extracts the FFT-radix data encoded by n and stores in the NRADICES and RADIX_VEC[] globals */
+/* extracts the FFT-radix data encoded by n and stores in the NRADICES, RADIX_VEC[] and FFT_CACHE_BLOCK globals */
 void	extractFFTradicesFrom32Bit(uint32 n)
 {
 	uint32 i, nrad, retval;
+	/* Bit 31 stores the cache-blocked-pass-ordering flag: */
+	FFT_CACHE_BLOCK = (n >> 31) ? FFT_CACHE_BLOCK_DEF : 0;
 	/* Bits <0:9> store (leading radix-1): We subtract the 1 so radices up to 1024 can be stored: */
 	retval = (n & 0x3ff) + 1;	n >>= 10;
 	ASSERT(retval > 4, "extractFFTradicesFrom32Bit: Leading radix must be 5 or larger!");
@@ -253,7 +265,7 @@ void	extractFFTradicesFrom32Bit(uint32 n)
 	/* Bits <10:13> store (number of FFT radices): */
 	nrad   = (n & 0xf)    ;	n >>= 4;
 	ASSERT(nrad >=  3, "extractFFTradicesFrom32Bit: Number of radices must be 3 or larger!");
-	ASSERT(nrad <= 10, "extractFFTradicesFrom32Bit: Number of radices must be 10 or smaller!");
+	ASSERT(nrad <=  9, "extractFFTradicesFrom32Bit: Number of radices must be 9 or smaller!");
 	NRADICES = nrad;
 	/* Each successive pair of higher-order bits stores log2[(intermediate FFT radix)/8]: */
 	for(i = 1; i < 10; i++)	/* Already done leading radix, so start at 1, not 0 */
@@ -4356,10 +4356,12 @@ On Alpha, this needs a total of 7 MUL instructions and 12 ALU ops.
 	MUL_LOHI64(__x.d0,__y.d1,&__a ,&__b );\
 	MUL_LOHI64(__y.d0,__x.d1,&__c ,&__d );\
 	MUL_LOHI64(__x.d1,__y.d1,&__w2,&__w3);\
-	/* First add [a,b] + [c,d] : since b and d <= 2^64 - 2, can add carryout of a+c sans ripple-carry check: */\
+	/* First add [a,b] + [c,d] : since b and d <= 2^64 - 2, can add carryout of a+c sans ripple-carry check, but\
+	the sum may itself carry out, e.g. for x,y near 2^128, so add that into w3: */\
 	__a  += __c;\
-	__b  += __d + (__a < __c);\
-	DBG_ASSERT((__b >= __d),"MULH128: unexpected carryout of __b");\
+	__d  += (__a < __c);\
+	__b  += __d;\
+	__w3 += (__b < __d);\
 	/* Now add [w1,w2,w3] + [a,b,0]: */\
 	__w1 += __a;\
 	__cy  = (__w1 < __a);\
@@ -4766,12 +4768,16 @@ On Alpha, this needs a total of 7 MUL instructions and 12 ALU ops.
 		MUL_LOHI64(__x.d0,__y.d1, __a , __b );\
 		MUL_LOHI64(__y.d0,__x.d1, __c , __d );\
 		MUL_LOHI64(__x.d1,__y.d1, __w2, __w3);\
+		/* High halves of 64x64-bit products are <= 2^64 - 2, so can fold the carryin into __b|__d sans overflow,\
+		but must then compare against the sum: checking (__w2 < __b) misses the carry for __w2 = 2^64-1, carryin = 1: */\
 		__w1 += __a;\
-		__w2 += __b + (__w1 < __a); /* Overflow into word2 is checked here. */\
-		__w3 +=       (__w2 < __b); /* Overflow into word3 is checked here. */\
+		__b  += (__w1 < __a);\
+		__w2 += __b; /* Overflow into word2 is checked here. */\
+		__w3 += (__w2 < __b); /* Overflow into word3 is checked here. */\
 		__w1 += __c;\
-		__w2 += __d + (__w1 < __c); /* Overflow into word2 is checked here. */\
-		__w3 +=       (__w2 < __d); /* Overflow into word3 is checked here. */\
+		__d  += (__w1 < __c);\
+		__w2 += __d; /* Overflow into word2 is checked here. */\
+		__w3 += (__w2 < __d); /* Overflow into word3 is checked here. */\
 		__hi.d0 =  __w2;	__hi.d1 = __w3;\
     }
 
@@ -4813,10 +4819,15 @@ On Alpha, this needs a total of 7 MUL instructions and 12 ALU ops.
 		__t2 += __a2;\
 		__t3 += __a3;\
 		\
-		__hi0.d0 += __b0 + (__t0 < __a0);\
-		__hi1.d0 += __b1 + (__t1 < __a1);\
-		__hi2.d0 += __b2 + (__t2 < __a2);\
-		__hi3.d0 += __b3 + (__t3 < __a3);\
+		__b0 += (__t0 < __a0);\
+		__b1 += (__t1 < __a1);\
+		__b2 += (__t2 < __a2);\
+		__b3 += (__t3 < __a3);\
+		\
+		__hi0.d0 += __b0;\
+		__hi1.d0 += __b1;\
+		__hi2.d0 += __b2;\
+		__hi3.d0 += __b3;\
 		\
 		__hi0.d1 +=        (__hi0.d0 < __b0);\
 		__hi1.d1 +=        (__hi1.d0 < __b1);\
@@ -4828,10 +4839,15 @@ On Alpha, this needs a total of 7 MUL instructions and 12 ALU ops.
 		__t2 += __c2;\
 		__t3 += __c3;\
 		\
-		__hi0.d0 += __d0 + (__t0 < __c0);\
-		__hi1.d0 += __d1 + (__t1 < __c1);\
-		__hi2.d0 += __d2 + (__t2 < __c2);\
-		__hi3.d0 += __d3 + (__t3 < __c3);\
+		__d0 += (__t0 < __c0);\
+		__d1 += (__t1 < __c1);\
+		__d2 += (__t2 < __c2);\
+		__d3 += (__t3 < __c3);\
+		\
+		__hi0.d0 += __d0;\
+		__hi1.d0 += __d1;\
+		__hi2.d0 += __d2;\
+		__hi3.d0 += __d3;\
 		\
 		__hi0.d1 +=        (__hi0.d0 < __d0);\
 		__hi1.d1 +=        (__hi1.d0 < __d1);\
@@ -4902,14 +4918,23 @@ On Alpha, this needs a total of 7 MUL instructions and 12 ALU ops.
 		__t6 += __a6;\
 		__t7 += __a7;\
 		\
-		__hi0.d0 += __b0 + (__t0 < __a0);\
-		__hi1.d0 += __b1 + (__t1 < __a1);\
-		__hi2.d0 += __b2 + (__t2 < __a2);\
-		__hi3.d0 += __b3 + (__t3 < __a3);\
-		__hi4.d0 += __b4 + (__t4 < __a4);\
-		__hi5.d0 += __b5 + (__t5 < __a5);\
-		__hi6.d0 += __b6 + (__t6 < __a6);\
-		__hi7.d0 += __b7 + (__t7 < __a7);\
+		__b0 += (__t0 < __a0);\
+		__b1 += (__t1 < __a1);\
+		__b2 += (__t2 < __a2);\
+		__b3 += (__t3 < __a3);\
+		__b4 += (__t4 < __a4);\
+		__b5 += (__t5 < __a5);\
+		__b6 += (__t6 < __a6);\
+		__b7 += (__t7 < __a7);\
+		\
+		__hi0.d0 += __b0;\
+		__hi1.d0 += __b1;\
+		__hi2.d0 += __b2;\
+		__hi3.d0 += __b3;\
+		__hi4.d0 += __b4;\
+		__hi5.d0 += __b5;\
+		__hi6.d0 += __b6;\
+		__hi7.d0 += __b7;\
 		\
 		__hi0.d1 +=        (__hi0.d0 < __b0);\
 		__hi1.d1 +=        (__hi1.d0 < __b1);\
@@ -4929,14 +4954,23 @@ On Alpha, this needs a total of 7 MUL instructions and 12 ALU ops.
 		__t6 += __c6;\
 		__t7 += __c7;\
 		\
-		__hi0.d0 += __d0 + (__t0 < __c0);\
-		__hi1.d0 += __d1 + (__t1 < __c1);\
-		__hi2.d0 += __d2 + (__t2 < __c2);\
-		__hi3.d0 += __d3 + (__t3 < __c3);\
-		__hi4.d0 += __d4 + (__t4 < __c4);\
-		__hi5.d0 += __d5 + (__t5 < __c5);\
-		__hi6.d0 += __d6 + (__t6 < __c6);\
-		__hi7.d0 += __d7 + (__t7 < __c7);\
+		__d0 += (__t0 < __c0);\
+		__d1 += (__t1 < __c1);\
+		__d2 += (__t2 < __c2);\
+		__d3 += (__t3 < __c3);\
+		__d4 += (__t4 < __c4);\
+		__d5 += (__t5 < __c5);\
+		__d6 += (__t6 < __c6);\
+		__d7 += (__t7 < __c7);\
+		\
+		__hi0.d0 += __d0;\
+		__hi1.d0 += __d1;\
+		__hi2.d0 += __d2;\
+		__hi3.d0 += __d3;\
+		__hi4.d0 += __d4;\
+		__hi5.d0 += __d5;\
+		__hi6.d0 += __d6;\
+		__hi7.d0 += __d7;\
 		\
 		__hi0.d1 +=        (__hi0.d0 < __d0);\
 		__hi1.d1 +=        (__hi1.d0 < __d1);\
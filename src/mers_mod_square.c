@@ -198,6 +198,7 @@ The scratch array (2nd input argument) is only needed for data table initializat
 	static struct complex *rt0 = 0x0, *rt1 = 0x0, *rt0_ptmp = 0x0, *rt1_ptmp = 0x0;		/* reduced-size roots of unity arrays	*/
 	static double *wt0 = 0x0, *wt1 = 0x0, *tmp = 0x0, *wt0_ptmp = 0x0, *wt1_ptmp = 0x0, *tmp_ptmp = 0x0;		/* reduced-size DWT weights arrays	*/
 	double fracmax,wt,wtinv;
+	uint64 perf_snap[PERF_NEVENT];
 	double max_fp = 0.0, frac_fp, atmp;
 	static int first_entry = TRUE;
 	// Function pointers for DIF|DIT pass1; get set in init-block based on value of radix0:
@@ -336,7 +337,10 @@ The scratch array (2nd input argument) is only needed for data table initializat
 		for(i = 0; i < NRADICES; i++)
 		{
 			sprintf(char_addr,"%10d",RADIX_VEC[i]); char_addr += 10;
-		}; sprintf(char_addr,"\n");
+		};
+		if(FFT_CACHE_BLOCK)
+			char_addr += sprintf(char_addr,"  [cache-blocked: %u-double sub-blocks]",FFT_CACHE_BLOCK);
+		sprintf(char_addr,"\n");
 
 		if(INTERACT)
 			fprintf(stderr,"%s",cbuf);
@@ -1348,7 +1352,8 @@ for(i=0; i < NRT; i++) {
 		// MAX_THREADS is the max. no. of threads we expect to be able to make use of, at 1 thread per core.
 		ASSERT(MAX_THREADS == get_num_cores(), "MAX_THREADS not set or incorrectly set!");
 
-		if(nchunks % NTHREADS != 0) fprintf(stderr,"%s: radix0/2 not exactly divisible by NTHREADS - This will hurt performance.\n",func);
+		// Work units are dequeued dynamically, so a non-dividing thread count costs only the partially-filled last round:
+		if(nchunks % NTHREADS != 0) fprintf(stderr,"%s: radix0/2 = %d not exactly divisible by NTHREADS - expect ~%4.1f%% thread utilization in FFT passes.\n",func,nchunks,100.0*nchunks/(NTHREADS*((nchunks + NTHREADS-1)/NTHREADS)));
 
 		main_work_units = 0;
 		pool_work_units = nchunks;
@@ -1826,6 +1831,8 @@ for(iter=ilo+1; iter <= ihi && MLUCAS_KEEP_RUNNING; iter++)
 
 	fracmax = 0.0;
 
+	// Threadpool tasks run during the carry step also get credited to that phase:
+	if(PERF_COUNTERS) { PERF_TASK_PHASE = PERF_PHASE_CARRY; perf_read(perf_snap); }
 	switch(radix0)
 	{
 		case  5 :
@@ -1933,6 +1940,7 @@ for(iter=ilo+1; iter <= ihi && MLUCAS_KEEP_RUNNING; iter++)
 		default :
 			sprintf(cbuf,"ERROR: radix %d not available for ditN_cy_dif1. Halting...\n",radix0); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf);
 	}
+	if(PERF_COUNTERS) { perf_end(PERF_PHASE_CARRY, perf_snap); PERF_TASK_PHASE = PERF_PHASE_NONE; }
 
 	// v19: Nonzero exit carries used to be fatal, added retry-from-last-savefile handling for these
 	if(ierr)
@@ -2003,6 +2011,9 @@ for(iter=ilo+1; iter <= ihi && MLUCAS_KEEP_RUNNING; iter++)
 	*tdiff += (double)(clock2 - clock1);
 	clock1 = clock2;
 #endif
+	// Publish progress to the live status page - only for the main-residue iterations, which are the ones with a scratch array:
+	if(arr_scratch)
+		mstatus_update(iter, MME);
 #ifndef NO_USE_SIGNALS
 	// Listen for interrupts:
 	if (signal(SIGINT, sig_handler) == SIG_ERR)
@@ -2179,8 +2190,10 @@ void mers_process_chunk(
 #endif	// #ifdef MULTITHREAD
 
 	const char func[] = "mers_process_chunk";
+	uint64 perf_snap[PERF_NEVENT];
 	int radix0 = RADIX_VEC[0];
 	int i,incr,istart,j,jhi,jstart,k,koffset,l,mm;
+	int ib,incrb = 0,joff,kb = 0,mmb = 1,s, incrf,kf,mmf;	// Cache-blocked-pass-ordering params, see FFT_CACHE_BLOCK notes below
 	int init_sse2 = FALSE;	// Init-calls to various radix-pass routines presumed done prior to entry into this routine
 	/*** Unlike fermat_mod_square, no need for separate cptr = c + [offset] here, since c-array offsets computed inside radix*_wrapper_square routines ***/
 
@@ -2211,9 +2224,21 @@ void mers_process_chunk(
 #ifdef CTIME
 	clock_supp = clock();
 #endif
-
+		if(PERF_COUNTERS) perf_read(perf_snap);
+
+		/* Cache-blocked pass ordering: If FFT_CACHE_BLOCK != 0, the intermediate passes are done breadth-first over the
+		full n/radix0-sized data block only until the per-pass sub-block length incr fits in FFT_CACHE_BLOCK doubles.
+		The remaining passes are then done depth-first, i.e. each such sub-block is run through all of them before moving
+		on to the next, so only the first of those passes needs to stream the data from main memory. Sub-block s of
+		length incrb = incr starts at offset s*incrb and needs (mm/mmb) of the index[] entries for each ensuing pass,
+		starting at offset s*(mm/mmb). Sub-block offsets must be multiples of 2^DAT_BITS, else padding breaks:
+		*/
+		ib = NRADICES-1;	// Index of first depth-first pass; NRADICES-1 means "none"
 		for(i=1; i <= NRADICES-2; i++)
 		{
+			if(FFT_CACHE_BLOCK && incr <= FFT_CACHE_BLOCK) {
+				ib = i;	break;
+			}
 			/* Offset from base address of index array = L*NLOOPS = L*MM : */
 			koffset = l*mm;
 
@@ -2233,9 +2258,40 @@ void mers_process_chunk(
 			mm   *= RADIX_VEC[i];
 			incr /= RADIX_VEC[i];
 		}	/* end i-loop. */
+
+		if(ib <= NRADICES-2) {
+			ASSERT(DAT_BITS == 31 || !(incr & ((1 << DAT_BITS)-1)), "Cache-block sub-block length must be a multiple of 2^DAT_BITS!");
+			kb = k;	mmb = mm;	incrb = incr;
+			for(s = 0; s < mmb; s++)
+			{
+				joff = s*incrb;	joff += ((joff >> DAT_BITS) << PAD_BITS);
+				k = kb;	mm = mmb;	incr = incrb;
+				for(i = ib; i <= NRADICES-2; i++)
+				{
+					koffset = l*mm + s*(mm/mmb);
+
+					switch(RADIX_VEC[i])
+					{
+					case  8 :
+						 radix8_dif_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+					case 16 :
+						radix16_dif_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+					case 32 :
+						radix32_dif_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+					default :
+						sprintf(cbuf,"ERROR: radix %d not available for dif_pass. Halting...\n",RADIX_VEC[i]); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf);
+					}
+
+					k    += mm*radix0;
+					mm   *= RADIX_VEC[i];
+					incr /= RADIX_VEC[i];
+				}
+			}	/* end s-loop */
+		}
 #ifdef CTIME
 	dt_fwd += (double)(clock() - clock_supp);
 #endif
+		if(PERF_COUNTERS) perf_end(PERF_PHASE_FWD, perf_snap);
 	}	/* end j-loop */
   }	// v20: endif((fwd_fft & 0xC) != 0)
 
@@ -2247,6 +2303,7 @@ void mers_process_chunk(
 #ifdef CTIME
 	clock_supp = clock();
 #endif
+	if(PERF_COUNTERS) perf_read(perf_snap);
 
 	for(j = 0; j < jhi; j++)
 	{
@@ -2269,6 +2326,7 @@ void mers_process_chunk(
 #ifdef CTIME
 	dt_sqr += (double)(clock() - clock_supp);
 #endif
+	if(PERF_COUNTERS) perf_end(PERF_PHASE_SQR, perf_snap);
 
 	if(fwd_fft == 1) {
 	#ifdef MULTITHREAD
@@ -2300,8 +2358,12 @@ void mers_process_chunk(
 		istart = l*incr;
 		jstart = istart + ((istart >> DAT_BITS) << PAD_BITS );
 
+		ib = NRADICES-1;
 		for(i=1; i <= NRADICES-2; i++)
 		{
+			if(FFT_CACHE_BLOCK && incr <= FFT_CACHE_BLOCK && ib > NRADICES-2) {
+				ib = i;	kb = k;	mmb = mm;	incrb = incr;
+			}
 			k    += mm*radix0;
 			mm   *= RADIX_VEC[i];
 			incr /= RADIX_VEC[i];
@@ -2312,8 +2374,40 @@ void mers_process_chunk(
 #ifdef CTIME
 	clock_supp = clock();
 #endif
+		if(PERF_COUNTERS) perf_read(perf_snap);
+
+		/* In cache-blocked mode, mirror the DIF ordering: first do the depth-first passes on each sub-block,
+		which leaves (k,mm,incr) = (kb,mmb,incrb), then the remaining breadth-first ones: */
+		if(ib <= NRADICES-2) {
+			kf = k;	mmf = mm;	incrf = incr;
+			for(s = 0; s < mmb; s++)
+			{
+				joff = s*incrb;	joff += ((joff >> DAT_BITS) << PAD_BITS);
+				k = kf;	mm = mmf;	incr = incrf;
+				for(i=NRADICES-2; i >= ib; i--)
+				{
+					incr *= RADIX_VEC[i];
+					mm   /= RADIX_VEC[i];
+					k    -= mm*radix0;
+
+					koffset = l*mm + s*(mm/mmb);
+
+					switch(RADIX_VEC[i])
+					{
+					case  8 :
+						 radix8_dit_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+					case 16 :
+						radix16_dit_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+					case 32 :
+						radix32_dit_pass(&a[jstart+joff],n,rt0,rt1,&index[k+koffset],mm/mmb,incr,init_sse2,thr_id); break;
+					default :
+						sprintf(cbuf,"ERROR: radix %d not available for dit_pass. Halting...\n",RADIX_VEC[i]); fprintf(stderr,"%s", cbuf);	ASSERT(0,cbuf);
+					}
+				}
+			}	/* end s-loop */
+		}
 
-		for(i=NRADICES-2; i >= 1; i--)
+		for(i=ib-1; i >= 1; i--)
 		{
 			incr *= RADIX_VEC[i];
 			mm   /= RADIX_VEC[i];
@@ -2337,6 +2431,7 @@ void mers_process_chunk(
 #ifdef CTIME
 	dt_inv += (double)(clock() - clock_supp);
 #endif
+		if(PERF_COUNTERS) perf_end(PERF_PHASE_INV, perf_snap);
 
 	}	/* end j-loop */
 
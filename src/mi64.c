@@ -424,8 +424,8 @@ void	mi64_shlc(const uint64 x[], uint64 y[], uint32 nbits, uint32 nshift, uint32
 //	printf("mi64_shlc: %u bits, %u limbs, mask64 = %#" PRIX64 ", high limb = %#" PRIX64 "\n",nbits,len,mask64,x[len-1]);
   #ifndef __CUDA_ARCH__
 	/* Scratch array for storing off-shifted intermediate (need this to support in-place functionality): */
-	static uint64 *u = 0x0;
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0;
+	static MI64_TLS uint32 dimU = 0;
 	// Does scratch array need allocating or reallocating? (Use realloc for both cases).
 	// Use #words in modulus (as opposed to #words-in-shift) for needs-realloc check here:
 	if(dimU < 2*(nwmod+1)) {                // GG: fixed bug in comparison
@@ -2864,6 +2864,271 @@ uint64	mi64_mul_scalar_add_vec2(const uint64 x[], uint64 a, const uint64 y[], ui
 
 /*******************/
 
+/*
+	Subquadratic multiword multiply: for operands of at least MI64_KARA_THRESH words, mi64_mul_vector, mi64_sqr_vector
+	and mi64_mul_vector_hi_half use a recursive balanced multiply, mi64_mul_kara, which does Karatsuba steps down to
+	MI64_KARA_THRESH words and Toom-3 steps for operands of at least MI64_TOOM3_THRESH words; mi64_mul_vector_lo_half
+	does the analogous split of the low-half product above MI64_KARA_LO_THRESH words. None of these keep any state
+	between calls: all recursion levels work in a caller-supplied scratch array of [mi64_mul_scratch_len(len)] words,
+	which the above routines carve from their (in multithreaded builds, thread-local) scratch statics. Where x == y,
+	i.e. for squaring, the subproducts are squares as well, and the below-crossover products use the schoolbook
+	squaring code of mi64_sqr_vector.
+	The crossovers are from x86_64 timings of pure-C builds: Karatsuba wins from ~32 words for both mul and squaring,
+	and the split low-half product is ~2x faster than schoolbook at 256 words; our Toom-3 is only on par with Karatsuba up to ~1000 words, hence
+	the high crossover for that.
+*/
+#ifndef __CUDA_ARCH__
+
+// Crossovers (in words) - can override at compile time via -D[name]=[value]:
+#ifndef MI64_KARA_THRESH
+	#define MI64_KARA_THRESH	32
+#endif
+#ifndef MI64_TOOM3_THRESH
+	#define MI64_TOOM3_THRESH	256
+#endif
+#ifndef MI64_KARA_LO_THRESH
+	#define MI64_KARA_LO_THRESH	64
+#endif
+
+// Two's-complement negation of a length-len vector, in place:
+static void mi64_neg2c(uint64 x[], uint32 len)
+{
+	mi64_negl(x,x,len);	mi64_add_scalar(x,1ull,x,len);
+}
+
+// Arithmetic right-shift of a length-len two's-complement vector by one place, in place:
+static void mi64_sar1(uint64 x[], uint32 len)
+{
+	uint64 sgn = x[len-1] & 0x8000000000000000ull;
+	mi64_shrl(x,x,1,len,len);	x[len-1] |= sgn;
+}
+
+// Exact division of a length-len vector by 3, in place, via multiply by the mod-2^64 inverse of 3 word by word:
+static void mi64_divexact3(uint64 x[], uint32 len)
+{
+	const uint64 inv3 = 0xAAAAAAAAAAAAAAABull;
+	uint32 i;
+	uint64 t, q, bw = 0ull;
+	for(i = 0; i < len; i++) {
+		t = x[i] - bw;	bw = (x[i] < bw);
+		q = t*inv3;		x[i] = q;
+		// Borrow into the next word is the high word of 3*q, which is 0, 1 or 2:
+		bw += (q > 0x5555555555555555ull) + (q > 0xAAAAAAAAAAAAAAAAull);
+	}
+	ASSERT(bw == 0ull, "mi64_divexact3: input not divisible by 3!");
+}
+
+// x += y, where y has lenY <= lenX words; returns carry out of x[lenX-1]:
+static uint64 mi64_add_ext(uint64 x[], uint32 lenX, const uint64 y[], uint32 lenY)
+{
+	uint64 cy = mi64_add(x,y,x,lenY);
+	if(cy && lenX > lenY)
+		cy = mi64_add_scalar(x+lenY,cy,x+lenY,lenX-lenY);
+	return cy;
+}
+
+// x -= y, where y has lenY <= lenX words; returns borrow out of x[lenX-1]:
+static uint64 mi64_sub_ext(uint64 x[], uint32 lenX, const uint64 y[], uint32 lenY)
+{
+	uint64 bw = mi64_sub(x,y,x,lenY);
+	if(bw && lenX > lenY)
+		bw = mi64_sub_scalar(x+lenY,bw,x+lenY,lenX-lenY);
+	return bw;
+}
+
+// Adds the length-lenC coefficient c[] into the length-lenZ product z[] at word offset off, ignoring leading
+// zero words of c[] beyond the end of z[]:
+static void mi64_add_coeff(uint64 z[], uint32 lenZ, uint32 off, const uint64 c[], uint32 lenC)
+{
+	uint32 n = MIN(lenC, lenZ-off);
+	ASSERT(n == lenC || mi64_iszero(c+n,lenC-n), "mi64_add_coeff: coefficient overflows product!");
+	ASSERT(0 == mi64_add_ext(z+off,lenZ-off,c,n), "mi64_add_coeff: carry out of product!");
+}
+
+// d = |a - b| for a of lenA words and b of lenB = lenA or lenA-1 words; returns 1 if a < b, else 0:
+static uint32 mi64_absdiff(const uint64 a[], uint32 lenA, const uint64 b[], uint32 lenB, uint64 d[])
+{
+	uint32 neg = (lenA == lenB || a[lenB] == 0ull) && mi64_cmpult(a,b,lenB);
+	if(neg) {
+		mi64_sub(b,a,d,lenB);
+		if(lenA > lenB) d[lenB] = 0ull;
+	} else {
+		uint64 bw = mi64_sub(a,b,d,lenB);
+		if(lenA > lenB) d[lenB] = a[lenB] - bw;
+	}
+	return neg;
+}
+
+// Schoolbook z = x*y for length-len x,y; z must not overlap either input:
+static void mi64_mul_school(const uint64 x[], const uint64 y[], uint64 z[], uint32 len)
+{
+	uint32 j;
+	memset(z, 0ull, (len<<3));	// Upper half gets set by the row carries
+	for(j = 0; j < len; j++) {
+		z[len+j] = mi64_mul_scalar_add_vec2(x, y[j], z+j, z+j, len);
+	}
+}
+
+uint32	mi64_mul_scratch_len(uint32 len)
+{
+	uint32 m;
+	if(len < MI64_KARA_THRESH)
+		return 0;
+	if(len < MI64_TOOM3_THRESH) {
+		m = len - (len>>1);
+		return 6*m + 1 + mi64_mul_scratch_len(m);
+	}
+	m = (len+2)/3 + 1;
+	return 12*m + mi64_mul_scratch_len(m);
+}
+
+/* Toom-3 step of mi64_mul_kara, for len >= 3: Split x = x0 + x1.B + x2.B^2 with B = 2^(64*k), k = ceil(len/3),
+likewise y, and multiply the evaluations of the resulting quadratics at 0, 1, -1, -2 and infinity. The signed
+evaluations and products are kept in two's-complement form of w = k+1 and 2*w words, respectively, which gives room
+for the < 7*B and < 49*B^2 magnitudes arising; the pointwise products are done on magnitudes, by recursion.
+Interpolation follows Bodrato's sequence, with just one exact division by 3 and two by 2:
+*/
+static void mi64_mul_toom3(const uint64 x[], const uint64 y[], uint64 z[], uint32 len, uint64 scr[])
+{
+	uint32 k = (len+2)/3, k2 = len - 2*k, w = k+1, lenP = 2*w, lenZ = 2*len, sq = (x == y), i, sgn;
+	uint64 *px[3], *py[3], *r1, *rm1, *rm2, *r;
+	const uint64 *a;
+	ASSERT(len >= 5, "mi64_mul_toom3: len too small for a nonempty top part!");
+	// px[0,1,2] = x(1), x(-1), x(-2); likewise py:
+	px[0] = scr;	px[1] = px[0] + w;	px[2] = px[1] + w;
+	py[0] = px[2] + w;	py[1] = py[0] + w;	py[2] = py[1] + w;
+	r1 = py[2] + w;	rm1 = r1 + lenP;	rm2 = rm1 + lenP;	scr = rm2 + lenP;
+	for(i = 0; i < 2 - sq; i++) {
+		uint64 **p = (i ? py : px);
+		a = (i ? y : x);
+		// p(-1) = x0 + x2 - x1, p(1) = x0 + x2 + x1, p(-2) = 2*(p(-1) + x2) - x0:
+		mi64_set_eq(p[1], a, k);	p[1][k] = 0ull;
+		mi64_add_ext(p[1], w, a+2*k, k2);
+		mi64_set_eq(p[0], p[1], w);
+		mi64_add_ext(p[0], w, a+k, k);
+		mi64_sub_ext(p[1], w, a+k, k);
+		mi64_set_eq(p[2], p[1], w);	mi64_add_ext(p[2], w, a+2*k, k2);
+		mi64_shl(p[2], p[2], 1, w);
+		mi64_sub_ext(p[2], w, a, k);
+	}
+	if(sq) { py[0] = px[0];	py[1] = px[1];	py[2] = px[2]; }
+	// Pointwise products at 1, -1, -2 - the latter two via sign-magnitude:
+	mi64_mul_kara(px[0], py[0], r1, w, scr);
+	for(i = 1; i < 3; i++) {
+		r = (i == 1 ? rm1 : rm2);
+		sgn = px[i][w-1] >> 63;	if(sgn) mi64_neg2c(px[i], w);
+		if(!sq) { sgn ^= py[i][w-1] >> 63;	if(py[i][w-1] >> 63) mi64_neg2c(py[i], w); }
+		else sgn = 0;
+		mi64_mul_kara(px[i], py[i], r, w, scr);
+		if(sgn) mi64_neg2c(r, lenP);
+	}
+	// r0 = x0*y0 and rinf = x2*y2 go straight into their slots of z, with zeros between:
+	mi64_mul_kara(x, y, z, k, scr);
+	memset(z+2*k, 0ull, (k<<4));
+	mi64_mul_kara(x+2*k, y+2*k, z+4*k, k2, scr);
+	// Interpolate: r3 = (rm2 - r1)/3:
+	mi64_sub(rm2, r1, rm2, lenP);
+	sgn = rm2[lenP-1] >> 63;	if(sgn) mi64_neg2c(rm2, lenP);
+	mi64_divexact3(rm2, lenP);
+	if(sgn) mi64_neg2c(rm2, lenP);
+	// r1 = (r1 - rm1)/2:
+	mi64_sub(r1, rm1, r1, lenP);	mi64_sar1(r1, lenP);
+	// r2 = rm1 - r0:
+	mi64_sub_ext(rm1, lenP, z, 2*k);
+	// r3 = (r2 - r3)/2 + 2*rinf:
+	mi64_sub(rm1, rm2, rm2, lenP);	mi64_sar1(rm2, lenP);
+	mi64_add_ext(rm2, lenP, z+4*k, 2*k2);	mi64_add_ext(rm2, lenP, z+4*k, 2*k2);
+	// r2 = r2 + r1 - rinf:
+	mi64_add(rm1, r1, rm1, lenP);	mi64_sub_ext(rm1, lenP, z+4*k, 2*k2);
+	// r1 = r1 - r3:
+	mi64_sub(r1, rm2, r1, lenP);
+	// Now have the nonnegative coefficients r1,r2,r3 of B,B^2,B^3 in r1,rm1,rm2:
+	mi64_add_coeff(z, lenZ,   k, r1 , lenP);
+	mi64_add_coeff(z, lenZ, 2*k, rm1, lenP);
+	mi64_add_coeff(z, lenZ, 3*k, rm2, lenP);
+}
+
+/* Balanced multiply z = x*y of length-len x,y, with z of 2*len words not overlapping either input; x == y is
+allowed and gives a square. scr[] must have mi64_mul_scratch_len(len) words. Karatsuba step: with x = x0 + x1.B,
+B = 2^(64*m), m = ceil(len/2), and likewise y, x*y = x0.y0 + (x0.y0 + x1.y1 - (x0-x1).(y0-y1)).B + x1.y1.B^2,
+where we do the middle product as |x0-x1|*|y0-y1| to avoid carry-words in the recursion:
+*/
+void	mi64_mul_kara(const uint64 x[], const uint64 y[], uint64 z[], uint32 len, uint64 scr[])
+{
+	uint32 h, m, sgn;
+	uint64 *dx, *dy, *d, *t, cy;
+	if(len < MI64_KARA_THRESH) {
+		if(x == y)
+			mi64_sqr_vector(x, z, len);
+		else
+			mi64_mul_school(x, y, z, len);
+		return;
+	}
+	if(len >= MI64_TOOM3_THRESH) {
+		mi64_mul_toom3(x, y, z, len, scr);
+		return;
+	}
+	h = len>>1;	m = len - h;
+	dx = scr;	dy = dx + m;	d = dy + m;	t = d + 2*m;	scr = t + 2*m+1;
+	mi64_mul_kara(x  , y  , z    , m, scr);	// z0 = x0*y0
+	mi64_mul_kara(x+m, y+m, z+2*m, h, scr);	// z2 = x1*y1
+	sgn = mi64_absdiff(x, m, x+m, h, dx);
+	if(x == y) {
+		dy = dx;	sgn = 0;
+	} else {
+		sgn ^= mi64_absdiff(y, m, y+m, h, dy);
+	}
+	mi64_mul_kara(dx, dy, d, m, scr);
+	// t = z0 + z2 -+ d:
+	cy = mi64_add(z, z+2*m, t, 2*h);
+	if(m > h)
+		cy = mi64_add_scalar(z+2*h, cy, t+2*h, 2);
+	t[2*m] = cy;
+	if(sgn)
+		t[2*m] += mi64_add(t, d, t, 2*m);
+	else
+		t[2*m] -= mi64_sub(t, d, t, 2*m);
+	mi64_add_coeff(z, 2*len, m, t, 2*m+1);
+}
+
+static uint32 mi64_mul_lo_scratch_len(uint32 len)
+{
+	uint32 h = len>>1, m = len - h, n1, n2;
+	if(len < MI64_KARA_LO_THRESH)
+		return 0;
+	n1 = mi64_mul_scratch_len(m);	n2 = mi64_mul_lo_scratch_len(h);
+	return 2*m + MAX(n1,n2);
+}
+
+/* Low half z = x*y (mod 2^(64*len)), z not overlapping either input, scr[] of mi64_mul_lo_scratch_len(len) words.
+With x = x0 + x1.B, B = 2^(64*m), m = ceil(len/2), and likewise y, only need the full x0*y0 and the low halves of
+the two cross-products x0*y1 and x1*y0, which we do by recursion:
+*/
+static void mi64_mul_lo_kara(const uint64 x[], const uint64 y[], uint64 z[], uint32 len, uint64 scr[])
+{
+	uint32 h, m, j;
+	uint64 *t;
+	if(len < MI64_KARA_LO_THRESH) {
+		memset(z, 0ull, (len<<3));
+		for(j = 0; j < len; j++) {
+			if(y[j] == 0)
+				continue;
+			mi64_mul_scalar_add_vec2(x, y[j], z+j, z+j, len-j);
+		}
+		return;
+	}
+	h = len>>1;	m = len - h;
+	t = scr;	scr += 2*m;
+	mi64_mul_kara(x, y, t, m, scr);
+	mi64_set_eq(z, t, len);
+	mi64_mul_lo_kara(x, y+m, t, h, scr);	mi64_add(z+m, t, z+m, h);
+	mi64_mul_lo_kara(x+m, y, t, h, scr);	mi64_add(z+m, t, z+m, h);
+}
+
+#endif	// #ifndef __CUDA_ARCH__
+
+/*******************/
+
 /*
 	Unsigned multiply of base-2^64 vector ints X * Y, having respective lengths lenX, lenY.
 	Result is returned in vector int Z. For simplicity, NEITHER X NOR Y MAY OVERLAP Z,
@@ -2895,8 +3160,11 @@ void	mi64_mul_vector(const uint64 x[], uint32 lenX, const uint64 y[], uint32 len
 	const uint64 *A, *B;
   #ifndef __CUDA_ARCH__
 	/* Scratch array for storing intermediate scalar*vector products: */
-	static uint64 *u = 0x0;
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0;
+	static MI64_TLS uint32 dimU = 0;
+	/* Scratch for the Karatsuba/Toom-3 path: */
+	static MI64_TLS uint64 *w = 0x0;
+	static MI64_TLS uint32 dimW = 0;
   #endif
 	ASSERT(x && y && z, "Null array x/y/z!");
 	ASSERT(lenX != 0, "zero-length X-array!");
@@ -2926,6 +3194,28 @@ void	mi64_mul_vector(const uint64 x[], uint32 lenX, const uint64 y[], uint32 len
 	} else
 		*lenZ = lenA;
 
+  #ifndef __CUDA_ARCH__
+	/* Above the crossover, do lenB-word chunks of A via balanced subquadratic muls; any leftover
+	(lenA % lenB) words of A get done schoolbook-style, a row per word, with B as the long operand:
+	*/
+	if(lenB >= MI64_KARA_THRESH) {
+		j = 2*lenB + mi64_mul_scratch_len(lenB);
+		if(dimW < j) {
+			dimW = j;
+			w = (uint64 *)realloc(w, dimW*sizeof(uint64));	ASSERT(w != 0x0, "alloc failed!");
+		}
+		for(i = 0; i + lenB <= lenA; i += lenB) {
+			mi64_mul_kara(A+i, B, w, lenB, w+2*lenB);
+			ASSERT(0 == mi64_add_ext(z+i, lenA+lenB-i, w, 2*lenB), "Unexpected carryout!");
+		}
+		// z[i+lenB+j] is still 0 on entry to row j, so can simply assign the row carry to it:
+		for(j = 0; i + j < lenA; j++) {
+			z[i+lenB+j] = mi64_mul_scalar_add_vec2(B, A[i+j], z+i+j, z+i+j, lenB);
+		}
+		*lenZ = mi64_getlen(z, lenA+lenB);
+		return;
+	}
+  #endif
 	// Specialized MUL macros for equal-small-length inputs:
 	if(lenA == lenB && lenA == 4) {
 		*lenZ = lenA + lenB;
@@ -3046,8 +3336,21 @@ void	mi64_sqr_vector(const uint64 x[], uint64 z[], uint32 len)
 	uint64 sgn, cy;
   #ifndef __CUDA_ARCH__
 	/* Scratch array for storing intermediate scalar*vector products: */
-	static uint64 *u = 0x0;
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0;
+	static MI64_TLS uint32 dimU = 0;
+	/* Scratch for the Karatsuba/Toom-3 path: */
+	static MI64_TLS uint64 *w = 0x0;
+	static MI64_TLS uint32 dimW = 0;
+	if(len >= MI64_KARA_THRESH) {
+		ASSERT(z != x, "Input and output arrays must be distinct!");
+		i = mi64_mul_scratch_len(len);
+		if(dimW < i) {
+			dimW = i;
+			w = (uint64 *)realloc(w, dimW*sizeof(uint64));	ASSERT(w != 0x0, "alloc failed!");
+		}
+		mi64_mul_kara(x, x, z, len, w);
+		return;
+	}
 	// Does scratch array need allocating or reallocating? (Use realloc for both cases):
 	if(dimU < 2*(len+1)) {          // GG: fixed bug in comparison
 		dimU = 2*(len+1);
@@ -3150,10 +3453,23 @@ void	mi64_mul_vector_lo_half	(const uint64 x[], const uint64 y[], uint64 z[], ui
 	uint32 j;
   #ifndef __CUDA_ARCH__
 	/* Scratch array for storing intermediate scalar*vector products: */
-	static uint64 *u = 0x0;
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0;
+	static MI64_TLS uint32 dimU = 0;
+	/* Scratch for the Karatsuba path, whose output goes into its low len words: */
+	static MI64_TLS uint64 *w = 0x0;
+	static MI64_TLS uint32 dimW = 0;
 	ASSERT(x && y && z, "Null array pointer!");
 	ASSERT(len != 0, "zero-length X-array!");
+	if(len >= MI64_KARA_LO_THRESH) {
+		j = len + mi64_mul_lo_scratch_len(len);
+		if(dimW < j) {
+			dimW = j;
+			w = (uint64 *)realloc(w, dimW*sizeof(uint64));	ASSERT(w != 0x0, "alloc failed!");
+		}
+		mi64_mul_lo_kara(x, y, w, len, w+len);
+		memcpy(z,w,(len<<3));
+		return;
+	}
 	// Does scratch array need allocating or reallocating? (Use realloc for both cases):
 	if(dimU < 2*(len+1)) {          // GG: fixed bug in comparison
 		dimU = 2*(len+1);
@@ -3198,8 +3514,21 @@ void	mi64_mul_vector_hi_half	(const uint64 x[], const uint64 y[], uint64 z[], ui
 	uint32 j;
 	/* Scratch array for storing intermediate scalar*vector products: */
   #ifndef __CUDA_ARCH__
-	static uint64 *u = 0x0, *v = 0x0;
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0, *v = 0x0;
+	static MI64_TLS uint32 dimU = 0;
+	/* Scratch for the Karatsuba/Toom-3 path, which computes the full product: */
+	static MI64_TLS uint64 *w = 0x0;
+	static MI64_TLS uint32 dimW = 0;
+	if(len >= MI64_KARA_THRESH) {
+		j = 2*len + mi64_mul_scratch_len(len);
+		if(dimW < j) {
+			dimW = j;
+			w = (uint64 *)realloc(w, dimW*sizeof(uint64));	ASSERT(w != 0x0, "alloc failed!");
+		}
+		mi64_mul_kara(x, y, w, len, w+2*len);
+		memcpy(z,w+len,(len<<3));
+		return;
+	}
 	// Does scratch array need allocating or reallocating? (Use realloc for both cases):
 	if(dimU < 2*(len+1)) {          // GG: fixed bug in comparison
 	#if MI64_MULHI_DBG
@@ -3349,8 +3678,8 @@ void	mi64_mul_vector_hi_trunc(const uint64 x[], const uint64 y[], uint64 z[], ui
 {
 	int i0,idx,i,j, lm1 = len-1;	// j must be signed for purposes of loop control
 	uint64 tprod[2], cy;
-	static uint64 *u = 0x0, *v = 0x0;	// Scratch arrays for storing intermediate scalar*vector products
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0, *v = 0x0;	// Scratch arrays for storing intermediate scalar*vector products
+	static MI64_TLS uint32 dimU = 0;
 	ASSERT(len != 0, "zero-length X-array!");
 	// Does scratch array need allocating or reallocating? (Use realloc for both cases):
 	if(dimU < 2*(len+1)) {          // GG: fixed bug in comparison
@@ -3447,8 +3776,8 @@ void	mi64_mul_vector_hi_qmmp(const uint64 y[], const uint64 p, const uint64 k, u
 	uint64 k2 = k+k, bw;
   #ifndef __CUDA_ARCH__
 	/* Scratch array for storing intermediate scalar*vector products: */
-	static uint64 *u = 0x0, *v = 0x0;
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0, *v = 0x0;
+	static MI64_TLS uint32 dimU = 0;
 	/* Does scratch array need allocating or reallocating? */
 	if(dimU < (len+2)) {
 		// U needs same dim as v (i.e. (len*2) instead of (len+2)) to ensure mi64_shl can never grab an uninited high word
@@ -3474,7 +3803,9 @@ void	mi64_mul_vector_hi_qmmp(const uint64 y[], const uint64 p, const uint64 k, u
 	u[len] = mi64_mul_scalar(y,k2,u,len);	// u[] stores Z = 2.k.Y
 	mi64_shl(u,v,p,len2);			// v[] stores (Z << p), store result in V
 	u[len] -= mi64_sub(u,y,u,len);	// (2k-1).Y = Z-Y, store result in U
-	bw = mi64_sub(v,u,v,len+1);
+	// (2k-1).Y can exceed the low len+1 words of (Z << p), so the borrow must propagate through all len2 words -
+	// u[] is zero-padded above u[len] for that:
+	bw = mi64_sub(v,u,v,len2);
 	ASSERT(!bw, "Unexpected borrow!");
 
 	/* Right-shift by B bits to get UMULH(q,Y) = ((Z << p) - (2k-1).Y) >> B: */
@@ -3649,8 +3980,8 @@ void	mi64_mul_vector_hi_qferm(const uint64 y[], const uint64 p, const uint64 k,
 	uint64 cy;
   #ifndef __CUDA_ARCH__
 	/* Scratch array for storing intermediate scalar*vector products: */
-	static uint64 *u = 0x0;
-	static uint32 dimU = 0;
+	static MI64_TLS uint64 *u = 0x0;
+	static MI64_TLS uint32 dimU = 0;
 	/* Does scratch array need allocating or reallocating? */
 	if(dimU < (len+2)) {
 		// U needs dim (len*2) instead of (len+2)) to ensure mi64_shl can never grab an uninited high word:
@@ -5009,8 +5340,11 @@ int mi64_div(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY, uint6
 		itmp64 = mi64_div_by_scalar64_u4((uint64*)x, y[0], xlen, q);	// Use 4-folded divrem for speed
 		if(r != 0x0) r[0] = itmp64;
 		retval = (itmp64 == 0ull);
+	// Oct 2026: All multiword divisors go to the reciprocal-based mi64_div_barrett. mi64_div_mont, though faster for
+	// 4-word divisors thanks to the 4-word-specialized MUL macros used for such, gives wrong results for most even
+	// divisors and for some odd ones as small as 2 words, so is no longer used here:
 	} else {
-		retval = mi64_div_mont(x, y, xlen, ylen, q, r);
+		retval = mi64_div_barrett(x, y, xlen, ylen, q, r);
 	}
 	// v20: Ugh - v19 was only clearing high words of remainder array if rem-in-place (x == r), even commenting
 	// to that effect; moreover the (x == r) mi64_clear was clearing (lenX-ylen) high words, not (lenY-ylen)! WTF?
@@ -5632,10 +5966,11 @@ int mi64_div_binary(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY
 	ylen = mi64_getlen(y, lenY);
 	ASSERT(ylen != 0, "divide by 0!");
 
-	// Allocate the needed auxiliary storage - the 2 yloc = ... / mi64_set_eq calls below copy (lenX + lenY) limbs into scratch, so alloc at least that much:
-	if(lens < (lenX + lenY)) {
+	// Allocate the needed auxiliary storage - the 2 yloc = ... / mi64_set_eq calls below copy lenX limbs each into scratch
+	// (y-copy gets 0-padded to lenX limbs), so alloc at least that much. Oct 2026: was (lenX + lenY), which overran for lenY < lenX-16:
+	if(lens < (lenX + MAX(lenX,lenY))) {
 		// lens = MAX(1024,lenX + lenY);	// Alloc yloc same as x to allow for left-justification of y-copy
-		lens = lenX + lenY + 16;        // GG: bug fix: Always add some extra buffer length. 16 is arbitrary and conservative.
+		lens = lenX + MAX(lenX,lenY) + 16;        // GG: bug fix: Always add some extra buffer length. 16 is arbitrary and conservative.
 		/*** May 2022: In preparing for the cofactor-is-prime-power GCD on F25/[known factors], build on Linux
 		with GCC 9.2.1, hit SIGABRT 		here with 'realloc(): invalid next size'. Step-thru debug showed
 		the #limbs-allocated counter lens increasing from 0 to 4 to 9, next jump from 9 to 1048574 triggered
@@ -5676,7 +6011,7 @@ int mi64_div_binary(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY
 	lz_y = mi64_leadz(yloc, max_len);
 	nshift = lz_y - lz_x;
 	ASSERT(nshift >= 0, "nshift < 0");
-	i = (nshift+63)>>6;
+	i = (nshift+64)>>6;	// Quotient has up to nshift+1 bits; Oct 2026: was (nshift+63)>>6, which dropped the top bit for nshift = 0 (mod 64)
 	if(q) {
 		mi64_clear(q, i);	*lenQ = i;
 	}
@@ -5724,6 +6059,860 @@ int mi64_div_binary(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY
 }
 #endif	// __CUDA_ARCH__ ?
 
+/*
+Reciprocal of a normalized multiword divisor: Given y[] of len words with the high bit of y[len-1] set, returns
+v = floor(B^(2*len)/y) in the len+1 words of v[], where B = 2^64. (v has its top word = 1, except for the
+y = B^len/2 case, where it = 2.)
+We start with the exact reciprocal of the leading MI64_RECIP_BASE words of y via binary-div and then do Newton
+iterations v' = v + v.(B^(2m) - Y.v)/B^(2m) on the leading m words Y of y, for a sequence of precisions m which
+roughly doubles from one step to the next. The reciprocal at each step is brought to the exact floor(B^(2m)/Y)
+via a few +-1 correction steps, whose number stays small since each new m is at most 2k-1 for the preceding
+precision k. Cost is a small multiple of that of a len-word multiply.
+*/
+#ifndef __CUDA_ARCH__
+
+#ifndef MI64_RECIP_BASE
+	#define MI64_RECIP_BASE	4
+#endif
+
+void mi64_recip(const uint64 y[], uint32 len, uint64 v[])
+{
+	static MI64_TLS uint64 *scratch = 0x0;
+	static MI64_TLS uint32 lens = 0;
+	const uint32 ncmax = 16;
+	uint32 prec[32], np = 0, i, k, m, le, lz, nc, sgn;
+	uint64 *e, *t;
+	const uint64 *Y;
+	ASSERT(len != 0 && (y[len-1] >> 63), "mi64_recip: divisor must be normalized!");
+	if(lens < 6*len+8) {
+		lens = 6*len+8;
+		scratch = (uint64 *)realloc(scratch, lens*sizeof(uint64));	ASSERT(scratch != 0x0, "alloc fail!");
+	}
+	e = scratch;	t = e + 2*len+2;	// e needs 2*len+2 words, t needs 4*len+4 (the quotient from mi64_div_binary)
+	// Precisions m, in reverse order of use:
+	for(m = len; m > MI64_RECIP_BASE; m = (m+2)>>1) {
+		prec[np++] = m;
+	}
+	// Base case: v = floor(B^(2m)/Y) via binary-div:
+	Y = y + len - m;
+	mi64_clear(e, 2*m);	e[2*m] = 1ull;
+	mi64_div_binary(e, Y, 2*m+1, m, t, &i, 0x0);
+	ASSERT(i <= m+1, "mi64_recip: base-case quotient too large!");
+	mi64_clear(v, m+1);	mi64_set_eq(v, t, i);
+	for(k = m; np > 0; k = m) {
+		m = prec[--np];	Y = y + len - m;
+		// Scale the precision-k reciprocal up to m words:
+		for(i = k+1; i-- > 0; ) { v[i+m-k] = v[i]; }
+		mi64_clear(v, m-k);
+		// e = B^(2m) - Y.v, in (2m+2)-word two's-complement form:
+		mi64_mul_vector(Y, m, v, m+1, t, &lz);	t[2*m+1] = 0ull;
+		mi64_clear(e, 2*m+2);	e[2*m] = 1ull;
+		mi64_sub(e, t, e, 2*m+2);
+		sgn = e[2*m+1] >> 63;
+		if(sgn) { mi64_negl(e, e, 2*m+2);	mi64_add_scalar(e, 1ull, e, 2*m+2); }
+		// Newton correction v.|e|/B^(2m):
+		le = mi64_getlen(e, 2*m+2);
+		if(le) {
+			mi64_mul_vector(v, m+1, e, le, t, &lz);
+			if(m+1+le > 2*m) {
+				ASSERT(le <= 2*m, "mi64_recip: Newton error term too large!");
+				if(sgn)
+					mi64_sub_ext(v, m+1, t+2*m, le+1-m);
+				else
+					mi64_add_ext(v, m+1, t+2*m, le+1-m);
+			}
+		}
+		// Exact correction: want 0 <= B^(2m) - Y.v < Y:
+		mi64_mul_vector(Y, m, v, m+1, t, &lz);	t[2*m+1] = 0ull;
+		mi64_clear(e, 2*m+2);	e[2*m] = 1ull;
+		mi64_sub(e, t, e, 2*m+2);
+		for(nc = 0; (e[2*m+1] >> 63) && nc < ncmax; nc++) {
+			mi64_sub_scalar(v, 1ull, v, m+1);
+			if(mi64_add(e, Y, e, m))
+				mi64_add_scalar(e+m, 1ull, e+m, m+2);
+		}
+		for( ; !(e[2*m+1] >> 63) && (mi64_getlen(e+m, m+2) || !mi64_cmpult(e, Y, m)) && nc < ncmax; nc++) {
+			mi64_add_scalar(v, 1ull, v, m+1);
+			if(mi64_sub(e, Y, e, m))
+				mi64_sub_scalar(e+m, 1ull, e+m, m+2);
+		}
+		ASSERT(nc < ncmax, "mi64_recip: Unexpectedly large number of corrections needed!");
+	}
+}
+
+/* Reciprocal-based div-with-remainder: x/y, (optional) quotient q, remainder r, same calling conventions as mi64_div,
+which calls this for all multiword divisors. With y normalized to n words
+with high bit set and x shifted likewise, works down the dividend in n-word chunks, each step reducing a 2n-word
+U = (current remainder).B^n + (next chunk of x) via Barrett's method (cf. Menezes et al, HAC, Alg. 14.42):
+	q1 = floor(U/B^(n-1)), qhat = floor(q1.mu/B^(n+1)), r = U - qhat.y (mod B^(n+1)),
+where mu = floor(B^(2n)/y) from mi64_recip; then r < 3y, and we need at most 2 correction steps r -= y, ++qhat.
+That is 1 high-half and 1 low-half (n+1)-word multiply per n words of x. The normalized divisor and its reciprocal
+are kept from one call to the next, so repeated mods by the same divisor skip the reciprocal computation.
+*/
+int mi64_div_barrett(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY, uint64 q[], uint64 r[])
+{
+	// Divisor and reciprocal from the previous call:
+	static MI64_TLS uint64 *ysave = 0x0, *ynorm = 0x0, *mu = 0x0;
+	static MI64_TLS uint32 lenSave = 0, dimSave = 0;
+	// Local storage for the shifted dividend and per-chunk work:
+	static MI64_TLS uint64 *scratch = 0x0;
+	static MI64_TLS uint32 lens = 0;
+	uint32 i, n, xlen, nshift, nch, nc, len;
+	int c;
+	uint64 *xloc, *u, *qhat, *t;
+	ASSERT(lenX && lenY, "illegal 0 dimension!");
+	ASSERT(x && y && x != y, "Bad x or y array!");
+	ASSERT(r != y, "Y and Rem arrays overlap!");
+	ASSERT(q != x && q != y && (q == 0x0 || q != r), "Quotient array overlaps one of X, Y ,Rem!");
+	xlen = mi64_getlen(x, lenX);
+	n = mi64_getlen(y, lenY);	ASSERT(n != 0, "divide by 0!");
+	if(q) mi64_clear(q, lenX);
+	if((xlen < n) || ((xlen == n) && mi64_cmpult(x, y, n))) {
+		if(r != 0x0 && r != x) mi64_set_eq(r, x, lenX);
+		return mi64_iszero(x, lenX);
+	}
+	nshift = mi64_leadz(y, n);
+	// New divisor? Normalize it and compute its reciprocal:
+	if(n != lenSave || !mi64_cmp_eq(y, ysave, n)) {
+		if(dimSave < n) {
+			dimSave = n;
+			ysave = (uint64 *)realloc(ysave, (3*n+2)*sizeof(uint64));	ASSERT(ysave != 0x0, "alloc fail!");
+		}
+		ynorm = ysave + n;	mu = ynorm + n+1;
+		lenSave = n;	mi64_set_eq(ysave, y, n);
+		mi64_shl(y, ynorm, nshift, n);	ynorm[n] = 0ull;	// 0-padded to n+1 words for the low-half products
+		mi64_recip(ynorm, n, mu);
+	}
+	ynorm = ysave + n;	mu = ynorm + n+1;
+	// Dividend, shifted by the same amount as y, 0-padded to a multiple of n words:
+	nch = (xlen+1 + n-1)/n;	len = nch*n;
+	if(lens < len + 5*n+4) {
+		lens = len + 5*n+4;
+		scratch = (uint64 *)realloc(scratch, lens*sizeof(uint64));	ASSERT(scratch != 0x0, "alloc fail!");
+	}
+	xloc = scratch;	u = xloc + len;	qhat = u + 2*n+1;	t = qhat + n+1;
+	mi64_clear(xloc, len);	mi64_set_eq(xloc, x, xlen);
+	mi64_shl(xloc, xloc, nshift, xlen+1);
+	// u[n..2n) holds the running remainder, initially 0:
+	mi64_clear(u, 2*n+1);
+	for(c = nch-1; c >= 0; c--) {
+		mi64_set_eq(u, xloc + c*n, n);
+		mi64_mul_vector_hi_half(u+n-1, mu, qhat, n+1);
+		mi64_mul_vector_lo_half(qhat, ynorm, t, n+1);
+		mi64_sub(u, t, u, n+1);
+		for(nc = 0; (u[n] || !mi64_cmpult(u, ynorm, n)) && nc < 3; nc++) {
+			mi64_sub(u, ynorm, u, n+1);
+			mi64_add_scalar(qhat, 1ull, qhat, n+1);
+		}
+		ASSERT(nc < 3 && qhat[n] == 0ull, "mi64_div_barrett: Barrett quotient estimate off by more than 2!");
+		// Quotient words above lenX must = 0, since x < B^lenX:
+		if(q) {
+			for(i = 0; i < n && c*n+i < lenX; i++) { q[c*n+i] = qhat[i]; }
+		}
+		// Remainder becomes high half of next U:
+		for(i = n; i-- > 0; ) { u[n+i] = u[i]; }
+	}
+	// Un-normalize the remainder:
+	mi64_shrl(u+n, u+n, nshift, n, n);
+	if(r != 0x0) {
+		mi64_set_eq(r, u+n, n);
+		if(x == r)
+			mi64_clear(r+n, lenX-n);
+		else
+			mi64_clear(r+n, lenY-n);
+	}
+	return mi64_iszero(u+n, n);
+}
+#endif	// __CUDA_ARCH__ ?
+
+/*
+Subquadratic multiword GCD: mi64_gcd_dc follows the divide-and-conquer scheme of N. Moller, "On Schonhage's
+algorithm and subquadratic integer GCD computation", Math. Comp. 77 (2008), as also used by GMP's mpn_gcd:
+
+o mi64_hgcd(a,b,n,M), the half-GCD, takes n-word a,b and returns the product M of the Euclidean-step matrices
+  (1 q; 0 1) and (1 0; q 1) which takes (a,b) down to roughly half their size, along with the reduced values
+  (alpha,beta) = M^-1.(a,b), both > B^s for s = n/2+1, B = 2^64, which overwrite the inputs. Above MI64_HGCD_THRESH
+  words it recurses, first on the high half of the inputs, then on the high half of the partially-reduced values.
+  The matrix found for the leading words of (a,b) is also valid for the full-length (a,b) because hgcd stops short
+  of remainders which would be small enough to be affected by the discarded low words; the low words get folded
+  back in by mi64_hgcd_matrix_adjust.
+o Below that, and for the tail of the recursive steps, mi64_hgcd_step uses the 2x2 single-word Lehmer matrix
+  mi64_hgcd2 gets from the leading 128 bits of a and b, which it applies to the full-length vectors via 4 scalar-
+  vector muls; where that fails to make progress it does a single subtract-and-divide step, mi64_gcd_subdiv_step.
+o mi64_gcd_dc repeatedly reduces the high 1/3 of its inputs via mi64_hgcd, falling back to Lehmer steps once
+  the operands drop below MI64_GCD_DC_THRESH words.
+
+All matrix and matrix-vector products use mi64_mul_vector, hence are Karatsuba/Toom-3 above MI64_KARA_THRESH words,
+giving an O(M(n) log n) = O(n^1.47 log n) GCD; GMP's FFT-based multiply above ~10^4 words gives it the edge for
+really large inputs. mi64_gcd_dc does not use any statics, so is threadsafe.
+*/
+#ifndef __CUDA_ARCH__
+
+// Crossovers (in words) - can override at compile time via -D[name]=[value]:
+#ifndef MI64_HGCD_THRESH
+	#define MI64_HGCD_THRESH	100
+#endif
+#ifndef MI64_GCD_DC_THRESH
+	#define MI64_GCD_DC_THRESH	300
+#endif
+
+// 2x2 matrix with nonnegative multiword entries p[i][j] of [alloc] words each; n = max length of the 4 entries:
+struct mi64_hgcd_matrix {
+	uint32 alloc, n;
+	uint64 *p[2][2];
+};
+
+// Init M = identity, with room for the matrix returned by mi64_hgcd on n-word inputs:
+static void mi64_hgcd_matrix_init(struct mi64_hgcd_matrix *M, uint32 n)
+{
+	uint32 len = (n+1)/2 + 2;
+	M->alloc = len;	M->n = 1;
+	M->p[0][0] = (uint64 *)calloc(4*len, sizeof(uint64));	ASSERT(M->p[0][0] != 0x0, "alloc fail!");
+	M->p[0][1] = M->p[0][0] + len;	M->p[1][0] = M->p[0][1] + len;	M->p[1][1] = M->p[1][0] + len;
+	M->p[0][0][0] = M->p[1][1][0] = 1ull;
+}
+
+static void mi64_hgcd_matrix_free(struct mi64_hgcd_matrix *M)
+{
+	free((void *)M->p[0][0]);	M->p[0][0] = 0x0;
+}
+
+// Resets M->n to the max length of the 4 entries after an update:
+static void mi64_hgcd_matrix_setlen(struct mi64_hgcd_matrix *M)
+{
+	uint32 i,j, n = 1;
+	for(i = 0; i < 2; i++) {
+		for(j = 0; j < 2; j++) {
+			n = MAX(n, mi64_getlen(M->p[i][j], M->alloc));
+		}
+	}
+	ASSERT(n < M->alloc, "HGCD matrix entry overflows its allocation!");
+	M->n = n;
+}
+
+// M <- M.(1 0; q 1) (col = 0) or M.(1 q; 0 1) (col = 1), i.e. column [col] of M += q * column [1-col].
+// tp[] needs M->n + qn words:
+static void mi64_hgcd_matrix_update_q(struct mi64_hgcd_matrix *M, const uint64 q[], uint32 qn, uint32 col, uint64 tp[])
+{
+	uint32 row, lenT, n = M->n;
+	qn = mi64_getlen(q, qn);
+	if(!qn) return;
+	for(row = 0; row < 2; row++) {
+		if(qn == 1) {
+			tp[n] = mi64_mul_scalar(M->p[row][1-col], q[0], tp, n);	lenT = n+1;
+		} else {
+			mi64_mul_vector(M->p[row][1-col], n, q, qn, tp, &lenT);
+		}
+		lenT = mi64_getlen(tp, lenT);
+		if(!lenT) continue;
+		ASSERT(lenT < M->alloc, "HGCD matrix entry overflows its allocation!");
+		ASSERT(0 == mi64_add_ext(M->p[row][col], M->alloc, tp, lenT), "Unexpected carryout!");
+	}
+	mi64_hgcd_matrix_setlen(M);
+}
+
+// M <- M.M1 for the single-word M1 = (m1[0] m1[1]; m1[2] m1[3]), whose entries are < 2^63, so M grows by at most
+// one word. tp[] needs 2*(M->n + 1) words:
+static void mi64_hgcd_matrix_mul_1(struct mi64_hgcd_matrix *M, const uint64 m1[], uint64 tp[])
+{
+	uint32 row, n = M->n;
+	uint64 *t0 = tp, *t1 = tp + n+1;
+	ASSERT(n+1 < M->alloc, "HGCD matrix entry overflows its allocation!");
+	for(row = 0; row < 2; row++) {
+		t0[n]  = mi64_mul_scalar         (M->p[row][0], m1[0],     t0, n);
+		t0[n] += mi64_mul_scalar_add_vec2(M->p[row][1], m1[2], t0, t0, n);
+		t1[n]  = mi64_mul_scalar         (M->p[row][0], m1[1],     t1, n);
+		t1[n] += mi64_mul_scalar_add_vec2(M->p[row][1], m1[3], t1, t1, n);
+		mi64_set_eq(M->p[row][0], t0, n+1);
+		mi64_set_eq(M->p[row][1], t1, n+1);
+	}
+	mi64_hgcd_matrix_setlen(M);
+}
+
+// M <- M.M1 via 8 general multiword products. tp[] needs 3*(M->n + M1->n + 1) words:
+static void mi64_hgcd_matrix_mul(struct mi64_hgcd_matrix *M, const struct mi64_hgcd_matrix *M1, uint64 tp[])
+{
+	uint32 row, col, lenT, n = M->n, n1 = M1->n, len = n + n1 + 1;
+	uint64 *t[2], *u = tp + 2*len;
+	t[0] = tp;	t[1] = tp + len;
+	for(row = 0; row < 2; row++) {
+		for(col = 0; col < 2; col++) {
+			mi64_mul_vector(M->p[row][0], n, M1->p[0][col], n1, t[col], &lenT);
+			mi64_mul_vector(M->p[row][1], n, M1->p[1][col], n1, u     , &lenT);
+			t[col][len-1] = mi64_add(t[col], u, t[col], len-1);
+		}
+		for(col = 0; col < 2; col++) {
+			lenT = mi64_getlen(t[col], len);
+			ASSERT(lenT < M->alloc, "HGCD matrix entry overflows its allocation!");
+			mi64_clear(M->p[row][col], M->alloc);	mi64_set_eq(M->p[row][col], t[col], lenT);
+		}
+	}
+	mi64_hgcd_matrix_setlen(M);
+}
+
+/* Given n-word a,b whose words [p,n) hold the reduced (alpha,beta) returned by mi64_hgcd(a+p,b+p,n-p,M) and whose
+low p words are still those of the original inputs (a0,b0), completes the full-length reduction
+	(a,b) <- M^-1.(a,b) = (alpha.B^p + M11.a0 - M01.b0, beta.B^p + M00.b0 - M10.a0)	[det M = 1].
+Both results are nonnegative, but may need an extra word, hence a,b must have at least n+1 words of storage.
+Returns the new normalized length. tp[] needs 4*(p + M->n) words.
+*/
+static uint32 mi64_hgcd_matrix_adjust(const struct mi64_hgcd_matrix *M, uint32 n, uint64 a[], uint64 b[], uint32 p, uint64 tp[])
+{
+	uint32 i, lenT[4], len = p + M->n;
+	uint64 *t[4], ah, bh;
+	for(i = 0; i < 4; i++) { t[i] = tp + i*len; }
+	mi64_mul_vector(M->p[1][1], M->n, a, p, t[0], lenT  );
+	mi64_mul_vector(M->p[0][1], M->n, b, p, t[1], lenT+1);
+	mi64_mul_vector(M->p[0][0], M->n, b, p, t[2], lenT+2);
+	mi64_mul_vector(M->p[1][0], M->n, a, p, t[3], lenT+3);
+	for(i = 0; i < 4; i++) {
+		lenT[i] = mi64_getlen(t[i], len);	ASSERT(lenT[i] <= n, "HGCD matrix-adjust product too large!");
+	}
+	mi64_clear(a, p);	mi64_clear(b, p);
+	ah = bh = 0ull;
+	if(lenT[0]) ah += mi64_add_ext(a, n, t[0], lenT[0]);
+	if(lenT[1]) ah -= mi64_sub_ext(a, n, t[1], lenT[1]);
+	if(lenT[2]) bh += mi64_add_ext(b, n, t[2], lenT[2]);
+	if(lenT[3]) bh -= mi64_sub_ext(b, n, t[3], lenT[3]);
+	ASSERT(ah <= 1ull && bh <= 1ull, "HGCD matrix-adjust yields negative result!");
+	if(ah | bh) {
+		a[n] = ah;	b[n] = bh;	return n+1;
+	}
+	return MAX(mi64_getlen(a, n), mi64_getlen(b, n));
+}
+
+/* (a,b) <- M1^-1.(a,b) = (m1[3].a - m1[1].b, m1[0].b - m1[2].a) for the single-word det-1 matrix M1 from
+mi64_hgcd2. Returns the new normalized length; tp[] needs 2*(n+1) words.
+*/
+static uint32 mi64_hgcd_mul1_inverse_vector(const uint64 m1[], uint64 a[], uint64 b[], uint32 n, uint64 tp[])
+{
+	uint64 *t0 = tp, *t1 = tp + n+1, cy;
+	t0[n]  = mi64_mul_scalar(a, m1[3], t0, n);
+	t1[n]  = mi64_mul_scalar(b, m1[1], t1, n);
+	ASSERT(0 == mi64_sub(t0, t1, t0, n+1) && t0[n] == 0ull, "HGCD Lehmer step yields negative or oversized result!");
+	t1[n]  = mi64_mul_scalar(a, m1[2], t1, n);
+	cy     = mi64_mul_scalar(b, m1[0], b , n);
+	ASSERT(cy == t1[n] + mi64_sub(b, t1, b, n), "HGCD Lehmer step yields negative or oversized result!");
+	mi64_set_eq(a, t0, n);
+	return MAX(mi64_getlen(a, n), mi64_getlen(b, n));
+}
+
+// 128/128-bit quotient and remainder for n >= d, whose top words satisfy nh > dh >= 2, so q < 2^63:
+static uint64 mi64_hgcd_div2(uint64 r[], uint64 nh, uint64 nl, uint64 dh, uint64 dl)
+{
+	int i, cnt = leadz64(dh) - leadz64(nh);
+	uint64 q = 0ull;
+	if(cnt) {
+		dh = (dh << cnt) + (dl >> (64-cnt));	dl <<= cnt;
+	}
+	for(i = 0; i <= cnt; i++) {
+		q <<= 1;
+		if(nh > dh || (nh == dh && nl >= dl)) {
+			nh -= dh + (nl < dl);	nl -= dl;	q++;
+		}
+		dl = (dl >> 1) + (dh << 63);	dh >>= 1;
+	}
+	r[0] = nl;	r[1] = nh;
+	return q;
+}
+
+// (h,l) -= (h2,l2) for 128-bit values in 64-bit word pairs:
+#define SUB_128(__h,__l, __h2,__l2)	{ __h -= __h2 + (__l < __l2);	__l -= __l2; }
+
+/* Lehmer step on the leading 128 bits (ah,al), (bh,bl) of a and b, at least one of which is normalized: if
+successful, returns 1 and the single-word matrix M1 = (m1[0] m1[1]; m1[2] m1[3]) of the longest sequence of
+Euclidean steps which is guaranteed to be the same for the full-length a,b, else returns 0. Quotients are
+computed on the 128-bit values until one of them drops below 2^96, then on the leading 64 bits of the 128-bit
+values; the stopping rule is Jebelean's, requiring both remainders to remain > the possible error, 2^65 (resp.
+2^33 for the 64-bit phase). This is Moller's simplified version of GMP's mpn_hgcd2.
+*/
+static int mi64_hgcd2(uint64 ah, uint64 al, uint64 bh, uint64 bl, uint64 m1[])
+{
+	const uint64 half = 1ull << 32, half1 = 1ull << 33;
+	uint64 u00, u01, u10, u11, q, r[2];
+	if(ah < 2 || bh < 2)
+		return 0;
+	if(ah > bh || (ah == bh && al > bl)) {
+		SUB_128(ah,al, bh,bl);
+		if(ah < 2)
+			return 0;
+		u00 = u01 = u11 = 1;	u10 = 0;
+	} else {
+		SUB_128(bh,bl, ah,al);
+		if(bh < 2)
+			return 0;
+		u00 = u10 = u11 = 1;	u01 = 0;
+	}
+	if(ah < bh)
+		goto subtract_a;
+	// Double-word phase:
+	for(;;) {
+		if(ah == bh)
+			goto done;
+		if(ah < half) {
+			ah = (ah << 32) + (al >> 32);	bh = (bh << 32) + (bl >> 32);
+			break;
+		}
+		// a -= q.b, M <- M.(1 q; 0 1):
+		SUB_128(ah,al, bh,bl);
+		if(ah < 2)
+			goto done;
+		if(ah <= bh) {
+			u01 += u00;	u11 += u10;
+		} else {
+			q = mi64_hgcd_div2(r, ah,al, bh,bl);	al = r[0];	ah = r[1];
+			if(ah < 2) {	// a too small, but q is correct
+				u01 += q*u00;	u11 += q*u10;
+				goto done;
+			}
+			q++;
+			u01 += q*u00;	u11 += q*u10;
+		}
+	subtract_a:
+		if(ah == bh)
+			goto done;
+		if(bh < half) {
+			ah = (ah << 32) + (al >> 32);	bh = (bh << 32) + (bl >> 32);
+			goto subtract_a1;
+		}
+		// b -= q.a, M <- M.(1 0; q 1):
+		SUB_128(bh,bl, ah,al);
+		if(bh < 2)
+			goto done;
+		if(bh <= ah) {
+			u00 += u01;	u10 += u11;
+		} else {
+			q = mi64_hgcd_div2(r, bh,bl, ah,al);	bl = r[0];	bh = r[1];
+			if(bh < 2) {	// b too small, but q is correct
+				u00 += q*u01;	u10 += q*u11;
+				goto done;
+			}
+			q++;
+			u00 += q*u01;	u10 += q*u11;
+		}
+	}
+	// Single-word phase, on the leading 64 bits of the 128-bit values:
+	for(;;) {
+		ah -= bh;
+		if(ah < half1)
+			break;
+		if(ah <= bh) {
+			u01 += u00;	u11 += u10;
+		} else {
+			q = ah/bh;	ah -= q*bh;
+			if(ah < half1) {
+				u01 += q*u00;	u11 += q*u10;
+				break;
+			}
+			q++;
+			u01 += q*u00;	u11 += q*u10;
+		}
+	subtract_a1:
+		bh -= ah;
+		if(bh < half1)
+			break;
+		if(bh <= ah) {
+			u00 += u01;	u10 += u11;
+		} else {
+			q = bh/ah;	bh -= q*ah;
+			if(bh < half1) {
+				u00 += q*u01;	u10 += q*u11;
+				break;
+			}
+			q++;
+			u00 += q*u01;	u10 += q*u11;
+		}
+	}
+done:
+	m1[0] = u00;	m1[1] = u01;	m1[2] = u10;	m1[3] = u11;
+	return 1;
+}
+#undef SUB_128
+
+/* b <- b % a, q <- b / a for b of bn >= an words and a of an words with a[an-1] != 0; q needs bn words.
+Short quotients - the common case - are done schoolbook-style a word at a time, using the leading word of the
+normalized divisor for the quotient-word estimate, which is at most 2 too small; longer quotients use mi64_div.
+The bn-an high words of b are cleared on return.
+*/
+static void mi64_gcd_divrem(uint64 b[], uint32 bn, const uint64 a[], uint32 an, uint64 q[], uint64 tp[])
+{
+	int k;
+	uint32 sh;
+	uint64 ahi, qhat, x[2], y[2];
+	if(an < 2 || bn - an > 1) {
+		mi64_div(b, a, bn, an, q, b);
+		mi64_clear(b+an, bn-an);
+		return;
+	}
+	mi64_clear(q, bn);
+	sh = leadz64(a[an-1]);
+	ahi = sh ? (a[an-1] << sh) + (a[an-2] >> (64-sh)) : a[an-1];
+	for(k = bn-an; k >= 0; k--) {
+		// b < a.B^(k+1), so the leading 128 bits of (b << sh) at word position k+an-1 are < (ahi+1).B:
+		x[1] = (k+an < bn ? b[k+an] << sh : 0ull) + (sh ? b[k+an-1] >> (64-sh) : 0ull);
+		x[0] = (b[k+an-1] << sh) + (sh ? b[k+an-2] >> (64-sh) : 0ull);
+		if(ahi == -1ull) {
+			qhat = x[1];
+		} else {
+			mi64_div_by_scalar64(x, ahi+1, 2, y);	qhat = y[0];
+		}
+		if(qhat) {
+			tp[an] = mi64_mul_scalar(a, qhat, tp, an);
+			ASSERT(0 == mi64_sub_ext(b+k, bn-k, tp, an + (k+an < bn)), "Quotient estimate too large!");
+		}
+		while((k+an < bn && b[k+an]) || !mi64_cmpult(b+k, a, an)) {
+			if(k+an < bn)
+				b[k+an] -= mi64_sub(b+k, a, b+k, an);
+			else
+				mi64_sub(b+k, a, b+k, an);
+			qhat++;
+		}
+		q[k] = qhat;
+	}
+}
+
+/* One subtract-and-divide Euclidean step on n-word a,b, for use where mi64_hgcd2 fails to make progress, which
+leaves the larger of the 2 as the remainder after subtracting the smaller one, then dividing by it. For s > 0 the
+step is undone - and 0 returned - where it would yield a remainder of s or fewer words. The quotients are
+accumulated in M, if non-null. For s = 0, returns 0 if the GCD was found, in which case it is written to g[], its
+length to *gn, and whether it is the final value of a or of b (*gsel = 0|1) to *gsel. Otherwise returns the new
+length. tp[] needs 2*n + M->n words.
+*/
+static uint32 mi64_gcd_subdiv_step(uint64 a[], uint64 b[], uint32 n, uint32 s, struct mi64_hgcd_matrix *M, uint64 g[], uint32 *gn, uint32 *gsel, uint64 tp[])
+{
+	const uint64 one = 1ull;
+	uint32 an, bn, qn, swapped = 0, itmp32;
+	uint64 *ptr, cy;
+	int c;
+	// Swaps a <-> b, and their lengths:
+	#define SWAP_AB	{ ptr = a; a = b; b = ptr;	itmp32 = an; an = bn; bn = itmp32;	swapped ^= 1; }
+	an = mi64_getlen(a, n);	bn = mi64_getlen(b, n);
+	ASSERT(an || bn, "Both inputs = 0!");
+	// Arrange for a < b, then b -= a:
+	if(an == bn) {
+		c = mi64_cmpult(a, b, an) ? -1 : !mi64_cmp_eq(a, b, an);
+		if(c == 0) {
+			if(s == 0) {
+				mi64_set_eq(g, a, an);	*gn = an;	*gsel = 0;
+			}
+			return 0;
+		} else if(c > 0) {
+			SWAP_AB;
+		}
+	} else if(an > bn) {
+		SWAP_AB;
+	}
+	if(an <= s) {
+		if(s == 0) {
+			mi64_set_eq(g, b, bn);	*gn = bn;	*gsel = !swapped;
+		}
+		return 0;
+	}
+	ASSERT(0 == mi64_sub_ext(b, bn, a, an), "Unexpected borrow!");
+	bn = mi64_getlen(b, bn);	ASSERT(bn != 0, "Zero difference!");
+	if(bn <= s) {	// Undo subtraction
+		cy = mi64_add(b, a, b, an);
+		if(cy) b[an] = cy;
+		return 0;
+	}
+	// Arrange for a < b again, record the subtraction:
+	if(an == bn) {
+		c = mi64_cmpult(a, b, an) ? -1 : !mi64_cmp_eq(a, b, an);
+		if(c == 0) {
+			if(s > 0) {
+				mi64_hgcd_matrix_update_q(M, &one, 1, swapped, tp);
+			} else {	// b = a; take the latter, whose cofactors are those of the preceding step:
+				mi64_set_eq(g, a, an);	*gn = an;	*gsel = swapped;
+			}
+			return 0;
+		}
+		if(M) mi64_hgcd_matrix_update_q(M, &one, 1, swapped, tp);
+		if(c > 0) SWAP_AB;
+	} else {
+		if(M) mi64_hgcd_matrix_update_q(M, &one, 1, swapped, tp);
+		if(an > bn) SWAP_AB;
+	}
+	#undef SWAP_AB
+	// b = q.a + r:
+	mi64_gcd_divrem(b, bn, a, an, tp, tp+bn);
+	qn = bn - an + 1;
+	bn = mi64_getlen(b, an);
+	if(bn <= s) {
+		if(s == 0) {
+			mi64_set_eq(g, a, an);	*gn = an;	*gsel = swapped;
+			return 0;
+		}
+		// Quotient is one too large - decrement it and add back a:
+		if(bn > 0) {
+			cy = mi64_add(b, a, b, an);
+			if(cy) b[an++] = cy;
+		} else {
+			mi64_set_eq(b, a, an);
+		}
+		mi64_sub_scalar(tp, 1ull, tp, qn);
+	}
+	if(M) mi64_hgcd_matrix_update_q(M, tp, qn, swapped, tp+qn);
+	return an;
+}
+
+/* Reduction step for the half-GCD of n-word a,b with one of the leading words nonzero: a single Lehmer step via
+mi64_hgcd2 where possible, else a single subtract-and-divide step. Steps yielding a remainder of s or fewer words
+are refused. Accumulates the step matrix in M and returns the new length, or 0 if no step could be done.
+tp[] needs 2*n + M->n + 2 words.
+*/
+static uint32 mi64_hgcd_step(uint32 n, uint64 a[], uint64 b[], uint32 s, struct mi64_hgcd_matrix *M, uint64 tp[])
+{
+	uint64 mask = a[n-1] | b[n-1], ah, al, bh, bl, m1[4];
+	uint32 shift;
+	ASSERT(n > s && mask != 0ull, "Bad inputs to mi64_hgcd_step!");
+	if(n == s+1) {
+		if(mask < 4)
+			goto subtract;
+		ah = a[n-1];	al = a[n-2];	bh = b[n-1];	bl = b[n-2];
+	} else if(mask >> 63) {
+		ah = a[n-1];	al = a[n-2];	bh = b[n-1];	bl = b[n-2];
+	} else {
+		shift = leadz64(mask);
+		ah = (a[n-1] << shift) + (a[n-2] >> (64-shift));	al = (a[n-2] << shift) + (a[n-3] >> (64-shift));
+		bh = (b[n-1] << shift) + (b[n-2] >> (64-shift));	bl = (b[n-2] << shift) + (b[n-3] >> (64-shift));
+	}
+	if(mi64_hgcd2(ah,al, bh,bl, m1)) {
+		mi64_hgcd_matrix_mul_1(M, m1, tp);
+		return mi64_hgcd_mul1_inverse_vector(m1, a, b, n, tp);
+	}
+subtract:
+	return mi64_gcd_subdiv_step(a, b, n, s, M, 0x0, 0x0, 0x0, tp);
+}
+
+/* Half-GCD: Given n-word a,b with a[n-1] | b[n-1] != 0 and M = identity on entry (with room for the
+entries of an (n+1)/2-word matrix, as set up by mi64_hgcd_matrix_init(M,n)), overwrites (a,b) with the reduced
+(alpha,beta) = M^-1.(a,b), both > B^s, s = n/2+1, and returns their length, or 0 if no reduction was possible.
+a and b need n+1 words of storage.
+*/
+static uint32 mi64_hgcd(uint64 a[], uint64 b[], uint32 n, struct mi64_hgcd_matrix *M)
+{
+	const uint32 s = n/2 + 1;
+	uint32 n2, p, nn, success = 0;
+	uint64 *tp;
+	struct mi64_hgcd_matrix M1;
+	if(n <= s)	// Only for n <= 2
+		return 0;
+	// Enough for the worst case, the matrix adjust for p = n/2, or the step after it:
+	tp = (uint64 *)malloc((4*n + 16)*sizeof(uint64));	ASSERT(tp != 0x0, "alloc fail!");
+	if(n >= MI64_HGCD_THRESH) {
+		n2 = (3*n)/4 + 1;	p = n/2;
+		nn = mi64_hgcd(a+p, b+p, n-p, M);
+		if(nn) {
+			n = mi64_hgcd_matrix_adjust(M, p+nn, a, b, p, tp);
+			success = 1;
+		}
+		while(n > n2) {
+			nn = mi64_hgcd_step(n, a, b, s, M, tp);
+			if(!nn)
+				goto hgcd_return;
+			n = nn;	success = 1;
+		}
+		if(n > s + 2) {
+			p = 2*s - n + 1;
+			mi64_hgcd_matrix_init(&M1, n-p);
+			nn = mi64_hgcd(a+p, b+p, n-p, &M1);
+			if(nn) {
+				n = mi64_hgcd_matrix_adjust(&M1, p+nn, a, b, p, tp);
+				mi64_hgcd_matrix_mul(M, &M1, tp);
+				success = 1;
+			}
+			mi64_hgcd_matrix_free(&M1);
+		}
+	}
+	for(;;) {
+		nn = mi64_hgcd_step(n, a, b, s, M, tp);
+		if(!nn)
+			break;
+		n = nn;	success = 1;
+	}
+hgcd_return:
+	free((void *)tp);	tp = 0x0;
+	return success ? n : 0;
+}
+
+/* Cofactor tracking for mi64_modinv_dc: with X the input to be inverted, the current (a,b) satisfy
+a == +ca.X, b == -cb.X (mod m) for nonnegative ca, cb. A reduction step (a,b) <- M^-1.(a,b) then takes
+	(ca,cb) <- (m11.ca + m01.cb, m10.ca + m00.cb),
+which is done by this for a multiword M, and by mi64_gcd_cofactor_update_1 for a single-word one from mi64_hgcd2.
+ca and cb have *cn words on entry and room for [alloc] words; tp[] needs 3*(*cn + M->n + 1) words.
+*/
+static void mi64_gcd_cofactor_update(uint64 ca[], uint64 cb[], uint32 *cn, uint32 alloc, const struct mi64_hgcd_matrix *M, uint64 tp[])
+{
+	uint32 lenT, n = *cn, len = n + M->n + 1;
+	uint64 *ta = tp, *tb = tp + len, *u = tb + len;
+	mi64_mul_vector(M->p[1][1], M->n, ca, n, ta, &lenT);
+	mi64_mul_vector(M->p[0][1], M->n, cb, n, u , &lenT);	ta[len-1] = mi64_add(ta, u, ta, len-1);
+	mi64_mul_vector(M->p[1][0], M->n, ca, n, tb, &lenT);
+	mi64_mul_vector(M->p[0][0], M->n, cb, n, u , &lenT);	tb[len-1] = mi64_add(tb, u, tb, len-1);
+	n = MAX(mi64_getlen(ta, len), mi64_getlen(tb, len));
+	ASSERT(n < alloc, "GCD cofactor overflows its allocation!");
+	mi64_set_eq(ca, ta, n);	mi64_set_eq(cb, tb, n);	*cn = MAX(n, 1);
+}
+
+static void mi64_gcd_cofactor_update_1(uint64 ca[], uint64 cb[], uint32 *cn, uint32 alloc, const uint64 m1[], uint64 tp[])
+{
+	uint32 n = *cn;
+	uint64 *ta = tp, *tb = tp + n+1;
+	ASSERT(n+1 < alloc, "GCD cofactor overflows its allocation!");
+	ta[n]  = mi64_mul_scalar         (ca, m1[3],     ta, n);
+	ta[n] += mi64_mul_scalar_add_vec2(cb, m1[1], ta, ta, n);
+	tb[n]  = mi64_mul_scalar         (ca, m1[2],     tb, n);
+	tb[n] += mi64_mul_scalar_add_vec2(cb, m1[0], tb, tb, n);
+	mi64_set_eq(ca, ta, n+1);	mi64_set_eq(cb, tb, n+1);
+	*cn = MAX(mi64_getlen(ca, n+1), mi64_getlen(cb, n+1));
+	*cn = MAX(*cn, 1);
+}
+
+/* GCD driver for mi64_gcd_dc and mi64_modinv_dc: a,b hold the inputs, of length ulen,vlen <= len, with len+1 words
+of storage each, and are overwritten. Returns the GCD in the len words of g[] and its length in the function
+result, and in *gsel whether it is the final a (0) or b (1). If ca != 0x0, the (ca,cb) pair, with room for
+len+2 words each and initialized to (1,0), gets the cofactors described above mi64_gcd_cofactor_update.
+*/
+static uint32 mi64_gcd_core(uint64 a[], uint64 b[], uint32 ulen, uint32 vlen, uint32 len, uint64 g[], uint32 *gsel, uint64 ca[], uint64 cb[])
+{
+	struct mi64_hgcd_matrix M, *Mptr = 0x0;
+	uint32 n, p, nn, gn = 0, cn = 1, col, lenX, lenY;
+	const uint32 alloc = len+2;
+	uint64 *tp, *ctp = 0x0, *x, *y, m1[4], ah, al, bh, bl, mask;
+	int shift;
+	ASSERT(ulen && vlen, "mi64_gcd_core needs nonzero inputs!");
+	tp = (uint64 *)malloc((4*len + 16)*sizeof(uint64));	ASSERT(tp != 0x0, "alloc fail!");
+	if(ca) {
+		ctp = (uint64 *)malloc((6*len + 16)*sizeof(uint64));	ASSERT(ctp != 0x0, "alloc fail!");
+		Mptr = &M;
+	}
+	// Reduce the longer input mod the shorter, so both are of similar size going into the main loop;
+	// (a,b) -= (q.b,0) has M = (1 q; 0 1), (a,b) -= (0,q.a) has M = (1 0; q 1):
+	if(ulen != vlen) {
+		if(ulen > vlen) {
+			x = a;	y = b;	lenX = ulen;	lenY = vlen;	col = 1;
+		} else {
+			x = b;	y = a;	lenX = vlen;	lenY = ulen;	col = 0;
+		}
+		mi64_gcd_divrem(x, lenX, y, lenY, tp, tp+lenX);
+		if(ca) {
+			mi64_hgcd_matrix_init(&M, 2*len);
+			mi64_hgcd_matrix_update_q(&M, tp, lenX-lenY+1, col, ctp);
+			mi64_gcd_cofactor_update(ca, cb, &cn, alloc, &M, ctp);
+			mi64_hgcd_matrix_free(&M);
+		}
+		if(mi64_iszero(x, lenY)) {
+			mi64_set_eq(g, y, lenY);	gn = lenY;	*gsel = (y == b);
+			goto gcd_return;
+		}
+		ulen = vlen = lenY;
+	}
+	n = vlen;
+	while(n >= MI64_GCD_DC_THRESH) {
+		p = (2*n)/3;
+		mi64_hgcd_matrix_init(&M, n-p);
+		nn = mi64_hgcd(a+p, b+p, n-p, &M);
+		if(nn) {
+			n = mi64_hgcd_matrix_adjust(&M, p+nn, a, b, p, tp);
+		} else {
+			if(ca) {	// The quotient here can be as large as the inputs:
+				mi64_hgcd_matrix_free(&M);	mi64_hgcd_matrix_init(&M, 2*n);
+			}
+			n = mi64_gcd_subdiv_step(a, b, n, 0, Mptr, g, &gn, gsel, tp);
+		}
+		if(ca) mi64_gcd_cofactor_update(ca, cb, &cn, alloc, &M, ctp);
+		mi64_hgcd_matrix_free(&M);
+		if(!n)
+			goto gcd_return;
+	}
+	// Lehmer steps, then plain Euclid on what's left:
+	while(n) {
+		if(n > 2) {
+			mask = a[n-1] | b[n-1];
+			if(mask >> 63) {
+				ah = a[n-1];	al = a[n-2];	bh = b[n-1];	bl = b[n-2];
+			} else {
+				shift = leadz64(mask);
+				ah = (a[n-1] << shift) + (a[n-2] >> (64-shift));	al = (a[n-2] << shift) + (a[n-3] >> (64-shift));
+				bh = (b[n-1] << shift) + (b[n-2] >> (64-shift));	bl = (b[n-2] << shift) + (b[n-3] >> (64-shift));
+			}
+			if(mi64_hgcd2(ah,al, bh,bl, m1)) {
+				n = mi64_hgcd_mul1_inverse_vector(m1, a, b, n, tp);
+				if(ca) mi64_gcd_cofactor_update_1(ca, cb, &cn, alloc, m1, ctp);
+				continue;
+			}
+		}
+		if(ca) mi64_hgcd_matrix_init(&M, 2*n);
+		n = mi64_gcd_subdiv_step(a, b, n, 0, Mptr, g, &gn, gsel, tp);
+		if(ca) {
+			mi64_gcd_cofactor_update(ca, cb, &cn, alloc, &M, ctp);
+			mi64_hgcd_matrix_free(&M);
+		}
+	}
+gcd_return:
+	mi64_clear(g+gn, len-gn);
+	free((void *)tp);	tp = 0x0;
+	if(ctp) {
+		free((void *)ctp);	ctp = 0x0;
+	}
+	return gn;
+}
+
+/* Returns g = gcd(u,v) for len-word u,v in the len words of g[], and the length of g in the function result.
+Either input may be 0, in which case the GCD is the other; gcd(0,0) = 0. Inputs are not modified.
+*/
+uint32 mi64_gcd_dc(const uint64 u[], const uint64 v[], uint32 len, uint64 g[])
+{
+	uint32 ulen, vlen, gn, gsel;
+	uint64 *a;
+	ASSERT(len != 0 && u && v && g, "Bad inputs to mi64_gcd_dc!");
+	ulen = mi64_getlen(u, len);	vlen = mi64_getlen(v, len);
+	if(!ulen || !vlen) {	// gcd(x,0) = x:
+		mi64_set_eq(g, ulen ? u : v, len);
+		return MAX(ulen, vlen);
+	}
+	// Local copies with an extra word for the matrix-adjust carry:
+	a = (uint64 *)calloc(2*(len+1), sizeof(uint64));	ASSERT(a != 0x0, "alloc fail!");
+	mi64_set_eq(a, u, ulen);	mi64_set_eq(a+len+1, v, vlen);
+	gn = mi64_gcd_core(a, a+len+1, ulen, vlen, len, g, &gsel, 0x0, 0x0);
+	free((void *)a);	a = 0x0;
+	return gn;
+}
+
+/* Modular inverse: If gcd(x,m) = 1 for len-word x,m (m > 1), returns 1 and x^-1 (mod m) in the len words of inv[];
+otherwise returns 0 and inv[] = 0. Via the extended form of the mi64_gcd_dc algorithm. Inputs are not modified.
+*/
+uint32 mi64_modinv_dc(const uint64 x[], const uint64 m[], uint32 len, uint64 inv[])
+{
+	uint32 xlen, mlen, gn, gsel, retval = 0;
+	uint64 *a, *b, *ca, *cb, *g;
+	ASSERT(len != 0 && x && m && inv && inv != m, "Bad inputs to mi64_modinv_dc!");
+	xlen = mi64_getlen(x, len);	mlen = mi64_getlen(m, len);
+	ASSERT(mlen > 1 || m[0] > 1, "Modulus must be > 1!");
+	if(!xlen) {
+		mi64_clear(inv, len);
+		return 0;
+	}
+	a = (uint64 *)calloc(5*(len+2), sizeof(uint64));	ASSERT(a != 0x0, "alloc fail!");
+	b = a + len+2;	ca = b + len+2;	cb = ca + len+2;	g = cb + len+2;
+	mi64_set_eq(a, x, xlen);	mi64_set_eq(b, m, mlen);	ca[0] = 1ull;
+	gn = mi64_gcd_core(a, b, xlen, mlen, len, g, &gsel, ca, cb);
+	mi64_clear(inv, len);
+	if(gn == 1 && g[0] == 1ull) {
+		// g == +ca.X (gsel = 0) or -cb.X (gsel = 1) (mod m), with 0 <= ca,cb <= m:
+		if(gsel) {
+			if(!mi64_iszero(cb, len)) mi64_sub(m, cb, inv, len);
+		} else {
+			mi64_set_eq(inv, ca, len);
+		}
+		if(!mi64_cmpult(inv, m, len)) mi64_sub(inv, m, inv, len);
+		retval = 1;
+	}
+	free((void *)a);	a = 0x0;
+	return retval;
+}
+#endif	// __CUDA_ARCH__ ?
+
 /// Fast is-divisible-by-32-bit-scalar using Montgomery modmul and right-to-left modding:
 /*** NOTE *** Routine assumes x[] is a uint64 array cast to uint32[], hence the doubling-of-len
 is done HERE, i.e. user must supply uint64-len just as for the 'true 64-bit' mi64 functions!
@@ -7370,10 +8559,10 @@ uint64 mi64_div_by_scalar64_u4(uint64 x[], uint64 q, uint32 lenu, uint64 y[])
 	int i,j,len = (lenu+3) & ~0x3,len2 = (len>>1),len4 = (len>>2),npad = len-lenu,nshift,lshift = -1;	// Pad to multiple-of-4 length
 	uint64 qinv,cy0,cy1,cy2,cy3,rpow,rem_save = 0,itmp64,mask,*iptr0,*iptr1,*iptr2,*iptr3, ptr_incr,ptr_inc2;
 	uint64 *xy_ptr_diff, pads[3];
-	// Local-alloc-related statics - these should only ever be updated in single-thread mode:
-	static int first_entry = TRUE;
-	static uint32 len_save = 10;	// Initial-alloc values
-	static uint64 *svec = 0x0;	// svec = "scratch vector"
+	// Local-alloc-related statics, thread-local in multithreaded builds:
+	static MI64_TLS int first_entry = TRUE;
+	static MI64_TLS uint32 len_save = 10;	// Initial-alloc values
+	static MI64_TLS uint64 *svec = 0x0;	// svec = "scratch vector"
 	if(first_entry) {
 		first_entry = FALSE;
 		svec = (uint64 *)calloc(len_save, sizeof(uint64));	ASSERT(svec != 0x0, "alloc failed!");
@@ -8303,10 +9492,10 @@ uint32 mi64_twopmodq(const uint64 p[], uint32 len_p, const uint64 k, uint64 q[],
   #if MI64_POW_DBG
 	uint32 dbg = FERMAT && pow2 == 256;//STREQ(&s0[convert_mi64_base10_char(s0, q, len, 0)], "531137992816767098689588206552468627329593117727031923199444138200403559860852242739162502265229285668889329486246501015346579337652707239409519978766587351943831270835393219031728127");
   #endif
-	// Local-alloc-related statics - these should only ever be updated in single-thread mode:
-	static int first_entry = TRUE;
-	static uint32 lenp_save = 10, lenq_save = 10;	// Initial-alloc values
-	static uint64 *pshift = 0x0, *qhalf = 0x0, *qinv = 0x0, *x = 0x0, *lo = 0x0, *hi = 0x0;
+	// Local-alloc-related statics, thread-local in multithreaded builds:
+	static MI64_TLS int first_entry = TRUE;
+	static MI64_TLS uint32 lenp_save = 10, lenq_save = 10;	// Initial-alloc values
+	static MI64_TLS uint64 *pshift = 0x0, *qhalf = 0x0, *qinv = 0x0, *x = 0x0, *lo = 0x0, *hi = 0x0;
 	 int32 j;	// Current-Bit index j needs to be signed because of the LR binary exponentiation.
 	uint32 retval, idum, pbits;
 	uint64 lead_chunk, lo64, cyout;
@@ -8571,20 +9760,23 @@ uint32 mi64_twopmodq_qmmp(const uint64 p, const uint64 k, uint64*res)//, uint32
 	 int32 j;
 	uint32 lenP, lenQ, pbits;
 	uint64 k2 = k+k, lead_chunk, lo64, cyout;
-	static uint64 *q = 0x0, *qhalf = 0x0, *qinv = 0x0, *x = 0x0, *lo = 0x0, *hi = 0x0;
-	static uint64 psave = 0, *pshift = 0x0;
-	static uint32 lenQ_save = 0, qbits, log2_numbits, start_index, zshift;
-	static uint32  first_entry = TRUE;
+	static MI64_TLS uint64 *q = 0x0, *qhalf = 0x0, *qinv = 0x0, *x = 0x0, *lo = 0x0, *hi = 0x0;
+	static MI64_TLS uint64 psave = 0, *pshift = 0x0;
+	static MI64_TLS uint32 lenQ_save = 0, qbits, log2_numbits, start_index, zshift;
+	static MI64_TLS uint32  first_entry = TRUE;
 
 	// Quick computation of number of uint64 needed to hold current q:
 	ASSERT((k != 0) && ((k2>>1) == k), "2*k overflows!");	// Make sure 2*k does not overflow
 	j = (p+1)&63;	// p+1 mod 64, needed since q = 2*k*MMp+1 ~= k*MM(p+1)
 	lenP = ((p+1) + 63)>>6;	// #64-bit words needed
-	lo64 = k;		// Copy of k
-	if( (j == 0) || ((lo64 << j) >> j) != k ) {	// 2*k*MMp crosses a word boundary, need one more word than required by MMp to store it
-		lenQ = lenP + 1;
-	} else {
+	/* q = 2.k.M(p)+1 fits in lenP words iff k.M(p) = k.2^p - k < 2^(p+b), with b = 64.lenP-1-p = (64-j)%64, i.e. iff
+	k <= 2^b or (k - 2^b).2^p < k. Merely testing k < 2^b, as we used to, allocated an all-zero leading word for q
+	whenever k = 2^b or (for p < 64) k is only slightly larger than that: */
+	lo64 = 1ull << ((64-j)&63);	// 2^b
+	if(k <= lo64 || (p < 64 && (k - lo64) <= ((k-1) >> p))) {
 		lenQ = lenP;
+	} else {	// 2*k*MMp crosses a word boundary, need one more word than required by MMp to store it
+		lenQ = lenP + 1;
 	}
   #if MI64_POW_DBG
 	if(dbg) { printf("mi64_twopmodq_qmmp: k = %" PRIu64 ", lenP = %u, lenQ = %u\n",k,lenP,lenQ); }
@@ -8599,8 +9791,9 @@ uint32 mi64_twopmodq_qmmp(const uint64 p, const uint64 k, uint64*res)//, uint32
 		pshift[0] = 1;
 		mi64_shl(pshift, pshift, p, lenP);	// 2^p
 		mi64_sub_scalar(pshift, 1, pshift, lenP);	// M(p) = 2^p-1
-		/* pshift = p + len*64: */
-		pshift[lenP] = mi64_add_scalar(pshift, lenP*64, pshift, lenP);
+		/* pshift = p + len*64, with len the #words of q - lenQ > lenP if 2.k.M(p) crosses a word boundary; cf. the
+		April 2015 lenP ==> lenQ fix in mi64_twopmodq. Using lenP here gave wrong results for all such q: */
+		pshift[lenP] = mi64_add_scalar(pshift, lenQ*64, pshift, lenP);
 		ASSERT(!pshift[lenP], "pshift overflows!");
 	#if MI64_POW_DBG
 		if(dbg) { printf("mi64_twopmodq_qmmp: Init: k = %" PRIu64 ", lenP = %u, lenQ = %u\n",k,lenP,lenQ); }
@@ -46,6 +46,18 @@ extern "C" {
   #endif
 #endif
 
+// Storage class for the local-alloc scratch statics in the mi64 modmul and modpow routines: thread-local in
+// multithreaded builds, so that e.g. multiple TF threads can run mi64_twopmodq[_qmmp] concurrently:
+#if defined(MULTITHREAD) && !defined(__CUDA_ARCH__)
+  #ifdef COMPILER_TYPE_MSVC
+	#define MI64_TLS	__declspec(thread)
+  #else
+	#define MI64_TLS	__thread
+  #endif
+#else
+	#define MI64_TLS
+#endif
+
 // Table of leading 2048 bits of Pi treated as a no-binary-point bitstring 1100100100001111110110... in
 // to base-2^64 form, i.e. the final word 0x648... contains the leftmost 64 bits of the above expansion:
 static const uint64 pi_bits[32] = {														// Input index range by row:/
@@ -283,6 +295,9 @@ DEV void	mi64_mul_vector_hi_trunc(const uint64 x[], const uint64 y[], uint64 z[]
 DEV void	mi64_mul_vector_hi_qferm(const uint64 y[], const uint64 p, const uint64 k, uint64 z[], uint32 bits);
 // Specialized O(n) version of mi64_mul_vector_hi_half for moduli q = 2.k.M(p) + 1, where M(p) is a Mersenne prime
 DEV void	mi64_mul_vector_hi_qmmp	(const uint64 y[], const uint64 p, const uint64 k, uint64 z[], uint32 bits);
+// Karatsuba/Toom-3 balanced multiply underlying the above for large len, with caller-supplied scratch:
+	uint32	mi64_mul_scratch_len	(uint32 len);
+	void	mi64_mul_kara			(const uint64 x[], const uint64 y[], uint64 z[], uint32 len, uint64 scr[]);
 #endif
 //void	mi64_mul_vector_hi_fast	(const uint64 x[], const uint64 y[], uint64 z[], uint32 len);
 DEV void	mi64_mul_vector_hi_fast	(const uint64 y[], const uint64 p, const uint64 k, uint64 z[], uint32 len);
@@ -307,12 +322,18 @@ DEV uint64	mi64_modmul64(const uint64 a, const uint64 b, const uint64 m);
 
 /* Fast division based on Montgomery multiply: */
 	uint64	radix_power64(const uint64 q, const uint64 qinv, uint32 n);
-DEV int		mi64_div				(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY, uint64 q[], uint64 r[]);	// Wrapper for the next 2 routines
+DEV int		mi64_div				(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY, uint64 q[], uint64 r[]);	// Wrapper for mi64_div_mont|barrett
 	int		mi64_div_mont			(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY, uint64 q[], uint64 r[]);
 DEV uint64	mi64_div_by_scalar64	(const uint64 x[], uint64 a, uint32 lenX, uint64 q[]);
 	// x declared non-const in folded versions to permit 0-padding:
 DEV uint64	mi64_div_by_scalar64_u2	(uint64 x[], uint64 a, uint32 lenX, uint64 q[]);	// 2-way interleaved-|| loop
 DEV uint64	mi64_div_by_scalar64_u4	(uint64 x[], uint64 a, uint32 lenX, uint64 q[]);	// 4-way interleaved-|| loop
+/* Reciprocal-based division via Newton iteration and Barrett reduction: */
+	void	mi64_recip				(const uint64 y[], uint32 len, uint64 v[]);
+	int		mi64_div_barrett		(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY, uint64 q[], uint64 r[]);
+/* Subquadratic GCD and modular inverse via half-GCD: */
+	uint32	mi64_gcd_dc				(const uint64 u[], const uint64 v[], uint32 len, uint64 g[]);
+	uint32	mi64_modinv_dc			(const uint64 x[], const uint64 m[], uint32 len, uint64 inv[]);
 /* Slow bit-at-a-time division to obtain quotient q = x/y and/or remainder r = x%y: */
 	int		mi64_div_binary			(const uint64 x[], const uint64 y[], uint32 lenX, uint32 lenY, uint64 q[], uint32*lenQ, uint64 r[]);
 
@@ -0,0 +1,241 @@
+/*******************************************************************************
+*                                                                              *
+*   (C) 1997-2021 by Ernst W. Mayer.                                           *
+*                                                                              *
+*  This program is free software; you can redistribute it and/or modify it     *
+*  under the terms of the GNU General Public License as published by the       *
+*  Free Software Foundation; either version 2 of the License, or (at your      *
+*  option) any later version.                                                  *
+*                                                                              *
+*  This program is distributed in the hope that it will be useful, but WITHOUT *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+*  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   *
+*  more details.                                                               *
+*                                                                              *
+*  You should have received a copy of the GNU General Public License along     *
+*  with this program; see the file GPL.txt.  If not, you may view one at       *
+*  http://www.fsf.org/licenses/licenses.html, or obtain one by writing to the  *
+*  Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA     *
+*  02111-1307, USA.                                                            *
+*                                                                              *
+*******************************************************************************/
+
+/* Live shared-memory status page - cf. mstatus.h for the layout and update protocol. Built as part of Mlucas this
+provides the writer side; with -DMSTATUS_STANDALONE it builds the mstatus reader tool:
+
+	mstatus [-w] [pid ...]
+
+With no pid arguments, lists all status pages found in /dev/shm (Linux only; elsewhere the pids must be given).
+-w repeats the listing once per second until interrupted.
+*/
+#include "mstatus.h"
+#include "Mdata.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+	#define MSTATUS_NO_SHM	// No POSIX shared memory; the writer-side functions are no-ops
+#else
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <signal.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+#ifndef MSTATUS_STANDALONE
+
+// Minimum wall-clock time over which the msec_per_iter field is averaged, in seconds:
+#ifndef MSTATUS_TIME_WINDOW
+	#define MSTATUS_TIME_WINDOW	0.25
+#endif
+
+static mstatus_t *mstatus = 0x0;
+static char mstatus_name[32];
+static double mstatus_t0 = 0.0;		// Start time and iteration of the current timing window
+static uint32 mstatus_iter0 = 0;
+
+// Creates this process' status page. Returns 1 on success (or if already open), 0 on failure:
+int mstatus_open(void)
+{
+#ifdef MSTATUS_NO_SHM
+	return 0;
+#else
+	int fd;
+	void*ptr;
+	if(mstatus)
+		return 1;
+	snprintf(mstatus_name, sizeof(mstatus_name), MSTATUS_PREFIX "%u", (uint32)getpid());
+	fd = shm_open(mstatus_name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+	if(fd < 0)
+		return 0;
+	if(ftruncate(fd, sizeof(mstatus_t))) {
+		close(fd); shm_unlink(mstatus_name);
+		return 0;
+	}
+	ptr = mmap(0x0, sizeof(mstatus_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);	// Mapping remains valid after close
+	if(ptr == MAP_FAILED) {
+		shm_unlink(mstatus_name);
+		return 0;
+	}
+	mstatus = (mstatus_t *)ptr;
+	memset(mstatus, 0, sizeof(mstatus_t));
+	mstatus->version = MSTATUS_VERSION;
+	mstatus->pid = (uint32)getpid();
+	// Readers ignore pages without the magic number, so set that last:
+	__atomic_store_n(&mstatus->magic, MSTATUS_MAGIC, __ATOMIC_RELEASE);
+	atexit(mstatus_close);
+	return 1;
+#endif
+}
+
+void mstatus_close(void)
+{
+#ifndef MSTATUS_NO_SHM
+	if(!mstatus)
+		return;
+	munmap(mstatus, sizeof(mstatus_t));
+	shm_unlink(mstatus_name);
+	mstatus = 0x0;
+#endif
+}
+
+// Called at the start of each test, and whenever the FFT length or threadcount changes:
+void mstatus_set_run(uint64 p, uint32 mod_type, uint32 test_type, uint32 fftlen, uint32 nthreads, uint32 maxiter)
+{
+	uint32 seq;
+	if(!mstatus)
+		return;
+	seq = mstatus->seq;
+	__atomic_store_n(&mstatus->seq, seq+1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	mstatus->p = p;	mstatus->mod_type = mod_type;	mstatus->test_type = test_type;
+	mstatus->fftlen = fftlen;	mstatus->nthreads = nthreads;	mstatus->maxiter = maxiter;
+	mstatus->iter = 0;	mstatus->msec_per_iter = mstatus->maxerr = 0.0;
+	mstatus->time = (uint64)time(0x0);
+	__atomic_store_n(&mstatus->seq, seq+2, __ATOMIC_RELEASE);
+	mstatus_t0 = 0.0;	mstatus_iter0 = 0;
+}
+
+// Called once per iteration from the [mers|fermat]_mod_square main loop; a no-op if there is no status page:
+void mstatus_update(uint32 iter, double maxerr)
+{
+	uint32 seq;
+	double t;
+	if(!mstatus)
+		return;
+	t = getRealTime();
+	// First update of the run, or iteration count went backward on restart from a savefile: start a new timing window
+	if(mstatus_t0 == 0.0 || iter <= mstatus_iter0) {
+		mstatus_t0 = t;	mstatus_iter0 = iter;
+	}
+	seq = mstatus->seq;
+	__atomic_store_n(&mstatus->seq, seq+1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	mstatus->iter = iter;	mstatus->maxerr = maxerr;
+	if(t - mstatus_t0 >= MSTATUS_TIME_WINDOW) {
+		mstatus->msec_per_iter = 1000*(t - mstatus_t0)/(iter - mstatus_iter0);
+		mstatus->time = (uint64)time(0x0);
+		mstatus_t0 = t;	mstatus_iter0 = iter;
+	}
+	__atomic_store_n(&mstatus->seq, seq+2, __ATOMIC_RELEASE);
+}
+
+#else	// Standalone reader tool
+
+#ifdef MSTATUS_NO_SHM
+	#error mstatus reader tool requires POSIX shared memory.
+#endif
+#include <dirent.h>
+
+// Copies out a consistent snapshot of the status page of process pid. Returns 1 on success, 0 if no valid page was found:
+int mstatus_read(uint32 pid, mstatus_t*st)
+{
+	char name[32];
+	uint32 s0, s1;
+	int fd;
+	const mstatus_t*m;
+	snprintf(name, sizeof(name), MSTATUS_PREFIX "%u", pid);
+	fd = shm_open(name, O_RDONLY, 0);
+	if(fd < 0)
+		return 0;
+	m = (const mstatus_t *)mmap(0x0, sizeof(mstatus_t), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(m == MAP_FAILED)
+		return 0;
+	do {
+		s0 = __atomic_load_n(&m->seq, __ATOMIC_ACQUIRE);
+		memcpy(st, (const void *)m, sizeof(mstatus_t));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		s1 = __atomic_load_n(&m->seq, __ATOMIC_RELAXED);
+	} while((s0 & 1) || s0 != s1);
+	munmap((void *)m, sizeof(mstatus_t));
+	return (st->magic == MSTATUS_MAGIC && st->version == MSTATUS_VERSION);
+}
+
+void mstatus_print(uint32 pid)
+{
+	const char*test_str[TEST_TYPE_MAX+1] = {"?","LL","PRP","P-1"};
+	mstatus_t st;
+	int alive;
+	if(!mstatus_read(pid, &st)) {
+		printf("pid %u: no Mlucas status page found.\n",pid);
+		return;
+	}
+	// A crashed run leaves its page behind; flag those:
+	alive = !(kill((pid_t)pid, 0) && errno == ESRCH);
+	if(!st.p) {
+		printf("pid %u: no test underway%s\n",pid,alive ? "." : " [not running]");
+		return;
+	}
+	printf("pid %u: %c%" PRIu64 " %s iter %u/%u [%5.2f%%], FFT %uK, %u threads, %.3f msec/iter, MaxErr = %.9f, updated %" PRId64 " s ago%s\n",
+		pid, (st.mod_type == MODULUS_TYPE_FERMAT ? 'F' : 'M'), st.p,
+		(st.mod_type == MODULUS_TYPE_FERMAT && st.test_type == TEST_TYPE_PRIMALITY) ? "Pepin" : test_str[st.test_type <= TEST_TYPE_MAX ? st.test_type : 0],
+		st.iter, st.maxiter, st.maxiter ? 100.0*st.iter/st.maxiter : 0.0, st.fftlen >> 10, st.nthreads,
+		st.msec_per_iter, st.maxerr, (int64)time(0x0) - (int64)st.time, alive ? "" : " [not running]");
+}
+
+int main(int argc, char *argv[])
+{
+	int i, watch = 0, npid = 0;
+	DIR*dir;
+	struct dirent*ent;
+	for(i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-w"))
+			watch = 1;
+		else if(strtoul(argv[i], 0x0, 10) != 0)
+			npid++;
+		else {
+			fprintf(stderr,"Usage: %s [-w] [pid ...]\n",argv[0]);
+			return 1;
+		}
+	}
+	for(;;) {
+		if(npid) {
+			for(i = 1; i < argc; i++) {
+				if(strcmp(argv[i], "-w")) mstatus_print((uint32)strtoul(argv[i], 0x0, 10));
+			}
+		} else if((dir = opendir("/dev/shm")) != 0x0) {
+			while((ent = readdir(dir)) != 0x0) {
+				if(!strncmp(ent->d_name, MSTATUS_PREFIX + 1, strlen(MSTATUS_PREFIX) - 1))
+					mstatus_print((uint32)strtoul(ent->d_name + strlen(MSTATUS_PREFIX) - 1, 0x0, 10));
+			}
+			closedir(dir);
+		} else {
+			fprintf(stderr,"Unable to list /dev/shm ... please specify the pid(s) of the Mlucas run(s) to show.\n");
+			return 1;
+		}
+		if(!watch)
+			break;
+		fflush(stdout);
+		sleep(1);
+		printf("\n");
+	}
+	return 0;
+}
+
+#endif	// MSTATUS_STANDALONE
@@ -0,0 +1,77 @@
+/*******************************************************************************
+*                                                                              *
+*   (C) 1997-2021 by Ernst W. Mayer.                                           *
+*                                                                              *
+*  This program is free software; you can redistribute it and/or modify it     *
+*  under the terms of the GNU General Public License as published by the       *
+*  Free Software Foundation; either version 2 of the License, or (at your      *
+*  option) any later version.                                                  *
+*                                                                              *
+*  This program is distributed in the hope that it will be useful, but WITHOUT *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+*  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   *
+*  more details.                                                               *
+*                                                                              *
+*  You should have received a copy of the GNU General Public License along     *
+*  with this program; see the file GPL.txt.  If not, you may view one at       *
+*  http://www.fsf.org/licenses/licenses.html, or obtain one by writing to the  *
+*  Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA     *
+*  02111-1307, USA.                                                            *
+*                                                                              *
+*******************************************************************************/
+
+/*******************************************************************************
+   We now include this header file if it was not included before.
+*******************************************************************************/
+#ifndef mstatus_h_included
+#define mstatus_h_included
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Live status page: each production run publishes the fixed-layout struct below in a POSIX shared-memory object
+named /mlucas.[pid] (on Linux, visible as /dev/shm/mlucas.[pid]), which monitoring tools may poll as often as they
+like without adding any file I/O to the running program. The struct is updated lock-free from the main iteration loop
+using a sequence count: the (single) writer makes seq odd before updating the other fields and even again afterward;
+a reader copies out the struct and retries unless it saw the same even seq value before and after the copy.
+
+All fields are naturally aligned and in host byte order; the mstatus reader tool is built from mstatus.c via
+	gcc -O2 -DMSTATUS_STANDALONE -o mstatus mstatus.c	[older glibc versions also need -lrt]
+*/
+#define MSTATUS_MAGIC	0x54534C4Du	// "MLST" in little-endian byte order
+#define MSTATUS_VERSION	1
+#define MSTATUS_PREFIX	"/mlucas."
+
+typedef struct {
+	uint32 magic;			// MSTATUS_MAGIC
+	uint32 version;			// MSTATUS_VERSION
+	uint32 seq;				// Sequence count, odd while an update is in progress
+	uint32 pid;				// Process ID of the writer
+	uint64 p;				// Mersenne exponent or Fermat-number index
+	uint32 mod_type;		// MODULUS_TYPE_* and TEST_TYPE_* as defined in Mdata.h
+	uint32 test_type;
+	uint32 fftlen;			// FFT length in doubles
+	uint32 nthreads;
+	uint32 iter;			// Last iteration completed (p-1 stage 1: bit of the stage 1 powering)
+	uint32 maxiter;			// Iterations needed for the current test
+	double msec_per_iter;	// Current timing, averaged over the most-recent fraction of a second
+	double maxerr;			// Max. roundoff error since the last checkpoint
+	uint64 time;			// Unix time of the last update
+} mstatus_t;
+
+#ifndef MSTATUS_STANDALONE
+	int		mstatus_open(void);
+	void	mstatus_close(void);
+	void	mstatus_set_run(uint64 p, uint32 mod_type, uint32 test_type, uint32 fftlen, uint32 nthreads, uint32 maxiter);
+	void	mstatus_update(uint32 iter, double maxerr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* mstatus_h_included */
+
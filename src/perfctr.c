@@ -0,0 +1,233 @@
+/*******************************************************************************
+*                                                                              *
+*   (C) 1997-2021 by Ernst W. Mayer.                                           *
+*                                                                              *
+*  This program is free software; you can redistribute it and/or modify it     *
+*  under the terms of the GNU General Public License as published by the       *
+*  Free Software Foundation; either version 2 of the License, or (at your      *
+*  option) any later version.                                                  *
+*                                                                              *
+*  This program is distributed in the hope that it will be useful, but WITHOUT *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+*  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   *
+*  more details.                                                               *
+*                                                                              *
+*  You should have received a copy of the GNU General Public License along     *
+*  with this program; see the file GPL.txt.  If not, you may view one at       *
+*  http://www.fsf.org/licenses/licenses.html, or obtain one by writing to the  *
+*  Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA     *
+*  02111-1307, USA.                                                            *
+*                                                                              *
+*******************************************************************************/
+
+/* Per-FFT-phase and per-threadpool-task hardware performance counters - cf. perfctr.h. */
+
+#include "perfctr.h"
+#include "Mdata.h"
+#include <time.h>
+
+#if INCLUDE_PERF
+	#include <errno.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+#endif
+
+uint32 PERF_COUNTERS = 0;
+volatile int PERF_TASK_PHASE = PERF_PHASE_NONE;
+
+static const char *perf_phase_name[PERF_NPHASE] = {"DIF passes","wrapper/dyadic-square","DIT passes","carry"};
+static uint32 perf_ev_avail = 0;	// Bitmap of events which every thread so far has been able to open
+// Totals since the last perf_reset(), updated atomically since all pool threads add to them:
+static uint64 perf_phase_tot[PERF_NPHASE][PERF_NEVENT];
+static uint64 perf_task_tot[PERF_MAX_THREADS][PERF_NEVENT];
+
+#if INCLUDE_PERF
+
+static const char *perf_ev_name[PERF_NEVENT] = {"task-clock","cycles","instructions","LLC-read-misses","DTLB-read-misses"};
+
+// Opens the calling thread's event group, with task-clock as the leader. Returns the leader fd, or -1 if even that
+// failed; pos[] gets each event's index in the group-read data, -1 for events which failed to open:
+static int perf_open_group(int pos[])
+{
+	const uint32 type[PERF_NEVENT] = {PERF_TYPE_SOFTWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE};
+	const uint64 config[PERF_NEVENT] = {
+		PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_LL   | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+		PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+	};
+	struct perf_event_attr attr;
+	int i, fd, leader = -1, npos = 0;
+	for(i = 0; i < PERF_NEVENT; i++) {
+		pos[i] = -1;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type[i];	attr.config = config[i];
+		attr.read_format = PERF_FORMAT_GROUP;
+		attr.exclude_kernel = 1;	attr.exclude_hv = 1;	// Also makes this usable at perf_event_paranoid = 2
+		fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);	// pid = 0, cpu = -1: calling thread, on any CPU
+		if(fd < 0) {
+			if(leader < 0) {	// This thread gets CPU time only, via perf_thread_cpu_nsec()
+				__atomic_and_fetch(&perf_ev_avail, 1u << PERF_EV_TASK_CLOCK, __ATOMIC_RELAXED);
+				return -1;
+			}
+			__atomic_and_fetch(&perf_ev_avail, ~(1u << i), __ATOMIC_RELAXED);
+			continue;
+		}
+		if(leader < 0) leader = fd;
+		pos[i] = npos++;
+	}
+	return leader;
+}
+
+#endif
+
+// Fallback for threads without an event group: the calling thread's CPU time in nsec, or the process' if the former is unsupported:
+static uint64 perf_thread_cpu_nsec(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+	struct timespec ts;
+	if(!clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts))
+		return (uint64)ts.tv_sec*1000000000ull + (uint64)ts.tv_nsec;
+#endif
+	return (uint64)(1e9*clock()/CLOCKS_PER_SEC);
+}
+
+// Called once from ernstMain if user set PerfCounters = 1, and by the -bench-radix benchmark. If perf_event_open() is
+// unavailable, falls back to counting just per-thread CPU time, so always returns 1:
+int perf_init(void)
+{
+	if(PERF_COUNTERS)
+		return 1;
+#if INCLUDE_PERF
+	int i, pos[PERF_NEVENT];
+	perf_ev_avail = (1u << PERF_NEVENT) - 1;
+	i = perf_open_group(pos);
+	if(i < 0) {
+		snprintf(cbuf,STR_MAX_LEN*2,"INFO: perf_event_open() failed with errno = %d ... per-FFT-phase counters limited to CPU time.\n",errno);
+	} else {
+		close(i);	// Each thread, including this one, opens its own group on its first perf_read()
+		sprintf(cbuf,"INFO: Enabled per-FFT-phase performance counters:");
+		for(i = 0; i < PERF_NEVENT; i++) {
+			if(perf_ev_avail & (1u << i)) { strcat(cbuf," "); strcat(cbuf,perf_ev_name[i]); }
+		}
+		strcat(cbuf,".\n");
+	}
+#else
+	perf_ev_avail = 1u << PERF_EV_TASK_CLOCK;
+	sprintf(cbuf,"INFO: Hardware performance counters only supported on Linux ... per-FFT-phase counters limited to CPU time.\n");
+#endif
+	mlucas_fprint(cbuf,1);
+	perf_reset();
+	PERF_COUNTERS = 1;
+	return 1;
+}
+
+void perf_reset(void)
+{
+	memset(perf_phase_tot, 0, sizeof(perf_phase_tot));
+	memset(perf_task_tot , 0, sizeof(perf_task_tot ));
+}
+
+// Snapshot of the calling thread's counters; just the CPU time if the thread's event group could not be opened:
+void perf_read(uint64 snap[])
+{
+#if INCLUDE_PERF
+	static PERF_TLS int fd = -2;	// -2 = not yet tried
+	static PERF_TLS int pos[PERF_NEVENT];
+	uint64 buf[PERF_NEVENT+1];
+	int i;
+	if(fd == -2)
+		fd = perf_open_group(pos);
+	if(fd >= 0 && read(fd, buf, sizeof(buf)) >= (ssize_t)(2*sizeof(uint64))) {
+		for(i = 0; i < PERF_NEVENT; i++) { snap[i] = (pos[i] >= 0 ? buf[1+pos[i]] : 0ull); }
+		return;
+	}
+#endif
+	memset(snap, 0, PERF_NEVENT*sizeof(uint64));
+	snap[PERF_EV_TASK_CLOCK] = perf_thread_cpu_nsec();
+}
+
+static void perf_accum(uint64 tot[], const uint64 snap[], const uint64 curr[])
+{
+	int i;
+	for(i = 0; i < PERF_NEVENT; i++) { __atomic_add_fetch(&tot[i], curr[i] - snap[i], __ATOMIC_RELAXED); }
+}
+
+// Adds the calling thread's counts since the snapshot snap[] to the totals for the given FFT phase:
+void perf_end(int phase, const uint64 snap[])
+{
+	uint64 curr[PERF_NEVENT];
+	perf_read(curr);
+	perf_accum(perf_phase_tot[phase], snap, curr);
+}
+
+// Same for a threadpool task, whose counts go to the per-pool-thread totals and to the phase in PERF_TASK_PHASE, if any:
+void perf_task_end(int thr_id, const uint64 snap[])
+{
+	uint64 curr[PERF_NEVENT];
+	int phase = PERF_TASK_PHASE;
+	perf_read(curr);
+	perf_accum(perf_task_tot[thr_id % PERF_MAX_THREADS], snap, curr);
+	if(phase != PERF_PHASE_NONE)
+		perf_accum(perf_phase_tot[phase], snap, curr);
+}
+
+// Total count of the given event for the given FFT phase since the last perf_reset(), summed over all threads:
+uint64 perf_phase_total(int phase, int event)
+{
+	return perf_phase_tot[phase][event];
+}
+
+static void perf_report_line(const char*label, const uint64 tot[], uint32 niter)
+{
+	char str[STR_MAX_LEN];
+	int i;
+	double x;
+	snprintf(cbuf,STR_MAX_LEN*2,"  %-22s",label);
+	for(i = 0; i < PERF_NEVENT; i++) {
+		if(i == PERF_EV_INSTRUCTIONS) continue;
+		if(i == PERF_EV_CYCLES) {	// Cycles is followed by an IPC column, which also needs instructions
+			if(!(perf_ev_avail & (1u << i)))
+				snprintf(str,STR_MAX_LEN," %12s %6s","n/a","n/a");
+			else if(!(perf_ev_avail & (1u << PERF_EV_INSTRUCTIONS)) || !tot[i])
+				snprintf(str,STR_MAX_LEN," %12.0f %6s",(double)tot[i]/niter,"n/a");
+			else {
+				x = (double)tot[PERF_EV_INSTRUCTIONS]/tot[i];
+				snprintf(str,STR_MAX_LEN," %12.0f %6.2f",(double)tot[i]/niter,x);
+			}
+		} else if(!(perf_ev_avail & (1u << i))) {
+			snprintf(str,STR_MAX_LEN," %12s","n/a");
+		} else if(i == PERF_EV_TASK_CLOCK) {
+			snprintf(str,STR_MAX_LEN," %12.4f",1e-6*tot[i]/niter);
+		} else {
+			snprintf(str,STR_MAX_LEN," %12.0f",(double)tot[i]/niter);
+		}
+		strcat(cbuf,str);
+	}
+	strcat(cbuf,"\n");
+	mlucas_fprint(cbuf,0);
+}
+
+// Called at checkpoint time: Writes the per-iteration averages over the niter iterations since the last perf_reset()
+// to the logfile, one line per FFT phase and one per pool thread which ran any tasks, then resets the totals:
+void perf_report(uint32 niter)
+{
+	char label[32];
+	int i;
+	if(!PERF_COUNTERS || !niter)
+		return;
+	snprintf(cbuf,STR_MAX_LEN*2,"Performance counters, per-iteration averages over the last %u iterations, radices = %u,%u,...,%u:\n"
+		"  %-22s %12s %12s %6s %12s %12s\n",niter,RADIX_VEC[0],RADIX_VEC[1],RADIX_VEC[NRADICES-1],
+		"phase","CPU-msec","cycles","IPC","LLC-miss","DTLB-miss");
+	mlucas_fprint(cbuf,0);
+	for(i = 0; i < PERF_NPHASE; i++) {
+		perf_report_line(perf_phase_name[i], perf_phase_tot[i], niter);
+	}
+	for(i = 0; i < PERF_MAX_THREADS; i++) {
+		if(!perf_task_tot[i][PERF_EV_TASK_CLOCK]) continue;
+		snprintf(label,sizeof(label),"pool thread %d tasks",i);
+		perf_report_line(label, perf_task_tot[i], niter);
+	}
+	perf_reset();
+}
@@ -0,0 +1,89 @@
+/*******************************************************************************
+*                                                                              *
+*   (C) 1997-2021 by Ernst W. Mayer.                                           *
+*                                                                              *
+*  This program is free software; you can redistribute it and/or modify it     *
+*  under the terms of the GNU General Public License as published by the       *
+*  Free Software Foundation; either version 2 of the License, or (at your      *
+*  option) any later version.                                                  *
+*                                                                              *
+*  This program is distributed in the hope that it will be useful, but WITHOUT *
+*  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+*  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   *
+*  more details.                                                               *
+*                                                                              *
+*  You should have received a copy of the GNU General Public License along     *
+*  with this program; see the file GPL.txt.  If not, you may view one at       *
+*  http://www.fsf.org/licenses/licenses.html, or obtain one by writing to the  *
+*  Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA     *
+*  02111-1307, USA.                                                            *
+*                                                                              *
+*******************************************************************************/
+
+/*******************************************************************************
+   We now include this header file if it was not included before.
+*******************************************************************************/
+#ifndef perfctr_h_included
+#define perfctr_h_included
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Opt-in per-FFT-phase hardware performance counters, via Linux perf_event_open(). Enabled at runtime by setting
+PerfCounters = 1 in mlucas.ini, else PERF_COUNTERS stays 0 and the hooks below reduce to a not-taken branch. On other
+platforms, or if the kernel does not permit user-space counting, only the per-thread CPU time is counted. Each thread
+opens its own event group on first use, and a phase is measured by bracketing it with a perf_read() into a local
+snapshot array and a perf_end() into the phase totals: */
+#ifndef INCLUDE_PERF
+  #if defined(__linux__) && !defined(__MINGW32__)
+	#define INCLUDE_PERF	1
+  #else
+	#define INCLUDE_PERF	0
+  #endif
+#endif
+
+// Thread-local storage for the per-thread event-group descriptors:
+#ifdef COMPILER_TYPE_MSVC
+	#define PERF_TLS	__declspec(thread)
+#else
+	#define PERF_TLS	__thread
+#endif
+
+enum {	// Events, in the order they are stored in a snapshot; task-clock (or its CPU-time fallback) is always available:
+	PERF_EV_TASK_CLOCK = 0,	// nsec
+	PERF_EV_CYCLES,
+	PERF_EV_INSTRUCTIONS,
+	PERF_EV_LLC_MISSES,
+	PERF_EV_DTLB_MISSES,
+	PERF_NEVENT
+};
+enum {	// FFT phases:
+	PERF_PHASE_NONE = -1,
+	PERF_PHASE_FWD = 0,		// Intermediate radix-8/16/32 DIF passes
+	PERF_PHASE_SQR,			// Fused final-DIF/pointwise-square/initial-DIT pass: radix*_wrapper_square, radix*_dyadic_square
+	PERF_PHASE_INV,			// Intermediate DIT passes
+	PERF_PHASE_CARRY,		// radix0 DIT pass, carry step and radix0 DIF pass: radix*_ditN_cy_dif1
+	PERF_NPHASE
+};
+#define PERF_MAX_THREADS	64	// Threadpool-task totals are kept per pool-thread index, mod this
+
+extern uint32 PERF_COUNTERS;		// Nonzero if counting is enabled and available
+extern volatile int PERF_TASK_PHASE;	// Phase to which threadpool-task totals are also credited, if not PERF_PHASE_NONE
+
+int		perf_init(void);
+void	perf_reset(void);
+void	perf_read(uint64 snap[]);
+void	perf_end(int phase, const uint64 snap[]);
+void	perf_task_end(int thr_id, const uint64 snap[]);
+void	perf_report(uint32 niter);
+uint64	perf_phase_total(int phase, int event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* perfctr_h_included */
+
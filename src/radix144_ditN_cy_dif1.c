@@ -410,20 +410,15 @@ int radix144_ditN_cy_dif1(double a[], int n, int nwt, int nwt_bits, double wt0[]
 
 	#ifdef MULTITHREAD
 
-		/* #Chunks ||ized in carry step is ideally a power of 2, so use the largest
-		power of 2 that is <= the value of the global NTHREADS (but still <= MAX_THREADS):
+		/* #Chunks ||ized in carry step must be a power of 2; for non-power-of-2 NTHREADS we use several chunks
+		per thread (if the leading radix permits) to keep all threads busy - see util.c::get_carry_work_units:
 		*/
-		if(isPow2(NTHREADS))
-			CY_THREADS = NTHREADS;
-		else {
-			i = leadz32(NTHREADS);
-			CY_THREADS = (((uint32)NTHREADS << i) & 0x80000000) >> i;
-		}
+		CY_THREADS = get_carry_work_units(NTHREADS, NDIVR, n_div_nwt);
 
-		if(CY_THREADS > MAX_THREADS)
+		if(MIN(NTHREADS,CY_THREADS) > MAX_THREADS)
 		{
 		//	CY_THREADS = MAX_THREADS;
-			fprintf(stderr,"WARN: CY_THREADS = %d exceeds number of cores = %d\n", CY_THREADS, MAX_THREADS);
+			fprintf(stderr,"WARN: #carry threads = %d exceeds number of cores = %d\n", MIN(NTHREADS,CY_THREADS), MAX_THREADS);
 		}
 		if(!isPow2(CY_THREADS))		{ WARN(HERE, "CY_THREADS not a power of 2!", "", 1); return(ERR_ASSERT); }
 		if(CY_THREADS > 1)
@@ -433,6 +428,11 @@ int radix144_ditN_cy_dif1(double a[], int n, int nwt, int nwt_bits, double wt0[]
 		}
 
 	  #ifdef USE_PTHREAD
+		// The chunk count depends on NDIVR, so a new FFT length may need a differently-sized tdat and pool:
+		if(tdat != 0x0 && pool_work_units != CY_THREADS) {
+			threadpool_free(tpool);	tpool = 0x0;
+			free((void *)tdat);	tdat = 0x0;
+		}
 		if(tdat == 0x0) {
 			j = (uint32)sizeof(struct cy_thread_data_t);
 			tdat = (struct cy_thread_data_t *)calloc(CY_THREADS, sizeof(struct cy_thread_data_t));
@@ -454,11 +454,11 @@ int radix144_ditN_cy_dif1(double a[], int n, int nwt, int nwt_bits, double wt0[]
 			#else
 
 				pool_work_units = CY_THREADS;
-				ASSERT(0x0 != (tpool = threadpool_init(CY_THREADS, MAX_THREADS, CY_THREADS, &thread_control)), "threadpool_init failed!");
+				ASSERT(0x0 != (tpool = threadpool_init(MIN(NTHREADS,CY_THREADS), MAX_THREADS, CY_THREADS, &thread_control)), "threadpool_init failed!");
 
 			#endif
 
-			fprintf(stderr,"Using %d threads in carry step\n", CY_THREADS);
+			fprintf(stderr,"Using %d threads, %d work units in carry step\n", MIN(NTHREADS,CY_THREADS), CY_THREADS);
 		}
 	  #endif
 
@@ -64,6 +64,7 @@ me at: heber.tomer@gmail.com
 
 #include "threadpool.h"
 #include "util.h"	// This is to get (or not) <hwloc.h>
+#include "perfctr.h"
 
 #ifdef MULTITHREAD	// Wrap contents of this file in flag (set via platform.h at compile time) ensuring no code built in unthreaded mode
 
@@ -275,6 +276,7 @@ me at: heber.tomer@gmail.com
 		struct threadpool *pool = init->pool;
 		thread_control_t *t = &init->control;
 		task_control_t *task;
+		uint64 perf_snap[PERF_NEVENT];
 
 		// Set CPU affinity masks of the thread:
 	#ifdef __OpenBSD__
@@ -448,8 +450,11 @@ me at: heber.tomer@gmail.com
 			if (task->init != NULL)
 				task->init(task->data, my_id);
 
-			if (task->run != NULL)
+			if (task->run != NULL) {
+				if (PERF_COUNTERS) perf_read(perf_snap);
 				task->run(task->data, my_id);
+				if (PERF_COUNTERS) perf_task_end(my_id, perf_snap);
+			}
 
 			if (task->shutdown != NULL)
 				task->shutdown(task->data, my_id);
@@ -195,9 +195,10 @@ int threadpool_drain(struct threadpool *pool,
 
 /********************* utility macros: ********************/
 
-// Don't use any of these at present, but note MacOS has its own versions of these, in /usr/include/X11/Xthreads.h:
+// Don't use any of these at present, but note MacOS has its own versions of these, in /usr/include/X11/Xthreads.h.
+// Declared inline so the many TUs which include this header but never call them don't draw -Wunused-function warnings:
 #if 1
-	static void * xmalloc(size_t len) {
+	static inline void * xmalloc(size_t len) {
 		void *ptr = malloc(len);
 		if (ptr == NULL) {
 			printf("failed to allocate %u bytes\n", (uint32)len);
@@ -206,7 +207,7 @@ int threadpool_drain(struct threadpool *pool,
 		return ptr;
 	}
 	
-	static void * xcalloc(size_t num, size_t len) {
+	static inline void * xcalloc(size_t num, size_t len) {
 		void *ptr = calloc(num, len);
 		if (ptr == NULL) {
 			printf("failed to calloc %u bytes\n", (uint32)(num * len));
@@ -215,7 +216,7 @@ int threadpool_drain(struct threadpool *pool,
 		return ptr;
 	}
 	
-	static void * xrealloc(void *iptr, size_t len) {
+	static inline void * xrealloc(void *iptr, size_t len) {
 		void *ptr = realloc(iptr, len);
 		if (ptr == NULL) {
 			printf("failed to reallocate %u bytes\n", (uint32)len);
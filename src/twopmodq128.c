@@ -964,6 +964,158 @@ uint64 twopmodq128_q4(uint64* p_in, uint64 k0, uint64 k1, uint64 k2, uint64 k3)
 	return(r);
 }
 
+/*** 4-trial-factor version specialized to Fermat-number moduli q = 2.k.2^n + 1 = k.2^s + 1, s = n+1 >= 64:
+In this case t = k.2^s has t^2 == 0 (mod 2^128), thus qinv = 1-t = 2-q (mod 2^128) and the Montgomery-mul
+MULL128(lo,qinv) reduces to lo - (lo.k << s), of which only the low word of lo.k is needed. Similarly,
+UMULH128(q,y) = (k.y.2^s + y) >> 128 needs just the 192-bit product k.y, a shift and a carry, i.e.
+we need 3+1+2 = 6 64-bit MULs per modsquare versus 3+3+4 for the generic twopmodq128_q4.
+The caller must ensure that n >= 63; [r] in the macros below is s-64, in [0,63]:
+***/
+// lo - (lo.k << s) (mod 2^128); in-place OK:
+#define MULL128_QFERM(__lo,__k,__r,__out)\
+{\
+	uint64 __t = (__lo.d0*__k) << __r;\
+	__out.d0 = __lo.d0;	__out.d1 = __lo.d1 - __t;\
+}
+// (k.y.2^s + y) >> 128; in-place OK. The (x >> 1) >> (63-r) idiom gives x >> (64-r) for r in [0,63]:
+#define MULH128_QFERM(__y,__k,__r,__out)\
+{\
+	uint64 __p0,__p1,__p2,__lo,__hi,__cy;\
+	MUL_LOHI64(__k, __y.d0, __p0, __cy);\
+	MUL_LOHI64(__k, __y.d1, __lo, __hi);\
+	__p1 = __lo + __cy;	__p2 = __hi + (__p1 < __lo);\
+	/* Carry out of the low half of k.y.2^s + y, whose lone nonzero word from k.y.2^s is p0 << r: */\
+	__lo = (__p0 << __r) + __y.d1;	__cy = (__lo < __y.d1);\
+	__out.d0 = (__p1 << __r) + ((__p0 >> 1) >> (63-__r)) + __cy;\
+	__out.d1 = (__p2 << __r) + ((__p1 >> 1) >> (63-__r)) + (__out.d0 < __cy);\
+}
+
+uint64 twopmodq128_q4_qferm(uint64 *p_in, uint64 k0, uint64 k1, uint64 k2, uint64 k3)
+{
+	 int32 j;
+	uint64 lead7, r;
+	uint128 p, q0, q1, q2, q3
+		, qinv0, qinv1, qinv2, qinv3
+		, qhalf0, qhalf1, qhalf2, qhalf3
+		, x0, x1, x2, x3
+		, lo0, lo1, lo2, lo3
+		, hi0, hi1, hi2, hi3;
+	static uint128 psave = {0ull,0ull}, pshift;
+	static uint32 start_index, zshift, rshift, first_entry = TRUE;
+
+	p.d0 = p_in[0]; p.d1 = p_in[1];
+	if(first_entry || !CMPEQ128(p, psave))
+	{
+		first_entry = FALSE;
+		psave = p;
+		// Check that p = 2^n with n >= 63:
+		ASSERT(p.d1 ? (isPow2_64(p.d1) && p.d0 == 0ull) : (p.d0 == 0x8000000000000000ull), "twopmodq128_q4_qferm: p must be 2^n with n >= 63!");
+		rshift = mi64_trailz(p_in,2) + 1 - 64;
+		pshift.d0 = p_in[0] + 128;	pshift.d1 = p_in[1] + (pshift.d0 < 128);
+		/* Extract leftmost 7 bits of pshift and subtract from 128: */
+		if(pshift.d1)
+		{
+			j = leadz64(pshift.d1);
+			lead7 = (((pshift.d1<<j) + (pshift.d0>>(64-j))) >> 57);
+			start_index = 128-j-7;
+			pshift.d1 = ~pshift.d1;
+		}
+		else
+		{
+			j = leadz64(pshift.d0);
+			lead7 = ((pshift.d0<<j) >> 57);
+			start_index =  64-j-7;
+		}
+		pshift.d0 = ~pshift.d0;
+  		zshift = 127 - lead7;
+		zshift <<= 1;				/* Doubling the shift count here takes cares of the first SQR_LOHI */
+	}
+
+	/* q = k.2^s + 1 is a single-word shift; the ASSERTs catch k.2^s >= 2^128: */
+	ASSERT((k0 >> 1 >> (63-rshift)) == 0ull, "q must be < 2^128!");	q0.d0 = 1ull;	q0.d1 = k0 << rshift;
+	ASSERT((k1 >> 1 >> (63-rshift)) == 0ull, "q must be < 2^128!");	q1.d0 = 1ull;	q1.d1 = k1 << rshift;
+	ASSERT((k2 >> 1 >> (63-rshift)) == 0ull, "q must be < 2^128!");	q2.d0 = 1ull;	q2.d1 = k2 << rshift;
+	ASSERT((k3 >> 1 >> (63-rshift)) == 0ull, "q must be < 2^128!");	q3.d0 = 1ull;	q3.d1 = k3 << rshift;
+
+	RSHIFT_FAST128(q0, 1, qhalf0);	/* = (q-1)/2, since q odd. */
+	RSHIFT_FAST128(q1, 1, qhalf1);
+	RSHIFT_FAST128(q2, 1, qhalf2);
+	RSHIFT_FAST128(q3, 1, qhalf3);
+
+	// No Newton iteration needed for the modular inverse (mod 2^128) of q:
+	SUB128(TWO128, q0, qinv0);
+	SUB128(TWO128, q1, qinv1);
+	SUB128(TWO128, q2, qinv2);
+	SUB128(TWO128, q3, qinv3);
+
+	/* Since zstart is a power of two < 2^128, use a streamlined code sequence for the first iteration: */
+	j = start_index-1;
+
+	/* MULL128(zstart,qinv,lo) simply amounts to a left-shift of the bits of qinv: */
+	LSHIFT128(qinv0, zshift, lo0);	MULH128_QFERM(lo0,k0,rshift,lo0);
+	LSHIFT128(qinv1, zshift, lo1);	MULH128_QFERM(lo1,k1,rshift,lo1);
+	LSHIFT128(qinv2, zshift, lo2);	MULH128_QFERM(lo2,k2,rshift,lo2);
+	LSHIFT128(qinv3, zshift, lo3);	MULH128_QFERM(lo3,k3,rshift,lo3);
+
+	/* hi = 0 in this instance, which simplifies things. */
+	SUB128(q0, lo0, x0);
+	SUB128(q1, lo1, x1);
+	SUB128(q2, lo2, x2);
+	SUB128(q3, lo3, x3);
+
+	if(TEST_BIT128(pshift, j))
+	{
+		/* Combines overflow-on-add and need-to-subtract-q-from-sum checks */
+		if(CMPUGT128(x0, qhalf0)){ ADD128(x0, x0, x0); SUB128(x0, q0, x0); }else{ ADD128(x0, x0, x0); }
+		if(CMPUGT128(x1, qhalf1)){ ADD128(x1, x1, x1); SUB128(x1, q1, x1); }else{ ADD128(x1, x1, x1); }
+		if(CMPUGT128(x2, qhalf2)){ ADD128(x2, x2, x2); SUB128(x2, q2, x2); }else{ ADD128(x2, x2, x2); }
+		if(CMPUGT128(x3, qhalf3)){ ADD128(x3, x3, x3); SUB128(x3, q3, x3); }else{ ADD128(x3, x3, x3); }
+	}
+
+	for(j = start_index-2; j >= 0; j--)
+	{
+		SQR_LOHI128_q4(
+		  x0, lo0, hi0
+		, x1, lo1, hi1
+		, x2, lo2, hi2
+		, x3, lo3, hi3);
+
+		MULL128_QFERM(lo0,k0,rshift,lo0);	MULH128_QFERM(lo0,k0,rshift,lo0);
+		MULL128_QFERM(lo1,k1,rshift,lo1);	MULH128_QFERM(lo1,k1,rshift,lo1);
+		MULL128_QFERM(lo2,k2,rshift,lo2);	MULH128_QFERM(lo2,k2,rshift,lo2);
+		MULL128_QFERM(lo3,k3,rshift,lo3);	MULH128_QFERM(lo3,k3,rshift,lo3);
+
+		/* If h < l, then calculate q-l+h < q; otherwise calculate h-l. */
+		if(CMPULT128(hi0, lo0)) { SUB128(q0, lo0, lo0);	ADD128(lo0, hi0, x0); } else { SUB128(hi0, lo0, x0); }
+		if(CMPULT128(hi1, lo1)) { SUB128(q1, lo1, lo1);	ADD128(lo1, hi1, x1); } else { SUB128(hi1, lo1, x1); }
+		if(CMPULT128(hi2, lo2)) { SUB128(q2, lo2, lo2);	ADD128(lo2, hi2, x2); } else { SUB128(hi2, lo2, x2); }
+		if(CMPULT128(hi3, lo3)) { SUB128(q3, lo3, lo3);	ADD128(lo3, hi3, x3); } else { SUB128(hi3, lo3, x3); }
+
+		if(TEST_BIT128(pshift, j))
+		{
+			/* Combines overflow-on-add and need-to-subtract-q-from-sum checks */
+			if(CMPUGT128(x0, qhalf0)){ ADD128(x0, x0, x0); SUB128(x0, q0, x0); }else{ ADD128(x0, x0, x0); }
+			if(CMPUGT128(x1, qhalf1)){ ADD128(x1, x1, x1); SUB128(x1, q1, x1); }else{ ADD128(x1, x1, x1); }
+			if(CMPUGT128(x2, qhalf2)){ ADD128(x2, x2, x2); SUB128(x2, q2, x2); }else{ ADD128(x2, x2, x2); }
+			if(CMPUGT128(x3, qhalf3)){ ADD128(x3, x3, x3); SUB128(x3, q3, x3); }else{ ADD128(x3, x3, x3); }
+		}
+	}
+
+	/*...Double and return. q divides F(n) iff 2^p == -1 (mod q), in which case x = (q-1)/2, i.e. 2.x = q-1.
+	Since x < q < 2^128, an overflowing 2.x would be >= 2^128 + q-1 and thus cannot spoof a match:
+	*/
+	ADD128(x0 ,x0, x0);
+	ADD128(x1 ,x1, x1);
+	ADD128(x2 ,x2, x2);
+	ADD128(x3 ,x3, x3);
+	r = 0;
+	if(x0.d0 == 0ull) r += ((uint64)(x0.d1 == q0.d1) << 0);
+	if(x1.d0 == 0ull) r += ((uint64)(x1.d1 == q1.d1) << 1);
+	if(x2.d0 == 0ull) r += ((uint64)(x2.d1 == q2.d1) << 2);
+	if(x3.d0 == 0ull) r += ((uint64)(x3.d1 == q3.d1) << 3);
+	return(r);
+}
+
 /*** 8-trial-factor version ***/
 uint64 twopmodq128_q8(uint64 *p_in, uint64 k0, uint64 k1, uint64 k2, uint64 k3, uint64 k4, uint64 k5, uint64 k6, uint64 k7)
 {
@@ -1132,6 +1132,202 @@ if(dbg) {
 	return(r);
 }
 
+/*** 4-trial-factor version specialized to Fermat-number moduli q = 2.k.2^n + 1 = k.2^s + 1, s = n+1 >= 96,
+analogous to twopmodq128_q4_qferm: t = k.2^s has t^2 == 0 (mod 2^192), thus qinv = 2-q (mod 2^192) and
+MULL192(lo,qinv) = lo - (lo.k << s), which needs just the low 128 bits of lo.k; UMULH192(q,y) = (k.y.2^s + y) >> 192
+needs the 256-bit product k.y, a shift and a carry. That is 6+2+3 = 11 64-bit MULs per modsquare versus 6+6+9
+for the generic twopmodq192_q4. In the macros below s = 64.w + r with w = 1 or 2, r in [0,63]:
+***/
+// lo - (lo.k << s) (mod 2^192); in-place OK:
+#define MULL192_QFERM(__lo,__k,__w,__r,__out)\
+{\
+	uint64 __u0,__u1;\
+	if(__w == 2) {\
+		__u0 = (__lo.d0*__k) << __r;\
+		__out.d0 = __lo.d0;	__out.d1 = __lo.d1;	__out.d2 = __lo.d2 - __u0;\
+	} else {\
+		MUL_LOHI64(__lo.d0, __k, __u0, __u1);	__u1 += __lo.d1*__k;\
+		__u1 = (__u1 << __r) + ((__u0 >> 1) >> (63-__r));	__u0 <<= __r;\
+		__out.d0 = __lo.d0;	__out.d2 = __lo.d2 - __u1 - (__lo.d1 < __u0);	__out.d1 = __lo.d1 - __u0;\
+	}\
+}
+// (k.y.2^s + y) >> 192; in-place OK. With Q = (k.y) << r, k.y.2^s = Q.2^(64.w):
+#define MULH192_QFERM(__y,__k,__w,__r,__out)\
+{\
+	uint64 __p0,__p1,__p2,__p3,__lo,__hi,__cy, __q0,__q1,__q2,__q3,__q4;\
+	MUL_LOHI64(__k, __y.d0, __p0, __cy);\
+	MUL_LOHI64(__k, __y.d1, __lo, __hi);\
+	__p1 = __lo + __cy;	__cy = __hi + (__p1 < __lo);\
+	MUL_LOHI64(__k, __y.d2, __lo, __hi);\
+	__p2 = __lo + __cy;	__p3 = __hi + (__p2 < __lo);\
+	__q0 = (__p0 << __r);\
+	__q1 = (__p1 << __r) + ((__p0 >> 1) >> (63-__r));\
+	__q2 = (__p2 << __r) + ((__p1 >> 1) >> (63-__r));\
+	__q3 = (__p3 << __r) + ((__p2 >> 1) >> (63-__r));\
+	if(__w == 2) {\
+		/* Low 192 bits of Q.2^128 + y: carry out of Q0 + y2: */\
+		__lo = __q0 + __y.d2;	__cy = (__lo < __y.d2);\
+		__out.d0 = __q1 + __cy;	__cy = (__out.d0 < __cy);\
+		__out.d1 = __q2 + __cy;	__cy = (__out.d1 < __cy);\
+		__out.d2 = __q3 + __cy;\
+	} else {\
+		__q4 = (__p3 >> 1) >> (63-__r);\
+		/* Low 192 bits of Q.2^64 + y: carry out of (Q0 + y1, Q1 + y2): */\
+		__lo = __q0 + __y.d1;	__cy = (__lo < __y.d1);\
+		__lo = __q1 + __cy;	__cy = (__lo < __cy);\
+		__lo += __y.d2;	__cy += (__lo < __y.d2);\
+		__out.d0 = __q2 + __cy;	__cy = (__out.d0 < __cy);\
+		__out.d1 = __q3 + __cy;	__cy = (__out.d1 < __cy);\
+		__out.d2 = __q4 + __cy;\
+	}\
+}
+
+uint64 twopmodq192_q4_qferm(uint64 *p_in, uint64 k0, uint64 k1, uint64 k2, uint64 k3)
+{
+	 int32 j;	/* This needs to be signed because of the LR binary exponentiation. */
+	uint64 lead8, r;
+	uint192 p, q0, q1, q2, q3
+			, qinv0, qinv1, qinv2, qinv3
+			, qhalf0, qhalf1, qhalf2, qhalf3
+			, x0, x1, x2, x3
+			, lo0, lo1, lo2, lo3
+			, hi0, hi1, hi2, hi3;
+	uint192 x;
+	static uint192 psave = {0ull,0ull,0ull}, pshift;
+	static uint32 start_index, zshift, wshift, rshift, first_entry = TRUE;
+
+	p.d0 = p_in[0]; p.d1 = p_in[1]; p.d2 = p_in[2];
+	if(first_entry || !CMPEQ192(p, psave))
+	{
+		first_entry = FALSE;
+		psave  = p;
+		// Check that p = 2^n with 95 <= n <= 190:
+		j = mi64_trailz(p_in,3);
+		ASSERT(j >= 95 && j <= 190 && mi64_leadz(p_in,3) == 191-j, "twopmodq192_q4_qferm: p must be 2^n with 95 <= n <= 190!");
+		wshift = (j+1) >> 6;	rshift = (j+1) & 63;
+		x.d0 = 192; x.d1 = x.d2 = 0;
+		ADD192(p, x, pshift);
+		if(pshift.d2)
+		{
+			j = leadz64(pshift.d2);
+			/* Extract leftmost 8 bits of pshift (if > 191, use the leftmost 7) and subtract from 192: */
+			lead8 = (((pshift.d2<<j) + (pshift.d1>>(64-j))) >> 56);
+			if(lead8 > 191)
+			{
+				lead8 >>= 1;
+				start_index = 192-j-7;	/* Use only the leftmost 7 bits */
+			}
+			else
+				start_index = 192-j-8;
+		}
+		else
+		{
+			j = leadz64(pshift.d1);
+			/* Extract leftmost 8 bits of pshift (if > 191, use the leftmost 7) and subtract from 192: */
+			lead8 = (((pshift.d1<<j) + (pshift.d0>>(64-j))) >> 56);
+			if(lead8 > 191)
+			{
+				lead8 >>= 1;
+				start_index = 128-j-7;	/* Use only the leftmost 7 bits */
+			}
+			else
+				start_index = 128-j-8;
+		}
+
+  		zshift = 191 - lead8;
+		zshift <<= 1;				/* Doubling the shift count here takes cares of the first SQR_LOHI */
+
+		pshift.d2 = ~pshift.d2;	pshift.d1 = ~pshift.d1;	pshift.d0 = ~pshift.d0;
+	}
+
+	/* q = k.2^s + 1 = k.2^r in word w, plus 1; the ASSERTs catch k.2^s >= 2^192: */
+	x.d0 = x.d1 = x.d2 = 0ull;
+	if(wshift == 2) {
+		ASSERT(((k0|k1|k2|k3) >> 1 >> (63-rshift)) == 0ull, "q must be < 2^192!");
+		q0 = x;	q0.d2 = k0 << rshift;
+		q1 = x;	q1.d2 = k1 << rshift;
+		q2 = x;	q2.d2 = k2 << rshift;
+		q3 = x;	q3.d2 = k3 << rshift;
+	} else {
+		q0 = x;	q0.d1 = k0 << rshift;	q0.d2 = (k0 >> 1) >> (63-rshift);
+		q1 = x;	q1.d1 = k1 << rshift;	q1.d2 = (k1 >> 1) >> (63-rshift);
+		q2 = x;	q2.d1 = k2 << rshift;	q2.d2 = (k2 >> 1) >> (63-rshift);
+		q3 = x;	q3.d1 = k3 << rshift;	q3.d2 = (k3 >> 1) >> (63-rshift);
+	}
+	q0.d0 = q1.d0 = q2.d0 = q3.d0 = 1ull;
+
+	RSHIFT_FAST192(q0, 1, qhalf0);	/* = (q-1)/2, since q odd. */
+	RSHIFT_FAST192(q1, 1, qhalf1);
+	RSHIFT_FAST192(q2, 1, qhalf2);
+	RSHIFT_FAST192(q3, 1, qhalf3);
+
+	// No Newton iteration needed for the modular inverse (mod 2^192) of q:
+	SUB192(TWO192, q0, qinv0);
+	SUB192(TWO192, q1, qinv1);
+	SUB192(TWO192, q2, qinv2);
+	SUB192(TWO192, q3, qinv3);
+
+	/* Since zstart is a power of two < 2^192, use a streamlined code sequence for the first iteration: */
+	j = start_index-1;
+
+	/* MULL192(zstart,qinv,lo) simply amounts to a left-shift of the bits of qinv.
+	hi = 0 in this instance, which simplifies things in the final subtract step.
+	*/
+	LSHIFT192(qinv0, zshift, x0);	MULH192_QFERM(x0,k0,wshift,rshift,lo0);	SUB192(q0, lo0, x0);
+	LSHIFT192(qinv1, zshift, x1);	MULH192_QFERM(x1,k1,wshift,rshift,lo1);	SUB192(q1, lo1, x1);
+	LSHIFT192(qinv2, zshift, x2);	MULH192_QFERM(x2,k2,wshift,rshift,lo2);	SUB192(q2, lo2, x2);
+	LSHIFT192(qinv3, zshift, x3);	MULH192_QFERM(x3,k3,wshift,rshift,lo3);	SUB192(q3, lo3, x3);
+
+	if(TEST_BIT192(pshift, j))
+	{
+		/* Combines overflow-on-add and need-to-subtract-q-from-sum checks */
+		if(CMPUGT192(x0, qhalf0)){ ADD192(x0, x0, x0); SUB192(x0, q0, x0); }else{ ADD192(x0, x0, x0); }
+		if(CMPUGT192(x1, qhalf1)){ ADD192(x1, x1, x1); SUB192(x1, q1, x1); }else{ ADD192(x1, x1, x1); }
+		if(CMPUGT192(x2, qhalf2)){ ADD192(x2, x2, x2); SUB192(x2, q2, x2); }else{ ADD192(x2, x2, x2); }
+		if(CMPUGT192(x3, qhalf3)){ ADD192(x3, x3, x3); SUB192(x3, q3, x3); }else{ ADD192(x3, x3, x3); }
+	}
+
+	for(j = start_index-2; j >= 0; j--)
+	{
+		SQR_LOHI192(x0,lo0,hi0);
+		SQR_LOHI192(x1,lo1,hi1);
+		SQR_LOHI192(x2,lo2,hi2);
+		SQR_LOHI192(x3,lo3,hi3);
+
+		MULL192_QFERM(lo0,k0,wshift,rshift,lo0);	MULH192_QFERM(lo0,k0,wshift,rshift,lo0);
+		MULL192_QFERM(lo1,k1,wshift,rshift,lo1);	MULH192_QFERM(lo1,k1,wshift,rshift,lo1);
+		MULL192_QFERM(lo2,k2,wshift,rshift,lo2);	MULH192_QFERM(lo2,k2,wshift,rshift,lo2);
+		MULL192_QFERM(lo3,k3,wshift,rshift,lo3);	MULH192_QFERM(lo3,k3,wshift,rshift,lo3);
+
+		/* If h < l, then calculate q-l+h < q; otherwise calculate h-l. */
+		if(CMPULT192(hi0, lo0)) { SUB192(q0, lo0, lo0);	ADD192(lo0, hi0, x0); } else { SUB192(hi0, lo0, x0); }
+		if(CMPULT192(hi1, lo1)) { SUB192(q1, lo1, lo1);	ADD192(lo1, hi1, x1); } else { SUB192(hi1, lo1, x1); }
+		if(CMPULT192(hi2, lo2)) { SUB192(q2, lo2, lo2);	ADD192(lo2, hi2, x2); } else { SUB192(hi2, lo2, x2); }
+		if(CMPULT192(hi3, lo3)) { SUB192(q3, lo3, lo3);	ADD192(lo3, hi3, x3); } else { SUB192(hi3, lo3, x3); }
+
+		if(TEST_BIT192(pshift, j))
+		{
+			/* Combines overflow-on-add and need-to-subtract-q-from-sum checks */
+			if(CMPUGT192(x0, qhalf0)){ ADD192(x0, x0, x0); SUB192(x0, q0, x0); }else{ ADD192(x0, x0, x0); }
+			if(CMPUGT192(x1, qhalf1)){ ADD192(x1, x1, x1); SUB192(x1, q1, x1); }else{ ADD192(x1, x1, x1); }
+			if(CMPUGT192(x2, qhalf2)){ ADD192(x2, x2, x2); SUB192(x2, q2, x2); }else{ ADD192(x2, x2, x2); }
+			if(CMPUGT192(x3, qhalf3)){ ADD192(x3, x3, x3); SUB192(x3, q3, x3); }else{ ADD192(x3, x3, x3); }
+		}
+	}
+
+	/*...Double and return. q divides F(n) iff 2^p == -1 (mod q), in which case 2.x = q-1 (cf. twopmodq128_q4_qferm): */
+	ADD192(x0 ,x0, x0);
+	ADD192(x1 ,x1, x1);
+	ADD192(x2 ,x2, x2);
+	ADD192(x3 ,x3, x3);
+	r = 0;
+	if(x0.d0 == 0ull) r += ((uint64)(x0.d1 == q0.d1 && x0.d2 == q0.d2) << 0);
+	if(x1.d0 == 0ull) r += ((uint64)(x1.d1 == q1.d1 && x1.d2 == q1.d2) << 1);
+	if(x2.d0 == 0ull) r += ((uint64)(x2.d1 == q2.d1 && x2.d2 == q2.d2) << 2);
+	if(x3.d0 == 0ull) r += ((uint64)(x3.d1 == q3.d1 && x3.d2 == q3.d2) << 3);
+	return(r);
+}
+
 /*** 8-trial-factor version ***/
 uint64 twopmodq192_q8(uint64 *p_in, uint64 k0, uint64 k1, uint64 k2, uint64 k3, uint64 k4, uint64 k5, uint64 k6, uint64 k7)
 {
@@ -187,10 +187,12 @@ x0 = 15135097; x1 = 6567697; x2 = 59027372; x=x0+a*x1+b*x2
 y0 = 22129433; y1 = -21457855; y2 = 15218570; y=y0+a*y1+b*y2
 z0 = 6272576; z12 = 898312175313603; z=z0+a*z12	<*** z0 is +1 too large ***
 #endif
-			/* If h < l, then calculate q+(h-l) < q; otherwise calculate h-l. */
-			fidx  = (fx1 < flohi52);
+			/* If h < l, then calculate q+(h-l) < q; otherwise calculate h-l. Comparing just the high 52 bits of h and l
+			misses the h < l cases with equal high parts, which are common for small q. The difference of the
+			high parts is an exact integer, so the full (h-l)-sign test is exact: */
 			fx1  -= flohi52;
 			fhi0 -= flo0;
+			fidx  = (fx1*TWO26FLOAT + fhi0 < 0);
 			fx1  +=        fq_or_nil_hi52[fidx];
 			fx0   = fhi0 + fq_or_nil_lo26[fidx];
 		/*
@@ -498,12 +500,8 @@ z0 = 6272576; z12 = 898312175313603; z=z0+a*z12	<*** z0 is +1 too large ***
 				, iq0,iq1,iq2, ilo0,ilo1,ilo2, ilo0,ilohi52
 			);
 
-			/* If h < l, then calculate q+(h-l) < q; otherwise calculate h-l. */
-			fidx = (fx1 < flohi52);
-			gidx = (gx1 < glohi52);
-			hidx = (hx1 < hlohi52);
-			iidx = (ix1 < ilohi52);
-
+			/* If h < l, then calculate q+(h-l) < q; otherwise calculate h-l. Need the sign of the full difference here,
+			not just a compare of the high 52 bits - see twopmodq78_gpu(): */
 			fx1 -= flohi52;
 			gx1 -= glohi52;
 			hx1 -= hlohi52;
@@ -514,6 +512,11 @@ z0 = 6272576; z12 = 898312175313603; z=z0+a*z12	<*** z0 is +1 too large ***
 			hhi0 -= hlo0;
 			ihi0 -= ilo0;
 
+			fidx = (fx1*TWO26FLOAT + fhi0 < 0);
+			gidx = (gx1*TWO26FLOAT + ghi0 < 0);
+			hidx = (hx1*TWO26FLOAT + hhi0 < 0);
+			iidx = (ix1*TWO26FLOAT + ihi0 < 0);
+
 			fx1 += fq_or_nil_hi52[fidx];
 			gx1 += gq_or_nil_hi52[gidx];
 			hx1 += hq_or_nil_hi52[hidx];
@@ -984,7 +987,7 @@ if(~pshift != p+78) {
 	MUL_LOHI64(lo.d0, (uint64)qmul, lo.d0, hi64);
 #endif
 	lo.d1 = hi64 + qmul*lo.d1;
-	lo.d0 -= FERMAT;
+	x.d0 += FERMAT;	// Not lo -= FERMAT, which can borrow from the high limb - cf. the Aug 2022 note in twopmodq96()
 	SUB96(x,lo,x);
 #if FAC_DEBUG
 	if(dbg) {
@@ -993,7 +996,9 @@ if(~pshift != p+78) {
 #endif
 } else {
 	ADD96(x,x,x);	/* In the case of interest, x = (q+1)/2 < 2^95, so x + x cannot overflow. */
-	q.d0 -= FERMAT;
+	// Fermat-factor q of F62 and up have q.d0 = 1, so q -= FERMAT would borrow from the high limb. Since we only care
+	// about the case x == q-1, do x += FERMAT without worrying about any carry instead - cf. the Aug 2022 note in twopmodq96():
+	x.d0 += FERMAT;
 	SUB96(x,q,x);
 #if FAC_DEBUG
 	if(dbg) {
@@ -1898,8 +1903,8 @@ if(~pshift != p+78) {
 	#endif
 		ADD96(x0,x0,x0);	/* In the case of interest, x = (q+1)/2 < 2^95, so x + x cannot overflow. */
 		ADD96(x1,x1,x1);
-		q0.d0 -= FERMAT;
-		q1.d0 -= FERMAT;
+		x0.d0 += FERMAT;	// Not q -= FERMAT, which borrows from the high limb for q.d0 = 1 - see twopmodq78_3WORD_DOUBLE()
+		x1.d0 += FERMAT;
 		SUB96(x0,q0,x0);
 		SUB96(x1,q1,x1);
 
@@ -2450,12 +2455,8 @@ if(~pshift != p+78) {
 				, iq0,iq1,iq2, ilo0,ilo1,ilo2, ilo0,ilohi52
 			);
 
-			/* If h < l, then calculate q+(h-l) < q; otherwise calculate h-l. */
-			fidx = (fx1 < flohi52);
-			gidx = (gx1 < glohi52);
-			hidx = (hx1 < hlohi52);
-			iidx = (ix1 < ilohi52);
-
+			/* If h < l, then calculate q+(h-l) < q; otherwise calculate h-l. Need the sign of the full difference here,
+			not just a compare of the high 52 bits - see twopmodq78_gpu(): */
 			fx1 -= flohi52;
 			gx1 -= glohi52;
 			hx1 -= hlohi52;
@@ -2466,6 +2467,11 @@ if(~pshift != p+78) {
 			hhi0 -= hlo0;
 			ihi0 -= ilo0;
 
+			fidx = (fx1*TWO26FLOAT + fhi0 < 0);
+			gidx = (gx1*TWO26FLOAT + ghi0 < 0);
+			hidx = (hx1*TWO26FLOAT + hhi0 < 0);
+			iidx = (ix1*TWO26FLOAT + ihi0 < 0);
+
 			fx1 += fq_or_nil_hi52[fidx];
 			gx1 += gq_or_nil_hi52[gidx];
 			hx1 += hq_or_nil_hi52[hidx];
@@ -2983,10 +2989,10 @@ if(~pshift != p+78) {
 		ADD96(x1,x1,x1);
 		ADD96(x2,x2,x2);
 		ADD96(x3,x3,x3);
-		q0.d0 -= FERMAT;
-		q1.d0 -= FERMAT;
-		q2.d0 -= FERMAT;
-		q3.d0 -= FERMAT;
+		x0.d0 += FERMAT;	// Not q -= FERMAT, which borrows from the high limb for q.d0 = 1 - see twopmodq78_3WORD_DOUBLE()
+		x1.d0 += FERMAT;
+		x2.d0 += FERMAT;
+		x3.d0 += FERMAT;
 		SUB96(x0,q0,x0);
 		SUB96(x1,q1,x1);
 		SUB96(x2,q2,x2);
@@ -3297,10 +3303,10 @@ if(~pshift != p+78) {
 		ADD96(x1,x1,x1);
 		ADD96(x2,x2,x2);
 		ADD96(x3,x3,x3);
-		q0.d0 -= FERMAT;
-		q1.d0 -= FERMAT;
-		q2.d0 -= FERMAT;
-		q3.d0 -= FERMAT;
+		x0.d0 += FERMAT;	// Not q -= FERMAT, which borrows from the high limb for q.d0 = 1 - see twopmodq78_3WORD_DOUBLE()
+		x1.d0 += FERMAT;
+		x2.d0 += FERMAT;
+		x3.d0 += FERMAT;
 		SUB96(x0,q0,x0);
 		SUB96(x1,q1,x1);
 		SUB96(x2,q2,x2);
@@ -3892,12 +3898,11 @@ if(~pshift != p+78) {
 			ADD96(x1,x1,x1);			ADD96(x5,x5,x5);
 			ADD96(x2,x2,x2);			ADD96(x6,x6,x6);
 			ADD96(x3,x3,x3);			ADD96(x7,x7,x7);
-			if(FERMAT) {
-				q0.d0 -= 2;		q4.d0 -= 2;
-				q1.d0 -= 2;		q5.d0 -= 2;
-				q2.d0 -= 2;		q6.d0 -= 2;
-				q3.d0 -= 2;		q7.d0 -= 2;
-			}
+			// Not q -= FERMAT, which borrows from the high limb for q.d0 = 1 - see twopmodq78_3WORD_DOUBLE():
+			x0.d0 += FERMAT;	x4.d0 += FERMAT;
+			x1.d0 += FERMAT;	x5.d0 += FERMAT;
+			x2.d0 += FERMAT;	x6.d0 += FERMAT;
+			x3.d0 += FERMAT;	x7.d0 += FERMAT;
 			SUB96(x0,q0,x0);	SUB96(x4,q4,x4);
 			SUB96(x1,q1,x1);	SUB96(x5,q5,x5);
 			SUB96(x2,q2,x2);	SUB96(x6,q6,x6);
@@ -4777,10 +4782,10 @@ if(~pshift != p+78) {
 			MUL_LOHI64(q1.d0,(uint64)qmul1 ,lo1.d0, tmp1);
 			MUL_LOHI64(q2.d0,(uint64)qmul2 ,lo2.d0, tmp2);
 			MUL_LOHI64(q3.d0,(uint64)qmul3 ,lo3.d0, tmp3);
-			lo0.d1 = tmp0 + qmul0*q0.d1;	lo0.d0 -= FERMAT;
-			lo1.d1 = tmp1 + qmul1*q1.d1;	lo1.d0 -= FERMAT;
-			lo2.d1 = tmp2 + qmul2*q2.d1;	lo2.d0 -= FERMAT;
-			lo3.d1 = tmp3 + qmul3*q3.d1;	lo3.d0 -= FERMAT;
+			lo0.d1 = tmp0 + qmul0*q0.d1;	x0.d0 += FERMAT;	// Not lo -= FERMAT, which can borrow from the high limb
+			lo1.d1 = tmp1 + qmul1*q1.d1;	x1.d0 += FERMAT;
+			lo2.d1 = tmp2 + qmul2*q2.d1;	x2.d0 += FERMAT;
+			lo3.d1 = tmp3 + qmul3*q3.d1;	x3.d0 += FERMAT;
 			SUB96(x0,lo0,x0);
 			SUB96(x1,lo1,x1);
 			SUB96(x2,lo2,x2);
@@ -4790,12 +4795,10 @@ if(~pshift != p+78) {
 			ADD96(x1,x1,x1);
 			ADD96(x2,x2,x2);
 			ADD96(x3,x3,x3);
-			if(FERMAT) {
-				q0.d0 -= 2;
-				q1.d0 -= 2;
-				q2.d0 -= 2;
-				q3.d0 -= 2;
-			}
+			x0.d0 += FERMAT;	// Not q -= FERMAT, which borrows from the high limb for q.d0 = 1 - see twopmodq78_3WORD_DOUBLE()
+			x1.d0 += FERMAT;
+			x2.d0 += FERMAT;
+			x3.d0 += FERMAT;
 			SUB96(x0,q0,x0);
 			SUB96(x1,q1,x1);
 			SUB96(x2,q2,x2);
@@ -4807,10 +4810,11 @@ if(~pshift != p+78) {
 			ADD96_PTR(x6 ,x6, x6);
 			ADD96_PTR(x7 ,x7, x7);
 
-			SUB96_PTR(x4,(qptr4-FERMAT),x4);
-			SUB96_PTR(x5,(qptr5-FERMAT),x5);
-			SUB96_PTR(x6,(qptr6-FERMAT),x6);
-			SUB96_PTR(x7,(qptr7-FERMAT),x7);
+			// qptr4-FERMAT would offset the pointer, not the value pointed to, so add FERMAT to x instead:
+			x4->d0 += FERMAT;	SUB96_PTR(x4,qptr4,x4);
+			x5->d0 += FERMAT;	SUB96_PTR(x5,qptr5,x5);
+			x6->d0 += FERMAT;	SUB96_PTR(x6,qptr6,x6);
+			x7->d0 += FERMAT;	SUB96_PTR(x7,qptr7,x7);
 
 			tmp0 = CMPEQ96(x0, ONE96);
 			tmp1 = CMPEQ96(x1, ONE96);
@@ -5346,7 +5350,7 @@ if(~pshift != p+78) {
 				CVT78_3WORD_DOUBLE_UINT96(*fx0[j],*fx1[j],*fx2[j], x[j]);
 				// In the case of interest, x = (q+1)/2 < 2^95, so x + x cannot overflow:
 				ADD96(x[j],x[j],x[j]);
-				q[j].d0 -= FERMAT;	// += 2 of result (achieve by q -= 2, and then sub-q from x) if Fermat number
+				x[j].d0 += FERMAT;	// += 2 of result if Fermat number; q -= 2 would borrow from the high limb for q.d0 = 1
 				SUB96(x[j],q[j],x[j]);
 				tmp64 = CMPEQ96(x[j], ONE96);
 			#if FAC_DEBUG
@@ -2844,7 +2844,11 @@ double __mi52 = fma(__fy2,TWO26FLOAT,__fy1);	/* mi52 = y1 + y2*2^26 */\
 		__fhi1 -= __fhi2*TWO26FLOAT;							__ghi1 -= __ghi2*TWO26FLOAT;							__hhi1 -= __hhi2*TWO26FLOAT;							__ihi1 -= __ihi2*TWO26FLOAT;\
 	}
 
-	/* Even-Cheaper version which leaves high 52 output bits as-is. Cost = 13 FMUL, 10 FADD, 2 DNINT: */
+	/* Even-Cheaper version which leaves high 52 output bits as-is. Cost = 14 FMUL, 11 FADD, 4 DNINT.
+	The carry out of the low 78 bits must be exact: in the Montgomery modmul those bits equal the low half of x^2, which
+	is often near 0 (e.g. always so for x < 2^26), and the older estimate of the carry from just digits 1 and 2, without
+	the x0*y0 term, was then frequently 1 too small. So do digits 0 and 1 exactly, and take the floor from the sign of the
+	full low 78 bits, i.e. of digit 2 unless that is 0, in which case of the low 52 bits: */
 	#define MULH78_3WORD_DOUBLE_LEAVE_HIGH52_UNNORMALIZED_q4(\
 	  __fx0,__fx1,__fx2, __fy0,__fy1,__fy2, __fhi0,__fhi1\
 	, __gx0,__gx1,__gx2, __gy0,__gy1,__gy2, __ghi0,__ghi1\
@@ -2854,18 +2858,26 @@ double __mi52 = fma(__fy2,TWO26FLOAT,__fy1);	/* mi52 = y1 + y2*2^26 */\
 	{\
 		double __ftmp, __gtmp, __htmp, __itmp;\
 		double __fcy, __gcy, __hcy, __icy;\
+		double __flo, __glo, __hlo, __ilo;\
 		\
+		/* Digit 0: */\
+		__ftmp = __fx0*__fy0;				__gtmp = __gx0*__gy0;				__htmp = __hx0*__hy0;				__itmp = __ix0*__iy0;				\
+		__fcy  = DNINT(__ftmp*TWO26FLINV);	__gcy  = DNINT(__gtmp*TWO26FLINV);	__hcy  = DNINT(__htmp*TWO26FLINV);	__icy  = DNINT(__itmp*TWO26FLINV);	\
+		__flo  = __ftmp - __fcy*TWO26FLOAT;	__glo  = __gtmp - __gcy*TWO26FLOAT;	__hlo  = __htmp - __hcy*TWO26FLOAT;	__ilo  = __itmp - __icy*TWO26FLOAT;	\
 		/* Digit 1: */\
-		__ftmp = __fx0*__fy1;				__gtmp = __gx0*__gy1;				__htmp = __hx0*__hy1;				__itmp = __ix0*__iy1;				\
+		__ftmp = __fx0*__fy1 + __fcy;		__gtmp = __gx0*__gy1 + __gcy;		__htmp = __hx0*__hy1 + __hcy;		__itmp = __ix0*__iy1 + __icy;		\
 		__ftmp+= __fx1*__fy0;				__gtmp+= __gx1*__gy0;				__htmp+= __hx1*__hy0;				__itmp+= __ix1*__iy0;				\
-		__ftmp*= TWO26FLINV;				__gtmp*= TWO26FLINV;				__htmp*= TWO26FLINV;				__itmp*= TWO26FLINV;				\
+		__fcy  = DNINT(__ftmp*TWO26FLINV);	__gcy  = DNINT(__gtmp*TWO26FLINV);	__hcy  = DNINT(__htmp*TWO26FLINV);	__icy  = DNINT(__itmp*TWO26FLINV);	\
+		__ftmp-= __fcy*TWO26FLOAT;			__gtmp-= __gcy*TWO26FLOAT;			__htmp-= __hcy*TWO26FLOAT;			__itmp-= __icy*TWO26FLOAT;			\
+		__flo += __ftmp*TWO26FLOAT;			__glo += __gtmp*TWO26FLOAT;			__hlo += __htmp*TWO26FLOAT;			__ilo += __itmp*TWO26FLOAT;			\
 		/* Digit 2: */\
-		__ftmp+= __fx0*__fy2;				__gtmp+= __gx0*__gy2;				__htmp+= __hx0*__hy2;				__itmp+= __ix0*__iy2;				\
+		__ftmp = __fx0*__fy2 + __fcy;		__gtmp = __gx0*__gy2 + __gcy;		__htmp = __hx0*__hy2 + __hcy;		__itmp = __ix0*__iy2 + __icy;		\
 		__ftmp+= __fx1*__fy1;				__gtmp+= __gx1*__gy1;				__htmp+= __hx1*__hy1;				__itmp+= __ix1*__iy1;				\
 		__ftmp+= __fx2*__fy0;				__gtmp+= __gx2*__gy0;				__htmp+= __hx2*__hy0;				__itmp+= __ix2*__iy0;				\
 		__fcy  = DNINT(__ftmp*TWO26FLINV);	__gcy  = DNINT(__gtmp*TWO26FLINV);	__hcy  = DNINT(__htmp*TWO26FLINV);	__icy  = DNINT(__itmp*TWO26FLINV);	\
 		__ftmp-= __fcy*TWO26FLOAT;			__gtmp-= __gcy*TWO26FLOAT;			__htmp-= __hcy*TWO26FLOAT;			__itmp-= __icy*TWO26FLOAT;			\
-		__fcy -= (double)(__ftmp < 0);		__gcy -= (double)(__gtmp < 0);		__hcy -= (double)(__htmp < 0);		__icy -= (double)(__itmp < 0);		\
+		__fcy -= (double)(__ftmp < 0 || (__ftmp == 0 && __flo < 0));	__gcy -= (double)(__gtmp < 0 || (__gtmp == 0 && __glo < 0));	\
+		__hcy -= (double)(__htmp < 0 || (__htmp == 0 && __hlo < 0));	__icy -= (double)(__itmp < 0 || (__itmp == 0 && __ilo < 0));	\
 		/* At this point the possibility of same-address in-and-outputs comes into play: */\
 		/* Precompute all the needed partial products: */\
 		__ftmp = __fx1*__fy2 + __fcy;		__gtmp = __gx1*__gy2 + __gcy;		__htmp = __hx1*__hy2 + __hcy;		__itmp = __ix1*__iy2 + __icy;		\
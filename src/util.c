@@ -8952,6 +8952,28 @@ exit(0);
 
   #endif
 
+	/* Number of work units (a.k.a. the CY_THREADS chunk count) into which the radix*_ditN_cy_dif1 carry step splits
+	its NDIVR-sized data block. The chunk count must be a power of 2 dividing both NDIVR and n_div_nwt; when it simply
+	equals the largest power of 2 <= #threads, a non-power-of-2 thread count leaves cores idle during the carry step -
+	e.g. 6 threads get 4 chunks, so 2 cores sit out. For such thread counts we instead split the block into as many as
+	CY_WORK_UNITS_PER_THREAD chunks per thread, which the threadpool hands out dynamically; the one extra cost is the
+	end-of-pass carry fixup, which is O(#chunks * RADIX) and negligible. If the leading radix cannot support a chunk
+	count finer than the legacy one we fall back to the latter. Power-of-2 thread counts keep 1 chunk per thread.
+	*/
+	uint32 get_carry_work_units(uint32 nthreads, uint32 ndivr, uint32 n_div_nwt)
+	{
+		uint32 i, nlo, nunits;
+		if(nthreads <= 1 || isPow2(nthreads))
+			return MAX(nthreads,1);
+		i = leadz32(nthreads);
+		nlo = ((nthreads << i) & 0x80000000) >> i;	// Largest power of 2 <= nthreads
+		i = leadz32(nthreads*CY_WORK_UNITS_PER_THREAD - 1);
+		nunits = 0x80000000 >> (i-1);	// Smallest power of 2 >= nthreads*CY_WORK_UNITS_PER_THREAD
+		while(nunits > nlo && (ndivr%nunits != 0 || n_div_nwt%nunits != 0))
+			nunits >>= 1;
+		return nunits;
+	}
+
 	// Simple struct to pass multiple args to the loop/join-test thread function:
 	struct do_loop_test_thread_data{
 		int tid;
@@ -9625,3 +9647,75 @@ double mlucas_getOptVal(const char*fname, char*optname)
 	return result;
 }
 
+
+/*********************/
+/* CRC-32C (Castagnoli polynomial 0x1EDC6F41, reflected form 0x82F63B78), as used for the per-block integrity checks of
+savefiles: Uses the SSE4.2 or ARMv8 CRC32 instructions where the compiler targets them, otherwise a slicing-by-8 table
+lookup, which runs at ~1-2 GB/sec, i.e. still faster than a typical disk. [crc] is the value returned by a previous call
+on the preceding bytes of the data, or 0 to start; thus crc32c(crc32c(0,a,m),a+m,n) == crc32c(0,a,m+n).
+*/
+#if defined(__SSE4_2__)
+	#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+	#include <arm_acle.h>
+#else
+	static uint32 crc32c_tab[8][256];
+	static int crc32c_tab_init = FALSE;
+#endif
+
+uint32 crc32c(uint32 crc, const uint8*buf, size_t len)
+{
+	crc = ~crc;
+#if defined(__SSE4_2__) || defined(__ARM_FEATURE_CRC32)
+	uint64 itmp64;
+	for(; len && ((intptr_t)buf & 7); len--) {
+	  #ifdef __SSE4_2__
+		crc = _mm_crc32_u8(crc, *buf++);
+	  #else
+		crc = __crc32cb(crc, *buf++);
+	  #endif
+	}
+	for(; len >= 8; len -= 8, buf += 8) {
+		memcpy(&itmp64, buf, 8);
+	  #ifdef __SSE4_2__
+		crc = (uint32)_mm_crc32_u64(crc, itmp64);
+	  #else
+		crc = __crc32cd(crc, itmp64);
+	  #endif
+	}
+	for(; len; len--) {
+	  #ifdef __SSE4_2__
+		crc = _mm_crc32_u8(crc, *buf++);
+	  #else
+		crc = __crc32cb(crc, *buf++);
+	  #endif
+	}
+#else
+	uint32 i,j, lo,hi;
+	if(!crc32c_tab_init) {
+		for(i = 0; i < 256; i++) {
+			lo = i;
+			for(j = 0; j < 8; j++) { lo = (lo >> 1) ^ (0x82F63B78 & -(lo & 1)); }
+			crc32c_tab[0][i] = lo;
+		}
+		for(i = 0; i < 256; i++) {
+			for(j = 1; j < 8; j++) { crc32c_tab[j][i] = (crc32c_tab[j-1][i] >> 8) ^ crc32c_tab[0][crc32c_tab[j-1][i] & 0xff]; }
+		}
+		crc32c_tab_init = TRUE;
+	}
+	for(; len && ((intptr_t)buf & 7); len--) {
+		crc = (crc >> 8) ^ crc32c_tab[0][(crc ^ *buf++) & 0xff];
+	}
+	// Byte-at-a-time loads make this endian-neutral:
+	for(; len >= 8; len -= 8, buf += 8) {
+		lo = crc ^ ((uint32)buf[0] | ((uint32)buf[1] << 8) | ((uint32)buf[2] << 16) | ((uint32)buf[3] << 24));
+		hi =        (uint32)buf[4] | ((uint32)buf[5] << 8) | ((uint32)buf[6] << 16) | ((uint32)buf[7] << 24);
+		crc = crc32c_tab[7][lo & 0xff] ^ crc32c_tab[6][(lo >> 8) & 0xff] ^ crc32c_tab[5][(lo >> 16) & 0xff] ^ crc32c_tab[4][lo >> 24]
+			^ crc32c_tab[3][hi & 0xff] ^ crc32c_tab[2][(hi >> 8) & 0xff] ^ crc32c_tab[1][(hi >> 16) & 0xff] ^ crc32c_tab[0][hi >> 24];
+	}
+	for(; len; len--) {
+		crc = (crc >> 8) ^ crc32c_tab[0][(crc ^ *buf++) & 0xff];
+	}
+#endif
+	return ~crc;
+}
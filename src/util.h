@@ -191,6 +191,7 @@ FILE	*mlucas_fopen(const char *path, const char *mode); /* fopen() wrapper  */
 // v20: Add simple utility to print the input string to the current-assignment logfile and/or to stderr:
 void	mlucas_fprint(char*const cstr, uint32 echo_to_stderr);
 double	mlucas_getOptVal(const char*fname, char*optname);
+uint32	crc32c(uint32 crc, const uint8*buf, size_t len);	// CRC-32C, used for savefile integrity checks
 
 #ifdef USE_GPU
 //#if defined(USE_GPU) && defined(__CUDACC__)
@@ -205,6 +206,9 @@ double	mlucas_getOptVal(const char*fname, char*optname);
 #ifdef MULTITHREAD
 
 	int		get_num_cores(void);
+	// Target #carry-step chunks per thread for non-power-of-2 thread counts; see get_carry_work_units():
+	#define CY_WORK_UNITS_PER_THREAD	4
+	uint32	get_carry_work_units(uint32 nthreads, uint32 ndivr, uint32 n_div_nwt);
 	int		test_pthreads(int ncpu, int verbose);
 	void* 	ex_loop(void* data);
 	void*	PrintHello(void *threadid);
@@ -0,0 +1,66 @@
+#!/bin/bash
+
+# Shell script for measuring Mfactor multithreaded scaling on a fixed trial-factoring range; Mfactor output saved to tf-thread-scaling.log
+
+################################################################################
+#                                                                              #
+#  This program is free software; you can redistribute it and/or modify it     #
+#  under the terms of the GNU General Public License as published by the       #
+#  Free Software Foundation; either version 2 of the License, or (at your      #
+#  option) any later version.                                                  #
+#                                                                              #
+#  This program is distributed in the hope that it will be useful, but WITHOUT #
+#  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       #
+#  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   #
+#  more details.                                                               #
+#                                                                              #
+#  You should have received a copy of the GNU General Public License along     #
+#  with this program; see the file GPL.txt.  If not, you may view one at       #
+#  http://www.fsf.org/licenses/licenses.html, or obtain one by writing to the  #
+#  Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA     #
+#  02111-1307, USA.                                                            #
+#                                                                              #
+################################################################################
+
+# Mfactor; for the default MM127 exponent this must be an arbitrary-precision build, i.e. compiled with -DNWORD
+MFACTOR=./Mfactor
+
+# Double-Mersenne index and upper k-bound; the default range takes a few minutes single-threaded
+MM=127
+KMAX=1000000000
+
+# Thread counts to try; counts exceeding the number of available cores are skipped
+THREADS=(1 2 4 8 16 32)
+
+# Mfactor arguments
+ARGS=(
+	"$@"
+	# Add e.g. -kmin settings here, or as following arguments, e.g. bash ../tf-thread-scaling.sh -kmin 1000000
+)
+
+NPROC=$(nproc 2>/dev/null || getconf _NPROCESSORS_ONLN)
+MFACTOR=$(realpath "$MFACTOR")
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+printf '%8s %14s %9s %11s\n' threads seconds speedup efficiency
+t1=''
+for t in "${THREADS[@]}"; do
+	if [[ $t -gt $NPROC ]]; then
+		break
+	fi
+	# Remove only the t[exponent] checkpoint, so each thread count starts from scratch
+	rm -f "$DIR/t$MM"* "$DIR"/results.txt
+	(cd "$DIR" && "$MFACTOR" -mm $MM -kmax $KMAX -nthread $t "${ARGS[@]}" >>tf-thread-scaling.log 2>&1)
+	# Run time is printed as 'Clocks = HH:MM:SS.mmm'
+	sec=$(awk -F'= *' '/^Clocks =/ { split($2, a, ":"); s = 3600 * a[1] + 60 * a[2] + a[3] } END { if (s != "") print s }' "$DIR/tf-thread-scaling.log" 2>/dev/null)
+	if [[ -z $sec ]]; then
+		printf '%8s %14s\n' "$t" failed
+		continue
+	fi
+	if [[ -z $t1 ]]; then
+		t1=$sec
+	fi
+	awk -v t="$t" -v s="$sec" -v t1="$t1" 'BEGIN { printf "%8d %14.3f %9.2f %10.1f%%\n", t, s, t1 / s, 100 * t1 / (s * t) }'
+done
+cp "$DIR/tf-thread-scaling.log" . 2>/dev/null
@@ -0,0 +1,67 @@
+#!/bin/bash
+
+# Shell script for measuring Mlucas multithreaded scaling at a fixed FFT length; Mlucas output saved to thread-scaling.log
+
+################################################################################
+#                                                                              #
+#  This program is free software; you can redistribute it and/or modify it     #
+#  under the terms of the GNU General Public License as published by the       #
+#  Free Software Foundation; either version 2 of the License, or (at your      #
+#  option) any later version.                                                  #
+#                                                                              #
+#  This program is distributed in the hope that it will be useful, but WITHOUT #
+#  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       #
+#  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for   #
+#  more details.                                                               #
+#                                                                              #
+#  You should have received a copy of the GNU General Public License along     #
+#  with this program; see the file GPL.txt.  If not, you may view one at       #
+#  http://www.fsf.org/licenses/licenses.html, or obtain one by writing to the  #
+#  Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA     #
+#  02111-1307, USA.                                                            #
+#                                                                              #
+################################################################################
+
+# Mlucas
+MLUCAS=./Mlucas
+
+# FFT length in K (the best radix set for each thread count is picked by the usual self-test timing)
+FFT=4096
+
+# Number of iterations per radix set
+ITERS=100
+
+# Thread counts to try; counts exceeding the number of available cores are skipped
+THREADS=(1 2 3 4 6 8 12 16 24 32 48 64)
+
+# Mlucas arguments
+ARGS=(
+	"$@"
+	# Add e.g. -radset settings here, or as following arguments, e.g. bash ../thread-scaling.sh -radset 0
+)
+
+NPROC=$(nproc 2>/dev/null || getconf _NPROCESSORS_ONLN)
+MLUCAS=$(realpath "$MLUCAS")
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+printf '%8s %12s %9s %11s\n' threads msec/iter speedup efficiency
+t1=''
+for t in "${THREADS[@]}"; do
+	if [[ $t -gt $NPROC ]]; then
+		break
+	fi
+	rm -f "$DIR/mlucas.cfg"
+	(cd "$DIR" && "$MLUCAS" -fft $FFT -iters $ITERS -cpu 0:$((t - 1)) "${ARGS[@]}" >>thread-scaling.log 2>&1)
+	# The self-test writes the timing of the fastest radix set to mlucas.cfg
+	msec=$(awk '$2 == "msec/iter" { print $4; exit }' "$DIR/mlucas.cfg" 2>/dev/null)
+	if [[ -z $msec ]]; then
+		printf '%8s %12s\n' "$t" failed
+		continue
+	fi
+	if [[ -z $t1 ]]; then
+		t1=$msec
+	fi
+	awk -v t="$t" -v m="$msec" -v t1="$t1" 'BEGIN { printf "%8d %12.2f %9.2f %10.1f%%\n", t, m, t1 / m, 100 * t1 / (m * t) }'
+done
+cp "$DIR/thread-scaling.log" . 2>/dev/null